@@ -43,7 +43,6 @@ namespace eicrecon {
 //
 // TODO:
 // - Array type configuration parameters are not yet supported in JANA (needs to be added)
-// - Random number service needs to bew resolved (on global scale)
 // - It is possible standard running of this with Gaudi relied on a number of parameters
 //   being set in the config. If that is the case, they should be moved into the default
 //   values here. This needs to be confirmed.
@@ -51,19 +50,10 @@ namespace eicrecon {
 
 void CalorimeterHitDigi::init() {
 
-    // Gaudi implements a random number generator service. It is not clear to me how this
-    // can work. There are multiple race conditions that occur in parallel event processing:
-    // 1. The exact same events processed by a given thread in one invocation will not
-    //    necessarily be the combination of events any thread sees in a subsequent
-    //    invocation. Thus, you can't rely on thread_local storage.
-    // 2. Its possible for the factory execution order to be modified by the presence of
-    //    a processor (e.g. monitoring plugin). This is not as serious since changing the
-    //    command line should cause one not to expect reproducibility. Still, one may
-    //    expect the inclusion of an "observer" plugin not to have such side affects.
-    //
-    // More information will be needed. In the meantime, we implement a local random number
-    // generator. Ideally, this would be seeded with the run number+event number, but for
-    // now, just use default values defined in header file.
+    // Random numbers are drawn from a stream per (merged) cell of each event,
+    // so the result does not depend on the number of threads nor on the order
+    // in which events are processed.
+    m_rng_key = algorithms::RandomStreamSvc::key(name());
 
     // set energy resolution numbers
     if (m_cfg.eRes.empty()) {
@@ -104,19 +94,8 @@ void CalorimeterHitDigi::init() {
     }
     id_mask = ~id_inverse_mask;
 
-    std::function hit_to_map = [this](const edm4hep::SimCalorimeterHit &h) {
-      std::unordered_map<std::string, double> params;
-      for(const auto &p : id_spec.fields()) {
-        const std::string &name = p.first;
-        const dd4hep::IDDescriptor::Field* field = p.second;
-        params.emplace(name, field->value(h.getCellID()));
-        trace("{} = {}", name, field->value(h.getCellID()));
-      }
-      return params;
-    };
-
     auto& serviceSvc = algorithms::ServiceSvc::instance();
-    corrMeanScale = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile(m_cfg.corrMeanScale, hit_to_map);
+    corrMeanScale = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile(m_cfg.corrMeanScale, id_spec);
 }
 
 
@@ -173,18 +152,20 @@ void CalorimeterHitDigi::process(
         }
         if (time > m_cfg.capTime) continue;
 
+        auto rng = m_random_svc.stream(m_rng_key, id);
+
         // safety check
         const double eResRel = (edep > m_cfg.threshold)
-                ? m_gaussian(m_generator) * std::sqrt(
+                ? rng.gaussian() * std::sqrt(
                      std::pow(m_cfg.eRes[0] / std::sqrt(edep), 2) +
                      std::pow(m_cfg.eRes[1], 2) +
                      std::pow(m_cfg.eRes[2] / (edep), 2)
                   )
                 : 0;
-        double    corrMeanScale_value = corrMeanScale(leading_hit);
-        double    ped     = m_cfg.pedMeanADC + m_gaussian(m_generator) * m_cfg.pedSigmaADC;
+        double    corrMeanScale_value = corrMeanScale(leading_hit.getCellID());
+        double    ped     = m_cfg.pedMeanADC + rng.gaussian() * m_cfg.pedSigmaADC;
         unsigned long long adc     = std::llround(ped + edep * corrMeanScale_value * ( 1.0 + eResRel) / m_cfg.dyRangeADC * m_cfg.capADC);
-        unsigned long long tdc     = std::llround((time + m_gaussian(m_generator) * tRes) * stepTDC);
+        unsigned long long tdc     = std::llround((time + rng.gaussian() * tRes) * stepTDC);
 
         if (edep> 1.e-3) trace("E sim {} \t adc: {} \t time: {}\t maxtime: {} \t tdc: {} \t corrMeanScale: {}", edep, adc, time, m_cfg.capTime, tdc, corrMeanScale_value);
         rawhits->create(
@@ -18,13 +18,13 @@
 #include <DD4hep/IDDescriptor.h>
 #include <edm4hep/RawCalorimeterHitCollection.h>
 #include <edm4hep/SimCalorimeterHitCollection.h>
-#include <random>
 #include <stdint.h>
 #include <string>
 #include <string_view>
 #include <functional>
 
 #include "CalorimeterHitDigiConfig.h"
+#include "algorithms/interfaces/RandomStreamSvc.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
@@ -60,15 +60,15 @@ namespace eicrecon {
 
     uint64_t         id_mask{0};
 
-    std::function<double(const edm4hep::SimCalorimeterHit &h)> corrMeanScale;
+    std::function<double(uint64_t cellID)> corrMeanScale;
 
     dd4hep::IDDescriptor id_spec;
 
   private:
     const algorithms::GeoSvc& m_geo = algorithms::GeoSvc::instance();
+    const algorithms::RandomStreamSvc& m_random_svc = algorithms::RandomStreamSvc::instance();
 
-    mutable std::default_random_engine m_generator;
-    mutable std::normal_distribution<double> m_gaussian;
+    uint64_t         m_rng_key{0};
 
   };
 
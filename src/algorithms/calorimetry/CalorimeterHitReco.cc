@@ -25,16 +25,20 @@
 #include <fmt/format.h>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <exception>
 #include <gsl/pointers>
 #include <map>
 #include <ostream>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "algorithms/calorimetry/CalorimeterHitRecoConfig.h"
 #include "services/evaluator/EvaluatorSvc.h"
+#include "services/geometry/cellgeo/CellGeoSvc.h"
+#include "services/geometry/cellgeo/ReadoutCells.h"
 
 using namespace dd4hep;
 
@@ -53,6 +57,13 @@ void CalorimeterHitReco::init() {
     // TDC channels to timing conversion
     stepTDC = dd4hep::ns / m_cfg.resolutionTDC;
 
+    // cell geometry depends on the readout and the configuration, share it between instances with the same ones
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    const std::string cell_geometry_configuration = fmt::format("{};{};{};{};{}", m_cfg.readout, fmt::join(m_cfg.maskPosFields, ","),
+                                                                m_cfg.maskPos, m_cfg.localDetElement, fmt::join(m_cfg.localDetFields, ","));
+    m_cell_geometry = &serviceSvc.service<CellGeoSvc>("CellGeoSvc")->cache<CellGeometry>(
+        fmt::format("CalorimeterHitReco/{}", m_cfg.readout.empty() ? name() : m_cfg.readout), cell_geometry_configuration);
+
     // do not get the layer/sector ID if no readout class provided
     if (m_cfg.readout.empty()) {
         return;
@@ -110,19 +121,7 @@ void CalorimeterHitReco::init() {
 
     id_spec = m_detector->readout(m_cfg.readout).idSpec();
 
-    std::function hit_to_map = [this](const edm4hep::RawCalorimeterHit &h) {
-      std::unordered_map<std::string, double> params;
-      for(const auto &p : id_spec.fields()) {
-        const std::string &name = p.first;
-        const dd4hep::IDDescriptor::Field* field = p.second;
-        params.emplace(name, field->value(h.getCellID()));
-        trace("{} = {}", name, field->value(h.getCellID()));
-      }
-      return params;
-    };
-
-    auto& serviceSvc = algorithms::ServiceSvc::instance();
-    sampFrac = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile(m_cfg.sampFrac, hit_to_map);
+    sampFrac = serviceSvc.service<EvaluatorSvc>("EvaluatorSvc")->compile_batch(m_cfg.sampFrac, id_spec);
 
     // local detector name has higher priority
     if (!m_cfg.localDetElement.empty()) {
@@ -144,6 +143,18 @@ void CalorimeterHitReco::init() {
             local_mask = ~static_cast<decltype(local_mask)>(0);
         }
     }
+
+    if (m_cfg.prefillCellGeometry) {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            const std::size_t n_cells = prefill_readout_cells(*m_cell_geometry, *m_detector, m_cfg.readout,
+                                                              [this](uint64_t cellID) { return cell_geometry(cellID); });
+            debug("Prefilled cell geometry of {} cells of {} in {:.3f} s", n_cells, m_cfg.readout,
+                  std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        } catch (std::exception& e) {
+            warning("Failed to prefill cell geometry of {}: {}", m_cfg.readout, e.what());
+        }
+    }
 }
 
 
@@ -164,6 +175,19 @@ void CalorimeterHitReco::process(
     // error is detector.
     if (NcellIDerrors >= MaxCellIDerrors) return;
 
+    // sampling fractions of all hits passing the zero-suppression threshold at once
+    std::vector<uint64_t> cellIDs;
+    cellIDs.reserve(rawhits->size());
+    for (const auto &rh: *rawhits) {
+        if (rh.getAmplitude() < m_cfg.pedMeanADC + thresholdADC) {
+            continue;
+        }
+        cellIDs.push_back(rh.getCellID());
+    }
+    std::vector<float> sampFrac_values(cellIDs.size());
+    sampFrac(cellIDs, sampFrac_values);
+    auto sampFrac_it = sampFrac_values.cbegin();
+
     for (const auto &rh: *rawhits) {
 
         //did not pass the zero-suppresion threshold
@@ -179,47 +203,17 @@ void CalorimeterHitReco::process(
                 id_dec != nullptr && !m_cfg.sectorField.empty() ? static_cast<int>(id_dec->get(cellID, sector_idx)) : -1;
 
         // convert ADC to energy
-        float sampFrac_value = sampFrac(rh);
+        float sampFrac_value = *sampFrac_it++;
         float energy = (((signed) rh.getAmplitude() - (signed) m_cfg.pedMeanADC)) / static_cast<float>(m_cfg.capADC) * m_cfg.dyRangeADC /
                 sampFrac_value;
 
         const float time = rh.getTimeStamp() / stepTDC;
         trace("cellID {}, \t energy: {},  TDC: {}, time: {}, sampFrac: {}", cellID, energy, rh.getTimeStamp(), time, sampFrac_value);
 
-        dd4hep::DetElement local;
-        dd4hep::Position gpos;
+        // geometry of a cell does not change, it is computed once for all threads
+        CellGeometry cell;
         try {
-            // global positions
-            gpos = m_converter->position(cellID);
-
-            // masked position (look for a mother volume)
-            if (gpos_mask != 0) {
-                auto mpos = m_converter->position(cellID & ~gpos_mask);
-                // replace corresponding coords
-                for (const char &c : m_cfg.maskPos) {
-                    switch (std::tolower(c)) {
-                    case 'x':
-                        gpos.SetX(mpos.X());
-                        break;
-                    case 'y':
-                        gpos.SetY(mpos.Y());
-                        break;
-                    case 'z':
-                        gpos.SetZ(mpos.Z());
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
-
-            // local positions
-            if (m_cfg.localDetElement.empty()) {
-                auto volman = m_detector->volumeManager();
-                local = volman.lookupDetElement(cellID & local_mask);
-            } else {
-                local = m_local;
-            }
+            cell = m_cell_geometry->get(cellID, [this](uint64_t id) { return cell_geometry(id); });
         } catch (...) {
             // Error looking up cellID. Messages should already have been printed.
             // Also, see comment at top of this method.
@@ -233,50 +227,90 @@ void CalorimeterHitReco::process(
             continue;
         }
 
-        const auto pos = local.nominal().worldToLocal(gpos);
-        std::vector<double> cdim;
-        // get segmentation dimensions
-        auto segmentation_type = m_converter->findReadout(local).segmentation().type();
-        if (segmentation_type == "CartesianGridXY" || segmentation_type == "HexGridXY") {
-            auto cell_dim = m_converter->cellDimensions(cellID);
-            cdim.resize(3);
-            cdim[0] = cell_dim[0];
-            cdim[1] = cell_dim[1];
-            debug("Using segmentation for cell dimensions: {}", fmt::join(cdim, ", "));
-        } else {
-            if ((segmentation_type != "NoSegmentation") && (!warned_unsupported_segmentation)) {
-                warning("Unsupported segmentation type \"{}\"", segmentation_type);
-                warned_unsupported_segmentation = true;
-            }
-
-            // Using bounding box instead of actual solid so the dimensions are always in dim_x, dim_y, dim_z
-            cdim = m_converter->findContext(cellID)->volumePlacement().volume().boundingBox().dimensions();
-            std::transform(cdim.begin(), cdim.end(), cdim.begin(),
-                           std::bind(std::multiplies<double>(), std::placeholders::_1, 2));
-            debug("Using bounding box for cell dimensions: {}", fmt::join(cdim, ", "));
-        }
-
-        //create constant vectors for passing to hit initializer list
-        //FIXME: needs to come from the geometry service/converter
-        const decltype(edm4eic::CalorimeterHitData::position) position(gpos.x() / dd4hep::mm, gpos.y() / dd4hep::mm,
-                                                                    gpos.z() / dd4hep::mm);
-        const decltype(edm4eic::CalorimeterHitData::dimension) dimension(cdim.at(0) / dd4hep::mm, cdim.at(1) / dd4hep::mm,
-                                                                      cdim.at(2) / dd4hep::mm);
-        const decltype(edm4eic::CalorimeterHitData::local) local_position(pos.x() / dd4hep::mm, pos.y() / dd4hep::mm,
-                                                                       pos.z() / dd4hep::mm);
-
         recohits->create(
             rh.getCellID(),
             energy,
             0,
             time,
             0,
-            position,
-            dimension,
+            cell.position,
+            cell.dimension,
             sid,
             lid,
-            local_position);
+            cell.local);
+    }
+}
+
+CalorimeterHitReco::CellGeometry CalorimeterHitReco::cell_geometry(uint64_t cellID) const {
+
+    dd4hep::DetElement local;
+    dd4hep::Position gpos;
+
+    // global positions
+    gpos = m_converter->position(cellID);
+
+    // masked position (look for a mother volume)
+    if (gpos_mask != 0) {
+        auto mpos = m_converter->position(cellID & ~gpos_mask);
+        // replace corresponding coords
+        for (const char &c : m_cfg.maskPos) {
+            switch (std::tolower(c)) {
+            case 'x':
+                gpos.SetX(mpos.X());
+                break;
+            case 'y':
+                gpos.SetY(mpos.Y());
+                break;
+            case 'z':
+                gpos.SetZ(mpos.Z());
+                break;
+            default:
+                break;
+            }
+        }
     }
+
+    // local positions
+    if (m_cfg.localDetElement.empty()) {
+        auto volman = m_detector->volumeManager();
+        local = volman.lookupDetElement(cellID & local_mask);
+    } else {
+        local = m_local;
+    }
+
+    const auto pos = local.nominal().worldToLocal(gpos);
+    std::vector<double> cdim;
+    // get segmentation dimensions
+    auto segmentation_type = m_converter->findReadout(local).segmentation().type();
+    if (segmentation_type == "CartesianGridXY" || segmentation_type == "HexGridXY") {
+        auto cell_dim = m_converter->cellDimensions(cellID);
+        cdim.resize(3);
+        cdim[0] = cell_dim[0];
+        cdim[1] = cell_dim[1];
+        debug("Using segmentation for cell dimensions: {}", fmt::join(cdim, ", "));
+    } else {
+        if ((segmentation_type != "NoSegmentation") && (!warned_unsupported_segmentation)) {
+            warning("Unsupported segmentation type \"{}\"", segmentation_type);
+            warned_unsupported_segmentation = true;
+        }
+
+        // Using bounding box instead of actual solid so the dimensions are always in dim_x, dim_y, dim_z
+        cdim = m_converter->findContext(cellID)->volumePlacement().volume().boundingBox().dimensions();
+        std::transform(cdim.begin(), cdim.end(), cdim.begin(),
+                       std::bind(std::multiplies<double>(), std::placeholders::_1, 2));
+        debug("Using bounding box for cell dimensions: {}", fmt::join(cdim, ", "));
+    }
+
+    //create constant vectors for passing to hit initializer list
+    //FIXME: needs to come from the geometry service/converter
+    return {
+        .position = {static_cast<float>(gpos.x() / dd4hep::mm), static_cast<float>(gpos.y() / dd4hep::mm),
+                     static_cast<float>(gpos.z() / dd4hep::mm)},
+        .dimension = {static_cast<float>(cdim.at(0) / dd4hep::mm), static_cast<float>(cdim.at(1) / dd4hep::mm),
+                      static_cast<float>(cdim.at(2) / dd4hep::mm)},
+        .local = {static_cast<float>(pos.x() / dd4hep::mm), static_cast<float>(pos.y() / dd4hep::mm),
+                  static_cast<float>(pos.z() / dd4hep::mm)},
+    };
 }
 
 } // namespace eicrecon
@@ -21,11 +21,13 @@
 #include <stdint.h>
 #include <functional>
 #include <gsl/pointers>
+#include <span>
 #include <string>
 #include <string_view>
 
 #include "CalorimeterHitRecoConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellgeo/CellGeoSvc.h"
 
 namespace eicrecon {
 
@@ -58,7 +60,16 @@ namespace eicrecon {
     double thresholdADC{0};
     double stepTDC{0};
 
-    std::function<double(const edm4hep::RawCalorimeterHit &h)> sampFrac;
+    std::function<void(std::span<const uint64_t> cellIDs, std::span<float> values)> sampFrac;
+
+    // geometry of a cell as stored in the reconstructed hit
+    struct CellGeometry {
+      decltype(edm4eic::CalorimeterHitData::position) position;
+      decltype(edm4eic::CalorimeterHitData::dimension) dimension;
+      decltype(edm4eic::CalorimeterHitData::local) local;
+    };
+    CellGeometry cell_geometry(uint64_t cellID) const;
+    CellGeoCache<CellGeometry>* m_cell_geometry{nullptr};
 
     dd4hep::IDDescriptor id_spec;
     dd4hep::BitFieldCoder* id_dec = nullptr;
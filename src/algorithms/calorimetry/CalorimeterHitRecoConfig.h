@@ -36,6 +36,9 @@ namespace eicrecon {
     std::vector<std::string> localDetFields{};
     std::string              maskPos{""};
     std::vector<std::string> maskPosFields{};
+
+    // cache the geometry of all cells of the readout at initialisation
+    bool                     prefillCellGeometry{false};
   };
 
 } // eicrecon
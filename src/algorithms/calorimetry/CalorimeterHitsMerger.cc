@@ -20,10 +20,14 @@
 #include <Evaluator/DD4hepUnits.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
+#include <algorithms/service.h>
 #include <fmt/core.h>
+#include <fmt/format.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <exception>
 #include <gsl/pointers>
 #include <string>
 #include <unordered_map>
@@ -31,11 +35,20 @@
 #include <vector>
 
 #include "algorithms/calorimetry/CalorimeterHitsMergerConfig.h"
+#include "services/geometry/cellgeo/CellGeoSvc.h"
+#include "services/geometry/cellgeo/ReadoutCells.h"
 
 namespace eicrecon {
 
 void CalorimeterHitsMerger::init() {
 
+    // reference cells depend on the readout and the merged fields, share them between instances with the same ones
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    const std::string cell_geometry_configuration = fmt::format("{};{};{}", m_cfg.readout, fmt::join(m_cfg.fields, ","),
+                                                                fmt::join(m_cfg.refs, ","));
+    m_cell_geometry = &serviceSvc.service<CellGeoSvc>("CellGeoSvc")->cache<CellGeometry>(
+        fmt::format("CalorimeterHitsMerger/{}", m_cfg.readout.empty() ? name() : m_cfg.readout), cell_geometry_configuration);
+
     if (m_cfg.readout.empty()) {
         error("readoutClass is not provided, it is needed to know the fields in readout ids");
         return;
@@ -59,6 +72,23 @@ void CalorimeterHitsMerger::init() {
     }
     id_mask = ~id_mask;
     debug("ID mask in {:s}: {:#064b}", m_cfg.readout, id_mask);
+
+    if (m_cfg.prefillCellGeometry && m_cell_geometry->claim_prefill()) {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<uint64_t> ref_ids = readout_cell_ids(*m_detector, m_cfg.readout, m_cell_geometry->max_size());
+            for (auto& id : ref_ids) {
+                id = (id & id_mask) | ref_mask;
+            }
+            std::sort(ref_ids.begin(), ref_ids.end());
+            ref_ids.erase(std::unique(ref_ids.begin(), ref_ids.end()), ref_ids.end());
+            const std::size_t n_failed = m_cell_geometry->prefill(ref_ids, [this](uint64_t cellID) { return cell_geometry(cellID); });
+            debug("Prefilled cell geometry of {} reference cells of {} in {:.3f} s", ref_ids.size() - n_failed, m_cfg.readout,
+                  std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        } catch (std::exception& e) {
+            warning("Failed to prefill cell geometry of {}: {}", m_cfg.readout, e.what());
+        }
+    }
 }
 
 void CalorimeterHitsMerger::process(
@@ -86,18 +116,11 @@ void CalorimeterHitsMerger::process(
     }
 
     // reconstruct info for merged hits
-    // dd4hep decoders
-    auto volman = m_detector->volumeManager();
-
     for (const auto &[id, ixs] : merge_map) {
         // reference fields id
         const uint64_t ref_id = id | ref_mask;
-        // global positions
-        const auto gpos = m_converter->position(ref_id);
-        // local positions
-        auto alignment = volman.lookupDetElement(ref_id).nominal();
-        const auto pos = alignment.worldToLocal(dd4hep::Position(gpos.x(), gpos.y(), gpos.z()));
-        debug("{}, {}", volman.lookupDetElement(ref_id).path(), volman.lookupDetector(ref_id).path());
+        // global and local positions
+        const auto cell = m_cell_geometry->get(ref_id, [this](uint64_t cellID) { return cell_geometry(cellID); });
         // sum energy
         float energy = 0.;
         float energyError = 0.;
@@ -116,28 +139,39 @@ void CalorimeterHitsMerger::process(
 
         const auto href = (*in_hits)[ixs.front()];
 
-        // create const vectors for passing to hit initializer list
-        const decltype(edm4eic::CalorimeterHitData::position) position(
-                gpos.x() / dd4hep::mm, gpos.y() / dd4hep::mm, gpos.z() / dd4hep::mm
-        );
-        const decltype(edm4eic::CalorimeterHitData::local) local(
-                pos.x(), pos.y(), pos.z()
-        );
-
         out_hits->create(
                         href.getCellID(),
                         energy,
                         energyError,
                         time,
                         timeError,
-                        position,
+                        cell.position,
                         href.getDimension(),
                         href.getSector(),
                         href.getLayer(),
-                        local); // Can do better here? Right now position is mapped on the central hit
+                        cell.local); // Can do better here? Right now position is mapped on the central hit
     }
 
     debug("Size before = {}, after = {}", in_hits->size(), out_hits->size());
 }
 
+CalorimeterHitsMerger::CellGeometry CalorimeterHitsMerger::cell_geometry(uint64_t ref_id) const {
+    // dd4hep decoders
+    auto volman = m_detector->volumeManager();
+
+    // global positions
+    const auto gpos = m_converter->position(ref_id);
+    // local positions
+    auto alignment = volman.lookupDetElement(ref_id).nominal();
+    const auto pos = alignment.worldToLocal(dd4hep::Position(gpos.x(), gpos.y(), gpos.z()));
+    debug("{}, {}", volman.lookupDetElement(ref_id).path(), volman.lookupDetector(ref_id).path());
+
+    // create const vectors for passing to hit initializer list
+    return {
+        .position = {static_cast<float>(gpos.x() / dd4hep::mm), static_cast<float>(gpos.y() / dd4hep::mm),
+                     static_cast<float>(gpos.z() / dd4hep::mm)},
+        .local = {static_cast<float>(pos.x()), static_cast<float>(pos.y()), static_cast<float>(pos.z())},
+    };
+}
+
 } // namespace eicrecon
@@ -22,6 +22,7 @@
 
 #include "CalorimeterHitsMergerConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellgeo/CellGeoSvc.h"
 
 namespace eicrecon {
 
@@ -51,6 +52,14 @@ namespace eicrecon {
   private:
     uint64_t id_mask{0}, ref_mask{0};
 
+    // geometry of a reference cell as stored in the merged hit
+    struct CellGeometry {
+      decltype(edm4eic::CalorimeterHitData::position) position;
+      decltype(edm4eic::CalorimeterHitData::local) local;
+    };
+    CellGeometry cell_geometry(uint64_t ref_id) const;
+    CellGeoCache<CellGeometry>* m_cell_geometry{nullptr};
+
   private:
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
     const dd4hep::rec::CellIDPositionConverter* m_converter{algorithms::GeoSvc::instance().cellIDPositionConverter()};
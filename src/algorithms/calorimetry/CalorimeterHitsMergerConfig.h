@@ -14,6 +14,9 @@ namespace eicrecon {
     std::vector<std::string> fields{};
     std::vector<int>         refs{};
 
+    // cache the geometry of all reference cells of the readout at initialisation
+    bool                     prefillCellGeometry{false};
+
   };
 
 } // eicrecon
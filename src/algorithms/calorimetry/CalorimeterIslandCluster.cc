@@ -13,10 +13,15 @@
 #include <edm4hep/Vector3f.h>
 #include <fmt/format.h>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <gsl/pointers>
+#include <iterator>
 #include <map>
 #include <memory>
-#include <set>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -79,11 +84,71 @@ static edm4hep::Vector2f globalDistEtaPhi(const CaloHit &h1, const CaloHit &h2)
   };
 }
 
+// Bins of the neighbour index, the hits that can be neighbours are at most
+// one bin apart along each probed axis
+using BinKey = std::array<std::int64_t, 3>;
+
+// Width of the bins for a distance cut, with some slack for the float
+// arithmetic in the distance functions
+static double neighbour_bin_width(double dist) {
+  return dist * (1. + 1e-4);
+}
+
+// Bin of a coordinate, or nothing if the coordinate can not be binned
+static std::optional<std::int64_t> neighbour_bin(double x, double width) {
+  // degenerate axis, all hits share a bin
+  if (!(width > 0.)) {
+    return 0;
+  }
+  const double bin = std::floor(x / width);
+  if (!std::isfinite(bin) || std::abs(bin) > 1e15) {
+    return std::nullopt;
+  }
+  return static_cast<std::int64_t>(bin);
+}
+
+// Call f(idx1, idx2) once for every pair of binned hits, idx1 < idx2, whose bins
+// are adjacent along the probed axes and equal along the others. The last axis
+// wraps around if period is not zero.
+template<typename F>
+static void for_each_adjacent_pair(std::vector<std::pair<BinKey, std::size_t>> &binned,
+                                   const std::array<bool, 3> &probe, std::int64_t period, F &&f) {
+  std::sort(binned.begin(), binned.end());
+
+  const auto key_less = [](const std::pair<BinKey, std::size_t> &entry, const BinKey &key) {
+    return entry.first < key;
+  };
+  const std::int64_t r0 = probe[0] ? 1 : 0;
+  const std::int64_t r1 = probe[1] ? 1 : 0;
+  const std::int64_t r2 = probe[2] ? 1 : 0;
+
+  for (const auto &[key, idx1] : binned) {
+    for (std::int64_t d0 = -r0; d0 <= r0; ++d0) {
+      for (std::int64_t d1 = -r1; d1 <= r1; ++d1) {
+        for (std::int64_t d2 = -r2; d2 <= r2; ++d2) {
+          BinKey other{key[0] + d0, key[1] + d1, key[2] + d2};
+          if (period != 0) {
+            other[2] = (other[2] + period) % period;
+          }
+          for (auto it = std::lower_bound(binned.begin(), binned.end(), other, key_less);
+               it != binned.end() && it->first == other; ++it) {
+            if (it->second > idx1) {
+              f(idx1, it->second);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 //------------------------
 // AlgorithmInit
 //------------------------
 void CalorimeterIslandCluster::init() {
 
+    m_neighbourMethod.clear();
+
     static std::map<std::string,
                 std::tuple<std::function<edm4hep::Vector2f(const CaloHit&, const CaloHit&)>, std::vector<double>>>
     distMethods{
@@ -107,6 +172,7 @@ void CalorimeterIslandCluster::init() {
           neighbourDist[i] = uprop.second[i] / units[i];
         }
         hitsDist = method;
+        m_neighbourMethod = uprop.first;
         info("Clustering uses {} with distances <= [{}]", uprop.first, fmt::join(neighbourDist, ","));
       }
       return true;
@@ -217,6 +283,158 @@ void CalorimeterIslandCluster::init() {
 }
 
 
+CalorimeterIslandCluster::NeighbourGraph CalorimeterIslandCluster::build_neighbour_graph(
+      const edm4eic::CalorimeterHitCollection &hits) const {
+
+    // not qualified hits do not participate clustering
+    std::vector<std::size_t> qualified;
+    qualified.reserve(hits.size());
+    for (std::size_t idx = 0; idx < hits.size(); ++idx) {
+      if (hits[idx].getEnergy() >= m_cfg.minClusterHitEdep) {
+        qualified.push_back(idx);
+      }
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    // the coordinate distance methods are symmetric in the two hits
+    auto add_symmetric = [&](std::size_t idx1, std::size_t idx2) {
+      if (is_neighbour(hits[idx1], hits[idx2])) {
+        edges.emplace_back(idx1, idx2);
+        edges.emplace_back(idx2, idx1);
+      }
+    };
+    auto add_all_pairs = [&]() {
+      for (std::size_t i = 0; i < qualified.size(); ++i) {
+        for (std::size_t j = i + 1; j < qualified.size(); ++j) {
+          add_symmetric(qualified[i], qualified[j]);
+        }
+      }
+    };
+
+    if (m_neighbourMethod.empty()) {
+      // an adjacency matrix expression can not be binned, nor assumed to be symmetric
+      for (std::size_t idx1 : qualified) {
+        for (std::size_t idx2 : qualified) {
+          if ((idx1 != idx2) && is_neighbour(hits[idx1], hits[idx2])) {
+            edges.emplace_back(idx1, idx2);
+          }
+        }
+      }
+    } else {
+      // hits in the same sector are binned in the coordinates of the distance method
+      std::array<double, 2> width{neighbour_bin_width(neighbourDist[0]), neighbour_bin_width(neighbourDist[1])};
+      bool periodic = false;
+      std::function<std::array<double, 2>(const CaloHit&)> coordinates;
+      if (m_neighbourMethod == "localDistXY" || m_neighbourMethod == "dimScaledLocalDistXY") {
+        coordinates = [](const CaloHit &h) { return std::array<double, 2>{h.getLocal().x, h.getLocal().y}; };
+      } else if (m_neighbourMethod == "localDistXZ") {
+        coordinates = [](const CaloHit &h) { return std::array<double, 2>{h.getLocal().x, h.getLocal().z}; };
+      } else if (m_neighbourMethod == "localDistYZ") {
+        coordinates = [](const CaloHit &h) { return std::array<double, 2>{h.getLocal().y, h.getLocal().z}; };
+      } else if (m_neighbourMethod == "globalDistRPhi") {
+        periodic = true;
+        coordinates = [](const CaloHit &h) {
+          return std::array<double, 2>{edm4hep::utils::magnitude(h.getPosition()), edm4hep::utils::angleAzimuthal(h.getPosition())};
+        };
+      } else if (m_neighbourMethod == "globalDistEtaPhi") {
+        periodic = true;
+        coordinates = [](const CaloHit &h) {
+          return std::array<double, 2>{edm4hep::utils::eta(h.getPosition()), edm4hep::utils::angleAzimuthal(h.getPosition())};
+        };
+      }
+      if (m_neighbourMethod == "dimScaledLocalDistXY") {
+        // distances are scaled by the mean dimension of the two cells
+        double max_dim_x = 0., max_dim_y = 0.;
+        for (std::size_t idx : qualified) {
+          max_dim_x = std::max<double>(max_dim_x, std::abs(hits[idx].getDimension().x));
+          max_dim_y = std::max<double>(max_dim_y, std::abs(hits[idx].getDimension().y));
+        }
+        width = {neighbour_bin_width(neighbourDist[0] * max_dim_x), neighbour_bin_width(neighbourDist[1] * max_dim_y)};
+      }
+
+      // phi bins cover the full circle, with at least three of them to wrap around
+      std::int64_t n_phi_bins = 0;
+      if (periodic && width[1] > 0.) {
+        n_phi_bins = static_cast<std::int64_t>(std::min(std::floor(2 * M_PI / width[1]), 1e6));
+      }
+      if (periodic) {
+        width[1] = (n_phi_bins >= 3) ? 2 * M_PI / n_phi_bins : 0.;
+      }
+
+      bool binned_ok = static_cast<bool>(coordinates);
+      std::vector<std::pair<BinKey, std::size_t>> binned;
+      binned.reserve(qualified.size());
+      for (std::size_t idx : qualified) {
+        if (!binned_ok) {
+          break;
+        }
+        const auto coord = coordinates(hits[idx]);
+        const auto bin_a = neighbour_bin(coord[0], width[0]);
+        auto bin_b = neighbour_bin(periodic ? coord[1] + M_PI : coord[1], width[1]);
+        if (!bin_a || !bin_b) {
+          binned_ok = false;
+          break;
+        }
+        if (periodic && n_phi_bins >= 3) {
+          bin_b = std::clamp<std::int64_t>(*bin_b, 0, n_phi_bins - 1);
+        }
+        binned.push_back({BinKey{hits[idx].getSector(), *bin_a, *bin_b}, idx});
+      }
+
+      // hits in different sectors are compared by their global distance
+      bool multiple_sectors = false;
+      for (std::size_t idx : qualified) {
+        multiple_sectors |= (hits[idx].getSector() != hits[qualified.front()].getSector());
+      }
+      std::vector<std::pair<BinKey, std::size_t>> binned_global;
+      if (binned_ok && multiple_sectors) {
+        const double global_width = neighbour_bin_width(m_cfg.sectorDist / dd4hep::mm);
+        binned_global.reserve(qualified.size());
+        for (std::size_t idx : qualified) {
+          const auto &position = hits[idx].getPosition();
+          const auto bin_x = neighbour_bin(position.x, global_width);
+          const auto bin_y = neighbour_bin(position.y, global_width);
+          const auto bin_z = neighbour_bin(position.z, global_width);
+          if (!bin_x || !bin_y || !bin_z) {
+            binned_ok = false;
+            break;
+          }
+          binned_global.push_back({BinKey{*bin_x, *bin_y, *bin_z}, idx});
+        }
+      }
+
+      if (binned_ok) {
+        for_each_adjacent_pair(binned, {false, width[0] > 0., width[1] > 0.}, (width[1] > 0.) ? n_phi_bins : 0, add_symmetric);
+        for_each_adjacent_pair(binned_global, {true, true, true}, 0,
+          [&](std::size_t idx1, std::size_t idx2) {
+            if (hits[idx1].getSector() != hits[idx2].getSector()) {
+              add_symmetric(idx1, idx2);
+            }
+          });
+      } else {
+        debug("Can not bin hits for neighbour search, comparing all pairs");
+        add_all_pairs();
+      }
+    }
+
+    // compressed adjacency lists
+    NeighbourGraph graph;
+    graph.offsets.assign(hits.size() + 1, 0);
+    for (const auto &[idx1, idx2] : edges) {
+      ++graph.offsets[idx1 + 1];
+    }
+    std::partial_sum(graph.offsets.begin(), graph.offsets.end(), graph.offsets.begin());
+    graph.neighbours.resize(edges.size());
+    std::vector<std::size_t> fill(graph.offsets.begin(), std::prev(graph.offsets.end()));
+    for (const auto &[idx1, idx2] : edges) {
+      graph.neighbours[fill[idx1]++] = idx2;
+    }
+
+    trace("neighbour graph: {} hits, {} edges", hits.size(), edges.size());
+    return graph;
+}
+
+
 void CalorimeterIslandCluster::process(
       const CalorimeterIslandCluster::Input& input,
       const CalorimeterIslandCluster::Output& output) const {
@@ -224,8 +442,11 @@ void CalorimeterIslandCluster::process(
     const auto [hits] = input;
     auto [proto_clusters] = output;
 
+    // neighbours are found once, grouping and maxima finding walk the graph
+    const NeighbourGraph graph = build_neighbour_graph(*hits);
+
     // group neighboring hits
-    std::vector<std::set<std::size_t>> groups;
+    std::vector<std::vector<std::size_t>> groups;
 
     std::vector<bool> visits(hits->size(), false);
     for (size_t i = 0; i < hits->size(); ++i) {
@@ -240,14 +461,14 @@ void CalorimeterIslandCluster::process(
       }
       groups.emplace_back();
       // create a new group, and group all the neighboring hits
-      bfs_group(*hits, groups.back(), i, visits);
+      bfs_group(*hits, graph, groups.back(), i, visits);
     }
 
     for (auto& group : groups) {
       if (group.empty()) {
         continue;
       }
-      auto maxima = find_maxima(*hits, group, !m_cfg.splitCluster);
+      auto maxima = find_maxima(*hits, graph, group, !m_cfg.splitCluster);
       split_group(*hits, group, maxima, proto_clusters);
 
       debug("hits in a group: {}, local maxima: {}", group.size(), maxima.size());
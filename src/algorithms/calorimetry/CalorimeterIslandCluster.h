@@ -12,12 +12,12 @@
 #include <edm4hep/Vector2f.h>
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
 #include <functional>
 #include <gsl/pointers>
-#include <set>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -73,12 +73,25 @@ namespace eicrecon {
     // Pointer to the geometry service
     dd4hep::IDDescriptor m_idSpec;
 
+    // coordinate distance method used by is_neighbour, empty for adjacency matrix
+    std::string m_neighbourMethod;
+
   private:
 
     static unsigned int function_id;
 
+    // neighbour index of an event: the hits adjacent to hit idx are
+    // neighbours[offsets[idx]], ..., neighbours[offsets[idx + 1] - 1]
+    struct NeighbourGraph {
+      std::vector<std::size_t> offsets;
+      std::vector<std::size_t> neighbours;
+    };
+
+    // evaluate is_neighbour once for all candidate pairs of qualified hits
+    NeighbourGraph build_neighbour_graph(const edm4eic::CalorimeterHitCollection &hits) const;
+
     // grouping function with Breadth-First Search
-    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, std::set<std::size_t> &group, std::size_t idx, std::vector<bool> &visits) const {
+    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, const NeighbourGraph &graph, std::vector<std::size_t> &group, std::size_t idx, std::vector<bool> &visits) const {
       visits[idx] = true;
 
       // not a qualified hit to participate clustering, stop here
@@ -86,37 +99,33 @@ namespace eicrecon {
         return;
       }
 
-      group.insert(idx);
-      size_t prev_size = 0;
-
-      while (prev_size != group.size()) {
-        prev_size = group.size();
-        for (std::size_t idx1 : group) {
-          // check neighbours
-          for (std::size_t idx2 = 0; idx2 < hits.size(); ++idx2) {
-            // not a qualified hit to participate clustering, skip
-            if (hits[idx2].getEnergy() < m_cfg.minClusterHitEdep) {
-              continue;
-            }
-            if ((!visits[idx2])
-                && is_neighbour(hits[idx1], hits[idx2])) {
-              group.insert(idx2);
-              visits[idx2] = true;
-            }
+      group.push_back(idx);
+
+      // only qualified hits have entries in the neighbour graph
+      for (std::size_t pos = 0; pos < group.size(); ++pos) {
+        const std::size_t idx1 = group[pos];
+        for (std::size_t k = graph.offsets[idx1]; k < graph.offsets[idx1 + 1]; ++k) {
+          const std::size_t idx2 = graph.neighbours[k];
+          if (!visits[idx2]) {
+            group.push_back(idx2);
+            visits[idx2] = true;
           }
         }
       }
+
+      // hits are added to the clusters in the order of the collection
+      std::sort(group.begin(), group.end());
     }
 
     // find local maxima that above a certain threshold
-  std::vector<std::size_t> find_maxima(const edm4eic::CalorimeterHitCollection &hits, const std::set<std::size_t> &group, bool global = false) const {
+  std::vector<std::size_t> find_maxima(const edm4eic::CalorimeterHitCollection &hits, const NeighbourGraph &graph, const std::vector<std::size_t> &group, bool global = false) const {
     std::vector<std::size_t> maxima;
     if (group.empty()) {
       return maxima;
     }
 
     if (global) {
-      std::size_t mpos = *group.begin();
+      std::size_t mpos = group.front();
       for (auto idx : group) {
         if (hits[mpos].getEnergy() < hits[idx].getEnergy()) {
           mpos = idx;
@@ -135,12 +144,10 @@ namespace eicrecon {
       }
 
       bool maximum = true;
-      for (std::size_t idx2 : group) {
-        if (idx1 == idx2) {
-          continue;
-        }
-
-        if (is_neighbour(hits[idx1], hits[idx2]) && (hits[idx2].getEnergy() > hits[idx1].getEnergy())) {
+      for (std::size_t k = graph.offsets[idx1]; k < graph.offsets[idx1 + 1]; ++k) {
+        const std::size_t idx2 = graph.neighbours[k];
+        if ((hits[idx2].getEnergy() > hits[idx1].getEnergy())
+            && std::binary_search(group.begin(), group.end(), idx2)) {
           maximum = false;
           break;
         }
@@ -166,7 +173,7 @@ namespace eicrecon {
 
     // split a group of hits according to the local maxima
     //TODO: confirm protoclustering without protoclustercollection
-  void split_group(const edm4eic::CalorimeterHitCollection &hits, std::set<std::size_t>& group, const std::vector<std::size_t>& maxima, edm4eic::ProtoClusterCollection *protoClusters) const {
+  void split_group(const edm4eic::CalorimeterHitCollection &hits, const std::vector<std::size_t>& group, const std::vector<std::size_t>& maxima, edm4eic::ProtoClusterCollection *protoClusters) const {
     // special cases
     if (maxima.empty()) {
       debug("No maxima found, not building any clusters");
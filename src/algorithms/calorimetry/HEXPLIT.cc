@@ -14,8 +14,13 @@
 #include <edm4hep/Vector3f.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <gsl/pointers>                            // for not_null
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "HEXPLIT.h"
@@ -75,6 +80,17 @@ const std::vector<double> HEXPLIT::subcell_offsets_y =[]() {
 
 void HEXPLIT::init() { }
 
+namespace {
+
+  // key of a bin of the spatial hash used to find neighboring cells
+  std::uint64_t bin_key(int layer, long ix, long iy) {
+    return (static_cast<std::uint64_t>(layer & 0xffff) << 48)
+         | (static_cast<std::uint64_t>(ix & 0xffffff) << 24)
+         | static_cast<std::uint64_t>(iy & 0xffffff);
+  }
+
+} // namespace
+
 void HEXPLIT::process(const HEXPLIT::Input& input,
                       const HEXPLIT::Output& output) const {
 
@@ -85,53 +101,104 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
   double Emin=m_cfg.Emin_in_MIPs*MIP;
   double tmax=m_cfg.tmax/dd4hep::ns;
 
+  // maximum distance between where the neighboring cell is and where it should be
+  // based on an ideal geometry using the staggered tessellation pattern.
+  // Deviations could arise from rounding errors or from detector misalignment.
+  const double tol=0.1; // in units of side lengths.
+
   auto volman = m_detector->volumeManager();
 
-  for(const auto& hit : *hits){
-    //skip hits that do not pass E and t cuts
+  // hits that pass E and t cuts
+  std::vector<std::size_t> selected;
+  selected.reserve(hits->size());
+  double bin_size=0;
+  for (std::size_t i = 0; i < hits->size(); i++) {
+    const auto& hit = (*hits)[i];
     if (hit.getEnergy()<Emin || hit.getTime()>tmax)
       continue;
+    selected.push_back(i);
+    bin_size=std::max<double>(bin_size, hit.getDimension().x/2.);
+  }
+  if (selected.empty())
+    return;
+  if (!(bin_size>0))
+    bin_size=1;
+
+  // spatial hash of the selected hits, binned by layer and local transverse position
+  std::unordered_map<std::uint64_t, std::vector<std::size_t>> bins;
+  bins.reserve(selected.size());
+  for (std::size_t i : selected) {
+    const auto& hit = (*hits)[i];
+    long ix=std::lround(std::floor(hit.getLocal().x/bin_size));
+    long iy=std::lround(std::floor(hit.getLocal().y/bin_size));
+    bins[bin_key(hit.getLayer(), ix, iy)].push_back(i);
+  }
+
+  for (std::size_t i : selected) {
+    const auto& hit = (*hits)[i];
 
     //keep track of the energy in each neighboring cell
-    std::vector<double> Eneighbors(NEIGHBORS, 0.0);
+    std::array<double, NEIGHBORS> Eneighbors{};
 
     double sl = hit.getDimension().x/2.;
-    for (const auto& other_hit : *hits){
-      // maximum distance between where the neighboring cell is and where it should be
-      // based on an ideal geometry using the staggered tessellation pattern.
-      // Deviations could arise from rounding errors or from detector misalignment.
-      double tol=0.1; // in units of side lengths.
-
-      //only look at hits nearby within two layers of the current layer
-      int dz=abs(hit.getLayer()-other_hit.getLayer());
-      if (dz>2 || dz==0)
-        continue;
-      if (other_hit.getEnergy()<Emin || other_hit.getTime()>tmax)
-        continue;
-      //difference in transverse position (in units of side lengths)
-      double dx=(other_hit.getLocal().x-hit.getLocal().x)/sl;
-      double dy=(other_hit.getLocal().y-hit.getLocal().y)/sl;
-      if (abs(dx)>2 || abs(dy)>sqrt(3))
-        continue;
-
-      //loop over locations of the neighboring cells
-      //and check if the jth hit matches this location
+    //only look at hits nearby within two layers of the current layer
+    for (int dz : {-2, -1, 1, 2}) {
+      int layer=hit.getLayer()+dz;
+      //probe the locations of the neighboring cells
       for(int k=0;k<NEIGHBORS;k++){
-        if(abs(dx-neighbor_offsets_x[k])<tol && abs(dy-neighbor_offsets_y[k])<tol){
-          Eneighbors[k]+=other_hit.getEnergy();
-          break;
+        double x=hit.getLocal().x+neighbor_offsets_x[k]*sl;
+        double y=hit.getLocal().y+neighbor_offsets_y[k]*sl;
+        long ix_min=std::lround(std::floor((x-tol*sl)/bin_size));
+        long ix_max=std::lround(std::floor((x+tol*sl)/bin_size));
+        long iy_min=std::lround(std::floor((y-tol*sl)/bin_size));
+        long iy_max=std::lround(std::floor((y+tol*sl)/bin_size));
+        for (long ix = ix_min; ix <= ix_max; ix++) {
+          for (long iy = iy_min; iy <= iy_max; iy++) {
+            auto bin = bins.find(bin_key(layer, ix, iy));
+            if (bin == bins.end())
+              continue;
+            for (std::size_t j : bin->second) {
+              const auto& other_hit = (*hits)[j];
+              if (other_hit.getLayer()!=layer)
+                continue;
+              //difference in transverse position (in units of side lengths)
+              double dx=(other_hit.getLocal().x-hit.getLocal().x)/sl;
+              double dy=(other_hit.getLocal().y-hit.getLocal().y)/sl;
+              if(std::abs(dx-neighbor_offsets_x[k])<tol && std::abs(dy-neighbor_offsets_y[k])<tol){
+                Eneighbors[k]+=other_hit.getEnergy();
+              }
+            }
+          }
         }
       }
     }
-    double weights[SUBCELLS];
+
     for(int k=0; k<NEIGHBORS; k++){
       Eneighbors[k]=std::max(Eneighbors[k],MIP);
     }
-    double sum_weights=0;
+    std::array<double, SUBCELLS> weights;
     for(int k=0; k<SUBCELLS; k++){
       weights[k]=Eneighbors[neighbor_indices[k][0]]*Eneighbors[neighbor_indices[k][1]]*Eneighbors[neighbor_indices[k][2]];
+    }
+    double sum_weights=0;
+    for(int k=0; k<SUBCELLS; k++){
       sum_weights+=weights[k];
     }
+    std::array<double, SUBCELLS> energies;
+    for(int k=0; k<SUBCELLS; k++){
+      energies[k]=hit.getEnergy()*weights[k]/sum_weights;
+    }
+
+    //the subcells share the transformation of their cell
+    std::optional<dd4hep::Alignment> alignment;
+    try {
+      alignment = volman.lookupDetElement(hit.getCellID()).nominal();
+    }
+    catch (...){
+      // do this to prevent errors when running the test on the mock detector
+      warning("Cannot find transformation from local to global coordinates.");
+    }
+
     for(int k=0; k<SUBCELLS;k++){
 
       //create the subcell hits.  First determine their positions in local coordinates.
@@ -143,20 +210,8 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
       local_position.SetY(local.y*dd4hep::mm);
       local_position.SetZ(local.z*dd4hep::mm);
 
-      dd4hep::Position global_position;
-      try {
-
-        //also convert this to the detector's global coordinates.  To do: check if this is correct
-        auto alignment = volman.lookupDetElement(hit.getCellID()).nominal();
-
-        global_position = alignment.localToWorld(local_position);
-
-      }
-      catch (...){
-        // do this to prevent errors when running the test on the mock detector
-        warning("Cannot find transformation from local to global coordinates.");
-        global_position = local_position;
-      }
+      //also convert this to the detector's global coordinates.  To do: check if this is correct
+      dd4hep::Position global_position = alignment ? alignment->localToWorld(local_position) : local_position;
 
       //convert this from position object to a vector object
       const decltype(edm4eic::CalorimeterHitData::position) position = {static_cast<float>(global_position.X()/dd4hep::mm), static_cast<float>(global_position.Y()/dd4hep::mm), static_cast<float>(global_position.Z()/dd4hep::mm)};
@@ -168,7 +223,7 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
 
       subcellHits->create(
             hit.getCellID(),
-            hit.getEnergy()*weights[k]/sum_weights,
+            energies[k],
             0,
             hit.getTime(),
             0,
@@ -181,5 +236,4 @@ void HEXPLIT::process(const HEXPLIT::Input& input,
   }
 }
 
-
 } // namespace eicrecon
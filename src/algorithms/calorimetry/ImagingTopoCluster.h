@@ -12,6 +12,11 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 #include <algorithms/algorithm.h>
 #include <DD4hep/BitFieldCoder.h>
@@ -123,9 +128,13 @@ namespace eicrecon {
         const auto [hits] = input;
         auto [proto] = output;
 
-        // group neighbouring hits
+        // spatial index of the hits that can participate in clustering
+        const HitIndex index = build_index(*hits);
+
+        // group neighbouring hits, the hits of each group are stored contiguously
         std::vector<bool> visits(hits->size(), false);
-        std::vector<std::set<std::size_t>> groups;
+        std::vector<std::size_t> group_hits;
+        std::vector<std::size_t> group_offsets{0};
         for (size_t i = 0; i < hits->size(); ++i) {
             debug("hit {:d}: local position = ({}, {}, {}), global position = ({}, {}, {})", i + 1,
                          (*hits)[i].getLocal().x, (*hits)[i].getLocal().y, (*hits)[i].getPosition().z,
@@ -136,29 +145,32 @@ namespace eicrecon {
                 continue;
             }
             // create a new group, and group all the neighbouring hits
-            groups.emplace_back();
-            bfs_group(*hits, groups.back(), i, visits);
+            bfs_group(*hits, index, group_hits, i, visits);
+            group_offsets.push_back(group_hits.size());
         }
-        debug("found {} potential clusters (groups of hits)", groups.size());
-        for (size_t i = 0; i < groups.size(); ++i) {
-            debug("group {}: {} hits", i, groups[i].size());
+        const std::size_t n_groups = group_offsets.size() - 1;
+        debug("found {} potential clusters (groups of hits)", n_groups);
+        for (size_t i = 0; i < n_groups; ++i) {
+            debug("group {}: {} hits", i, group_offsets[i + 1] - group_offsets[i]);
         }
 
         // form clusters
-        for (const auto &group : groups) {
-            if (static_cast<int>(group.size()) < m_cfg.minClusterNhits) {
+        for (size_t i = 0; i < n_groups; ++i) {
+            const auto group_begin = group_hits.begin() + group_offsets[i];
+            const auto group_end = group_hits.begin() + group_offsets[i + 1];
+            if (static_cast<int>(group_end - group_begin) < m_cfg.minClusterNhits) {
                 continue;
             }
             double energy = 0.;
-            for (std::size_t idx : group) {
-                energy += (*hits)[idx].getEnergy();
+            for (auto it = group_begin; it != group_end; ++it) {
+                energy += (*hits)[*it].getEnergy();
             }
             if (energy < minClusterEdep) {
                 continue;
             }
             auto pcl = proto->create();
-            for (std::size_t idx : group) {
-                pcl.addToHits((*hits)[idx]);
+            for (auto it = group_begin; it != group_end; ++it) {
+                pcl.addToHits((*hits)[*it]);
                 pcl.addToWeights(1);
             }
         }
@@ -166,6 +178,140 @@ namespace eicrecon {
 
   private:
 
+    // hits binned on a grid, as (bin key, hit index) pairs sorted by key
+    using HitGrid = std::vector<std::pair<std::uint64_t, std::size_t>>;
+
+    struct HitIndex {
+        // same sector and layer, binned in local (x, y)
+        HitGrid local;
+        // same sector and layer, binned in the coordinates compared between layers
+        HitGrid layer;
+        // all sectors, binned in global (x, y, z)
+        HitGrid sector;
+        std::vector<std::array<double, 2>> layer_coordinates;
+        bool multiple_sectors{false};
+    };
+
+    // bin sizes follow the clustering distances, so that neighbours are
+    // found in the bins adjacent to the bin of a hit
+    static double bin_size(double dist) {
+        return std::max(dist, 1e-6);
+    }
+
+    static std::int64_t bin_index(double x, double size) {
+        double bin = std::floor(x / size);
+        // keep non-finite coordinates (e.g. eta along the beam axis) in a valid bin
+        return std::isfinite(bin) ? static_cast<std::int64_t>(std::clamp(bin, -1e15, 1e15)) : 0;
+    }
+
+    // wrapping of the fields only adds candidates, which are then rejected by is_neighbour()
+    static std::uint64_t bin_key(std::int64_t sector, std::int64_t layer, std::int64_t ix, std::int64_t iy) {
+        return ((static_cast<std::uint64_t>(sector) & 0xfff) << 52) | ((static_cast<std::uint64_t>(layer) & 0xfff) << 40)
+             | ((static_cast<std::uint64_t>(ix) & 0xfffff) << 20) | (static_cast<std::uint64_t>(iy) & 0xfffff);
+    }
+
+    static std::uint64_t bin_key(std::int64_t ix, std::int64_t iy, std::int64_t iz) {
+        return ((static_cast<std::uint64_t>(ix) & 0x1fffff) << 42) | ((static_cast<std::uint64_t>(iy) & 0x1fffff) << 21)
+             | (static_cast<std::uint64_t>(iz) & 0x1fffff);
+    }
+
+    std::array<double, 2> layer_coordinates(const edm4eic::CalorimeterHit& hit) const {
+        if (m_cfg.layerMode == eicrecon::ImagingTopoClusterConfig::ELayerMode::etaphi) {
+            return {edm4hep::utils::eta(hit.getPosition()), edm4hep::utils::angleAzimuthal(hit.getPosition())};
+        }
+        return {hit.getPosition().x, hit.getPosition().y};
+    }
+
+    const double* layer_dist() const {
+        return (m_cfg.layerMode == eicrecon::ImagingTopoClusterConfig::ELayerMode::etaphi) ? layerDistEtaPhi : layerDistXY;
+    }
+
+    HitIndex build_index(const edm4eic::CalorimeterHitCollection &hits) const {
+        HitIndex index;
+        index.layer_coordinates.resize(hits.size());
+        const double* layer_d = layer_dist();
+        for (std::size_t idx = 0; idx < hits.size(); ++idx) {
+            const auto& hit = hits[idx];
+            // not a qualified hit to participate clustering, never a neighbour
+            if (hit.getEnergy() < m_cfg.minClusterHitEdep) {
+                continue;
+            }
+            const auto& coords = index.layer_coordinates[idx] = layer_coordinates(hit);
+            index.local.emplace_back(bin_key(hit.getSector(), hit.getLayer(),
+                                             bin_index(hit.getLocal().x, bin_size(localDistXY[0])),
+                                             bin_index(hit.getLocal().y, bin_size(localDistXY[1]))), idx);
+            index.layer.emplace_back(bin_key(hit.getSector(), hit.getLayer(),
+                                             bin_index(coords[0], bin_size(layer_d[0])),
+                                             bin_index(coords[1], bin_size(layer_d[1]))), idx);
+            index.sector.emplace_back(bin_key(bin_index(hit.getPosition().x, bin_size(sectorDist)),
+                                              bin_index(hit.getPosition().y, bin_size(sectorDist)),
+                                              bin_index(hit.getPosition().z, bin_size(sectorDist))), idx);
+            index.multiple_sectors |= (hit.getSector() != hits[index.local.front().second].getSector());
+        }
+        for (HitGrid* grid : {&index.local, &index.layer, &index.sector}) {
+            std::sort(grid->begin(), grid->end());
+        }
+        return index;
+    }
+
+    // calls f for every hit in the bin
+    template <typename F>
+    static void for_each_in_bin(const HitGrid& grid, std::uint64_t key, F&& f) {
+        auto it = std::lower_bound(grid.begin(), grid.end(), key,
+                                   [](const auto& entry, std::uint64_t k) { return entry.first < k; });
+        for (; it != grid.end() && it->first == key; ++it) {
+            f(it->second);
+        }
+    }
+
+    // calls f for every hit in the bins that can contain neighbours of the hit
+    template <typename F>
+    void for_each_candidate(const edm4eic::CalorimeterHitCollection &hits, const HitIndex& index, std::size_t idx, F&& f) const {
+        const auto& hit = hits[idx];
+
+        // same layer, local positions
+        for (auto ix = bin_index(hit.getLocal().x - localDistXY[0], bin_size(localDistXY[0]));
+             ix <= bin_index(hit.getLocal().x + localDistXY[0], bin_size(localDistXY[0])); ++ix) {
+            for (auto iy = bin_index(hit.getLocal().y - localDistXY[1], bin_size(localDistXY[1]));
+                 iy <= bin_index(hit.getLocal().y + localDistXY[1], bin_size(localDistXY[1])); ++iy) {
+                for_each_in_bin(index.local, bin_key(hit.getSector(), hit.getLayer(), ix, iy), f);
+            }
+        }
+
+        // neighbour layers
+        const double* layer_d = layer_dist();
+        const auto& coords = index.layer_coordinates[idx];
+        for (int ldiff = -m_cfg.neighbourLayersRange; ldiff <= m_cfg.neighbourLayersRange; ++ldiff) {
+            if (ldiff == 0) {
+                continue;
+            }
+            for (auto ix = bin_index(coords[0] - layer_d[0], bin_size(layer_d[0]));
+                 ix <= bin_index(coords[0] + layer_d[0], bin_size(layer_d[0])); ++ix) {
+                for (auto iy = bin_index(coords[1] - layer_d[1], bin_size(layer_d[1]));
+                     iy <= bin_index(coords[1] + layer_d[1], bin_size(layer_d[1])); ++iy) {
+                    for_each_in_bin(index.layer, bin_key(hit.getSector(), hit.getLayer() + ldiff, ix, iy), f);
+                }
+            }
+        }
+
+        // different sectors, global positions
+        if (!index.multiple_sectors) {
+            return;
+        }
+        const double size = bin_size(sectorDist);
+        for (auto ix = bin_index(hit.getPosition().x - sectorDist, size); ix <= bin_index(hit.getPosition().x + sectorDist, size); ++ix) {
+            for (auto iy = bin_index(hit.getPosition().y - sectorDist, size); iy <= bin_index(hit.getPosition().y + sectorDist, size); ++iy) {
+                for (auto iz = bin_index(hit.getPosition().z - sectorDist, size); iz <= bin_index(hit.getPosition().z + sectorDist, size); ++iz) {
+                    for_each_in_bin(index.sector, bin_key(ix, iy, iz), [&](std::size_t idx2) {
+                        if (hits[idx2].getSector() != hit.getSector()) {
+                            f(idx2);
+                        }
+                    });
+                }
+            }
+        }
+    }
+
     // helper function to group hits
     bool is_neighbour(const edm4eic::CalorimeterHit& h1, const edm4eic::CalorimeterHit& h2) const {
         // different sectors, simple distance check
@@ -196,8 +342,8 @@ namespace eicrecon {
         return false;
     }
 
-    // grouping function with Breadth-First Search
-    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, std::set<std::size_t> &group, std::size_t idx, std::vector<bool> &visits) const {
+    // grouping function with Breadth-First Search, appends the group to group_hits in increasing hit order
+    void bfs_group(const edm4eic::CalorimeterHitCollection &hits, const HitIndex& index, std::vector<std::size_t> &group_hits, std::size_t idx, std::vector<bool> &visits) const {
       visits[idx] = true;
 
       // not a qualified hit to participate clustering, stop here
@@ -205,26 +351,23 @@ namespace eicrecon {
         return;
       }
 
-      group.insert(idx);
-      size_t prev_size = 0;
-
-      while (prev_size != group.size()) {
-        prev_size = group.size();
-        for (std::size_t idx1 : group) {
-          // check neighbours
-          for (std::size_t idx2 = 0; idx2 < hits.size(); ++idx2) {
-            // not a qualified hit to participate clustering, skip
-            if (hits[idx2].getEnergy() < m_cfg.minClusterHitEdep) {
-              continue;
-            }
-            if ((!visits[idx2])
-                && is_neighbour(hits[idx1], hits[idx2])) {
-              group.insert(idx2);
-              visits[idx2] = true;
-            }
+      const std::size_t group_begin = group_hits.size();
+      group_hits.push_back(idx);
+
+      // the hits appended to the group are the queue of the search
+      for (std::size_t queue_idx = group_begin; queue_idx < group_hits.size(); ++queue_idx) {
+        const std::size_t idx1 = group_hits[queue_idx];
+        // check neighbours, the index only holds hits qualified to participate clustering
+        for_each_candidate(hits, index, idx1, [&](std::size_t idx2) {
+          if ((!visits[idx2])
+              && is_neighbour(hits[idx1], hits[idx2])) {
+            group_hits.push_back(idx2);
+            visits[idx2] = true;
           }
-        }
+        });
       }
+
+      std::sort(group_hits.begin() + group_begin, group_hits.end());
     }
   };
 
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <gsl/pointers>
 #include <iterator>
+#include <string>
 
 #include "algorithms/digi/PhotoMultiplierHitDigiConfig.h"
 
@@ -38,27 +39,9 @@ void PhotoMultiplierHitDigi::init()
     // print the configuration parameters
     debug() << m_cfg << endmsg;
 
-    /* warn if using potentially thread-unsafe seed
-     * FIXME: remove this warning when this issue is resolved:
-     *        https://github.com/eic/EICrecon/issues/539
-     */
-    if(m_cfg.seed==0) warning("using seed=0 may cause thread-unsafe behavior of TRandom (EICrecon issue 539)");
-
-    // random number generators
-    m_random.SetSeed(m_cfg.seed);
-    m_rngNorm = [&](){
-        return m_random.Gaus(0., 1.0);
-    };
-    m_rngUni = [&](){
-        return m_random.Uniform(0., 1.0);
-    };
-    //auto randSvc = svc<IRndmGenSvc>("RndmGenSvc", true);
-    auto sc1 = m_rngUni;//m_rngUni.initialize(randSvc, Rndm::Flat(0., 1.));
-    auto sc2 = m_rngNorm;//m_rngNorm.initialize(randSvc, Rndm::Gauss(0., 1.));
-    //if (!sc1.isSuccess() || !sc2.isSuccess()) {
-    if (!sc1 || !sc2) {
-        throw std::runtime_error("Cannot initialize random generator!");
-    }
+    // random number streams, keyed by the algorithm name and the seed
+    m_rng_key       = algorithms::RandomStreamSvc::key(name(), m_cfg.seed);
+    m_noise_rng_key = algorithms::RandomStreamSvc::key(std::string(name()) + ":noise", m_cfg.seed);
 
     // initialize quantum efficiency table
     qe_init();
@@ -85,12 +68,13 @@ void PhotoMultiplierHitDigi::process(
             auto edep_eV = sim_hit.getEDep() * 1e9; // [GeV] -> [eV] // FIXME: use common unit converters, when available
             auto id      = sim_hit.getCellID();
             trace("hit: pixel id={:#018X}  edep = {} eV", id, edep_eV);
+            auto rng     = m_random_svc.stream(m_rng_key, id, sim_hit_index);
 
             // overall safety factor
-            if (m_rngUni() > m_cfg.safetyFactor) continue;
+            if (rng.uniform() > m_cfg.safetyFactor) continue;
 
             // quantum efficiency
-            if (!qe_pass(edep_eV, m_rngUni())) continue;
+            if (!qe_pass(edep_eV, rng.uniform())) continue;
 
             // pixel gap cuts
             if(m_cfg.enablePixelGaps) {
@@ -103,7 +87,7 @@ void PhotoMultiplierHitDigi::process(
             trace(" -> hit accepted");
             trace(" -> MC hit id={}", sim_hit.getObjectID().index);
             auto   time = sim_hit.getTime();
-            double amp  = m_cfg.speMean + m_rngNorm() * m_cfg.speError;
+            double amp  = m_cfg.speMean + rng.gaussian() * m_cfg.speError;
 
             // insert hit to `hit_groups`
             InsertHit(
@@ -111,7 +95,8 @@ void PhotoMultiplierHitDigi::process(
                 id,
                 amp,
                 time,
-                sim_hit_index
+                sim_hit_index,
+                rng
                 );
         }
 
@@ -130,12 +115,12 @@ void PhotoMultiplierHitDigi::process(
         if (m_cfg.enableNoise) {
           trace("{:=^70}"," BEGIN NOISE INJECTION ");
           float p = m_cfg.noiseRate*m_cfg.noiseTimeWindow;
-          auto cellID_action = [this,&hit_groups] (auto id) {
+          auto rng = m_random_svc.stream(m_noise_rng_key, 0);
+          auto cellID_action = [this,&hit_groups,&rng] (auto id) {
 
             // cell time, signal amplitude
-            double   amp  = m_cfg.speMean + m_rngNorm()*m_cfg.speError;
-            TimeType time = m_cfg.noiseTimeWindow*m_rngUni() / dd4hep::ns;
-            dd4hep::Position pos_hit_global = m_converter->position(id);
+            double   amp  = m_cfg.speMean + rng.gaussian()*m_cfg.speError;
+            TimeType time = m_cfg.noiseTimeWindow*rng.uniform() / dd4hep::ns;
 
             // insert in `hit_groups`, or if the pixel already has a hit, update `npe` and `signal`
             this->InsertHit(
@@ -144,11 +129,12 @@ void PhotoMultiplierHitDigi::process(
                 amp,
                 time,
                 0, // not used
+                rng,
                 true
                 );
 
           };
-          m_VisitRngCellIDs(cellID_action, p);
+          m_VisitRngCellIDs(cellID_action, p, rng);
         }
 
         // build output `RawTrackerHit` and `MCRecoTrackerHitAssociation` collections
@@ -276,6 +262,7 @@ void PhotoMultiplierHitDigi::InsertHit(
     double           amp,
     TimeType         time,
     std::size_t      sim_hit_index,
+    algorithms::RandomStream& rng,
     bool             is_noise_hit
     ) const // NOLINTEND(bugprone-easily-swappable-parameters)
 {
@@ -294,7 +281,7 @@ void PhotoMultiplierHitDigi::InsertHit(
     }
     // no hits group found
     if (i >= it->second.size()) {
-      auto sig = amp + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
+      auto sig = amp + m_cfg.pedMean + m_cfg.pedError * rng.gaussian();
       decltype(HitData::sim_hit_indices) indices;
       if(!is_noise_hit) indices.push_back(sim_hit_index);
       hit_groups.insert({ id, {HitData{1, sig, time, indices}} });
@@ -302,7 +289,7 @@ void PhotoMultiplierHitDigi::InsertHit(
       trace("    so new group @ {:#018X}: signal={}", id, sig);
     }
   } else {
-    auto sig = amp + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
+    auto sig = amp + m_cfg.pedMean + m_cfg.pedError * rng.gaussian();
     decltype(HitData::sim_hit_indices) indices;
     if(!is_noise_hit) indices.push_back(sim_hit_index);
     hit_groups.insert({ id, {HitData{1, sig, time, indices}} });
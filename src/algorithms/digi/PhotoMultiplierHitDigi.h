@@ -20,7 +20,6 @@
 #include <DDRec/CellIDPositionConverter.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
-#include <TRandomGen.h>
 #include <algorithms/algorithm.h>
 #include <algorithms/geo.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
@@ -38,6 +37,7 @@
 #include <vector>
 
 #include "PhotoMultiplierHitDigiConfig.h"
+#include "algorithms/interfaces/RandomStreamSvc.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
@@ -79,17 +79,12 @@ namespace eicrecon {
       std::vector<std::size_t> sim_hit_indices;
     };
 
-    // random number generators
-    TRandomMixMax m_random;
-    std::function<double()> m_rngNorm;
-    std::function<double()> m_rngUni;
-    //Rndm::Numbers m_rngUni, m_rngNorm;
-
     // set `m_VisitAllRngPixels`, a visitor to run an action (type
-    // `function<void(cellID)>`) on a selection of random CellIDs; must be
-    // defined externally, since this would be detector-specific
+    // `function<void(cellID)>`) on a selection of random CellIDs, drawn from
+    // the given random stream; must be defined externally, since this would
+    // be detector-specific
     void SetVisitRngCellIDs(
-        std::function< void(std::function<void(CellIDType)>, float) > visitor
+        std::function< void(std::function<void(CellIDType)>, float, algorithms::RandomStream&) > visitor
         )
     { m_VisitRngCellIDs = visitor; }
 
@@ -104,8 +99,8 @@ namespace eicrecon {
 protected:
 
     // visitor of all possible CellIDs (set with SetVisitRngCellIDs)
-    std::function< void(std::function<void(CellIDType)>, float) > m_VisitRngCellIDs =
-      [] ( std::function<void(CellIDType)> visitor_action, float p ) { /* default no-op */ };
+    std::function< void(std::function<void(CellIDType)>, float, algorithms::RandomStream&) > m_VisitRngCellIDs =
+      [] ( std::function<void(CellIDType)> visitor_action, float p, algorithms::RandomStream& rng ) { /* default no-op */ };
 
     // pixel gap mask
     std::function< bool(CellIDType, dd4hep::Position) > m_PixelGapMask =
@@ -123,14 +118,17 @@ private:
         double           amp,
         TimeType         time,
         std::size_t      sim_hit_index,
+        algorithms::RandomStream& rng,
         bool             is_noise_hit = false
         ) const;
 
     const dd4hep::Detector* m_detector{algorithms::GeoSvc::instance().detector()};
     const dd4hep::rec::CellIDPositionConverter* m_converter{algorithms::GeoSvc::instance().cellIDPositionConverter()};
 
-    // std::default_random_engine generator; // TODO: need something more appropriate here
-    // std::normal_distribution<double> m_normDist; // defaults to mean=0, sigma=1
+    // random number generation: one stream per sim hit, and one for the noise of each event
+    const algorithms::RandomStreamSvc& m_random_svc{algorithms::RandomStreamSvc::instance()};
+    uint64_t m_rng_key{0};
+    uint64_t m_noise_rng_key{0};
 
     std::vector<std::pair<double, double>> qeff;
     void qe_init();
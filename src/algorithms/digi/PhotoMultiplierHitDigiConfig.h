@@ -9,12 +9,8 @@ namespace eicrecon {
   class PhotoMultiplierHitDigiConfig {
     public:
 
-      // random number generator seed
-      /* FIXME: don't use 0 if `TRandomMixMax` is the RNG, it can get "stuck"
-       * FIXME: remove this warning when this issue is resolved:
-       *        https://github.com/eic/EICrecon/issues/539
-       */
-      unsigned long seed = 1; // seed for RNG (note: `0` might mean "unique" seed)
+      // random number generator seed, combined with the global seed of the random streams
+      unsigned long seed = 1;
 
       // triggering
       double hitTimeWindow  = 20.0;   // time gate in which 2 input hits will be grouped to 1 output hit // [ns]
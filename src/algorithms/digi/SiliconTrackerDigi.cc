@@ -11,21 +11,19 @@
 #include <fmt/core.h>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <gsl/pointers>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "algorithms/digi/SiliconTrackerDigiConfig.h"
 
 namespace eicrecon {
 
 void SiliconTrackerDigi::init() {
-    // Create random gauss function
-    m_gauss = [&](){
-        return m_random.Gaus(0, m_cfg.timeResolution);
-        //return m_rng.gaussian<double>(0., m_cfg.timeResolution);
-    };
+    m_rng_key = algorithms::RandomStreamSvc::key(name());
 }
 
 
@@ -36,14 +34,22 @@ void SiliconTrackerDigi::process(
     const auto [sim_hits] = input;
     auto [raw_hits,associations] = output;
 
-    // A map of unique cellIDs with temporary structure RawHit
-    std::unordered_map<std::uint64_t, edm4eic::MutableRawTrackerHit> cell_hit_map;
-
+    // Per-thread scratch space, reused across events to avoid reallocation.
+    // The map holds the index of the raw hit for each cell, and hit_sim_hits
+    // the indices of the sim hits contributing to each raw hit.
+    thread_local std::unordered_map<std::uint64_t, std::size_t> cell_hit_map;
+    thread_local std::vector<std::vector<std::size_t>> hit_sim_hits;
+    cell_hit_map.clear();
+    for (auto& indices : hit_sim_hits) {
+        indices.clear();
+    }
 
-    for (const auto& sim_hit : *sim_hits) {
+    for (std::size_t sim_hit_index = 0; sim_hit_index < sim_hits->size(); sim_hit_index++) {
+        const auto& sim_hit = (*sim_hits)[sim_hit_index];
 
         // time smearing
-        double time_smearing = m_gauss();
+        auto rng = m_random_svc.stream(m_rng_key, sim_hit.getCellID(), sim_hit_index);
+        double time_smearing = rng.gaussian(0., m_cfg.timeResolution);
         double result_time = sim_hit.getTime() + time_smearing;
         auto hit_time_stamp = (std::int32_t) (result_time * 1e3);
 
@@ -64,20 +70,20 @@ void SiliconTrackerDigi::process(
             continue;
         }
 
-        if (cell_hit_map.count(sim_hit.getCellID()) == 0) {
+        auto [it, inserted] = cell_hit_map.try_emplace(sim_hit.getCellID(), raw_hits->size());
+        if (inserted) {
             // This cell doesn't have hits
-            cell_hit_map[sim_hit.getCellID()] = {
+            raw_hits->create(
                 sim_hit.getCellID(),
                 (std::int32_t) std::llround(sim_hit.getEDep() * 1e6),
                 hit_time_stamp  // ns->ps
-            };
+            );
         } else {
             // There is previous values in the cell
-            auto& hit = cell_hit_map[sim_hit.getCellID()];
+            auto hit = (*raw_hits)[it->second];
             debug("  Hit already exists in cell ID={}, prev. hit time: {}", sim_hit.getCellID(), hit.getTimeStamp());
 
             // keep earliest time for hit
-            auto time_stamp = hit.getTimeStamp();
             hit.setTimeStamp(std::min(hit_time_stamp, hit.getTimeStamp()));
 
             // sum deposited energy
@@ -86,23 +92,31 @@ void SiliconTrackerDigi::process(
         }
     }
 
-    for (auto item : cell_hit_map) {
-        raw_hits->push_back(item.second);
+    // Every sim hit in a cell with a raw hit is associated to it, including
+    // the ones below threshold
+    if (hit_sim_hits.size() < raw_hits->size()) {
+        hit_sim_hits.resize(raw_hits->size());
+    }
+    for (std::size_t sim_hit_index = 0; sim_hit_index < sim_hits->size(); sim_hit_index++) {
+        auto it = cell_hit_map.find((*sim_hits)[sim_hit_index].getCellID());
+        if (it != cell_hit_map.end()) {
+            hit_sim_hits[it->second].push_back(sim_hit_index);
+        }
+    }
 
-        for (const auto& sim_hit : *sim_hits) {
-          if (item.first == sim_hit.getCellID()) {
+    for (std::size_t raw_hit_index = 0; raw_hit_index < raw_hits->size(); raw_hit_index++) {
+        auto raw_hit = (*raw_hits)[raw_hit_index];
+        for (std::size_t sim_hit_index : hit_sim_hits[raw_hit_index]) {
             // set association
             auto hitassoc = associations->create();
             hitassoc.setWeight(1.0);
-            hitassoc.setRawHit(item.second);
+            hitassoc.setRawHit(raw_hit);
 #if EDM4EIC_VERSION_MAJOR >= 6
-            hitassoc.setSimHit(sim_hit);
+            hitassoc.setSimHit((*sim_hits)[sim_hit_index]);
 #else
-            hitassoc.addToSimHits(sim_hit);
+            hitassoc.addToSimHits((*sim_hits)[sim_hit_index]);
 #endif
-          }
         }
-
     }
 }
 
@@ -3,16 +3,16 @@
 
 #pragma once
 
-#include <TRandomGen.h>
 #include <algorithms/algorithm.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
 #include <edm4eic/RawTrackerHitCollection.h>
 #include <edm4hep/SimTrackerHitCollection.h>
-#include <functional>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
 #include "SiliconTrackerDigiConfig.h"
+#include "algorithms/interfaces/RandomStreamSvc.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
@@ -37,15 +37,9 @@ public:
   void process(const Input&, const Output&) const final;
 
 private:
-  /** Random number generation*/
-  TRandomMixMax m_random;
-  std::function<double()> m_gauss;
-
-  // FIXME replace with standard random engine
-  // std::default_random_engine generator; // TODO: need something more appropriate here
-  // std::normal_distribution<double> m_normDist; // defaults to mean=0, sigma=1
-
-  // algorithms::Generator m_rng = algorithms::RandomSvc::instance().generator();
+  /** Random number generation: one stream per sim hit, keyed by cellID */
+  const algorithms::RandomStreamSvc& m_random_svc = algorithms::RandomStreamSvc::instance();
+  std::uint64_t m_rng_key{0};
 };
 
 } // namespace eicrecon
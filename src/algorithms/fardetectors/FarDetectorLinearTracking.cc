@@ -12,13 +12,15 @@
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <stdint.h>
+#include <Eigen/Eigenvalues>
 #include <Eigen/Geometry>
-#include <Eigen/Householder>
-#include <Eigen/Jacobi>
-#include <Eigen/QR>
-#include <Eigen/SVD>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include "FarDetectorLinearTracking.h"
 #include "algorithms/fardetectors/FarDetectorLinearTrackingConfig.h"
@@ -52,8 +54,6 @@ namespace eicrecon {
         }
 
         // Check there aren't too many hits in any layer to handle
-        // Temporary limit of number of hits per layer before Kalman filtering/GNN implemented
-        // TODO - Implement more sensible solution
         for(const auto& layerHits: inputhits){
           if((*layerHits).size()>m_cfg.layer_hits_max){
             info("Too many hits in layer");
@@ -61,65 +61,172 @@ namespace eicrecon {
           }
         }
 
-        // Create a matrix to store the hit positions
-        Eigen::MatrixXd hitMatrix(3,m_cfg.n_layer);
-        // Loop over all combinations of hits fitting a track to all layers
-        buildMatrixRecursive(m_cfg.n_layer-1,&hitMatrix,inputhits,outputTracks);
+        // Index the hits of each layer by x
+        std::vector<LayerHits> layers(m_cfg.n_layer);
+        for(int level=0; level<m_cfg.n_layer; level++){
+          auto& layer = layers[level];
+          for(auto hit : (*inputhits[level])){
+            auto pos = hit.getPosition();
+            layer.positions.emplace_back(pos.x, pos.y, pos.z);
+          }
+          layer.xOrder.resize(layer.positions.size());
+          std::iota(layer.xOrder.begin(),layer.xOrder.end(),0);
+          std::sort(layer.xOrder.begin(),layer.xOrder.end(),[&layer](std::size_t a, std::size_t b){
+            return layer.positions[a].x()<layer.positions[b].x();
+          });
+          if(!layer.positions.empty()){
+            auto [zMin,zMax] = std::minmax_element(layer.positions.begin(),layer.positions.end(),[](const auto& a, const auto& b){
+              return a.z()<b.z();
+            });
+            layer.zMin = zMin->z();
+            layer.zMax = zMax->z();
+          }
+        }
+
+        std::vector<Eigen::Vector3d> trackHits(m_cfg.n_layer);
+        std::vector<std::vector<std::size_t>> candidates(m_cfg.n_layer);
+
+        // Seed from each hit in the outermost layer. Inner hits of a seed pair must lie
+        // within the step angle tolerance of the optimum direction, which bounds their
+        // distance from the line along the optimum direction.
+        int outer = m_cfg.n_layer-1;
+        const double sinTolerance = std::sin(std::min<double>(m_cfg.step_angle_tolerance,M_PI/2));
+        for(const auto& outerHit : layers[outer].positions){
+          trackHits[outer] = outerHit;
+          if(outer==0){
+            Eigen::Vector3d anchor, direction;
+            double residuals = fitLine(trackHits,0,anchor,direction);
+            if(residuals/(2*m_cfg.n_layer)<=m_cfg.chi2_max){
+              writeTrack(anchor,direction,outputTracks);
+            }
+            continue;
+          }
+          double window = std::numeric_limits<double>::infinity();
+          if(m_cfg.restrict_direction && std::abs(m_optimumDirection.z())>sinTolerance){
+            double maxDz = std::max(std::abs(outerHit.z()-layers[outer-1].zMin),std::abs(outerHit.z()-layers[outer-1].zMax));
+            window = sinTolerance*maxDz/(std::abs(m_optimumDirection.z())-sinTolerance);
+          }
+          searchRoad(outer-1,outerHit,m_optimumDirection,window,layers,trackHits,candidates,outputTracks);
+        }
 
     }
 
 
-    void FarDetectorLinearTracking::buildMatrixRecursive(int level,
-                                                        Eigen::MatrixXd* hitMatrix,
-                                                        const std::vector<gsl::not_null<const edm4hep::TrackerHitCollection*>>& hits,
-                                                        gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks ) const {
+    void FarDetectorLinearTracking::searchRoad(int level,
+                                               const Eigen::Vector3d& anchor,
+                                               const Eigen::Vector3d& direction,
+                                               double window,
+                                               const std::vector<LayerHits>& layers,
+                                               std::vector<Eigen::Vector3d>& trackHits,
+                                               std::vector<std::vector<std::size_t>>& candidates,
+                                               gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks ) const {
+
+      // Hits of this layer within the window around the extrapolated line, in input order
+      findCandidates(layers[level],anchor,direction,window,candidates[level]);
 
-      // Iterate over hits in this layer
-      for(auto hit : (*hits[level])){
-        auto pos = hit.getPosition();
-        hitMatrix->col(level) << pos.x, pos.y, pos.z;
+      for(std::size_t index : candidates[level]){
+        trackHits[level] = layers[level].positions[index];
 
         // Check the last two hits are within a certain angle of the optimum direction
-        if(m_cfg.restrict_direction && level<m_cfg.n_layer-1){
-          if(!checkHitPair(hitMatrix->col(level),hitMatrix->col(level+1))){
+        if(m_cfg.restrict_direction){
+          if(!checkHitPair(trackHits[level],trackHits[level+1])){
             continue;
           }
         }
 
+        // Adding hits never decreases the residuals, so the chi2 cut applies to partial tracks
+        Eigen::Vector3d trackAnchor, trackDirection;
+        double residuals = fitLine(trackHits,level,trackAnchor,trackDirection);
+        if(residuals/(2*m_cfg.n_layer)>m_cfg.chi2_max){
+          continue;
+        }
+
         if(level>0){
-          buildMatrixRecursive(level-1,
-                               hitMatrix,
-                               hits,
-                               outputTracks);
+          searchRoad(level-1,trackAnchor,trackDirection,m_cfg.road_window,layers,trackHits,candidates,outputTracks);
         }
         else{
-          checkHitCombination(hitMatrix,outputTracks);
+          writeTrack(trackAnchor,trackDirection,outputTracks);
+        }
+      }
+
+    }
+
+
+    void FarDetectorLinearTracking::findCandidates(const LayerHits& layer,
+                                                   const Eigen::Vector3d& anchor,
+                                                   const Eigen::Vector3d& direction,
+                                                   double window,
+                                                   std::vector<std::size_t>& candidates) const {
+
+      candidates.clear();
+
+      // Range in x of the line over the layer, extended by the window
+      double xLow  = -std::numeric_limits<double>::infinity();
+      double xHigh = std::numeric_limits<double>::infinity();
+      if(std::isfinite(window) && std::abs(direction.z())>1e-9){
+        double slope = direction.x()/direction.z();
+        double x1 = anchor.x()+(layer.zMin-window-anchor.z())*slope;
+        double x2 = anchor.x()+(layer.zMax+window-anchor.z())*slope;
+        xLow  = std::min(x1,x2)-window;
+        xHigh = std::max(x1,x2)+window;
+      }
+
+      auto it = std::lower_bound(layer.xOrder.begin(),layer.xOrder.end(),xLow,[&layer](std::size_t index, double x){
+        return layer.positions[index].x()<x;
+      });
+      for(; it!=layer.xOrder.end() && layer.positions[*it].x()<=xHigh; ++it){
+        // Distance of the hit from the line
+        if(std::isfinite(window) && (layer.positions[*it]-anchor).cross(direction).norm()>window){
+          continue;
         }
+        candidates.push_back(*it);
       }
+      std::sort(candidates.begin(),candidates.end());
 
     }
 
 
-    void FarDetectorLinearTracking::checkHitCombination(Eigen::MatrixXd* hitMatrix,
-                                                        gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks ) const {
+    double FarDetectorLinearTracking::fitLine(const std::vector<Eigen::Vector3d>& trackHits,
+                                              int firstLayer,
+                                              Eigen::Vector3d& anchor,
+                                              Eigen::Vector3d& direction) const {
+
+      int nHits = m_cfg.n_layer-firstLayer;
+      double weightSum = 0;
+      anchor.setZero();
+      for(int level=firstLayer; level<m_cfg.n_layer; level++){
+        anchor += trackHits[level]*m_layerWeights[level];
+        weightSum += m_layerWeights[level];
+      }
+      anchor /= weightSum;
 
-      Eigen::Vector3d weightedAnchor = (*hitMatrix)*m_layerWeights/(m_layerWeights.sum());
+      if(nHits==2){
+        direction = (trackHits[firstLayer+1]-trackHits[firstLayer]).normalized();
+        return 0;
+      }
 
-      auto localMatrix = (*hitMatrix).colwise()-weightedAnchor;
+      // The principal axis of the hits is the eigenvector of the scatter matrix with the
+      // largest eigenvalue, the other eigenvalues are the sums of squared residuals
+      Eigen::Matrix3d scatter = Eigen::Matrix3d::Zero();
+      for(int level=firstLayer; level<m_cfg.n_layer; level++){
+        Eigen::Vector3d local = trackHits[level]-anchor;
+        scatter.selfadjointView<Eigen::Lower>().rankUpdate(local);
+      }
+      Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+      solver.computeDirect(scatter.selfadjointView<Eigen::Lower>());
 
-      Eigen::BDCSVD<Eigen::MatrixXd> svd(localMatrix.transpose(), Eigen::ComputeThinU | Eigen::ComputeThinV);
+      direction = solver.eigenvectors().col(2);
+      return std::max(0.,solver.eigenvalues()(0)+solver.eigenvalues()(1));
 
-      auto V = svd.matrixV();
+    }
 
-      // Rotate into principle components and calculate chi2/ndf
-      auto rotatedMatrix = localMatrix.transpose()*V;
-      auto residuals     = rotatedMatrix.rightCols(2);
-      double chi2        = (residuals.array()*residuals.array()).sum()/(2*m_cfg.n_layer);
 
-      if(chi2>m_cfg.chi2_max) return;
+    void FarDetectorLinearTracking::writeTrack(const Eigen::Vector3d& anchor,
+                                               const Eigen::Vector3d& direction,
+                                               gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks ) const {
 
-      edm4hep::Vector3d outPos = weightedAnchor.data();
-      edm4hep::Vector3d outVec = V.col(0).data();
+      edm4hep::Vector3d outPos = anchor.data();
+      edm4hep::Vector3d outVec = direction.data();
 
       // Make sure fit was pointing in the right direction
       if(outVec.z>0) outVec = outVec*-1;
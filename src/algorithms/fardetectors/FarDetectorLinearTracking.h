@@ -9,6 +9,7 @@
 #include <edm4eic/TrackSegmentCollection.h>
 #include <edm4hep/TrackerHitCollection.h>
 #include <gsl/pointers>
+#include <cstddef>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -42,13 +43,29 @@ private:
 
   Eigen::Vector3d m_optimumDirection;
 
-  void
-  buildMatrixRecursive(int level, Eigen::MatrixXd* hitMatrix,
-                       const std::vector<gsl::not_null<const edm4hep::TrackerHitCollection*>>& hits,
-                       gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
+  /** Hit positions of a layer, indexed by x for road lookups **/
+  struct LayerHits {
+    std::vector<Eigen::Vector3d> positions;
+    std::vector<std::size_t> xOrder;
+    double zMin{0};
+    double zMax{0};
+  };
 
-  void checkHitCombination(Eigen::MatrixXd* hitMatrix,
-                           gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
+  void searchRoad(int level, const Eigen::Vector3d& anchor, const Eigen::Vector3d& direction,
+                  double window, const std::vector<LayerHits>& layers,
+                  std::vector<Eigen::Vector3d>& trackHits,
+                  std::vector<std::vector<std::size_t>>& candidates,
+                  gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
+
+  void findCandidates(const LayerHits& layer, const Eigen::Vector3d& anchor,
+                      const Eigen::Vector3d& direction, double window,
+                      std::vector<std::size_t>& candidates) const;
+
+  double fitLine(const std::vector<Eigen::Vector3d>& trackHits, int firstLayer,
+                 Eigen::Vector3d& anchor, Eigen::Vector3d& direction) const;
+
+  void writeTrack(const Eigen::Vector3d& anchor, const Eigen::Vector3d& direction,
+                  gsl::not_null<edm4eic::TrackSegmentCollection*> outputTracks) const;
 
   bool checkHitPair(const Eigen::Vector3d& hit1, const Eigen::Vector3d& hit2) const;
 };
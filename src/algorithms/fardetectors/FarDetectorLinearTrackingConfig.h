@@ -6,10 +6,13 @@
 namespace eicrecon {
   struct FarDetectorLinearTrackingConfig {
 
-    int   layer_hits_max{10};
+    int   layer_hits_max{100};
     float chi2_max{0.001};
     int   n_layer{4};
 
+    // Maximum distance [mm] of a hit from the line fitted to the hits already on the track
+    float road_window{1.0};
+
     // Restrict hit direction
     bool  restrict_direction{true};
     float optimum_theta{0.026};
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 // Copyright (C) 2024, Simon Gardner
 
-#include <TMVA/IMethod.h>
+#include <Eigen/Core>
 #include <edm4eic/Cov6f.h>
 #include <edm4eic/vector_utils.h>
 #include <edm4hep/Vector2f.h>
@@ -9,9 +9,11 @@
 #include <edm4hep/utils/vector_utils.h>
 #include <fmt/core.h>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <gsl/pointers>
+#include <string>
 #include <vector>
 
 #include "FarDetectorMLReconstruction.h"
@@ -22,20 +24,25 @@ namespace eicrecon {
 
   void FarDetectorMLReconstruction::init() {
 
-    m_reader = new TMVA::Reader( "!Color:!Silent" );
-    // Create a set of variables and declare them to the reader
-    // - the variable names MUST corresponds in name and type to those given in the weight file(s) used
-    m_reader->AddVariable( "LowQ2Tracks[0].loc.a", &nnInput[FarDetectorMLNNIndexIn::PosY] );
-    m_reader->AddVariable( "LowQ2Tracks[0].loc.b", &nnInput[FarDetectorMLNNIndexIn::PosZ] );
-    m_reader->AddVariable( "sin(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)", &nnInput[FarDetectorMLNNIndexIn::DirX] );
-    m_reader->AddVariable( "cos(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)", &nnInput[FarDetectorMLNNIndexIn::DirY] );
+    // The network is evaluated natively, so it is shared between threads
+    // The variables MUST correspond in name and order to those in the weight file
+    const std::vector<std::string> variables{
+      "LowQ2Tracks[0].loc.a",
+      "LowQ2Tracks[0].loc.b",
+      "sin(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)",
+      "cos(LowQ2Tracks[0].phi)*sin(LowQ2Tracks[0].theta)",
+    };
 
     // Locate and load the weight file
     // TODO - Add functionality to select passed by configuration
-    bool methodFound = false;
     if(!m_cfg.modelPath.empty()){
       try{
-        m_method = dynamic_cast<TMVA::MethodBase*>(m_reader->BookMVA( m_cfg.methodName, m_cfg.modelPath ));
+        auto network = TMVADenseNetwork::load(m_cfg.modelPath);
+        if (network->variables() != variables || network->targets().size() <= FarDetectorMLNNIndexOut::MomZ) {
+          error("Method {} in file {} does not use the expected variables and targets", m_cfg.methodName, m_cfg.modelPath);
+        } else {
+          m_network = network;
+        }
       }
       catch(std::exception &e){
         error(fmt::format("Failed to load method {} from file {}: {}", m_cfg.methodName, m_cfg.modelPath, e.what()));
@@ -71,18 +78,30 @@ namespace eicrecon {
     std::int32_t type   = 0; // Check?
     float        charge = -1;
 
-    for(const auto& track: *inputTracks){
+    if (m_network == nullptr) {
+      debug("skipping because no network is loaded");
+      return;
+    }
+
+    // Evaluate all tracks of the event together
+    TMVADenseNetwork::Matrix nnInput(inputTracks->size(), 4);
+    for(std::size_t i = 0; i < inputTracks->size(); i++){
 
+      auto track      = (*inputTracks)[i];
       auto pos        = track.getLoc();
       auto trackphi   = track.getPhi();
       auto tracktheta = track.getTheta();
 
-      nnInput[FarDetectorMLNNIndexIn::PosY] = pos.a;
-      nnInput[FarDetectorMLNNIndexIn::PosZ] = pos.b;
-      nnInput[FarDetectorMLNNIndexIn::DirX] = sin(trackphi)*sin(tracktheta);
-      nnInput[FarDetectorMLNNIndexIn::DirY] = cos(trackphi)*sin(tracktheta);
+      nnInput(i, FarDetectorMLNNIndexIn::PosY) = pos.a;
+      nnInput(i, FarDetectorMLNNIndexIn::PosZ) = pos.b;
+      nnInput(i, FarDetectorMLNNIndexIn::DirX) = sin(trackphi)*sin(tracktheta);
+      nnInput(i, FarDetectorMLNNIndexIn::DirY) = cos(trackphi)*sin(tracktheta);
+    }
+    TMVADenseNetwork::Matrix nnOutput = m_network->evaluate(nnInput);
+
+    for(std::size_t i = 0; i < inputTracks->size(); i++){
 
-      auto values = m_method->GetRegressionValues();
+      Eigen::RowVectorXf values = nnOutput.row(i).cast<float>();
 
       edm4hep::Vector3f momentum = {values[FarDetectorMLNNIndexOut::MomX],values[FarDetectorMLNNIndexOut::MomY],values[FarDetectorMLNNIndexOut::MomZ]};
 
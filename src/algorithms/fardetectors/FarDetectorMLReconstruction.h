@@ -3,19 +3,19 @@
 
 #pragma once
 
-#include <TMVA/MethodBase.h>
-#include <TMVA/Reader.h>
 #include <algorithms/algorithm.h>
 #include <edm4eic/TrackCollection.h>
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4eic/TrajectoryCollection.h>
 // Event Model related classes
 #include <edm4hep/MCParticleCollection.h>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 
 #include "FarDetectorMLReconstructionConfig.h"
+#include "TMVADenseNetwork.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 namespace eicrecon {
@@ -56,11 +56,9 @@ namespace eicrecon {
       //----- Define constants here ------
 
   private:
-      TMVA::Reader*     m_reader{nullptr};
-      TMVA::MethodBase* m_method{nullptr};
+      std::shared_ptr<const TMVADenseNetwork> m_network;
       float m_beamE{10.0};
       std::once_flag m_initBeamE;
-      float nnInput[4]  = {0.0,0.0,0.0,0.0};
 
   };
 
@@ -18,6 +18,14 @@
 #include <fmt/core.h>
 #include <gsl/pointers>
 #include <sys/types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
 
 #include "algorithms/fardetectors/FarDetectorTrackerCluster.h"
 #include "algorithms/fardetectors/FarDetectorTrackerClusterConfig.h"
@@ -77,61 +85,100 @@ FarDetectorTrackerCluster::ClusterHits(const edm4eic::RawTrackerHitCollection& i
 
   std::vector<FDTrackerCluster> clusters;
 
-  ROOT::VecOps::RVec<unsigned long> id;
-  ROOT::VecOps::RVec<int> x;
-  ROOT::VecOps::RVec<int> y;
-  ROOT::VecOps::RVec<float> e;
-  ROOT::VecOps::RVec<float> t;
+  const std::size_t nHits = inputHits.size();
+  std::vector<unsigned long> id(nHits);
+  std::vector<int> x(nHits);
+  std::vector<int> y(nHits);
+  std::vector<float> e(nHits);
+  std::vector<float> t(nHits);
 
   // Gather detector id positions
-  for (const auto& hit : inputHits) {
-    auto cellID = hit.getCellID();
-    id.push_back(cellID);
-    x.push_back(m_id_dec->get(cellID, m_x_idx));
-    y.push_back(m_id_dec->get(cellID, m_y_idx));
-    e.push_back(hit.getCharge());
-    t.push_back(hit.getTimeStamp());
+  for (std::size_t i = 0; i < nHits; i++) {
+    const auto& hit = inputHits[i];
+    auto cellID     = hit.getCellID();
+    id[i]           = cellID;
+    x[i]            = m_id_dec->get(cellID, m_x_idx);
+    y[i]            = m_id_dec->get(cellID, m_y_idx);
+    e[i]            = hit.getCharge();
+    t[i]            = hit.getTimeStamp();
   }
 
+  // Index hits by pixel, hits in the same pixel form a linked list in increasing index order
+  auto pixelKey = [](int px, int py) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(px)) << 32) |
+           static_cast<std::uint32_t>(py);
+  };
+  constexpr std::size_t noHit = std::numeric_limits<std::size_t>::max();
+  std::unordered_map<std::uint64_t, std::size_t> pixelFirstHit;
+  pixelFirstHit.reserve(nHits);
+  std::vector<std::size_t> nextInPixel(nHits, noHit);
+  for (std::size_t i = nHits; i-- > 0;) {
+    auto [it, inserted] = pixelFirstHit.try_emplace(pixelKey(x[i], y[i]), i);
+    if (!inserted) {
+      nextInPixel[i] = it->second;
+      it->second     = i;
+    }
+  }
+
+  // Seeds are taken in order of decreasing energy, the first hit in case of equal energies
+  std::vector<std::size_t> seedOrder(nHits);
+  std::iota(seedOrder.begin(), seedOrder.end(), 0);
+  std::stable_sort(seedOrder.begin(), seedOrder.end(),
+                   [&e](std::size_t a, std::size_t b) { return e[a] > e[b]; });
+
   // Set up clustering variables
-  ROOT::VecOps::RVec<bool> available(id.size(), 1);
-  auto indices = Enumerate(id);
+  std::vector<bool> available(nHits, true);
+  std::vector<std::size_t> clusterList;
+  std::vector<std::size_t> neighbours;
 
   // Loop while there are unclustered hits
-  while (ROOT::VecOps::Any(available)) {
+  for (std::size_t maxIndex : seedOrder) {
+    if (!available[maxIndex]) {
+      continue;
+    }
 
     dd4hep::Position localPos = {0, 0, 0};
     float weightSum           = 0;
 
-    float esum    = 0;
-    float t0      = 0;
-    float tError  = 0;
-    auto maxIndex = ROOT::VecOps::ArgMax(e * available);
+    float esum   = 0;
+    float t0     = 0;
+    float tError = 0;
 
-    available[maxIndex] = 0;
+    available[maxIndex] = false;
 
-    ROOT::VecOps::RVec<unsigned long> clusterList = {maxIndex};
+    clusterList.assign(1, maxIndex);
     ROOT::VecOps::RVec<float> clusterT;
     std::vector<podio::ObjectID> clusterHits;
 
     // Loop over hits, adding neighbouring hits as relevant
-    while (clusterList.size()) {
-
-      // Takes first remaining hit in cluster list
-      auto index = clusterList[0];
-
-      // Finds neighbours of cluster within time limit
-      auto filter = available * (abs(x - x[index]) <= 1) * (abs(y - y[index]) <= 1) *
-                    (abs(t - t[index]) < m_cfg.hit_time_limit);
-
-      // Adds the found hits to the cluster
-      clusterList = Concatenate(clusterList, indices[filter]);
-
-      // Removes the found hits from the list of still available hits
-      available = available * (!filter);
-
-      // Removes current hit from remaining found cluster hits
-      clusterList.erase(clusterList.begin());
+    for (std::size_t listIndex = 0; listIndex < clusterList.size(); listIndex++) {
+
+      // Takes next hit in cluster list
+      auto index = clusterList[listIndex];
+
+      // Finds neighbours of cluster within time limit in the surrounding pixels
+      neighbours.clear();
+      for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+          auto it = pixelFirstHit.find(pixelKey(x[index] + dx, y[index] + dy));
+          if (it == pixelFirstHit.end()) {
+            continue;
+          }
+          for (std::size_t j = it->second; j != noHit; j = nextInPixel[j]) {
+            if (available[j] && std::abs(t[j] - t[index]) < m_cfg.hit_time_limit) {
+              neighbours.push_back(j);
+            }
+          }
+        }
+      }
+
+      // Adds the found hits to the cluster in index order and removes them from the list of
+      // still available hits
+      std::sort(neighbours.begin(), neighbours.end());
+      for (std::size_t j : neighbours) {
+        available[j] = false;
+        clusterList.push_back(j);
+      }
 
       // Adds raw hit to TrackerHit contribution
       clusterHits.push_back((inputHits)[index].getObjectID());
@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Simon Gardner
+
+#include "TMVADenseNetwork.h"
+
+#include <TXMLEngine.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace eicrecon {
+
+namespace {
+
+  class WeightFile {
+  public:
+    explicit WeightFile(const std::string& path) : m_path(path), m_doc(m_xml.ParseFile(path.c_str())) {
+      if (m_doc == nullptr) {
+        throw std::runtime_error(fmt::format("Unable to parse TMVA weight file \"{}\"", path));
+      }
+    }
+    ~WeightFile() { m_xml.FreeDoc(m_doc); }
+    WeightFile(const WeightFile&) = delete;
+    WeightFile& operator=(const WeightFile&) = delete;
+
+    XMLNodePointer_t root() { return m_xml.DocGetRootElement(m_doc); }
+
+    std::vector<XMLNodePointer_t> children(XMLNodePointer_t node, const std::string& name = "") {
+      std::vector<XMLNodePointer_t> result;
+      for (XMLNodePointer_t child = m_xml.GetChild(node); child != nullptr; child = m_xml.GetNext(child)) {
+        if (name.empty() || name == m_xml.GetNodeName(child)) {
+          result.push_back(child);
+        }
+      }
+      return result;
+    }
+
+    XMLNodePointer_t child(XMLNodePointer_t node, const std::string& name) {
+      auto result = children(node, name);
+      if (result.empty()) {
+        throw std::runtime_error(fmt::format("No <{}> in <{}> of TMVA weight file \"{}\"", name, this->name(node), m_path));
+      }
+      return result.front();
+    }
+
+    std::string name(XMLNodePointer_t node) { return m_xml.GetNodeName(node); }
+
+    bool has_attr(XMLNodePointer_t node, const std::string& name) { return m_xml.HasAttr(node, name.c_str()); }
+
+    std::string attr(XMLNodePointer_t node, const std::string& name) {
+      const char* value = m_xml.GetAttr(node, name.c_str());
+      if (value == nullptr) {
+        throw std::runtime_error(fmt::format("No attribute {} of <{}> in TMVA weight file \"{}\"", name, this->name(node), m_path));
+      }
+      return value;
+    }
+
+    /// Matrix as written by TMVA, with "Rows"/"Columns" (DL) or "rows"/"cols" (DNN) attributes
+    Eigen::MatrixXd matrix(XMLNodePointer_t node) {
+      const int rows = std::stoi(has_attr(node, "Rows") ? attr(node, "Rows") : attr(node, "rows"));
+      const int cols = std::stoi(has_attr(node, "Columns") ? attr(node, "Columns") : attr(node, "cols"));
+      const char* content = m_xml.GetNodeContent(node);
+      std::istringstream stream(content != nullptr ? content : "");
+      Eigen::MatrixXd result(rows, cols);
+      for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+          if (!(stream >> result(row, col))) {
+            throw std::runtime_error(fmt::format("Truncated <{}> matrix in TMVA weight file \"{}\"", name(node), m_path));
+          }
+        }
+      }
+      return result;
+    }
+
+  private:
+    std::string m_path;
+    TXMLEngine m_xml;
+    XMLDocPointer_t m_doc;
+  };
+
+} // namespace
+
+TMVADenseNetwork::TMVADenseNetwork(const std::string& path) {
+  WeightFile file(path);
+  XMLNodePointer_t setup = file.root();
+
+  for (auto variable : file.children(file.child(setup, "Variables"), "Variable")) {
+    m_variables.push_back(file.attr(variable, "Expression"));
+  }
+  for (auto target : file.children(file.child(setup, "Targets"), "Target")) {
+    m_targets.push_back(file.attr(target, "Expression"));
+  }
+
+  // Variable transformations, only Normalize is supported
+  m_input_scale = Eigen::RowVectorXd::Ones(m_variables.size());
+  m_input_offset = Eigen::RowVectorXd::Zero(m_variables.size());
+  m_target_scale = Eigen::RowVectorXd::Ones(m_targets.size());
+  m_target_offset = Eigen::RowVectorXd::Zero(m_targets.size());
+  for (auto transformations : file.children(setup, "Transformations")) {
+    for (auto transform : file.children(transformations, "Transform")) {
+      const std::string name = file.attr(transform, "Name");
+      if (name == "Id") {
+        continue;
+      }
+      if (name != "Normalize") {
+        throw std::runtime_error(fmt::format("Unsupported {} transformation in TMVA weight file \"{}\"", name, path));
+      }
+      // The last class holds the ranges over all classes, which are the ones used for regression
+      auto classes = file.children(transform, "Class");
+      if (classes.empty()) {
+        throw std::runtime_error(fmt::format("No ranges of Normalize transformation in TMVA weight file \"{}\"", path));
+      }
+      std::map<int, std::pair<double, double>> ranges;
+      for (auto range : file.children(file.child(classes.back(), "Ranges"), "Range")) {
+        ranges[std::stoi(file.attr(range, "Index"))] = {std::stod(file.attr(range, "Min")), std::stod(file.attr(range, "Max"))};
+      }
+      auto inputs = file.children(file.child(file.child(transform, "Selection"), "Input"), "Input");
+      for (std::size_t index = 0; index < inputs.size(); index++) {
+        const std::string type = file.attr(inputs[index], "Type");
+        const std::string expression = file.attr(inputs[index], "Expression");
+        const auto& expressions = (type == "Target") ? m_targets : m_variables;
+        auto it = std::find(expressions.begin(), expressions.end(), expression);
+        if ((type != "Variable" && type != "Target") || it == expressions.end() || !ranges.contains(index)) {
+          throw std::runtime_error(fmt::format("Unsupported Normalize input {} {} in TMVA weight file \"{}\"", type, expression, path));
+        }
+        const auto [min, max] = ranges.at(index);
+        const double scale = (max > min) ? 2. / (max - min) : 1.;
+        auto& scales = (type == "Target") ? m_target_scale : m_input_scale;
+        auto& offsets = (type == "Target") ? m_target_offset : m_input_offset;
+        const std::size_t i = std::distance(expressions.begin(), it);
+        // chain with any earlier transformation
+        offsets(i) = (offsets(i) - min) * scale - 1.;
+        scales(i) *= scale;
+      }
+    }
+  }
+
+  // Layers: <DenseLayer> from the DL method, <Layer> from the legacy DNN method
+  XMLNodePointer_t weights = file.child(setup, "Weights");
+  if (file.has_attr(weights, "OutputFunction")) {
+    const std::string output_function = file.attr(weights, "OutputFunction");
+    if (output_function == "S") {
+      m_sigmoid_output = true;
+    } else if (output_function != "I") {
+      throw std::runtime_error(fmt::format("Unsupported output function {} in TMVA weight file \"{}\"", output_function, path));
+    }
+  }
+  std::size_t width = m_variables.size();
+  for (auto layer : file.children(weights)) {
+    const std::string name = file.name(layer);
+    if (name != "DenseLayer" && name != "Layer") {
+      throw std::runtime_error(fmt::format("Unsupported {} in TMVA weight file \"{}\"", name, path));
+    }
+    const int activation = std::stoi(file.attr(layer, "ActivationFunction"));
+    if (activation < 0 || activation > static_cast<int>(Activation::FastTanh)) {
+      throw std::runtime_error(fmt::format("Unsupported activation function {} in TMVA weight file \"{}\"", activation, path));
+    }
+    Layer& added = m_layers.emplace_back(Layer{
+      file.matrix(file.child(layer, "Weights")),
+      file.matrix(file.child(layer, "Biases")).transpose(),
+      static_cast<Activation>(activation),
+    });
+    if (static_cast<std::size_t>(added.weights.cols()) != width || added.biases.size() != added.weights.rows()) {
+      throw std::runtime_error(fmt::format("Inconsistent layer dimensions in TMVA weight file \"{}\"", path));
+    }
+    width = added.weights.rows();
+  }
+  if (m_layers.empty() || width != m_targets.size()) {
+    throw std::runtime_error(fmt::format("Network in TMVA weight file \"{}\" does not produce {} targets", path, m_targets.size()));
+  }
+}
+
+std::shared_ptr<const TMVADenseNetwork> TMVADenseNetwork::load(const std::string& path) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const TMVADenseNetwork>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto network = cache[path].lock();
+  if (network == nullptr) {
+    network = std::make_shared<const TMVADenseNetwork>(path);
+    cache[path] = network;
+  }
+  return network;
+}
+
+void TMVADenseNetwork::activate(Matrix& values, Activation activation) {
+  auto array = values.array();
+  switch (activation) {
+  case Activation::Identity:
+    break;
+  case Activation::Relu:
+    array = array.max(0.);
+    break;
+  case Activation::Sigmoid:
+    array = 1. / (1. + (-array).exp());
+    break;
+  case Activation::Tanh:
+  case Activation::FastTanh:
+    array = array.tanh();
+    break;
+  case Activation::SymmRelu:
+    array = array.abs();
+    break;
+  case Activation::SoftSign:
+    array = array / (1. + array.abs());
+    break;
+  case Activation::Gauss:
+    array = (-array.square()).exp();
+    break;
+  }
+}
+
+TMVADenseNetwork::Matrix TMVADenseNetwork::evaluate(const Matrix& inputs) const {
+  if (static_cast<std::size_t>(inputs.cols()) != m_variables.size()) {
+    throw std::invalid_argument(fmt::format("Network expects {} variables, got {}", m_variables.size(), inputs.cols()));
+  }
+
+  Matrix values = (inputs.array().rowwise() * m_input_scale.array()).rowwise() + m_input_offset.array();
+  for (const auto& layer : m_layers) {
+    values = (values * layer.weights.transpose()).rowwise() + layer.biases;
+    activate(values, layer.activation);
+  }
+  if (m_sigmoid_output) {
+    activate(values, Activation::Sigmoid);
+  }
+  return (values.array().rowwise() - m_target_offset.array()).rowwise() / m_target_scale.array();
+}
+
+} // namespace eicrecon
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Simon Gardner
+
+#pragma once
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * Evaluates a fully connected network from a TMVA DL (or legacy DNN) weight file.
+ *
+ * Unlike a TMVA::Reader the evaluation is const and reentrant, so a single
+ * loaded network can be shared between threads, and all rows of an event are
+ * evaluated in one pass. The Normalize transformation of the variables and
+ * targets is applied as TMVA does.
+ */
+class TMVADenseNetwork {
+public:
+  using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  /// Reads a weight file, throws std::runtime_error if it can not be used
+  explicit TMVADenseNetwork(const std::string& path);
+
+  /// The network in `path`, shared with any other user of the same file
+  static std::shared_ptr<const TMVADenseNetwork> load(const std::string& path);
+
+  /// Expressions of the input variables and of the targets, in weight file order
+  const std::vector<std::string>& variables() const { return m_variables; };
+  const std::vector<std::string>& targets() const { return m_targets; };
+
+  /// Evaluates one row of variables per row of `inputs`, returns one row of targets per row
+  Matrix evaluate(const Matrix& inputs) const;
+
+private:
+  enum class Activation { Identity = 0, Relu = 1, Sigmoid = 2, Tanh = 3, SymmRelu = 4, SoftSign = 5, Gauss = 6, FastTanh = 7 };
+
+  struct Layer {
+    Eigen::MatrixXd weights; // width x inputs
+    Eigen::RowVectorXd biases;
+    Activation activation;
+  };
+
+  static void activate(Matrix& values, Activation activation);
+
+  std::vector<std::string> m_variables;
+  std::vector<std::string> m_targets;
+  std::vector<Layer> m_layers;
+  bool m_sigmoid_output{false};
+
+  // normalized = raw * scale + offset
+  Eigen::RowVectorXd m_input_scale;
+  Eigen::RowVectorXd m_input_offset;
+  Eigen::RowVectorXd m_target_scale;
+  Eigen::RowVectorXd m_target_offset;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <algorithms/service.h>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <string_view>
+
+namespace algorithms {
+
+/**
+ * @brief Philox4x32-10 block function
+ *
+ * Counter-based generator of Salmon et al., "Parallel random numbers: as
+ * easy as 1, 2, 3" (SC'11): the output is a bijection of the counter for
+ * each key, so any block of a stream can be computed independently.
+ */
+constexpr std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> ctr,
+                                                  std::array<std::uint32_t, 2> key) {
+  constexpr std::uint32_t kMul0 = 0xD2511F53;
+  constexpr std::uint32_t kMul1 = 0xCD9E8D57;
+  constexpr std::uint32_t kWeyl0 = 0x9E3779B9;
+  constexpr std::uint32_t kWeyl1 = 0xBB67AE85;
+  for (int round = 0; round < 10; ++round) {
+    const std::uint64_t p0 = static_cast<std::uint64_t>(kMul0) * ctr[0];
+    const std::uint64_t p1 = static_cast<std::uint64_t>(kMul1) * ctr[2];
+    ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(p1),
+           static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<std::uint32_t>(p0)};
+    key[0] += kWeyl0;
+    key[1] += kWeyl1;
+  }
+  return ctr;
+}
+
+/**
+ * @brief Random numbers determined by a 64-bit key and a 96-bit stream id
+ *
+ * Cheap to construct, so a stream can be made per object (e.g. per cell)
+ * right where the numbers are needed. Satisfies UniformRandomBitGenerator,
+ * but uniform() and gaussian() should be preferred, as the standard
+ * distributions are implementation-defined and not reproducible across
+ * standard libraries.
+ */
+class RandomStream {
+public:
+  using result_type = std::uint64_t;
+
+  constexpr RandomStream(std::uint64_t key, std::uint64_t id, std::uint32_t sub_id = 0)
+      : m_key{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)}
+      , m_id{static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(id >> 32)}
+      , m_sub_id{sub_id} {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    if (m_buffer_pos == 2) {
+      m_buffer = philox4x32({m_block++, m_sub_id, m_id[0], m_id[1]}, m_key);
+      m_buffer_pos = 0;
+    }
+    const std::size_t i = 2 * m_buffer_pos++;
+    return (static_cast<std::uint64_t>(m_buffer[i]) << 32) | m_buffer[i + 1];
+  }
+
+  /// Uniform in [0, 1)
+  double uniform() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+  /// Uniform in [low, high)
+  double uniform(double low, double high) { return low + (high - low) * uniform(); }
+
+  /// Normal distribution by the Box-Muller transform
+  double gaussian(double mean = 0., double sigma = 1.) {
+    if (m_has_gaussian) {
+      m_has_gaussian = false;
+      return mean + sigma * m_gaussian;
+    }
+    const double r = std::sqrt(-2. * std::log(1. - uniform()));
+    const double phi = 2. * std::numbers::pi * uniform();
+    m_gaussian = r * std::sin(phi);
+    m_has_gaussian = true;
+    return mean + sigma * r * std::cos(phi);
+  }
+
+private:
+  std::array<std::uint32_t, 2> m_key;
+  std::array<std::uint32_t, 2> m_id;
+  std::uint32_t m_sub_id;
+  std::uint32_t m_block{0};
+  std::array<std::uint32_t, 4> m_buffer{};
+  std::size_t m_buffer_pos{2};
+  double m_gaussian{0.};
+  bool m_has_gaussian{false};
+};
+
+/**
+ * @brief Counter-based random numbers, reproducible regardless of threading
+ *
+ * Streams are derived from the seed, the run and event numbers, a key
+ * identifying the algorithm (see key()) and an id such as a cellID, so no
+ * generator state is shared between calls. The run and event numbers are
+ * set per thread by an EventScope around the algorithm call; without one,
+ * both are zero.
+ */
+class RandomStreamSvc : public Service<RandomStreamSvc> {
+private:
+  struct EventContext {
+    std::uint64_t run{0};
+    std::uint64_t event{0};
+  };
+
+public:
+  void init(std::uint64_t seed = 1) { m_seed = seed; }
+
+  std::uint64_t seed() const { return m_seed; }
+
+  /// Key for the streams of an algorithm, from its name and an optional seed
+  static constexpr std::uint64_t key(std::string_view name, std::uint64_t seed = 0) {
+    std::uint64_t hash = 0xcbf29ce484222325; // FNV-1a
+    for (char c : name) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+    }
+    return mix(hash ^ mix(seed));
+  }
+
+  /// Stream for the current event
+  RandomStream stream(std::uint64_t key, std::uint64_t id, std::uint32_t sub_id = 0) const {
+    const EventContext& context = current();
+    const std::uint64_t event_key = mix(mix(mix(m_seed) ^ context.run) ^ context.event);
+    return RandomStream(mix(event_key ^ key), id, sub_id);
+  }
+
+  /// Sets the run and event numbers of the streams created on this thread
+  class EventScope {
+  public:
+    EventScope(std::uint64_t run, std::uint64_t event) : m_previous(current()) {
+      current() = {run, event};
+    }
+    ~EventScope() { current() = m_previous; }
+    EventScope(const EventScope&) = delete;
+    EventScope& operator=(const EventScope&) = delete;
+
+  private:
+    EventContext m_previous;
+  };
+
+private:
+  static EventContext& current() {
+    static thread_local EventContext context;
+    return context;
+  }
+
+  // splitmix64 finaliser
+  static constexpr std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+  }
+
+  std::uint64_t m_seed{1};
+
+  ALGORITHMS_DEFINE_SERVICE(RandomStreamSvc)
+};
+
+} // namespace algorithms
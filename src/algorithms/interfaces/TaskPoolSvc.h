@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <algorithms/service.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace algorithms {
+
+/**
+ * @brief Fixed set of threads shared by all algorithms that split an event into tasks
+ *
+ * JANA already processes one event per thread, so threads started per event
+ * would multiply with jana:nthreads. Instead, the tasks of an event are run
+ * by the calling thread together with idle threads of this pool, whose size
+ * is fixed at init and counts in addition to jana:nthreads. Without threads
+ * (the default) all tasks run on the calling thread, in order.
+ */
+class TaskPoolSvc : public Service<TaskPoolSvc> {
+public:
+  /// Starts n_threads threads, only the first call has an effect
+  void init(std::size_t n_threads = 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_initialized) {
+      return;
+    }
+    m_initialized = true;
+    for (std::size_t i = 0; i < n_threads; ++i) {
+      m_threads.emplace_back([this]() { work(); });
+    }
+  }
+
+  /// Joins the threads, tasks submitted afterwards run on the calling thread
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_job_available.notify_all();
+    for (auto& thread : m_threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  ~TaskPoolSvc() { stop(); }
+
+  std::size_t size() const { return m_threads.size(); }
+
+  /// Calls f(i) for i in [0, n_tasks) on the calling thread and up to
+  /// max_threads - 1 pool threads (0: all of them), and returns when all
+  /// calls returned. The first exception thrown by f is rethrown.
+  template <typename F>
+  void parallel_for(std::size_t n_tasks, std::size_t max_threads, F&& f) {
+    if (n_tasks == 0) {
+      return;
+    }
+    auto job = std::make_shared<Job>(n_tasks, std::function<void(std::size_t)>(std::ref(f)));
+
+    std::size_t n_helpers = std::min(m_threads.size(), n_tasks - 1);
+    if (max_threads > 0) {
+      n_helpers = std::min(n_helpers, max_threads - 1);
+    }
+    if (n_helpers > 0) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_stopping) {
+        for (std::size_t i = 0; i < n_helpers; ++i) {
+          m_jobs.push_back(job);
+        }
+      }
+    }
+    for (std::size_t i = 0; i < n_helpers; ++i) {
+      m_job_available.notify_one();
+    }
+
+    job->run();
+    {
+      // Helpers that pick the job up later find no tasks left and never call f
+      std::unique_lock<std::mutex> lock(job->mutex);
+      job->finished.wait(lock, [&job]() { return job->n_done.load() == job->n_tasks; });
+    }
+    if (job->exception) {
+      std::rethrow_exception(job->exception);
+    }
+  }
+
+private:
+  struct Job {
+    Job(std::size_t n, std::function<void(std::size_t)> func) : n_tasks(n), f(std::move(func)) {}
+
+    void run() {
+      for (std::size_t i = next++; i < n_tasks; i = next++) {
+        try {
+          f(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!exception) {
+            exception = std::current_exception();
+          }
+        }
+        if (++n_done == n_tasks) {
+          std::lock_guard<std::mutex> lock(mutex);
+          finished.notify_all();
+        }
+      }
+    }
+
+    const std::size_t n_tasks;
+    const std::function<void(std::size_t)> f;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> n_done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr exception;
+  };
+
+  void work() {
+    for (;;) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job_available.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+          return;
+        }
+        job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+      job->run();
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_job_available;
+  std::deque<std::shared_ptr<Job>> m_jobs;
+  std::vector<std::thread> m_threads;
+  bool m_initialized{false};
+  bool m_stopping{false};
+
+  ALGORITHMS_DEFINE_SERVICE(TaskPoolSvc)
+};
+
+} // namespace algorithms
@@ -19,11 +19,14 @@
 #include <Acts/Visualization/PlyVisualization3D.hpp>
 #include <DD4hep/DetElement.h>
 #include <DD4hep/VolumeManager.h>
+#include <DD4hep/detail/VolumeManagerInterna.h>
 #include <JANA/JException.h>
 #include <TGeoManager.h>
 #include <fmt/core.h>
 #include <fmt/ostream.h>
+#include <fmt/ranges.h>
 #include <spdlog/common.h>
+#include <algorithm>
 #include <exception>
 #include <initializer_list>
 #include <type_traits>
@@ -150,7 +153,8 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
         }
 
         m_init_log->debug("visiting all the surfaces  ");
-        m_trackingGeo->visitSurfaces([this](const Acts::Surface *surface) {
+        std::array<uint64_t, 256> masks{};
+        m_trackingGeo->visitSurfaces([this, &masks](const Acts::Surface *surface) {
             // for now we just require a valid surface
             if (surface == nullptr) {
                 m_init_log->info("no surface??? ");
@@ -177,7 +181,18 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
             }
 
             this->m_surfaces.insert_or_assign(vol_id, surface);
+
+            // volume ID bits of this system, cell IDs of hits are reduced to a volume ID with them
+            const auto det_mask = volman.subdetector(vol_id).ptr()->detMask;
+            auto& mask = masks[vol_id & 0xFF];
+            if (mask != 0 && mask != det_mask) {
+                m_init_log->error("System {} has volume ID masks {:#x} and {:#x}", vol_id & 0xFF, mask, det_mask);
+            }
+            mask = det_mask;
         });
+
+        m_surfaceTable = SurfaceTable(masks, m_surfaces);
+        m_init_log->debug("surface table of {} sensors", m_surfaceTable.size());
     }
     else {
         m_init_log->error("m_trackingGeo==null why am I still alive???");
@@ -185,7 +200,21 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
 
     // Load ACTS magnetic field
     m_init_log->info("Loading magnetic field...");
-    m_magneticField = std::make_shared<const eicrecon::BField::DD4hepBField>(m_dd4hepDetector);
+    m_magneticField = std::make_shared<const eicrecon::BField::DD4hepBField>(m_dd4hepDetector, m_fieldGridConfig);
+    if (m_magneticField->hasGrid()) {
+        const auto& grid = m_fieldGridConfig;
+        m_init_log->info("Magnetic field interpolated on {} grid from {} to {} [mm] in steps of {} [mm] ({})",
+                         grid.type, grid.min, grid.max, grid.step,
+                         m_magneticField->gridFromFile() ? "read from " + grid.file
+                         : m_magneticField->gridWritten() ? "sampled, saved to " + grid.file
+                         : "sampled");
+        if (m_fieldValidationPoints > 0) {
+            auto v = m_magneticField->validate(m_fieldValidationPoints);
+            m_init_log->info("Magnetic field grid max deviation {:.3g} T over {} points at ({}) [mm] where B = ({}) T",
+                             v.max_deviation / Acts::UnitConstants::T, v.points,
+                             v.position.transpose() / Acts::UnitConstants::mm, v.exact.transpose() / Acts::UnitConstants::T);
+        }
+    }
     Acts::MagneticFieldContext m_fieldctx{eicrecon::BField::BFieldVariant(m_magneticField)};
     auto bCache = m_magneticField->makeCache(m_fieldctx);
     for (int z: {0, 500, 1000, 1500, 2000, 3000, 4000}) {
@@ -195,3 +224,18 @@ void ActsGeometryProvider::initialize(const dd4hep::Detector* dd4hep_geo,
 
     m_init_log->info("ActsGeometryProvider initialization complete");
 }
+
+ActsGeometryProvider::SurfaceTable::SurfaceTable(const std::array<uint64_t, 256>& masks, const VolumeSurfaceMap& surfaces)
+    : m_masks(masks), m_entries(surfaces.begin(), surfaces.end()) {
+    std::sort(m_entries.begin(), m_entries.end());
+}
+
+const Acts::Surface* ActsGeometryProvider::SurfaceTable::find(uint64_t cellID) const {
+    const uint64_t vol_id = volumeID(cellID);
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), vol_id,
+                               [](const auto& entry, uint64_t id) { return entry.first < id; });
+    if (vol_id == 0 || it == m_entries.end() || it->first != vol_id) {
+        return nullptr;
+    }
+    return it->second;
+}
@@ -18,11 +18,14 @@
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <spdlog/logger.h>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "DD4hepBField.h"
 
@@ -41,6 +44,32 @@ public:
     ActsGeometryProvider() {}
     using VolumeSurfaceMap = std::unordered_map<uint64_t, const Acts::Surface *>;
 
+    /** Sensitive surfaces by cell ID.
+     *  Flat table sorted by volume ID. The volume ID is taken from the cell ID
+     *  with the volume manager mask of its system, so a lookup neither
+     *  allocates nor goes through the volume manager.
+     */
+    class SurfaceTable {
+    public:
+        SurfaceTable() = default;
+
+        /// Table of the given sensor surfaces, `masks` holds the volume ID bits of each system
+        SurfaceTable(const std::array<uint64_t, 256>& masks, const VolumeSurfaceMap& surfaces);
+
+        /// Volume ID of the sensor a cell ID belongs to, 0 for systems without surfaces
+        uint64_t volumeID(uint64_t cellID) const { return cellID & m_masks[cellID & 0xFF]; }
+
+        /// Surface of the sensor a cell ID belongs to, nullptr if there is none
+        const Acts::Surface* find(uint64_t cellID) const;
+
+        std::size_t size() const { return m_entries.size(); }
+
+    private:
+        /// Volume ID bits, indexed by the system ID in the lowest byte
+        std::array<uint64_t, 256> m_masks{};
+        std::vector<std::pair<uint64_t, const Acts::Surface*>> m_entries;
+    };
+
     virtual void initialize(const dd4hep::Detector* dd4hep_geo,
                             std::string material_file,
                             std::shared_ptr<spdlog::logger> log,
@@ -60,6 +89,8 @@ public:
 
     const VolumeSurfaceMap &surfaceMap() const  { return m_surfaces; }
 
+    const SurfaceTable &surfaceTable() const  { return m_surfaceTable; }
+
 
     std::map<int64_t, dd4hep::rec::Surface *> getDD4hepSurfaceMap() const { return m_surfaceMap; }
 
@@ -96,6 +127,9 @@ private:
     /// ACTS surface lookup container for hit surfaces that generate smeared hits
     VolumeSurfaceMap m_surfaces;
 
+    /// Same surfaces, for lookups by cell ID
+    SurfaceTable m_surfaceTable;
+
     /// Acts magnetic field
     std::shared_ptr<const eicrecon::BField::DD4hepBField> m_magneticField = nullptr;
 
@@ -113,6 +147,10 @@ private:
     Acts::ViewConfig m_sensitiveView{{0, 180, 240}};
     Acts::ViewConfig m_passiveView{{240, 280, 0}};
     Acts::ViewConfig m_gridView{{220, 0, 0}};
+    /// Magnetic field grid configuration
+    eicrecon::BField::DD4hepBField::GridConfig m_fieldGridConfig;
+    std::size_t m_fieldValidationPoints{0};
+
     bool m_objWriteIt{false};
     bool m_plyWriteIt{false};
     std::string m_outputTag{""};
@@ -140,4 +178,9 @@ public:
     void setGridView(std::array<int,3> view) { m_gridView = Acts::ViewConfig{view}; }
     const Acts::ViewConfig& getGridView() const { return m_gridView; }
 
+    void setFieldGridConfig(const eicrecon::BField::DD4hepBField::GridConfig& cfg) { m_fieldGridConfig = cfg; }
+    const eicrecon::BField::DD4hepBField::GridConfig& getFieldGridConfig() const { return m_fieldGridConfig; }
+    void setFieldValidationPoints(std::size_t n) { m_fieldValidationPoints = n; }
+    std::size_t getFieldValidationPoints() const { return m_fieldValidationPoints; }
+
 };
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#pragma once
+
+#include <ActsExamples/EventData/IndexSourceLink.hpp>
+#include <ActsExamples/EventData/Measurement.hpp>
+
+namespace eicrecon {
+
+/** Acts measurements of an event with their source links.
+ *
+ * Converted once per event from a Measurement2D collection and shared by all
+ * consumers. Source link index i refers to measurements[i] and to element i of
+ * the Measurement2D collection.
+ */
+struct ActsMeasurements {
+  ActsExamples::MeasurementContainer measurements;
+  ActsExamples::IndexSourceLinkContainer sourceLinks; // geometry-ordered
+};
+
+} // namespace eicrecon
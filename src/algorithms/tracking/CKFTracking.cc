@@ -7,10 +7,8 @@
 #include <Acts/Definitions/TrackParametrization.hpp>
 #include <Acts/Definitions/Units.hpp>
 #include <Acts/EventData/GenericBoundTrackParameters.hpp>
-#include <Acts/EventData/Measurement.hpp>
 #include <Acts/EventData/MultiTrajectory.hpp>
 #include <Acts/EventData/ParticleHypothesis.hpp>
-#include <Acts/EventData/SourceLink.hpp>
 #include <Acts/EventData/TrackContainer.hpp>
 #include <Acts/EventData/TrackProxy.hpp>
 #include <Acts/EventData/VectorMultiTrajectory.hpp>
@@ -26,23 +24,22 @@
 #include <ActsExamples/EventData/Measurement.hpp>
 #include <ActsExamples/EventData/MeasurementCalibration.hpp>
 #include <ActsExamples/EventData/Track.hpp>
-#include <edm4eic/Cov3f.h>
 #include <edm4eic/Cov6f.h>
-#include <edm4eic/Measurement2DCollection.h>
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4hep/Vector2f.h>
 #include <fmt/core.h>
 #include <Eigen/Core>
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
 #include <functional>
-#include <list>
 #include <optional>
 #include <utility>
 
 #include "ActsGeometryProvider.h"
 #include "DD4hepBField.h"
+#include "algorithms/interfaces/TaskPoolSvc.h"
 #include "extensions/spdlog/SpdlogFormatters.h" // IWYU pragma: keep
 #include "extensions/spdlog/SpdlogToActs.h"
 
@@ -69,14 +66,22 @@ namespace eicrecon {
     }
 
     void CKFTracking::init(std::shared_ptr<const ActsGeometryProvider> geo_svc, std::shared_ptr<spdlog::logger> log) {
-        m_log = log;
-        m_acts_logger = eicrecon::getSpdlogLogger("CKF", m_log);
+        m_acts_logger = eicrecon::getSpdlogLogger("CKF", log);
 
         m_geoSvc = geo_svc;
 
         m_BField = std::dynamic_pointer_cast<const eicrecon::BField::DD4hepBField>(m_geoSvc->getFieldProvider());
         m_fieldctx = eicrecon::BField::BFieldVariant(m_BField);
 
+        init(CKFTracking::makeCKFTrackingFunction(m_geoSvc->trackingGeometry(), m_BField, logger()), log);
+    }
+
+    void CKFTracking::init(std::shared_ptr<CKFTrackingFunction> trackFinderFunc, std::shared_ptr<spdlog::logger> log) {
+        m_log = log;
+        if (m_acts_logger == nullptr) {
+            m_acts_logger = eicrecon::getSpdlogLogger("CKF", m_log);
+        }
+
         // eta bins, chi2 and #sourclinks per surface cutoffs
         m_sourcelinkSelectorCfg = {
                 {Acts::GeometryIdentifier(),
@@ -85,55 +90,19 @@ namespace eicrecon {
                  }
                 },
         };
-        m_trackFinderFunc = CKFTracking::makeCKFTrackingFunction(m_geoSvc->trackingGeometry(), m_BField, logger());
+        m_trackFinderFunc = std::move(trackFinderFunc);
     }
 
     std::tuple<
         std::vector<ActsExamples::Trajectories*>,
         std::vector<ActsExamples::ConstTrackContainer*>
     >
-    CKFTracking::process(const edm4eic::Measurement2DCollection& meas2Ds,
+    CKFTracking::process(const ActsMeasurements& acts_measurements,
                          const edm4eic::TrackParametersCollection &init_trk_params) {
 
-
-        // create sourcelink and measurement containers
-        auto measurements = std::make_shared<ActsExamples::MeasurementContainer>();
-
-          // need list here for stable addresses
-        std::list<ActsExamples::IndexSourceLink> sourceLinkStorage;
-        ActsExamples::IndexSourceLinkContainer src_links;
-        src_links.reserve(meas2Ds.size());
-        std::size_t  hit_index = 0;
-
-
-        for (const auto& meas2D : meas2Ds) {
-
-            // --follow example from ACTS to create source links
-            sourceLinkStorage.emplace_back(meas2D.getSurface(), hit_index);
-            ActsExamples::IndexSourceLink& sourceLink = sourceLinkStorage.back();
-            // Add to output containers:
-            // index map and source link container are geometry-ordered.
-            // since the input is also geometry-ordered, new items can
-            // be added at the end.
-            src_links.insert(src_links.end(), sourceLink);
-            // ---
-            // Create ACTS measurements
-            Acts::Vector2 loc = Acts::Vector2::Zero();
-            loc[Acts::eBoundLoc0] = meas2D.getLoc().a;
-            loc[Acts::eBoundLoc1] = meas2D.getLoc().b;
-
-
-            Acts::SquareMatrix2 cov = Acts::SquareMatrix2::Zero();
-            cov(0, 0) = meas2D.getCovariance().xx;
-            cov(1, 1) = meas2D.getCovariance().yy;
-            cov(0, 1) = meas2D.getCovariance().xy;
-            cov(1, 0) = meas2D.getCovariance().xy;
-
-            auto measurement = Acts::makeMeasurement(Acts::SourceLink{sourceLink}, loc, cov, Acts::eBoundLoc0, Acts::eBoundLoc1);
-            measurements->emplace_back(std::move(measurement));
-
-            hit_index++;
-        }
+        // measurements and source links are shared with the other consumers of this event, not copied
+        const auto& measurements = acts_measurements.measurements;
+        const auto& src_links = acts_measurements.sourceLinks;
 
         ActsExamples::TrackParametersContainer acts_init_trk_params;
         for (const auto& track_parameter: init_trk_params) {
@@ -169,40 +138,6 @@ namespace eicrecon {
 
         ACTS_LOCAL_LOGGER(eicrecon::getSpdlogLogger("CKF", m_log, {"^No tracks found$"}));
 
-        Acts::PropagatorPlainOptions pOptions;
-        pOptions.maxSteps = 10000;
-
-        ActsExamples::PassThroughCalibrator pcalibrator;
-        ActsExamples::MeasurementCalibratorAdapter calibrator(pcalibrator, *measurements);
-        Acts::GainMatrixUpdater kfUpdater;
-        Acts::GainMatrixSmoother kfSmoother;
-        Acts::MeasurementSelector measSel{m_sourcelinkSelectorCfg};
-
-        Acts::CombinatorialKalmanFilterExtensions<Acts::VectorMultiTrajectory>
-                extensions;
-        extensions.calibrator.connect<&ActsExamples::MeasurementCalibratorAdapter::calibrate>(
-                &calibrator);
-        extensions.updater.connect<
-                &Acts::GainMatrixUpdater::operator()<Acts::VectorMultiTrajectory>>(
-                &kfUpdater);
-        extensions.smoother.connect<
-                &Acts::GainMatrixSmoother::operator()<Acts::VectorMultiTrajectory>>(
-                &kfSmoother);
-        extensions.measurementSelector.connect<
-                &Acts::MeasurementSelector::select<Acts::VectorMultiTrajectory>>(
-                &measSel);
-
-        ActsExamples::IndexSourceLinkAccessor slAccessor;
-        slAccessor.container = &src_links;
-        Acts::SourceLinkAccessorDelegate<ActsExamples::IndexSourceLinkAccessor::Iterator>
-                slAccessorDelegate;
-        slAccessorDelegate.connect<&ActsExamples::IndexSourceLinkAccessor::range>(&slAccessor);
-
-        // Set the CombinatorialKalmanFilter options
-        CKFTracking::TrackFinderOptions options(
-                m_geoctx, m_fieldctx, m_calibctx, slAccessorDelegate,
-                extensions, pOptions, &(*pSurface));
-
         // Create track container
         auto trackContainer = std::make_shared<Acts::VectorTrackContainer>();
         auto trackStateContainer = std::make_shared<Acts::VectorMultiTrajectory>();
@@ -210,22 +145,28 @@ namespace eicrecon {
 
         // Add seed number column
         acts_tracks.addColumn<unsigned int>("seed");
-        Acts::TrackAccessor<unsigned int> seedNumber("seed");
-
-        // Loop over seeds
-        for (std::size_t iseed = 0; iseed < acts_init_trk_params.size(); ++iseed) {
-            auto result =
-                (*m_trackFinderFunc)(acts_init_trk_params.at(iseed), options, acts_tracks);
 
-            if (!result.ok()) {
-                m_log->debug("Track finding failed for seed {} with error {}", iseed, result.error());
-                continue;
-            }
-
-            // Set seed number for all found tracks
-            auto& tracksForSeed = result.value();
-            for (auto& track : tracksForSeed) {
-                seedNumber(track) = iseed;
+        const std::size_t n_seeds = acts_init_trk_params.size();
+        const std::size_t chunk_size = m_cfg.seedChunkSize;
+        if (chunk_size == 0 || n_seeds <= chunk_size) {
+            find_tracks(acts_init_trk_params, 0, n_seeds, measurements, src_links, *pSurface, acts_tracks);
+        } else {
+            // Each chunk gets its own containers, which are appended in seed order afterwards so that
+            // tracks, track states and their indices come out exactly as from a single pass
+            const std::size_t n_chunks = (n_seeds + chunk_size - 1) / chunk_size;
+            std::vector<std::optional<ActsExamples::TrackContainer>> chunk_tracks(n_chunks);
+            // Chunks run on this thread and on threads of the shared task pool, never on new threads
+            algorithms::TaskPoolSvc::instance().parallel_for(n_chunks, m_cfg.maxChunkThreads, [&](std::size_t ichunk) {
+                auto& tracks = chunk_tracks[ichunk].emplace(
+                    std::make_shared<Acts::VectorTrackContainer>(),
+                    std::make_shared<Acts::VectorMultiTrajectory>());
+                tracks.addColumn<unsigned int>("seed");
+                find_tracks(acts_init_trk_params, ichunk * chunk_size, std::min(n_seeds, (ichunk + 1) * chunk_size),
+                            measurements, src_links, *pSurface, tracks);
+            });
+
+            for (const auto& tracks : chunk_tracks) {
+                append_tracks(*tracks, acts_tracks);
             }
         }
 
@@ -299,4 +240,96 @@ namespace eicrecon {
         return std::make_tuple(std::move(acts_trajectories), std::move(constTracks_v));
     }
 
+    void CKFTracking::find_tracks(const ActsExamples::TrackParametersContainer& seeds,
+                                  std::size_t begin, std::size_t end,
+                                  const ActsExamples::MeasurementContainer& measurements,
+                                  const ActsExamples::IndexSourceLinkContainer& src_links,
+                                  const Acts::Surface& target_surface,
+                                  ActsExamples::TrackContainer& acts_tracks) const {
+
+        // Everything the track finder calls back into lives here, so that chunks can run concurrently
+        Acts::PropagatorPlainOptions pOptions;
+        pOptions.maxSteps = 10000;
+
+        ActsExamples::PassThroughCalibrator pcalibrator;
+        ActsExamples::MeasurementCalibratorAdapter calibrator(pcalibrator, measurements);
+        Acts::GainMatrixUpdater kfUpdater;
+        Acts::GainMatrixSmoother kfSmoother;
+        Acts::MeasurementSelector measSel{m_sourcelinkSelectorCfg};
+
+        Acts::CombinatorialKalmanFilterExtensions<Acts::VectorMultiTrajectory>
+                extensions;
+        extensions.calibrator.connect<&ActsExamples::MeasurementCalibratorAdapter::calibrate>(
+                &calibrator);
+        extensions.updater.connect<
+                &Acts::GainMatrixUpdater::operator()<Acts::VectorMultiTrajectory>>(
+                &kfUpdater);
+        extensions.smoother.connect<
+                &Acts::GainMatrixSmoother::operator()<Acts::VectorMultiTrajectory>>(
+                &kfSmoother);
+        extensions.measurementSelector.connect<
+                &Acts::MeasurementSelector::select<Acts::VectorMultiTrajectory>>(
+                &measSel);
+
+        ActsExamples::IndexSourceLinkAccessor slAccessor;
+        slAccessor.container = &src_links;
+        Acts::SourceLinkAccessorDelegate<ActsExamples::IndexSourceLinkAccessor::Iterator>
+                slAccessorDelegate;
+        slAccessorDelegate.connect<&ActsExamples::IndexSourceLinkAccessor::range>(&slAccessor);
+
+        // Set the CombinatorialKalmanFilter options
+        CKFTracking::TrackFinderOptions options(
+                m_geoctx, m_fieldctx, m_calibctx, slAccessorDelegate,
+                extensions, pOptions, &target_surface);
+
+        Acts::TrackAccessor<unsigned int> seedNumber("seed");
+
+        // Loop over seeds
+        for (std::size_t iseed = begin; iseed < end; ++iseed) {
+            auto result =
+                (*m_trackFinderFunc)(seeds.at(iseed), options, acts_tracks);
+
+            if (!result.ok()) {
+                m_log->debug("Track finding failed for seed {} with error {}", iseed, result.error());
+                continue;
+            }
+
+            // Set seed number for all found tracks
+            auto& tracksForSeed = result.value();
+            for (auto& track : tracksForSeed) {
+                seedNumber(track) = iseed;
+            }
+        }
+    }
+
+    void CKFTracking::append_tracks(const ActsExamples::TrackContainer& src, ActsExamples::TrackContainer& dst) {
+
+        using IndexType = Acts::MultiTrajectoryTraits::IndexType;
+        constexpr IndexType kInvalid = Acts::MultiTrajectoryTraits::kInvalid;
+
+        const auto& src_states = src.trackStateContainer();
+        auto& dst_states = dst.trackStateContainer();
+        const IndexType offset = dst_states.size();
+        auto shifted = [offset](IndexType index) { return index == kInvalid ? kInvalid : index + offset; };
+
+        // Copy all track states, including those of branches that did not end up in a track,
+        // so that state indices are the same as if all seeds had been processed in dst
+        for (IndexType istate = 0; istate < src_states.size(); ++istate) {
+            const auto src_state = src_states.getTrackState(istate);
+            const auto mask = src_state.getMask();
+            const IndexType previous = src_state.hasPrevious() ? src_state.previous() : kInvalid;
+            auto dst_state = dst_states.getTrackState(dst_states.addTrackState(mask, shifted(previous)));
+            dst_state.copyFrom(src_state, mask);
+        }
+
+        for (const auto& src_track : src) {
+            auto dst_track = dst.getTrack(dst.addTrack());
+            dst_track.copyFrom(src_track, false);
+            dst_track.tipIndex() = shifted(src_track.tipIndex());
+            if constexpr (requires { dst_track.stemIndex(); }) {
+                dst_track.stemIndex() = shifted(src_track.stemIndex());
+            }
+        }
+    }
+
 } // namespace eicrecon
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <Acts/EventData/VectorMultiTrajectory.hpp>
+#include <Acts/Surfaces/Surface.hpp>
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Geometry/TrackingGeometry.hpp>
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
@@ -14,15 +15,17 @@
 #include <Acts/Utilities/Logger.hpp>
 #include <Acts/Utilities/Result.hpp>
 #include <ActsExamples/EventData/IndexSourceLink.hpp>
+#include <ActsExamples/EventData/Measurement.hpp>
 #include <ActsExamples/EventData/Track.hpp>
 #include <ActsExamples/EventData/Trajectories.hpp>
-#include <edm4eic/Measurement2DCollection.h>
 #include <edm4eic/TrackParametersCollection.h>
 #include <spdlog/logger.h>
+#include <cstddef>
 #include <memory>
 #include <tuple>
 #include <vector>
 
+#include "ActsMeasurements.h"
 #include "CKFTrackingConfig.h"
 #include "DD4hepBField.h"
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -70,14 +73,28 @@ namespace eicrecon {
 
         void init(std::shared_ptr<const ActsGeometryProvider> geo_svc, std::shared_ptr<spdlog::logger> log);
 
+        /// Initialize with a given track finder function, e.g. one that does not need a geometry in tests
+        void init(std::shared_ptr<CKFTrackingFunction> trackFinderFunc, std::shared_ptr<spdlog::logger> log);
+
         std::tuple<
             std::vector<ActsExamples::Trajectories*>,
             std::vector<ActsExamples::ConstTrackContainer*>
         >
-        process(const edm4eic::Measurement2DCollection& meas2Ds,
+        process(const ActsMeasurements& acts_measurements,
                 const edm4eic::TrackParametersCollection &init_trk_params);
 
     private:
+        /// Run the track finder for seeds [begin, end) and append the found tracks to acts_tracks
+        void find_tracks(const ActsExamples::TrackParametersContainer& seeds,
+                         std::size_t begin, std::size_t end,
+                         const ActsExamples::MeasurementContainer& measurements,
+                         const ActsExamples::IndexSourceLinkContainer& src_links,
+                         const Acts::Surface& target_surface,
+                         ActsExamples::TrackContainer& acts_tracks) const;
+
+        /// Append all tracks and track states of src to dst, preserving their order and layout
+        static void append_tracks(const ActsExamples::TrackContainer& src, ActsExamples::TrackContainer& dst);
+
         std::shared_ptr<spdlog::logger> m_log;
         std::shared_ptr<const Acts::Logger> m_acts_logger{nullptr};
         std::shared_ptr<CKFTrackingFunction> m_trackFinderFunc;
@@ -11,5 +11,15 @@ namespace eicrecon {
         std::vector<double> etaBins = {};  // {this, "etaBins", {}};
         std::vector<double> chi2CutOff = {15.}; //{this, "chi2CutOff", {15.}};
         std::vector<size_t> numMeasurementsCutOff = {10}; //{this, "numMeasurementsCutOff", {10}};
+
+        // Split the seeds of an event into chunks of this many seeds, 0 processes all seeds at once.
+        // Chunks are processed by the event's thread together with idle threads of the shared
+        // algorithms::TaskPoolSvc (taskpool:nthreads, 0 by default, in addition to jana:nthreads),
+        // so chunking only helps when there are fewer events in flight than cores.
+        // Results are identical either way.
+        size_t seedChunkSize = 0;
+        // Maximum number of threads working on the chunks of an event, including the event's thread,
+        // 0 uses all threads of the task pool
+        size_t maxChunkThreads = 0;
     };
 }
@@ -11,12 +11,113 @@
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <limits>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <thread>
 
 namespace eicrecon::BField {
 
-  Acts::Result<Acts::Vector3> DD4hepBField::getField(const Acts::Vector3& position,
-                                                     Acts::MagneticFieldProvider::Cache& /*cache*/) const
+  namespace {
+
+    constexpr char grid_file_magic[8] = {'E', 'I', 'C', 'B', 'G', 'R', 'D', '1'};
+
+    // FIXME Acts doesn't seem to like exact zero components
+    Acts::Vector3 avoid_zero_components(Acts::Vector3 field) {
+      if (field.x() * field.y() * field.z() == 0) {
+        constexpr double epsilon = std::numeric_limits<double>::epsilon();
+        field += Acts::Vector3{epsilon, epsilon, epsilon};
+      }
+      return field;
+    }
+
+    template <typename T> void write_pod(std::ostream& os, const T& value) {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T> bool read_pod(std::istream& is, T& value) {
+      return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+  } // namespace
+
+  DD4hepBField::DD4hepBField(gsl::not_null<const dd4hep::Detector*> det, const GridConfig& cfg)
+  : m_det(det), m_cfg(cfg) {
+
+    if (m_cfg.type == "none") {
+      return;
+    }
+    if (m_cfg.type != "rz" && m_cfg.type != "xyz") {
+      throw std::invalid_argument("DD4hepBField: unknown grid type '" + m_cfg.type + "', expected none, rz or xyz");
+    }
+    m_rz = (m_cfg.type == "rz");
+
+    // Nodes along each axis; the y axis is collapsed for rz
+    std::array<double, 3> lo = m_cfg.min;
+    std::array<double, 3> hi = m_cfg.max;
+    if (m_rz) {
+      lo[0] = 0.;
+      lo[1] = hi[1] = 0.;
+    }
+    for (std::size_t a = 0; a < 3; ++a) {
+      if (m_rz && a == 1) {
+        m_n[a] = 1;
+        continue;
+      }
+      if (!(m_cfg.step[a] > 0.) || !(hi[a] > lo[a])) {
+        throw std::invalid_argument("DD4hepBField: grid needs max > min and step > 0 on every axis");
+      }
+      m_n[a] = static_cast<std::size_t>(std::ceil((hi[a] - lo[a]) / m_cfg.step[a] - 1e-9)) + 1;
+      m_lo[a] = lo[a] * Acts::UnitConstants::mm;
+      m_step[a] = m_cfg.step[a] * Acts::UnitConstants::mm;
+      m_inv_step[a] = 1. / m_step[a];
+    }
+
+    if (!m_cfg.file.empty() && readGrid(m_cfg.file)) {
+      m_grid_from_file = true;
+      return;
+    }
+
+    // Sample the DD4hep field at every node, one z plane per task
+    m_grid.resize(3 * m_n[0] * m_n[1] * m_n[2]);
+    auto sample_planes = [this](std::size_t k_begin, std::size_t k_end) {
+      for (std::size_t k = k_begin; k < k_end; ++k) {
+        for (std::size_t j = 0; j < m_n[1]; ++j) {
+          for (std::size_t i = 0; i < m_n[0]; ++i) {
+            const Acts::Vector3 node{m_lo[0] + i * m_step[0], m_lo[1] + j * m_step[1], m_lo[2] + k * m_step[2]};
+            // For rz, node = (r, 0, z) is at phi = 0, so (Bx, By, Bz) there is (Br, Bphi, Bz)
+            const Acts::Vector3 field = exactField(node);
+            float* out = &m_grid[3 * ((k * m_n[1] + j) * m_n[0] + i)];
+            out[0] = field.x();
+            out[1] = field.y();
+            out[2] = field.z();
+          }
+        }
+      }
+    };
+    const std::size_t n_tasks = std::min<std::size_t>(std::max(1U, std::thread::hardware_concurrency()), m_n[2]);
+    std::vector<std::future<void>> tasks;
+    for (std::size_t t = 0; t < n_tasks; ++t) {
+      tasks.push_back(std::async(std::launch::async, sample_planes, t * m_n[2] / n_tasks, (t + 1) * m_n[2] / n_tasks));
+    }
+    for (auto& task : tasks) {
+      task.get();
+    }
+
+    if (!m_cfg.file.empty()) {
+      m_grid_written = writeGrid(m_cfg.file);
+    }
+  }
+
+  Acts::Vector3 DD4hepBField::exactField(const Acts::Vector3& position) const
   {
     dd4hep::Position pos(
       position[0] * (dd4hep::mm / Acts::UnitConstants::mm),
@@ -25,18 +126,75 @@ namespace eicrecon::BField {
 
     auto fieldObj = m_det->field();
     auto field = fieldObj.magneticField(pos) * (Acts::UnitConstants::T / dd4hep::tesla);
+    return {field.x(), field.y(), field.z()};
+  }
 
-    // FIXME Acts doesn't seem to like exact zero components
-    if (field.x() * field.y() * field.z() == 0) {
-      static dd4hep::Direction epsilon{
-        std::numeric_limits<double>::epsilon(),
-        std::numeric_limits<double>::epsilon(),
-        std::numeric_limits<double>::epsilon()
-      };
-      field += epsilon;
+  Acts::Result<Acts::Vector3> DD4hepBField::getField(const Acts::Vector3& position,
+                                                     Acts::MagneticFieldProvider::Cache& cache) const
+  {
+    if (m_grid.empty()) {
+      return Acts::Result<Acts::Vector3>::success(avoid_zero_components(exactField(position)));
+    }
+
+    const double r = m_rz ? std::hypot(position.x(), position.y()) : 0.;
+    const std::array<double, 3> u = m_rz ? std::array<double, 3>{r, 0., position.z()}
+                                         : std::array<double, 3>{position.x(), position.y(), position.z()};
+
+    // Lower node and fractional position in the cell along each axis
+    std::array<std::size_t, 3> idx = {0, 0, 0};
+    std::array<double, 3> frac = {0., 0., 0.};
+    for (std::size_t a = 0; a < 3; ++a) {
+      if (m_n[a] == 1) {
+        continue;
+      }
+      const double t = (u[a] - m_lo[a]) * m_inv_step[a];
+      if (!(t >= 0.) || t > static_cast<double>(m_n[a] - 1)) {
+        // Outside of the grid
+        return Acts::Result<Acts::Vector3>::success(avoid_zero_components(exactField(position)));
+      }
+      idx[a] = std::min(static_cast<std::size_t>(t), m_n[a] - 2);
+      frac[a] = t - idx[a];
     }
 
-    return Acts::Result<Acts::Vector3>::success({field.x(), field.y(), field.z()});
+    // Consecutive steps mostly stay in the same cell, so keep its corners in the cache
+    auto& c = cache.as<Cache>();
+    const std::size_t cell = (idx[2] * m_n[1] + idx[1]) * m_n[0] + idx[0];
+    const std::size_t dj_max = (m_n[1] > 1) ? 1 : 0;
+    if (c.cell != cell) {
+      for (std::size_t dk = 0; dk <= 1; ++dk) {
+        for (std::size_t dj = 0; dj <= dj_max; ++dj) {
+          for (std::size_t di = 0; di <= 1; ++di) {
+            const float* node = &m_grid[3 * (((idx[2] + dk) * m_n[1] + idx[1] + dj) * m_n[0] + idx[0] + di)];
+            c.corners[di + 2 * dj + 4 * dk] = Acts::Vector3{node[0], node[1], node[2]};
+          }
+        }
+      }
+      c.cell = cell;
+    }
+
+    // Trilinear (bilinear for rz) interpolation
+    Acts::Vector3 field = Acts::Vector3::Zero();
+    for (std::size_t dk = 0; dk <= 1; ++dk) {
+      const double wk = dk ? frac[2] : 1. - frac[2];
+      for (std::size_t dj = 0; dj <= dj_max; ++dj) {
+        const double wj = (dj_max == 0) ? 1. : (dj ? frac[1] : 1. - frac[1]);
+        for (std::size_t di = 0; di <= 1; ++di) {
+          const double wi = di ? frac[0] : 1. - frac[0];
+          field += (wi * wj * wk) * c.corners[di + 2 * dj + 4 * dk];
+        }
+      }
+    }
+
+    if (m_rz) {
+      // Rotate (Br, Bphi, Bz) to the azimuth of position
+      const double cos_phi = (r > 0.) ? position.x() / r : 1.;
+      const double sin_phi = (r > 0.) ? position.y() / r : 0.;
+      field = Acts::Vector3{field.x() * cos_phi - field.y() * sin_phi,
+                            field.x() * sin_phi + field.y() * cos_phi,
+                            field.z()};
+    }
+
+    return Acts::Result<Acts::Vector3>::success(avoid_zero_components(field));
   }
 
   Acts::Result<Acts::Vector3> DD4hepBField::getFieldGradient(const Acts::Vector3& position,
@@ -46,4 +204,125 @@ namespace eicrecon::BField {
     return this->getField(position, cache);
   }
 
+  DD4hepBField::Validation DD4hepBField::validate(std::size_t n_points) const
+  {
+    Validation result;
+    if (m_grid.empty()) {
+      return result;
+    }
+
+    // Fixed seed, so that repeated validations are comparable
+    std::mt19937_64 rng(0);
+    std::array<std::uniform_real_distribution<double>, 3> dist;
+    for (std::size_t a = 0; a < 3; ++a) {
+      const double hi = m_lo[a] + (m_n[a] - 1) * m_step[a];
+      dist[a] = std::uniform_real_distribution<double>(m_lo[a], std::max(m_lo[a], hi));
+    }
+    std::uniform_real_distribution<double> phi_dist(-std::numbers::pi, std::numbers::pi);
+
+    Acts::MagneticFieldContext mctx;
+    auto cache = makeCache(mctx);
+    for (std::size_t n = 0; n < n_points; ++n) {
+      Acts::Vector3 position;
+      if (m_rz) {
+        const double r = dist[0](rng);
+        const double phi = phi_dist(rng);
+        position = {r * std::cos(phi), r * std::sin(phi), dist[2](rng)};
+      } else {
+        position = {dist[0](rng), dist[1](rng), dist[2](rng)};
+      }
+      const Acts::Vector3 exact = avoid_zero_components(exactField(position));
+      const double deviation = (getField(position, cache).value() - exact).norm();
+      if (deviation > result.max_deviation) {
+        result.max_deviation = deviation;
+        result.position = position;
+        result.exact = exact;
+      }
+    }
+    result.points = n_points;
+    return result;
+  }
+
+  std::array<Acts::Vector3, 8> DD4hepBField::fingerprint() const
+  {
+    // Exact field at a few points along the grid diagonal, to recognize a grid file made
+    // with a different detector or field description
+    std::array<Acts::Vector3, 8> result;
+    for (std::size_t m = 0; m < result.size(); ++m) {
+      const double f = (m + 0.5) / result.size();
+      Acts::Vector3 position;
+      for (std::size_t a = 0; a < 3; ++a) {
+        position[a] = m_lo[a] + f * (m_n[a] - 1) * m_step[a];
+      }
+      result[m] = exactField(position);
+    }
+    return result;
+  }
+
+  bool DD4hepBField::readGrid(const std::string& file)
+  {
+    std::ifstream is(file, std::ios::binary);
+    if (!is) {
+      return false;
+    }
+
+    char magic[sizeof(grid_file_magic)];
+    std::uint8_t rz = 0;
+    std::array<std::uint64_t, 3> n;
+    std::array<double, 3> lo, inv_step;
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, grid_file_magic, sizeof(magic)) != 0
+        || !read_pod(is, rz) || !read_pod(is, n) || !read_pod(is, lo) || !read_pod(is, inv_step)) {
+      return false;
+    }
+    if (static_cast<bool>(rz) != m_rz || lo != m_lo || inv_step != m_inv_step
+        || n[0] != m_n[0] || n[1] != m_n[1] || n[2] != m_n[2]) {
+      return false;
+    }
+
+    for (const auto& expected : fingerprint()) {
+      Acts::Vector3 stored;
+      if (!read_pod(is, stored[0]) || !read_pod(is, stored[1]) || !read_pod(is, stored[2])) {
+        return false;
+      }
+      if ((stored - expected).norm() > 1e-9 * std::max(1., expected.norm())) {
+        return false;
+      }
+    }
+
+    std::vector<float> grid(3 * m_n[0] * m_n[1] * m_n[2]);
+    if (!is.read(reinterpret_cast<char*>(grid.data()), grid.size() * sizeof(float))) {
+      return false;
+    }
+    m_grid = std::move(grid);
+    return true;
+  }
+
+  bool DD4hepBField::writeGrid(const std::string& file) const
+  {
+    // Write to a temporary file and rename, so that concurrent jobs never see a partial grid
+    const std::string tmp_file = file + ".tmp" + std::to_string(std::random_device{}());
+    {
+      std::ofstream os(tmp_file, std::ios::binary | std::ios::trunc);
+      if (!os) {
+        return false;
+      }
+      os.write(grid_file_magic, sizeof(grid_file_magic));
+      write_pod(os, static_cast<std::uint8_t>(m_rz));
+      write_pod(os, std::array<std::uint64_t, 3>{m_n[0], m_n[1], m_n[2]});
+      write_pod(os, m_lo);
+      write_pod(os, m_inv_step);
+      for (const auto& field : fingerprint()) {
+        write_pod(os, field[0]);
+        write_pod(os, field[1]);
+        write_pod(os, field[2]);
+      }
+      os.write(reinterpret_cast<const char*>(m_grid.data()), m_grid.size() * sizeof(float));
+      if (!os.flush()) {
+        std::remove(tmp_file.c_str());
+        return false;
+      }
+    }
+    return std::rename(tmp_file.c_str(), file.c_str()) == 0;
+  }
+
 } // namespace eicrecon::BField
@@ -14,8 +14,12 @@
 #include <Acts/Utilities/Result.hpp>
 #include <DD4hep/Detector.h>
 #include <gsl/pointers>
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <variant>
+#include <vector>
 
 
 
@@ -37,8 +41,34 @@ namespace eicrecon::BField {
       gsl::not_null<const dd4hep::Detector*> m_det;
 
   public:
+    /** Optional grid on which the DD4hep field is sampled once and then interpolated.
+     *
+     *  For "rz" the field is sampled at phi = 0 and assumed to be axially symmetric,
+     *  using r in [0, max[0]] with step[0] and z in [min[2], max[2]] with step[2].
+     *  For "xyz" all three axes are used. Positions outside the grid use the
+     *  DD4hep field directly. Lengths are in mm.
+     */
+    struct GridConfig {
+      std::string type = "none"; // "none", "rz" or "xyz"
+      std::array<double, 3> min = {-1000., -1000., -4500.};
+      std::array<double, 3> max = {1000., 1000., 4500.};
+      std::array<double, 3> step = {10., 10., 10.};
+      std::string file = ""; // if set, the grid is read from here when it matches, or written here otherwise
+    };
+
+    /// Largest difference between the grid and the DD4hep field found by validate()
+    struct Validation {
+      std::size_t points = 0;
+      double max_deviation = 0.; // in Acts units
+      Acts::Vector3 position = Acts::Vector3::Zero(); // where max_deviation was found
+      Acts::Vector3 exact = Acts::Vector3::Zero();
+    };
+
     struct Cache {
       Cache(const Acts::MagneticFieldContext& /*mcfg*/) { }
+      /// Grid cell of the previous lookup and the field at its corners
+      std::size_t cell = static_cast<std::size_t>(-1);
+      std::array<Acts::Vector3, 8> corners;
     };
 
     Acts::MagneticFieldProvider::Cache makeCache(const Acts::MagneticFieldContext& mctx) const override
@@ -52,14 +82,30 @@ namespace eicrecon::BField {
     */
     explicit DD4hepBField(gsl::not_null<const dd4hep::Detector*> det) : m_det(det) {}
 
+    /** construct field interpolated on a grid, see GridConfig.
+    *
+    * @param [in] DD4hep detector instance
+    * @param [in] grid configuration
+    */
+    DD4hepBField(gsl::not_null<const dd4hep::Detector*> det, const GridConfig& cfg);
+
+    /// True if fields are interpolated on a grid
+    bool hasGrid() const { return !m_grid.empty(); }
+
+    /// True if the grid was read from GridConfig::file rather than sampled
+    bool gridFromFile() const { return m_grid_from_file; }
+
+    /// True if the sampled grid was saved to GridConfig::file
+    bool gridWritten() const { return m_grid_written; }
+
+    /// Compare the grid with the DD4hep field at n_points random positions inside the grid
+    Validation validate(std::size_t n_points) const;
+
     /**  retrieve magnetic field value.
      *
      *  @param [in] position global position
-     *  @param [in] cache Cache object (is ignored)
+     *  @param [in] cache Cache object, remembers the last grid cell
      *  @return magnetic field vector
-     *
-     *  @note The @p position is ignored and only kept as argument to provide
-     *        a consistent interface with other magnetic field services.
      */
     Acts::Result<Acts::Vector3> getField(const Acts::Vector3& position, Acts::MagneticFieldProvider::Cache& cache) const override;
 
@@ -78,6 +124,23 @@ namespace eicrecon::BField {
      */
     Acts::Result<Acts::Vector3> getFieldGradient(const Acts::Vector3& position, Acts::ActsMatrix<3, 3>& /*derivative*/,
                                                  Acts::MagneticFieldProvider::Cache& cache) const override;
+
+  private:
+    /// DD4hep field at position, both in Acts units
+    Acts::Vector3 exactField(const Acts::Vector3& position) const;
+    bool readGrid(const std::string& file);
+    bool writeGrid(const std::string& file) const;
+    std::array<Acts::Vector3, 8> fingerprint() const;
+
+    GridConfig m_cfg;
+    bool m_rz = false;
+    std::array<std::size_t, 3> m_n = {0, 0, 0}; // number of nodes per axis
+    std::array<double, 3> m_lo = {0., 0., 0.};  // first node per axis, in Acts units
+    std::array<double, 3> m_step = {0., 0., 0.};
+    std::array<double, 3> m_inv_step = {0., 0., 0.};
+    std::vector<float> m_grid; // 3 components per node, x fastest, in Acts units
+    bool m_grid_from_file = false;
+    bool m_grid_written = false;
   };
 
   using BFieldVariant = std::variant<std::shared_ptr<const DD4hepBField>>;
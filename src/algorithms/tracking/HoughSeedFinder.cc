@@ -0,0 +1,316 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#include "HoughSeedFinder.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+namespace eicrecon {
+
+HoughSeedFinder::HoughSeedFinder(const Config& cfg) : m_cfg(cfg) {
+  if (m_cfg.phiBins < 3 || m_cfg.curvatureBins == 0 || m_cfg.cotThetaBins == 0 || m_cfg.z0Bins == 0) {
+    throw std::invalid_argument("HoughSeedFinder: needs at least 3 phi bins and one bin on the other axes");
+  }
+  if (m_cfg.minHits < 3) {
+    throw std::invalid_argument("HoughSeedFinder: seeds need minHits of at least 3");
+  }
+  if (!(m_cfg.rMin > 0) || !(m_cfg.rMax > m_cfg.rMin) || !(m_cfg.curvatureMax >= 0) || !(m_cfg.cotThetaMax > 0) || !(m_cfg.z0Max > m_cfg.z0Min)) {
+    throw std::invalid_argument("HoughSeedFinder: needs rMin > 0 and non-empty r, curvature, cot theta and z0 ranges");
+  }
+
+  const float curvatureStep = 2 * m_cfg.curvatureMax / m_cfg.curvatureBins;
+  for (std::size_t c = 0; c <= m_cfg.curvatureBins; ++c) {
+    m_halfCurvatureEdges.push_back((-m_cfg.curvatureMax + c * curvatureStep) / 2);
+  }
+  // one bit of a LayerMask per layer
+  m_layerWidth = std::max(m_cfg.deltaRMin, (m_cfg.rMax - m_cfg.rMin) / (8 * sizeof(LayerMask)));
+  m_rzLayers.assign(m_cfg.cotThetaBins * m_cfg.z0Bins, 0);
+}
+
+bool HoughSeedFinder::isPeak(const std::vector<LayerMask>& layers, std::size_t rows, std::size_t cols,
+                             bool wrapCols, std::size_t row, std::size_t col) {
+  const int value = std::popcount(layers[row * cols + col]);
+  for (int dr = -1; dr <= 1; ++dr) {
+    if ((dr < 0 && row == 0) || (dr > 0 && row + 1 == rows)) {
+      continue;
+    }
+    for (int dc = -1; dc <= 1; ++dc) {
+      std::size_t other_col = col + dc;
+      if (dc < 0 && col == 0) {
+        if (!wrapCols) {
+          continue;
+        }
+        other_col = cols - 1;
+      } else if (dc > 0 && col + 1 == cols) {
+        if (!wrapCols) {
+          continue;
+        }
+        other_col = 0;
+      }
+      // plateaus are kept whole, their duplicate seeds are removed at the end
+      if (std::popcount(layers[(row + dr) * cols + other_col]) > value) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void HoughSeedFinder::find(const std::vector<float>& r, const std::vector<float>& phi, const std::vector<float>& z,
+                           std::vector<Seed>& seeds) {
+  m_selected.clear();
+  m_selectedR.clear();
+  m_selectedPhi.clear();
+  m_selectedZ.clear();
+  m_selectedLayers.clear();
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    if (r[i] >= m_cfg.rMin && r[i] <= m_cfg.rMax && z[i] >= m_cfg.zMin && z[i] <= m_cfg.zMax) {
+      m_selected.push_back(i);
+      m_selectedR.push_back(r[i]);
+      m_selectedPhi.push_back(phi[i]);
+      m_selectedZ.push_back(z[i]);
+      const auto layer = std::min<std::size_t>((r[i] - m_cfg.rMin) / m_layerWidth, 8 * sizeof(LayerMask) - 1);
+      m_selectedLayers.push_back(LayerMask{1} << layer);
+    }
+  }
+  const std::size_t n = m_selected.size();
+  if (n < m_cfg.minHits) {
+    return;
+  }
+
+  // Range of phi0 bins of every space point over each curvature bin, so that
+  // all space points of a track fall into the bin of its phi0 and curvature.
+  // The loops over space points only read and write contiguous arrays, so
+  // that they vectorise.
+  const std::size_t nc = m_cfg.curvatureBins;
+  const std::size_t np = m_cfg.phiBins;
+  const float phiScale = np / (2 * std::numbers::pi_v<float>);
+  const auto np_int = static_cast<std::int32_t>(np);
+  m_phiBins.resize(nc * n);
+  m_phiWidths.resize(nc * n);
+  for (std::size_t c = 0; c < nc; ++c) {
+    const float halfCurvatureLow = m_halfCurvatureEdges[c];
+    const float halfCurvatureHigh = m_halfCurvatureEdges[c + 1];
+    std::int32_t* bins = m_phiBins.data() + c * n;
+    std::int32_t* widths = m_phiWidths.data() + c * n;
+    for (std::size_t i = 0; i < n; ++i) {
+      // phi0 = phi + asin(r * curvature / 2) grows with the curvature
+      const float sLow = m_selectedR[i] * halfCurvatureLow;
+      const float sHigh = m_selectedR[i] * halfCurvatureHigh;
+      const float phi0Low = m_selectedPhi[i] + std::asin(std::clamp(sLow, -1.f, 1.f));
+      const float phi0High = m_selectedPhi[i] + std::asin(std::clamp(sHigh, -1.f, 1.f));
+      const auto low = static_cast<std::int32_t>(std::floor((phi0Low + std::numbers::pi_v<float>) * phiScale));
+      const auto high = static_cast<std::int32_t>(std::floor((phi0High + std::numbers::pi_v<float>) * phiScale));
+      // phi0 is within [-3 pi / 2, 3 pi / 2], wrap its bin into [0, np)
+      std::int32_t bin = low;
+      bin += (bin < 0) ? np_int : 0;
+      bin -= (bin >= np_int) ? np_int : 0;
+      bins[i] = bin;
+      // no circle through the beam line reaches the space point if r * curvature / 2 > 1
+      widths[i] = (sLow <= 1.f && sHigh >= -1.f) ? std::min(high - low + 1, np_int) : 0;
+    }
+  }
+
+  // Histogram, and the space points of each bin
+  auto forEachBin = [&](std::size_t c, auto&& f) {
+    const std::int32_t* bins = m_phiBins.data() + c * n;
+    const std::int32_t* widths = m_phiWidths.data() + c * n;
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::int32_t w = 0; w < widths[i]; ++w) {
+        const std::int32_t bin = bins[i] + w;
+        f(i, c * np + ((bin < np_int) ? bin : bin - np_int));
+      }
+    }
+  };
+  m_xyCounts.assign(nc * np, 0);
+  m_xyLayers.assign(nc * np, 0);
+  for (std::size_t c = 0; c < nc; ++c) {
+    forEachBin(c, [&](std::size_t i, std::size_t bin) {
+      ++m_xyCounts[bin];
+      m_xyLayers[bin] |= m_selectedLayers[i];
+    });
+  }
+  m_xyOffsets.resize(nc * np + 1);
+  m_xyOffsets[0] = 0;
+  for (std::size_t bin = 0; bin < nc * np; ++bin) {
+    m_xyOffsets[bin + 1] = m_xyOffsets[bin] + m_xyCounts[bin];
+  }
+  m_xyHits.resize(m_xyOffsets.back());
+  for (std::size_t c = 0; c < nc; ++c) {
+    // fill each bin from its end, the offsets are back to its start afterwards
+    forEachBin(c, [&](std::size_t i, std::size_t bin) { m_xyHits[--m_xyOffsets[bin + 1]] = i; });
+  }
+  for (std::size_t bin = 0; bin < nc * np; ++bin) {
+    m_xyOffsets[bin + 1] = m_xyOffsets[bin] + m_xyCounts[bin];
+  }
+
+  const std::size_t first_seed = seeds.size();
+  m_peakHits.clear();
+  for (std::size_t c = 0; c < nc; ++c) {
+    for (std::size_t p = 0; p < np; ++p) {
+      const std::size_t bin = c * np + p;
+      if (static_cast<std::size_t>(std::popcount(m_xyLayers[bin])) < m_cfg.minHits ||
+          !isPeak(m_xyLayers, nc, np, true, c, p)) {
+        continue;
+      }
+      // neighbours on a plateau mostly share their space points, which give the same lines
+      const auto hits_begin = m_xyHits.begin() + m_xyOffsets[bin];
+      const auto hits_end = m_xyHits.begin() + m_xyOffsets[bin + 1];
+      if (std::equal(hits_begin, hits_end, m_peakHits.begin(), m_peakHits.end())) {
+        continue;
+      }
+      m_peakHits.assign(hits_begin, hits_end);
+      findLines(m_halfCurvatureEdges[c] + m_halfCurvatureEdges[c + 1], seeds);
+    }
+  }
+
+  // Neighbouring candidates of a track give the same seed, keep the one with most space points
+  std::sort(seeds.begin() + first_seed, seeds.end(), [](const Seed& a, const Seed& b) {
+    return (a.spacePoints != b.spacePoints) ? a.spacePoints < b.spacePoints : a.hits > b.hits;
+  });
+  seeds.erase(std::unique(seeds.begin() + first_seed, seeds.end(),
+                          [](const Seed& a, const Seed& b) { return a.spacePoints == b.spacePoints; }),
+              seeds.end());
+}
+
+void HoughSeedFinder::findLines(float curvature, std::vector<Seed>& seeds) {
+  const std::size_t nt = m_cfg.cotThetaBins;
+  const std::size_t nz = m_cfg.z0Bins;
+  const float cotThetaStep = 2 * m_cfg.cotThetaMax / nt;
+  const float z0Step = (m_cfg.z0Max - m_cfg.z0Min) / nz;
+
+  auto this_r = [&](std::size_t k) { return m_selectedR[m_peakHits[k]]; };
+  auto this_z = [&](std::size_t k) { return m_selectedZ[m_peakHits[k]]; };
+
+  // transverse arc length from the beam line, space points only need to be reached
+  // at the lower curvature edge of the bin, r * curvature / 2 may exceed 1 at its centre
+  m_arcLengths.clear();
+  for (std::size_t k = 0; k < m_peakHits.size(); ++k) {
+    const float s = std::clamp(this_r(k) * curvature / 2, -1.f, 1.f);
+    m_arcLengths.push_back(std::abs(s) > 1e-6f ? this_r(k) * std::asin(s) / s : this_r(k));
+  }
+
+  // Range of z0 bins of a space point over a cot theta bin, empty if outside of the z0 range
+  auto z0Bins = [&](std::size_t k, std::size_t t) {
+    const float cotThetaLow = -m_cfg.cotThetaMax + t * cotThetaStep;
+    const float zk = this_z(k);
+    const auto low = static_cast<std::int64_t>(std::floor((zk - m_arcLengths[k] * (cotThetaLow + cotThetaStep) - m_cfg.z0Min) / z0Step));
+    const auto high = static_cast<std::int64_t>(std::floor((zk - m_arcLengths[k] * cotThetaLow - m_cfg.z0Min) / z0Step));
+    return std::make_pair(std::max<std::int64_t>(low, 0), std::min<std::int64_t>(high, nz - 1));
+  };
+
+  // Range of cot theta bins with z0 within its range, z0 = z - s * cot theta
+  auto cotThetaBins = [&](std::size_t k) {
+    const float cotThetaLow = (this_z(k) - m_cfg.z0Max) / m_arcLengths[k];
+    const float cotThetaHigh = (this_z(k) - m_cfg.z0Min) / m_arcLengths[k];
+    const auto low = static_cast<std::int64_t>(std::floor((std::max(cotThetaLow, -m_cfg.cotThetaMax) + m_cfg.cotThetaMax) / cotThetaStep));
+    const auto high = static_cast<std::int64_t>(std::floor((std::min(cotThetaHigh, m_cfg.cotThetaMax) + m_cfg.cotThetaMax) / cotThetaStep));
+    return std::make_pair(std::max<std::int64_t>(low, 0), std::min<std::int64_t>(high, nt - 1));
+  };
+
+  m_rzTouched.clear();
+  for (std::size_t k = 0; k < m_peakHits.size(); ++k) {
+    const auto [first, last] = cotThetaBins(k);
+    for (auto t = first; t <= last; ++t) {
+      const auto [low, high] = z0Bins(k, t);
+      for (auto zb = low; zb <= high; ++zb) {
+        const std::size_t bin = t * nz + zb;
+        if (m_rzLayers[bin] == 0) {
+          m_rzTouched.push_back(bin);
+        }
+        m_rzLayers[bin] |= m_selectedLayers[m_peakHits[k]];
+      }
+    }
+  }
+
+  for (std::size_t bin : m_rzTouched) {
+    const std::size_t t = bin / nz;
+    const std::size_t zb = bin % nz;
+    if (static_cast<std::size_t>(std::popcount(m_rzLayers[bin])) < m_cfg.minHits ||
+        !isPeak(m_rzLayers, nt, nz, false, t, zb)) {
+      continue;
+    }
+
+    m_lineHits.clear();
+    for (std::size_t k = 0; k < m_peakHits.size(); ++k) {
+      const auto [low, high] = z0Bins(k, t);
+      if (low <= static_cast<std::int64_t>(zb) && static_cast<std::int64_t>(zb) <= high) {
+        m_lineHits.push_back(k);
+      }
+    }
+
+    // Straight line fit z = z0 + s * cot theta, dropping the space point
+    // furthest from the line until all are within half a z0 bin of it
+    double z0 = 0;
+    double cotTheta = 0;
+    while (m_lineHits.size() >= 3) {
+      double sum_s = 0, sum_z = 0, sum_ss = 0, sum_sz = 0;
+      for (std::size_t k : m_lineHits) {
+        const double s = m_arcLengths[k];
+        sum_s += s;
+        sum_z += this_z(k);
+        sum_ss += s * s;
+        sum_sz += s * this_z(k);
+      }
+      const double nhits = m_lineHits.size();
+      const double denominator = nhits * sum_ss - sum_s * sum_s;
+      if (!(denominator > 0)) {
+        m_lineHits.clear();
+        break;
+      }
+      z0 = (sum_ss * sum_z - sum_s * sum_sz) / denominator;
+      cotTheta = (nhits * sum_sz - sum_s * sum_z) / denominator;
+
+      auto residual = [&](std::size_t k) { return std::abs(this_z(k) - z0 - m_arcLengths[k] * cotTheta); };
+      const auto worst = std::max_element(m_lineHits.begin(), m_lineHits.end(),
+                                          [&](std::size_t a, std::size_t b) { return residual(a) < residual(b); });
+      if (residual(*worst) <= z0Step / 2) {
+        break;
+      }
+      m_lineHits.erase(worst);
+    }
+    LayerMask layers = 0;
+    for (std::size_t k : m_lineHits) {
+      layers |= m_selectedLayers[m_peakHits[k]];
+    }
+    if (static_cast<std::size_t>(std::popcount(layers)) < m_cfg.minHits) {
+      continue;
+    }
+
+    // Bottom and top space point at the smallest and largest radius, the middle one closest to halfway
+    std::sort(m_lineHits.begin(), m_lineHits.end(),
+              [&](std::size_t a, std::size_t b) { return this_r(a) < this_r(b); });
+    const std::size_t bottom = m_lineHits.front();
+    const std::size_t top = m_lineHits.back();
+    const float rMiddle = (this_r(bottom) + this_r(top)) / 2;
+    std::size_t middle = bottom;
+    for (std::size_t k : m_lineHits) {
+      if (this_r(k) - this_r(bottom) >= m_cfg.deltaRMin && this_r(top) - this_r(k) >= m_cfg.deltaRMin &&
+          (middle == bottom || std::abs(this_r(k) - rMiddle) < std::abs(this_r(middle) - rMiddle))) {
+        middle = k;
+      }
+    }
+    if (middle == bottom) {
+      continue;
+    }
+
+    seeds.push_back(Seed{
+      {m_selected[m_peakHits[bottom]], m_selected[m_peakHits[middle]], m_selected[m_peakHits[top]]},
+      static_cast<float>(z0),
+      static_cast<float>(cotTheta),
+      curvature,
+      m_lineHits.size(),
+    });
+  }
+
+  for (std::size_t bin : m_rzTouched) {
+    m_rzLayers[bin] = 0;
+  }
+}
+
+} // namespace eicrecon
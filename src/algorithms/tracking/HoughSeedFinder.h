@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * Track seeds from Hough transforms of space points.
+ *
+ * Space points are first histogrammed in (phi0, curvature) of circles through
+ * the beam line, phi0 = phi + asin(r * curvature / 2). Each space point fills
+ * the range of phi0 bins it spans over a curvature bin, so that all space
+ * points of a track meet in the bin of its parameters. Bins count layers,
+ * approximated by radial slices at least deltaRMin wide, rather than space
+ * points. Every bin with at least minHits layers and no neighbour with more is
+ * a candidate, its space points are histogrammed in (cot theta, z0) of
+ * straight lines z = z0 + s * cot theta along the transverse arc length s,
+ * which is searched for candidates the same way. A line fit to the space
+ * points of such a candidate, with outliers beyond half a z0 bin removed,
+ * gives a seed of three of them spread in radius.
+ *
+ * The cost is linear in the number of space points, which makes it a cheaper
+ * alternative to the combinatorial seeders at high occupancy.
+ */
+class HoughSeedFinder {
+public:
+  struct Config {
+    // Space points used
+    float rMin;
+    float rMax;
+    float zMin;
+    float zMax;
+
+    // (phi0, curvature) histogram, the curvature range is symmetric
+    std::size_t phiBins;
+    std::size_t curvatureBins;
+    float curvatureMax; // [1/mm]
+
+    // (cot theta, z0) histogram, the cot theta range is symmetric
+    std::size_t cotThetaBins;
+    float cotThetaMax;
+    std::size_t z0Bins;
+    float z0Min;
+    float z0Max;
+
+    std::size_t minHits; // layers, at least 3
+    float deltaRMin;     // between the space points of a seed, and minimum layer width
+  };
+
+  struct Seed {
+    std::array<std::size_t, 3> spacePoints; // indices of the bottom, middle and top space point
+    float z0;
+    float cotTheta;
+    float curvature;
+    std::size_t hits; // number of space points on the line
+  };
+
+  explicit HoughSeedFinder(const Config& cfg);
+
+  /// Appends the seeds found among the space points at (r[i], phi[i], z[i]) to `seeds`
+  void find(const std::vector<float>& r, const std::vector<float>& phi, const std::vector<float>& z,
+            std::vector<Seed>& seeds);
+
+private:
+  using LayerMask = std::uint64_t;
+
+  /// True if no neighbour of a bin has more layers
+  static bool isPeak(const std::vector<LayerMask>& layers, std::size_t rows, std::size_t cols,
+                     bool wrapCols, std::size_t row, std::size_t col);
+
+  void findLines(float curvature, std::vector<Seed>& seeds);
+
+  Config m_cfg;
+  std::vector<float> m_halfCurvatureEdges; // half of the curvature at each bin edge
+  float m_layerWidth;
+
+  // Per event work space, kept between events to reuse the storage
+  std::vector<std::size_t> m_selected;    // space points within the r and z ranges
+  std::vector<float> m_selectedR;
+  std::vector<float> m_selectedPhi;
+  std::vector<float> m_selectedZ;
+  std::vector<LayerMask> m_selectedLayers;
+  std::vector<std::int32_t> m_phiBins;    // [curvature bin * selected + i], first phi0 bin
+  std::vector<std::int32_t> m_phiWidths;  // [curvature bin * selected + i], number of phi0 bins
+  std::vector<std::uint32_t> m_xyCounts;  // [curvature bin * phiBins + phi bin]
+  std::vector<LayerMask> m_xyLayers;
+  std::vector<std::uint32_t> m_xyOffsets; // space points of each bin in m_xyHits
+  std::vector<std::uint32_t> m_xyHits;
+  std::vector<LayerMask> m_rzLayers;      // [cot theta bin * z0Bins + z0 bin], zero between candidates
+  std::vector<std::size_t> m_rzTouched;
+  std::vector<std::uint32_t> m_peakHits;  // selected space points of an (phi0, curvature) candidate
+  std::vector<float> m_arcLengths;
+  std::vector<std::size_t> m_lineHits;
+};
+
+} // namespace eicrecon
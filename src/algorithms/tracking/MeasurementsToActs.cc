@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2022 - 2024 Whitney Armstrong, Wouter Deconinck, Dmitry Romanov, Shujie Li, Dmitry Kalinkin
+
+#include "MeasurementsToActs.h"
+
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Definitions/TrackParametrization.hpp>
+#include <Acts/EventData/Measurement.hpp>
+#include <Acts/EventData/SourceLink.hpp>
+#include <edm4eic/Cov3f.h>
+#include <edm4hep/Vector2f.h>
+#include <Eigen/Core>
+#include <cstddef>
+#include <gsl/pointers>
+#include <utility>
+
+namespace eicrecon {
+
+void MeasurementsToActs::init() {
+}
+
+void MeasurementsToActs::process(const Input& input, const Output& output) const {
+  const auto [meas2Ds] = input;
+  auto [acts_measurements] = output;
+
+  auto& measurements = acts_measurements->measurements;
+  auto& src_links = acts_measurements->sourceLinks;
+  measurements.reserve(meas2Ds->size());
+  src_links.reserve(meas2Ds->size());
+
+  for (std::size_t hit_index = 0; const auto& meas2D : *meas2Ds) {
+
+    // Source links hold their index by value, so they need no stable storage.
+    // The source link container is geometry-ordered, and since the input is
+    // also geometry-ordered, new items can be added at the end.
+    ActsExamples::IndexSourceLink sourceLink(meas2D.getSurface(), hit_index);
+    src_links.insert(src_links.end(), sourceLink);
+
+    Acts::Vector2 loc = Acts::Vector2::Zero();
+    loc[Acts::eBoundLoc0] = meas2D.getLoc().a;
+    loc[Acts::eBoundLoc1] = meas2D.getLoc().b;
+
+    Acts::SquareMatrix2 cov = Acts::SquareMatrix2::Zero();
+    cov(0, 0) = meas2D.getCovariance().xx;
+    cov(1, 1) = meas2D.getCovariance().yy;
+    cov(0, 1) = meas2D.getCovariance().xy;
+    cov(1, 0) = meas2D.getCovariance().xy;
+
+    measurements.emplace_back(Acts::makeMeasurement(Acts::SourceLink{sourceLink}, loc, cov, Acts::eBoundLoc0, Acts::eBoundLoc1));
+
+    ++hit_index;
+  }
+  debug("Converted {} measurements", measurements.size());
+}
+
+} // namespace eicrecon
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#pragma once
+
+#include <algorithms/algorithm.h>
+#include <edm4eic/Measurement2DCollection.h>
+#include <string>
+#include <string_view>
+
+#include "algorithms/tracking/ActsMeasurements.h"
+
+namespace eicrecon {
+
+using MeasurementsToActsAlgorithm =
+    algorithms::Algorithm<
+      algorithms::Input<edm4eic::Measurement2DCollection>,
+      algorithms::Output<ActsMeasurements>
+    >;
+
+class MeasurementsToActs : public MeasurementsToActsAlgorithm {
+public:
+    MeasurementsToActs(std::string_view name) : MeasurementsToActsAlgorithm{name, {"inputMeasurement2DCollection"}, {"outputActsMeasurements"}, "Converts EDM4eic measurements to Acts measurements and source links"} {};
+
+    void init() final;
+    void process(const Input&, const Output&) const final;
+};
+
+}
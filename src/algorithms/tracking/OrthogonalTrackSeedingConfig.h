@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 
 #include <Acts/Definitions/Units.hpp>
 
@@ -12,6 +13,10 @@ namespace eicrecon {
 
   struct OrthogonalTrackSeedingConfig {
 
+    //////////////////////////////////////////////////////////////////////////
+    /// SEEDER SELECTION
+    std::string seeder = "orthogonal"; // "orthogonal" for Acts::SeedFinderOrthogonal, "hough" for HoughSeedFinder
+
     //////////////////////////////////////////////////////////////////////////
     /// SEED FINDER GENERAL PARAMETERS
     float rMax = 440. * Acts::UnitConstants::mm; // max r to look for hits to compose seeds
@@ -78,6 +83,18 @@ namespace eicrecon {
     float  seedConfMaxZOriginForward      = 150.0 * Acts::UnitConstants::mm;
     float  minImpactSeedConfForward       = 1.0 * Acts::UnitConstants::mm;
 
+    //////////////////////////////////////////////////////////////////////////
+    /// HOUGH SEED FINDER PARAMETERS
+    /// Space points are taken within rMin..rMax and zMin..zMax, seeds within
+    /// collisionRegionMin..collisionRegionMax, cotThetaMax and bFieldInZ are shared
+    /// with the orthogonal seeder.
+    size_t houghPhiBins       = 256; // bins in phi0
+    size_t houghCurvatureBins = 64; // bins in signed curvature, up to that of houghMinPt
+    float  houghMinPt         = 100. * Acts::UnitConstants::MeV; // minimum transverse momentum
+    size_t houghCotThetaBins  = 500; // bins in cot theta
+    size_t houghZ0Bins        = 10; // bins in z0 over the collision region
+    size_t houghMinHits       = 4; // minimum number of layers with space points on a seed line
+
     //////////////////////////////////////
     ///Seed Covariance Error Matrix
     float locaError   = 1.5 * Acts::UnitConstants::mm;     //Error on Loc a
@@ -1,62 +1,126 @@
 #pragma once
 
+#include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Geometry/GeometryIdentifier.hpp>
 #include <Acts/Seeding/Seed.hpp>
 #include <Acts/Surfaces/Surface.hpp>
+#include <edm4eic/TrackerHitCollection.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
 #include "ActsGeometryProvider.h"
 namespace eicrecon {
 
-class SpacePoint : public edm4eic::TrackerHit
+class SpacePoint;
+
+/// Space points of an event in structure-of-arrays layout. The derived
+/// quantities the seeder asks for are computed once when a hit is added.
+/// Cleared rather than reallocated between events, so that it serves as a
+/// per-event arena.
+class SpacePointContainer
 {
  public:
-  const Acts::Surface *m_surface = nullptr;
-
- SpacePoint(const TrackerHit& hit) : TrackerHit(hit) {}
-
-  void setSurface(std::shared_ptr<const ActsGeometryProvider> m_geoSvc)
-    {
-      const auto its = m_geoSvc->surfaceMap().find(getCellID());
-      if (its == m_geoSvc->surfaceMap().end()) {
-        m_surface = nullptr;
-      }
-      else {
-        m_surface = its->second;
-      }
-    }
+  void clear()
+  {
+    m_x.clear(); m_y.clear(); m_z.clear(); m_r.clear(); m_phi.clear();
+    m_varianceR.clear(); m_varianceZ.clear(); m_surface.clear();
+  }
 
-  float x() const { return getPosition()[0]; }
-  float y() const { return getPosition()[1]; }
-  float z() const { return getPosition()[2]; }
-  float r() const { return std::hypot(x(), y()); }
-  float varianceR() const
+  void reserve(std::size_t n)
   {
-    return (std::pow(x(), 2) * getPositionError().xx +
-            std::pow(y(), 2) * getPositionError().yy) /
-      (std::pow(x(), 2) + std::pow(y(), 2));
+    m_x.reserve(n); m_y.reserve(n); m_z.reserve(n); m_r.reserve(n); m_phi.reserve(n);
+    m_varianceR.reserve(n); m_varianceZ.reserve(n); m_surface.reserve(n);
   }
-  float varianceZ() const { return getPositionError().zz; }
+
+  void push_back(const edm4eic::TrackerHit& hit, const Acts::Surface* surface)
+  {
+    const float x = hit.getPosition()[0];
+    const float y = hit.getPosition()[1];
+    push_back(x, y, hit.getPosition()[2],
+              (std::pow(x, 2) * hit.getPositionError().xx +
+               std::pow(y, 2) * hit.getPositionError().yy) /
+              (std::pow(x, 2) + std::pow(y, 2)),
+              hit.getPositionError().zz, surface);
+  }
+
+  /// Space point from its position and variances, the surface may be null if not needed
+  void push_back(float x, float y, float z, float varianceR, float varianceZ, const Acts::Surface* surface)
+  {
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_z.push_back(z);
+    m_r.push_back(std::hypot(x, y));
+    m_phi.push_back(std::atan2(y, x));
+    m_varianceR.push_back(varianceR);
+    m_varianceZ.push_back(varianceZ);
+    m_surface.push_back(surface);
+  }
+
+  std::size_t size() const { return m_x.size(); }
+
+  float x(std::size_t i) const { return m_x[i]; }
+  float y(std::size_t i) const { return m_y[i]; }
+  float z(std::size_t i) const { return m_z[i]; }
+  float r(std::size_t i) const { return m_r[i]; }
+  float phi(std::size_t i) const { return m_phi[i]; }
+  float varianceR(std::size_t i) const { return m_varianceR[i]; }
+  float varianceZ(std::size_t i) const { return m_varianceZ[i]; }
+  const Acts::Surface* surface(std::size_t i) const { return m_surface[i]; }
+
+  /// Whole columns, for algorithms looping over all space points
+  const std::vector<float>& rValues() const { return m_r; }
+  const std::vector<float>& phiValues() const { return m_phi; }
+  const std::vector<float>& zValues() const { return m_z; }
+
+ private:
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<float> m_z;
+  std::vector<float> m_r;
+  std::vector<float> m_phi;
+  std::vector<float> m_varianceR;
+  std::vector<float> m_varianceZ;
+  std::vector<const Acts::Surface*> m_surface;
+};
+
+/// Space point as seen by the Acts seeder: an index into a SpacePointContainer,
+/// which must not be modified while the space point is in use
+class SpacePoint
+{
+ public:
+  SpacePoint(const SpacePointContainer& container, std::size_t index)
+    : m_container(&container), m_index(index) {}
+
+  /// Index of the tracker hit in the input collection
+  std::size_t index() const { return m_index; }
+
+  float x() const { return m_container->x(m_index); }
+  float y() const { return m_container->y(m_index); }
+  float z() const { return m_container->z(m_index); }
+  float r() const { return m_container->r(m_index); }
+  float phi() const { return m_container->phi(m_index); }
+  float varianceR() const { return m_container->varianceR(m_index); }
+  float varianceZ() const { return m_container->varianceZ(m_index); }
+  const Acts::Surface* surface() const { return m_container->surface(m_index); }
 
   bool isOnSurface() const {
-    if (m_surface == nullptr) {
+    if (surface() == nullptr) {
       return false;
     }
-    return m_surface->isOnSurface(Acts::GeometryContext(), {x(), y(), z()},
-                                 {0, 0, 0});
+    return surface()->isOnSurface(Acts::GeometryContext(), {x(), y(), z()},
+                                  {0, 0, 0});
   }
-};
 
-inline bool operator==(SpacePoint a, SpacePoint b)
-{
-  return (a.getObjectID() == b.getObjectID());
-}
-static bool spCompare(SpacePoint r, SpacePoint s)
-{
-  return
-    std::hypot(r.x(), r.y(), r.z()) <
-    std::hypot(s.x(), s.y(), s.z());
-}
+  friend bool operator==(const SpacePoint& a, const SpacePoint& b)
+  {
+    return a.m_container == b.m_container && a.m_index == b.m_index;
+  }
+
+ private:
+  const SpacePointContainer* m_container;
+  std::size_t m_index;
+};
 
-using SpacePointPtr = std::unique_ptr<SpacePoint>;
 /// Container of sim seed
 using SeedContainer = std::vector<Acts::Seed<SpacePoint>>;
 
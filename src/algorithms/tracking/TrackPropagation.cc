@@ -39,8 +39,11 @@
 #include <string>
 #include <tuple>
 #include <typeinfo>
+#include <utility>
 #include <variant>
+#include <vector>
 
+#include "algorithms/interfaces/TaskPoolSvc.h"
 #include "algorithms/tracking/ActsGeometryProvider.h"
 #include "algorithms/tracking/TrackPropagation.h"
 #include "algorithms/tracking/TrackPropagationConfig.h"
@@ -58,6 +61,12 @@ void TrackPropagation::init(const dd4hep::Detector* detector,
                             std::shared_ptr<const ActsGeometryProvider> geo_svc,
                             std::shared_ptr<spdlog::logger> logger) {
     m_geoSvc = geo_svc;
+    init(detector, m_geoSvc->getFieldProvider(), logger);
+}
+
+void TrackPropagation::init(const dd4hep::Detector* detector,
+                            std::shared_ptr<const Acts::MagneticFieldProvider> field,
+                            std::shared_ptr<spdlog::logger> logger) {
     m_log = logger;
 
     std::map<uint32_t,size_t> system_id_layers;
@@ -102,10 +111,45 @@ void TrackPropagation::init(const dd4hep::Detector* detector,
     m_filter_surfaces.resize(m_cfg.filter_surfaces.size());
     std::transform(m_cfg.filter_surfaces.cbegin(), m_cfg.filter_surfaces.cend(), m_filter_surfaces.begin(), _toActsSurface);
 
+    // the propagator has no per-propagation state, so a single one is shared by all calls
+    m_propagator = std::make_unique<const Propagator>(Stepper(std::move(field)));
+
     m_log->trace("Initialized");
 }
 
 
+void TrackPropagation::process(
+          const std::tuple<const edm4eic::TrackCollection&, const std::vector<const ActsExamples::Trajectories*>, const std::vector<const ActsExamples::ConstTrackContainer*>> input,
+          const std::tuple<edm4eic::TrackSegmentCollection*> output) const
+{
+    const auto [tracks, acts_trajectories, acts_tracks] = input;
+    auto [propagated_tracks] = output;
+
+    // target surfaces are in no particular order, each is reached from the start of the trajectory
+    std::vector<std::vector<edm4eic::TrackPoint>> points(acts_trajectories.size());
+    algorithms::TaskPoolSvc::instance().parallel_for(acts_trajectories.size(), m_cfg.maxThreads, [&](std::size_t i) {
+        for (auto& surf : m_target_surfaces) {
+            auto prop_point = propagate(edm4eic::Track{}, acts_trajectories[i], surf);
+            if (!prop_point) continue;
+            prop_point->surface = surf->geometryId().layer();
+            prop_point->system  = surf->geometryId().extra();
+            points[i].push_back(*prop_point);
+        }
+    });
+
+    for (size_t i = 0; i < acts_trajectories.size(); ++i) {
+        auto this_propagated_track = propagated_tracks->create();
+        if (tracks.size() == acts_trajectories.size()) {
+            m_log->trace("track segment connected to track {}", i);
+            this_propagated_track.setTrack(tracks[i]);
+        }
+        for (const auto& point : points[i]) {
+            this_propagated_track.addToPoints(point);
+        }
+    }
+}
+
+
 void TrackPropagation::propagateToSurfaceList(
           const std::tuple<const edm4eic::TrackCollection&, const std::vector<const ActsExamples::Trajectories*>, const std::vector<const ActsExamples::ConstTrackContainer*>> input,
           const std::tuple<edm4eic::TrackSegmentCollection*> output) const
@@ -119,46 +163,54 @@ void TrackPropagation::propagateToSurfaceList(
     m_log->trace("number of acts_trajectories: {}", acts_trajectories.size());
     m_log->trace("number of acts_tracks: {}", acts_tracks.size());
 
-    // loop over input trajectories
-    for (size_t i = 0; const auto& traj : acts_trajectories) {
+    struct Segment {
+      std::vector<edm4eic::TrackPoint> points;
+      decltype(edm4eic::TrackSegmentData::length)      length       = 0;
+      decltype(edm4eic::TrackSegmentData::lengthError) length_error = 0;
+    };
+    std::vector<std::optional<Segment>> segments(acts_trajectories.size());
+
+    // propagate the trajectories, possibly in parallel on the shared task pool
+    algorithms::TaskPoolSvc::instance().parallel_for(acts_trajectories.size(), m_cfg.maxThreads, [&](std::size_t i) {
+      const auto& traj = acts_trajectories[i];
+
+      // skip empty
+      if (traj->tips().empty()) {
+        m_log->trace("  Empty multiTrajectory.");
+        return;
+      }
+      const auto& initial_bound_parameters = traj->trackParameters(traj->tips().front());
 
       // check if this trajectory can be propagated to any filter surface
       bool trajectory_reaches_filter_surface{false};
       for (const auto& filter_surface: m_filter_surfaces) {
-        auto point = propagate(edm4eic::Track{}, traj, filter_surface);
-        if (point) {
+        if (propagate(initial_bound_parameters, *filter_surface)) {
           trajectory_reaches_filter_surface = true;
           break;
         }
       }
       if (trajectory_reaches_filter_surface == false) {
-        ++i;
-        continue;
+        return;
       }
 
-      // start a mutable TrackSegment
-      auto track_segment = track_segments->create();
+      auto& segment = segments[i].emplace();
 
-      // corresponding track
-      if (tracks.size() == acts_trajectories.size()) {
-        m_log->trace("track segment connected to track {}", i);
-        track_segment.setTrack(tracks[i]);
-        ++i;
-      }
-
-      // zero measurements of segment length
-      decltype(edm4eic::TrackSegmentData::length)      length       = 0;
-      decltype(edm4eic::TrackSegmentData::lengthError) length_error = 0;
+      // step along the trajectory once: each surface is reached from the previous one
+      Acts::BoundTrackParameters parameters = initial_bound_parameters;
+      double path_length = 0;
 
       // loop over projection-target surfaces
       for (const auto& target_surface : m_target_surfaces) {
 
         // project the trajectory `traj` to this surface
-        auto point = propagate(edm4eic::Track{}, traj, target_surface);
-        if (!point) {
+        auto result = propagate(parameters, *target_surface);
+        if (!result) {
           m_log->trace("<> Failed to propagate trajectory to this plane");
           continue;
         }
+        parameters = std::move(result->first);
+        path_length += result->second;
+        auto point = trackPoint(parameters, *target_surface, path_length);
 
         // logging
         m_log->trace("<> trajectory: x=( {:>10.2f} {:>10.2f} {:>10.2f} )",
@@ -176,28 +228,47 @@ void TrackPropagation::propagateToSurfaceList(
 
         // update the `TrackSegment` length
         // FIXME: `length` and `length_error` are currently not used by any callers, and may not be correctly calculated here
-        if (track_segment.points_size()>0) {
+        if (!segment.points.empty()) {
           auto pos0 = point->position;
-          auto pos1 = std::prev(track_segment.points_end())->position;
+          auto pos1 = segment.points.back().position;
           auto dist = edm4hep::utils::magnitude(pos0-pos1);
-          length += dist;
+          segment.length += dist;
           m_log->trace("               dist to previous point: {}", dist);
         }
 
         // add the `TrackPoint` to the `TrackSegment`
-        track_segment.addToPoints(*point);
+        segment.points.push_back(*point);
 
       } // end `targetSurfaces` loop
+    });
+
+    // create the track segments in trajectory order
+    for (size_t i = 0; i < acts_trajectories.size(); ++i) {
+      if (!segments[i]) {
+        continue;
+      }
+
+      // start a mutable TrackSegment
+      auto track_segment = track_segments->create();
+
+      // corresponding track
+      if (tracks.size() == acts_trajectories.size()) {
+        m_log->trace("track segment connected to track {}", i);
+        track_segment.setTrack(tracks[i]);
+      }
+
+      for (const auto& point : segments[i]->points) {
+        track_segment.addToPoints(point);
+      }
 
       // set final length and length error
-      track_segment.setLength(length);
-      track_segment.setLengthError(length_error);
+      track_segment.setLength(segments[i]->length);
+      track_segment.setLengthError(segments[i]->length_error);
 
     } // end loop over input trajectories
   }
 
 
-
     std::unique_ptr<edm4eic::TrackPoint> TrackPropagation::propagate(
       const edm4eic::Track& track,
       const ActsExamples::Trajectories *acts_trajectory,
@@ -219,13 +290,9 @@ void TrackPropagation::propagateToSurfaceList(
 
         // Collect the trajectory summary info
         auto trajState = Acts::MultiTrajectoryHelpers::trajectoryState(mj, trackTip);
-        int m_nMeasurements = trajState.nMeasurements;
-        int m_nStates = trajState.nStates;
-
-        m_log->trace("  Num measurement in trajectory: {}", m_nMeasurements);
-        m_log->trace("  Num states in trajectory     : {}", m_nStates);
-
-
+        m_log->trace("  Num measurement in trajectory: {}", trajState.nMeasurements);
+        m_log->trace("  Num states in trajectory     : {}", trajState.nStates);
+        m_log->trace("  chi2                         : {:.4f}", trajState.chi2Sum);
 
         //=================================================
         //Track projection
@@ -233,36 +300,47 @@ void TrackPropagation::propagateToSurfaceList(
         //=================================================
         const auto &initial_bound_parameters = acts_trajectory->trackParameters(trackTip);
 
+        auto result = propagate(initial_bound_parameters, *targetSurf);
+        if (!result) {
+            return nullptr;
+        }
+        return trackPoint(result->first, *targetSurf, result->second);
+    }
+
 
-        m_log->trace("    TrackPropagation. Propagating to surface # {}", typeid(targetSurf->type()).name());
+    std::optional<std::pair<Acts::BoundTrackParameters, double>> TrackPropagation::propagate(
+      const Acts::BoundTrackParameters& start,
+      const Acts::Surface& targetSurf) const {
 
-        std::shared_ptr<const Acts::TrackingGeometry> trackingGeometry = m_geoSvc->trackingGeometry();
-        std::shared_ptr<const Acts::MagneticFieldProvider> magneticField = m_geoSvc->getFieldProvider();
-        using Stepper = Acts::EigenStepper<>;
-        using Propagator = Acts::Propagator<Stepper>;
-        Stepper stepper(magneticField);
-        Propagator propagator(stepper);
+        m_log->trace("    TrackPropagation. Propagating to surface # {}", typeid(targetSurf.type()).name());
 
         ACTS_LOCAL_LOGGER(eicrecon::getSpdlogLogger("PROP", m_log));
 
         Acts::PropagatorOptions<> options(m_geoContext, m_fieldContext);
 
-        auto result = propagator.propagate(initial_bound_parameters, *targetSurf, options);
+        auto result = m_propagator->propagate(start, targetSurf, options);
 
         // check propagation result
         if (!result.ok()) {
             m_log->trace("    propagation failed (!result.ok())");
-            return nullptr;
+            return std::nullopt;
         }
         m_log->trace("    propagation result is OK");
 
+        return std::make_pair(Acts::BoundTrackParameters(*((*result).endParameters)), static_cast<double>((*result).pathLength));
+    }
+
+
+    std::unique_ptr<edm4eic::TrackPoint> TrackPropagation::trackPoint(
+      const Acts::BoundTrackParameters& trackStateParams,
+      const Acts::Surface& targetSurf,
+      double pathLength) const {
+
         // Pulling results to convenient variables
-        auto trackStateParams = *((*result).endParameters);
         const auto &parameter = trackStateParams.parameters();
         const auto &covariance = *trackStateParams.covariance();
 
         // Path length
-        const float pathLength = (*result).pathLength;
         const float pathLengthError = 0;
         m_log->trace("    path len = {}", pathLength);
 
@@ -317,12 +395,11 @@ void TrackPropagation::propagateToSurfaceList(
         m_log->trace("    err phi = {:.4f}", sqrt(covariance(Acts::eBoundPhi, Acts::eBoundPhi)));
         m_log->trace("    err th  = {:.4f}", sqrt(covariance(Acts::eBoundTheta, Acts::eBoundTheta)));
         m_log->trace("    err q/p = {:.4f}", sqrt(covariance(Acts::eBoundQOverP, Acts::eBoundQOverP)));
-        m_log->trace("    chi2    = {:.4f}", trajState.chi2Sum);
         m_log->trace("    loc err = {:.4f}", static_cast<float>(covariance(Acts::eBoundLoc0, Acts::eBoundLoc0)));
         m_log->trace("    loc err = {:.4f}", static_cast<float>(covariance(Acts::eBoundLoc1, Acts::eBoundLoc1)));
         m_log->trace("    loc err = {:.4f}", static_cast<float>(covariance(Acts::eBoundLoc0, Acts::eBoundLoc1)));
 
-        uint64_t surface = targetSurf->geometryId().value();
+        uint64_t surface = targetSurf.geometryId().value();
         uint32_t system = 0; // default value...will be set in TrackPropagation factory
 
         /*
@@ -350,7 +427,7 @@ void TrackPropagation::propagateToSurfaceList(
                                                theta,
                                                phi,
                                                directionError,
-                                               pathLength,
+                                               static_cast<float>(pathLength),
                                                pathLengthError
                                        });
     }
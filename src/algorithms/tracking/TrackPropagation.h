@@ -7,6 +7,9 @@
 #include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Geometry/GeometryIdentifier.hpp>
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <Acts/MagneticField/MagneticFieldProvider.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/Propagator.hpp>
 #include <Acts/Surfaces/Surface.hpp>
 #include <Acts/Utilities/Result.hpp>
 #include <ActsExamples/EventData/Track.hpp>
@@ -19,7 +22,9 @@
 #include <spdlog/logger.h>
 #include <stddef.h>
 #include <memory>
+#include <optional>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -42,31 +47,12 @@ namespace eicrecon {
         /** Initialize algorithm */
         void init(const dd4hep::Detector* detector, std::shared_ptr<const ActsGeometryProvider> geo_svc, std::shared_ptr<spdlog::logger> logger);
 
+        /** Initialize algorithm with a given magnetic field, e.g. without a tracking geometry in tests */
+        void init(const dd4hep::Detector* detector, std::shared_ptr<const Acts::MagneticFieldProvider> field, std::shared_ptr<spdlog::logger> logger);
+
         void process(
                 const std::tuple<const edm4eic::TrackCollection&, const std::vector<const ActsExamples::Trajectories*>, const std::vector<const ActsExamples::ConstTrackContainer*>> input,
-                const std::tuple<edm4eic::TrackSegmentCollection*> output) const {
-
-            const auto [tracks, acts_trajectories, acts_tracks] = input;
-            auto [propagated_tracks] = output;
-
-            for (size_t i = 0; auto traj: acts_trajectories) {
-                auto this_propagated_track = propagated_tracks->create();
-                if (tracks.size() == acts_trajectories.size()) {
-                    m_log->trace("track segment connected to track {}", i);
-                    this_propagated_track.setTrack(tracks[i]);
-                }
-                for (auto& surf : m_target_surfaces) {
-                    auto prop_point = propagate(
-                        tracks.size() == acts_trajectories.size() ? tracks[i] : edm4eic::Track{},
-                        traj, surf);
-                    if (!prop_point) continue;
-                    prop_point->surface = surf->geometryId().layer();
-                    prop_point->system  = surf->geometryId().extra();
-                    this_propagated_track.addToPoints(*prop_point);
-                }
-                ++i;
-            }
-        }
+                const std::tuple<edm4eic::TrackSegmentCollection*> output) const;
 
         /** Propagates a single trajectory to a given surface */
         std::unique_ptr<edm4eic::TrackPoint> propagate(
@@ -74,7 +60,9 @@ namespace eicrecon {
             const ActsExamples::Trajectories*,
             const std::shared_ptr<const Acts::Surface>& targetSurf) const;
 
-        /** Propagates a collection of trajectories to a list of surfaces, and returns the full `TrackSegment`;
+        /** Propagates a collection of trajectories to a list of surfaces, and returns the full `TrackSegment`.
+         * The target surfaces must be ordered along the trajectories: each trajectory is stepped
+         * through once, continuing from its intersection with the previous surface.
          * @param trajectories the input collection of trajectories
          * @return the resulting collection of propagated tracks
          */
@@ -84,10 +72,25 @@ namespace eicrecon {
 
     private:
 
+        using Stepper = Acts::EigenStepper<>;
+        using Propagator = Acts::Propagator<Stepper>;
+
+        /** Propagates bound parameters to a surface, returns the parameters there and the path length */
+        std::optional<std::pair<Acts::BoundTrackParameters, double>> propagate(
+            const Acts::BoundTrackParameters& start,
+            const Acts::Surface& targetSurf) const;
+
+        /** Track point from bound parameters on the target surface */
+        std::unique_ptr<edm4eic::TrackPoint> trackPoint(
+            const Acts::BoundTrackParameters& parameters,
+            const Acts::Surface& targetSurf,
+            double pathLength) const;
+
         Acts::GeometryContext m_geoContext;
         Acts::MagneticFieldContext m_fieldContext;
         std::shared_ptr<const ActsGeometryProvider> m_geoSvc;
         std::shared_ptr<spdlog::logger> m_log;
+        std::unique_ptr<const Propagator> m_propagator;
 
         std::vector<std::shared_ptr<Acts::Surface>> m_filter_surfaces;
         std::vector<std::shared_ptr<Acts::Surface>> m_target_surfaces;
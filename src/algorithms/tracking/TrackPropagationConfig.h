@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -34,6 +36,10 @@ namespace eicrecon {
       [](const edm4eic::TrackPoint&) { return true; }
     };
     bool skip_track_on_track_point_cut_failure{false};
+
+    // Trajectories of an event are propagated on up to this many threads, the event's thread and
+    // threads of the shared algorithms::TaskPoolSvc, 0 uses all of them. Results are identical either way.
+    size_t maxThreads{1};
   };
 
 } // eicrecon
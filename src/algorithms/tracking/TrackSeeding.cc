@@ -25,8 +25,10 @@
 #include <cmath>
 #include <functional>
 #include <limits>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace
 {
@@ -47,77 +49,122 @@ void eicrecon::TrackSeeding::init(std::shared_ptr<const ActsGeometryProvider> ge
     configure();
 }
 
-void eicrecon::TrackSeeding::configure() {
+std::pair<Acts::SeedFinderOrthogonalConfig<eicrecon::SpacePoint>, Acts::SeedFinderOptions>
+eicrecon::orthogonalSeedFinderConfig(const OrthogonalTrackSeedingConfig& cfg) {
+
+    Acts::SeedFilterConfig seedFilterConfig;
+    Acts::SeedFinderOrthogonalConfig<eicrecon::SpacePoint> seedFinderConfig;
+    Acts::SeedFinderOptions seedFinderOptions;
 
     // Filter parameters
-    m_seedFilterConfig.maxSeedsPerSpM        = m_cfg.maxSeedsPerSpM_filter;
-    m_seedFilterConfig.deltaRMin             = m_cfg.deltaRMin;
-    m_seedFilterConfig.seedConfirmation      = m_cfg.seedConfirmation;
-    m_seedFilterConfig.deltaInvHelixDiameter = m_cfg.deltaInvHelixDiameter;
-    m_seedFilterConfig.impactWeightFactor    = m_cfg.impactWeightFactor;
-    m_seedFilterConfig.zOriginWeightFactor   = m_cfg.zOriginWeightFactor;
-    m_seedFilterConfig.compatSeedWeight      = m_cfg.compatSeedWeight;
-    m_seedFilterConfig.compatSeedLimit       = m_cfg.compatSeedLimit;
-    m_seedFilterConfig.seedWeightIncrement   = m_cfg.seedWeightIncrement;
-
-    m_seedFilterConfig.centralSeedConfirmationRange = Acts::SeedConfirmationRangeConfig{
-      m_cfg.zMinSeedConfCentral,
-      m_cfg.zMaxSeedConfCentral,
-      m_cfg.rMaxSeedConfCentral,
-      m_cfg.nTopForLargeRCentral,
-      m_cfg.nTopForSmallRCentral,
-      m_cfg.seedConfMinBottomRadiusCentral,
-      m_cfg.seedConfMaxZOriginCentral,
-      m_cfg.minImpactSeedConfCentral
+    seedFilterConfig.maxSeedsPerSpM        = cfg.maxSeedsPerSpM_filter;
+    seedFilterConfig.deltaRMin             = cfg.deltaRMin;
+    seedFilterConfig.seedConfirmation      = cfg.seedConfirmation;
+    seedFilterConfig.deltaInvHelixDiameter = cfg.deltaInvHelixDiameter;
+    seedFilterConfig.impactWeightFactor    = cfg.impactWeightFactor;
+    seedFilterConfig.zOriginWeightFactor   = cfg.zOriginWeightFactor;
+    seedFilterConfig.compatSeedWeight      = cfg.compatSeedWeight;
+    seedFilterConfig.compatSeedLimit       = cfg.compatSeedLimit;
+    seedFilterConfig.seedWeightIncrement   = cfg.seedWeightIncrement;
+
+    seedFilterConfig.centralSeedConfirmationRange = Acts::SeedConfirmationRangeConfig{
+      cfg.zMinSeedConfCentral,
+      cfg.zMaxSeedConfCentral,
+      cfg.rMaxSeedConfCentral,
+      cfg.nTopForLargeRCentral,
+      cfg.nTopForSmallRCentral,
+      cfg.seedConfMinBottomRadiusCentral,
+      cfg.seedConfMaxZOriginCentral,
+      cfg.minImpactSeedConfCentral
     };
 
-    m_seedFilterConfig.forwardSeedConfirmationRange = Acts::SeedConfirmationRangeConfig{
-      m_cfg.zMinSeedConfForward,
-      m_cfg.zMaxSeedConfForward,
-      m_cfg.rMaxSeedConfForward,
-      m_cfg.nTopForLargeRForward,
-      m_cfg.nTopForSmallRForward,
-      m_cfg.seedConfMinBottomRadiusForward,
-      m_cfg.seedConfMaxZOriginForward,
-      m_cfg.minImpactSeedConfForward
+    seedFilterConfig.forwardSeedConfirmationRange = Acts::SeedConfirmationRangeConfig{
+      cfg.zMinSeedConfForward,
+      cfg.zMaxSeedConfForward,
+      cfg.rMaxSeedConfForward,
+      cfg.nTopForLargeRForward,
+      cfg.nTopForSmallRForward,
+      cfg.seedConfMinBottomRadiusForward,
+      cfg.seedConfMaxZOriginForward,
+      cfg.minImpactSeedConfForward
     };
 
-    m_seedFilterConfig = m_seedFilterConfig.toInternalUnits();
+    seedFilterConfig = seedFilterConfig.toInternalUnits();
 
     // Finder parameters
-    m_seedFinderConfig.seedFilter = std::make_unique<Acts::SeedFilter<eicrecon::SpacePoint>>(Acts::SeedFilter<eicrecon::SpacePoint>(m_seedFilterConfig));
-    m_seedFinderConfig.rMax               = m_cfg.rMax;
-    m_seedFinderConfig.deltaRMinTopSP     = m_cfg.deltaRMinTopSP;
-    m_seedFinderConfig.deltaRMaxTopSP     = m_cfg.deltaRMaxTopSP;
-    m_seedFinderConfig.deltaRMinBottomSP  = m_cfg.deltaRMinBottomSP;
-    m_seedFinderConfig.deltaRMaxBottomSP  = m_cfg.deltaRMaxBottomSP;
-    m_seedFinderConfig.collisionRegionMin = m_cfg.collisionRegionMin;
-    m_seedFinderConfig.collisionRegionMax = m_cfg.collisionRegionMax;
-    m_seedFinderConfig.zMin               = m_cfg.zMin;
-    m_seedFinderConfig.zMax               = m_cfg.zMax;
-    m_seedFinderConfig.maxSeedsPerSpM     = m_cfg.maxSeedsPerSpM;
-    m_seedFinderConfig.cotThetaMax        = m_cfg.cotThetaMax;
-    m_seedFinderConfig.sigmaScattering    = m_cfg.sigmaScattering;
-    m_seedFinderConfig.radLengthPerSeed   = m_cfg.radLengthPerSeed;
-    m_seedFinderConfig.minPt              = m_cfg.minPt;
-    m_seedFinderConfig.impactMax          = m_cfg.impactMax;
-    m_seedFinderConfig.rMinMiddle         = m_cfg.rMinMiddle;
-    m_seedFinderConfig.rMaxMiddle         = m_cfg.rMaxMiddle;
-
-    m_seedFinderOptions.beamPos   = Acts::Vector2(m_cfg.beamPosX, m_cfg.beamPosY);
-    m_seedFinderOptions.bFieldInZ = m_cfg.bFieldInZ;
-
-    m_seedFinderConfig =
-      m_seedFinderConfig.toInternalUnits().calculateDerivedQuantities();
-    m_seedFinderOptions =
-      m_seedFinderOptions.toInternalUnits().calculateDerivedQuantities(m_seedFinderConfig);
+    seedFinderConfig.seedFilter = std::make_unique<Acts::SeedFilter<eicrecon::SpacePoint>>(Acts::SeedFilter<eicrecon::SpacePoint>(seedFilterConfig));
+    seedFinderConfig.rMax               = cfg.rMax;
+    seedFinderConfig.deltaRMinTopSP     = cfg.deltaRMinTopSP;
+    seedFinderConfig.deltaRMaxTopSP     = cfg.deltaRMaxTopSP;
+    seedFinderConfig.deltaRMinBottomSP  = cfg.deltaRMinBottomSP;
+    seedFinderConfig.deltaRMaxBottomSP  = cfg.deltaRMaxBottomSP;
+    seedFinderConfig.collisionRegionMin = cfg.collisionRegionMin;
+    seedFinderConfig.collisionRegionMax = cfg.collisionRegionMax;
+    seedFinderConfig.zMin               = cfg.zMin;
+    seedFinderConfig.zMax               = cfg.zMax;
+    seedFinderConfig.maxSeedsPerSpM     = cfg.maxSeedsPerSpM;
+    seedFinderConfig.cotThetaMax        = cfg.cotThetaMax;
+    seedFinderConfig.sigmaScattering    = cfg.sigmaScattering;
+    seedFinderConfig.radLengthPerSeed   = cfg.radLengthPerSeed;
+    seedFinderConfig.minPt              = cfg.minPt;
+    seedFinderConfig.impactMax          = cfg.impactMax;
+    seedFinderConfig.rMinMiddle         = cfg.rMinMiddle;
+    seedFinderConfig.rMaxMiddle         = cfg.rMaxMiddle;
+
+    seedFinderOptions.beamPos   = Acts::Vector2(cfg.beamPosX, cfg.beamPosY);
+    seedFinderOptions.bFieldInZ = cfg.bFieldInZ;
+
+    seedFinderConfig =
+      seedFinderConfig.toInternalUnits().calculateDerivedQuantities();
+    seedFinderOptions =
+      seedFinderOptions.toInternalUnits().calculateDerivedQuantities(seedFinderConfig);
+
+    return {std::move(seedFinderConfig), std::move(seedFinderOptions)};
+}
 
+eicrecon::HoughSeedFinder::Config eicrecon::houghSeedFinderConfig(const OrthogonalTrackSeedingConfig& cfg) {
+    return {
+      .rMin          = cfg.rMin,
+      .rMax          = cfg.rMax,
+      .zMin          = cfg.zMin,
+      .zMax          = cfg.zMax,
+      .phiBins       = cfg.houghPhiBins,
+      .curvatureBins = cfg.houghCurvatureBins,
+      .curvatureMax  = cfg.bFieldInZ / cfg.houghMinPt, // 1/R[mm] = B[GeV/mm] / pt[GeV]
+      .cotThetaBins  = cfg.houghCotThetaBins,
+      .cotThetaMax   = cfg.cotThetaMax,
+      .z0Bins        = cfg.houghZ0Bins,
+      .z0Min         = cfg.collisionRegionMin,
+      .z0Max         = cfg.collisionRegionMax,
+      .minHits       = cfg.houghMinHits,
+      .deltaRMin     = cfg.deltaRMin,
+    };
+}
+
+void eicrecon::TrackSeeding::configure() {
+
+    std::tie(m_seedFinderConfig, m_seedFinderOptions) = orthogonalSeedFinderConfig(m_cfg);
+
+    if (m_cfg.seeder == "hough") {
+      m_houghSeedFinder.emplace(houghSeedFinderConfig(m_cfg));
+    } else if (m_cfg.seeder != "orthogonal") {
+      throw std::invalid_argument("TrackSeeding: unknown seeder '" + m_cfg.seeder + "', expected orthogonal or hough");
+    }
 }
 
 std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::produce(const edm4eic::TrackerHitCollection& trk_hits) {
 
-  std::vector<const eicrecon::SpacePoint*> spacePoints = getSpacePoints(trk_hits);
+  fillSpacePoints(trk_hits);
+
+  eicrecon::SeedContainer seeds = m_houghSeedFinder ? findHoughSeeds() : findOrthogonalSeeds();
 
+  std::unique_ptr<edm4eic::TrackParametersCollection> trackparams = makeTrackParams(seeds);
+
+  return std::move(trackparams);
+}
+
+eicrecon::SeedContainer eicrecon::TrackSeeding::findOrthogonalSeeds()
+{
   Acts::SeedFinderOrthogonal<eicrecon::SpacePoint> finder(m_seedFinderConfig); // FIXME move into class scope
 
   std::function<std::pair<Acts::Vector3, Acts::Vector2>(
@@ -128,45 +175,59 @@ std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::prod
         return std::make_pair(position, variance);
       };
 
-  eicrecon::SeedContainer seeds = finder.createSeeds(m_seedFinderOptions, spacePoints, create_coordinates);
-
-  std::unique_ptr<edm4eic::TrackParametersCollection> trackparams = makeTrackParams(seeds);
+  return finder.createSeeds(m_seedFinderOptions, m_spacePointPtrs, create_coordinates);
+}
 
-  for (auto& sp: spacePoints) {
-    delete sp;
+eicrecon::SeedContainer eicrecon::TrackSeeding::findHoughSeeds()
+{
+  m_houghSeeds.clear();
+  m_houghSeedFinder->find(m_spacePoints.rValues(), m_spacePoints.phiValues(), m_spacePoints.zValues(), m_houghSeeds);
+
+  eicrecon::SeedContainer seeds;
+  seeds.reserve(m_houghSeeds.size());
+  for (const auto& seed : m_houghSeeds) {
+    seeds.emplace_back(m_spacePointHandles[seed.spacePoints[0]],
+                       m_spacePointHandles[seed.spacePoints[1]],
+                       m_spacePointHandles[seed.spacePoints[2]],
+                       seed.z0, static_cast<float>(seed.hits));
   }
-
-  return std::move(trackparams);
+  return seeds;
 }
 
-std::vector<const eicrecon::SpacePoint*> eicrecon::TrackSeeding::getSpacePoints(const edm4eic::TrackerHitCollection& trk_hits)
+void eicrecon::TrackSeeding::fillSpacePoints(const edm4eic::TrackerHitCollection& trk_hits)
 {
-  std::vector<const eicrecon::SpacePoint*> spacepoints;
-
+  m_spacePoints.clear();
+  m_spacePointHandles.clear();
+  m_spacePointPtrs.clear();
+  m_spacePoints.reserve(trk_hits.size());
+  m_spacePointHandles.reserve(trk_hits.size());
+  m_spacePointPtrs.reserve(trk_hits.size());
+
+  const auto& surfaces = m_geoSvc->surfaceTable();
   for(const auto hit : trk_hits)
     {
-      const eicrecon::SpacePoint* sp = new SpacePoint(hit);
-      spacepoints.push_back(sp);
+      m_spacePoints.push_back(hit, surfaces.find(hit.getCellID()));
     }
 
-  return spacepoints;
+  // handles are only taken once the container is filled and will not reallocate
+  for(std::size_t i = 0; i < m_spacePoints.size(); ++i)
+    {
+      m_spacePointPtrs.push_back(&m_spacePointHandles.emplace_back(m_spacePoints, i));
+    }
 }
 
 std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::makeTrackParams(SeedContainer& seeds)
 {
   auto trackparams = std::make_unique<edm4eic::TrackParametersCollection>();
 
-  for(auto& seed : seeds)
+  SeedFits fits;
+  fitSeeds(seeds, fits);
+
+  for(std::size_t iseed = 0; iseed < seeds.size(); ++iseed)
     {
-      std::vector<std::pair<float,float>> xyHitPositions;
-      std::vector<std::pair<float,float>> rzHitPositions;
-      for(const auto& spptr : seed.sp())
-        {
-          xyHitPositions.emplace_back(spptr->x(), spptr->y());
-          rzHitPositions.emplace_back(spptr->r(), spptr->z());
-        }
-
-      auto RX0Y0 = circleFit(xyHitPositions);
+      const auto& seed = seeds[iseed];
+
+      auto RX0Y0 = std::make_tuple(fits.R[iseed], fits.X0[iseed], fits.Y0[iseed]);
       float R = std::get<0>(RX0Y0);
       float X0 = std::get<1>(RX0Y0);
       float Y0 = std::get<2>(RX0Y0);
@@ -183,14 +244,14 @@ std::unique_ptr<edm4eic::TrackParametersCollection> eicrecon::TrackSeeding::make
         continue;
       }
 
-      auto slopeZ0 = lineFit(rzHitPositions);
       const auto xypos = findPCA(RX0Y0);
 
 
       //Determine charge
-      int charge = determineCharge(xyHitPositions, xypos, RX0Y0);
+      const auto& firstsp = seed.sp().front();
+      int charge = determineCharge({firstsp->x(), firstsp->y()}, xypos, RX0Y0);
 
-      float theta = atan(1./std::get<0>(slopeZ0));
+      float theta = atan(1./fits.slope[iseed]);
       // normalize to 0<theta<pi
       if(theta < 0)
         { theta += M_PI; }
@@ -261,10 +322,9 @@ std::pair<float, float> eicrecon::TrackSeeding::findPCA(std::tuple<float,float,f
   return std::make_pair(xmin,ymin);
 }
 
-int eicrecon::TrackSeeding::determineCharge(std::vector<std::pair<float,float>>& positions, const std::pair<float,float>& PCA, std::tuple<float,float,float>& RX0Y0) const
+int eicrecon::TrackSeeding::determineCharge(const std::pair<float,float>& firstpos, const std::pair<float,float>& PCA, std::tuple<float,float,float>& RX0Y0) const
 {
 
-  const auto& firstpos = positions.at(0);
   auto hit_x = firstpos.first;
   auto hit_y = firstpos.second;
 
@@ -297,114 +357,128 @@ int eicrecon::TrackSeeding::determineCharge(std::vector<std::pair<float,float>>&
    * It still has a small bias and its statistical accuracy is slightly lower than that of the geometric fit (minimizing geometric distances),
    * It provides a very good initial guess for a subsequent geometric fit.
    * Nikolai Chernov  (September 2012)
+   *
+   * The circle fit in xy is followed by a straight line fit in rz.
    */
-std::tuple<float,float,float> eicrecon::TrackSeeding::circleFit(std::vector<std::pair<float,float>>& positions) const
+void eicrecon::TrackSeeding::fitSeeds(const SeedContainer& seeds, SeedFits& fits) const
 {
-  // Compute x- and y- sample means
-  double meanX = 0;
-  double meanY = 0;
-  double weight = 0;
-
-  for( const auto& [x,y] : positions)
-  {
-    meanX += x;
-    meanY += y;
-    ++weight;
-  }
-  meanX /= weight;
-  meanY /= weight;
-
-  //     computing moments
-
-  double Mxx = 0;
-  double Myy = 0;
-  double Mxy = 0;
-  double Mxz = 0;
-  double Myz = 0;
-  double Mzz = 0;
-
-  for (auto& [x,y] : positions)
-  {
-    double Xi = x - meanX;   //  centered x-coordinates
-    double Yi = y - meanY;   //  centered y-coordinates
-double Zi = std::pow(Xi,2) + std::pow(Yi,2);
-
-    Mxy += Xi*Yi;
-    Mxx += Xi*Xi;
-    Myy += Yi*Yi;
-    Mxz += Xi*Zi;
-    Myz += Yi*Zi;
-    Mzz += Zi*Zi;
+  const std::size_t n = seeds.size();
+  const std::size_t npts = 3; // space points per seed
+
+  // Hit coordinates of point k of seed s at [k * n + s], so that the loops over seeds are contiguous
+  std::vector<double> xs(npts * n), ys(npts * n), rs(npts * n), zs(npts * n);
+  for (std::size_t s = 0; s < n; ++s) {
+    for (std::size_t k = 0; k < npts; ++k) {
+      const auto* sp = seeds[s].sp()[k];
+      xs[k * n + s] = sp->x();
+      ys[k * n + s] = sp->y();
+      rs[k * n + s] = sp->r();
+      zs[k * n + s] = sp->z();
+    }
   }
-  Mxx /= weight;
-  Myy /= weight;
-  Mxy /= weight;
-  Mxz /= weight;
-  Myz /= weight;
-  Mzz /= weight;
-
-  //  computing coefficients of the characteristic polynomial
-
-  const double Mz = Mxx + Myy;
-  const double Cov_xy = Mxx*Myy - Mxy*Mxy;
-  const double Var_z = Mzz - Mz*Mz;
-  const double A3 = 4*Mz;
-  const double A2 = -3*Mz*Mz - Mzz;
-  const double A1 = Var_z*Mz + 4*Cov_xy*Mz - Mxz*Mxz - Myz*Myz;
-  const double A0 = Mxz*(Mxz*Myy - Myz*Mxy) + Myz*(Myz*Mxx - Mxz*Mxy) - Var_z*Cov_xy;
-  const double A22 = A2 + A2;
-  const double A33 = A3 + A3 + A3;
-
-  //    finding the root of the characteristic polynomial
-  //    using Newton's method starting at x=0
-  //    (it is guaranteed to converge to the right root)
-  static constexpr int iter_max = 99;
-  double x = 0;
-  double y = A0;
-
-  // usually, 4-6 iterations are enough
-  for( int iter=0; iter<iter_max; ++iter)
-  {
-    const double Dy = A1 + x*(A22 + A33*x);
-    const double xnew = x - y/Dy;
-    if ((xnew == x)||(!std::isfinite(xnew))) break;
-
-    const double ynew = A0 + xnew*(A1 + xnew*(A2 + xnew*A3));
-    if (std::abs(ynew)>=std::abs(y))  break;
-
-    x = xnew;  y = ynew;
 
+  fits.R.resize(n);
+  fits.X0.resize(n);
+  fits.Y0.resize(n);
+  fits.slope.resize(n);
+  fits.intercept.resize(n);
+
+  // Compute x- and y- sample means and moments
+  std::vector<double> meanX(n, 0.), meanY(n, 0.);
+  std::vector<double> Mxx(n, 0.), Myy(n, 0.), Mxy(n, 0.), Mxz(n, 0.), Myz(n, 0.), Mzz(n, 0.);
+  const double weight = npts;
+  for (std::size_t k = 0; k < npts; ++k) {
+    for (std::size_t s = 0; s < n; ++s) {
+      meanX[s] += xs[k * n + s];
+      meanY[s] += ys[k * n + s];
+    }
+  }
+  for (std::size_t s = 0; s < n; ++s) {
+    meanX[s] /= weight;
+    meanY[s] /= weight;
+  }
+  for (std::size_t k = 0; k < npts; ++k) {
+    for (std::size_t s = 0; s < n; ++s) {
+      const double Xi = xs[k * n + s] - meanX[s];   //  centered x-coordinates
+      const double Yi = ys[k * n + s] - meanY[s];   //  centered y-coordinates
+      const double Zi = Xi*Xi + Yi*Yi;
+
+      Mxy[s] += Xi*Yi;
+      Mxx[s] += Xi*Xi;
+      Myy[s] += Yi*Yi;
+      Mxz[s] += Xi*Zi;
+      Myz[s] += Yi*Zi;
+      Mzz[s] += Zi*Zi;
+    }
   }
 
-  //  computing parameters of the fitting circle
-  const double DET = std::pow(x,2) - x*Mz + Cov_xy;
-  const double Xcenter = (Mxz*(Myy - x) - Myz*Mxy)/DET/2;
-  const double Ycenter = (Myz*(Mxx - x) - Mxz*Mxy)/DET/2;
+  for (std::size_t s = 0; s < n; ++s) {
+    const double mxx = Mxx[s] / weight;
+    const double myy = Myy[s] / weight;
+    const double mxy = Mxy[s] / weight;
+    const double mxz = Mxz[s] / weight;
+    const double myz = Myz[s] / weight;
+    const double mzz = Mzz[s] / weight;
+
+    //  computing coefficients of the characteristic polynomial
+
+    const double Mz = mxx + myy;
+    const double Cov_xy = mxx*myy - mxy*mxy;
+    const double Var_z = mzz - Mz*Mz;
+    const double A3 = 4*Mz;
+    const double A2 = -3*Mz*Mz - mzz;
+    const double A1 = Var_z*Mz + 4*Cov_xy*Mz - mxz*mxz - myz*myz;
+    const double A0 = mxz*(mxz*myy - myz*mxy) + myz*(myz*mxx - mxz*mxy) - Var_z*Cov_xy;
+    const double A22 = A2 + A2;
+    const double A33 = A3 + A3 + A3;
+
+    //    finding the root of the characteristic polynomial
+    //    using Newton's method starting at x=0
+    //    (it is guaranteed to converge to the right root)
+    static constexpr int iter_max = 99;
+    double x = 0;
+    double y = A0;
+
+    // usually, 4-6 iterations are enough
+    for( int iter=0; iter<iter_max; ++iter)
+    {
+      const double Dy = A1 + x*(A22 + A33*x);
+      const double xnew = x - y/Dy;
+      if ((xnew == x)||(!std::isfinite(xnew))) break;
 
-  //  assembling the output
-  float X0 = Xcenter + meanX;
-  float Y0 = Ycenter + meanY;
-  float R = std::sqrt( std::pow(Xcenter,2) + std::pow(Ycenter,2) + Mz);
-  return std::make_tuple( R, X0, Y0 );
-}
+      const double ynew = A0 + xnew*(A1 + xnew*(A2 + xnew*A3));
+      if (std::abs(ynew)>=std::abs(y))  break;
 
-std::tuple<float,float> eicrecon::TrackSeeding::lineFit(std::vector<std::pair<float,float>>& positions) const
-{
-  double xsum=0;
-  double x2sum=0;
-  double ysum=0;
-  double xysum=0;
-  for( const auto& [r,z]:positions )
-  {
-    xsum=xsum+r;                        //calculate sigma(xi)
-    ysum=ysum+z;                        //calculate sigma(yi)
-    x2sum=x2sum+std::pow(r,2);              //calculate sigma(x^2i)
-    xysum=xysum+r*z;                    //calculate sigma(xi*yi)
+      x = xnew;  y = ynew;
+
+    }
+
+    //  computing parameters of the fitting circle
+    const double DET = x*x - x*Mz + Cov_xy;
+    const double Xcenter = (mxz*(myy - x) - myz*mxy)/DET/2;
+    const double Ycenter = (myz*(mxx - x) - mxz*mxy)/DET/2;
+
+    //  assembling the output
+    fits.X0[s] = Xcenter + meanX[s];
+    fits.Y0[s] = Ycenter + meanY[s];
+    fits.R[s] = std::sqrt(Xcenter*Xcenter + Ycenter*Ycenter + Mz);
   }
 
-  const auto npts = positions.size();
-  const double denominator = (x2sum*npts-std::pow(xsum,2));
-  const float a= (xysum*npts-xsum*ysum)/denominator;            //calculate slope
-  const float b= (x2sum*ysum-xsum*xysum)/denominator;           //calculate intercept
-  return std::make_tuple( a, b );
+  // Line fit in rz
+  std::vector<double> xsum(n, 0.), x2sum(n, 0.), ysum(n, 0.), xysum(n, 0.);
+  for (std::size_t k = 0; k < npts; ++k) {
+    for (std::size_t s = 0; s < n; ++s) {
+      const double r = rs[k * n + s];
+      const double z = zs[k * n + s];
+      xsum[s] += r;                        //calculate sigma(xi)
+      ysum[s] += z;                        //calculate sigma(yi)
+      x2sum[s] += r*r;                     //calculate sigma(x^2i)
+      xysum[s] += r*z;                     //calculate sigma(xi*yi)
+    }
+  }
+  for (std::size_t s = 0; s < n; ++s) {
+    const double denominator = (x2sum[s]*npts - xsum[s]*xsum[s]);
+    fits.slope[s] = (xysum[s]*npts - xsum[s]*ysum[s])/denominator;         //calculate slope
+    fits.intercept[s] = (x2sum[s]*ysum[s] - xsum[s]*xysum[s])/denominator; //calculate intercept
+  }
 }
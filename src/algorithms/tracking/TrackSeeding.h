@@ -5,7 +5,6 @@
 #pragma once
 
 #include <Acts/MagneticField/MagneticFieldContext.hpp>
-#include <Acts/Seeding/SeedFilterConfig.hpp>
 #include <Acts/Seeding/SeedFinderConfig.hpp>
 #include <Acts/Seeding/SeedFinderOrthogonalConfig.hpp>
 #include <edm4eic/TrackParametersCollection.h>
@@ -13,18 +12,25 @@
 #include <spdlog/logger.h>
 #include <cstddef> // IWYU pragma: keep FIXME size_t missing in SeedConfirmationRangeConfig.hpp until Acts 27.2.0 (maybe even later)
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include "ActsGeometryProvider.h"
 #include "DD4hepBField.h"
+#include "HoughSeedFinder.h"
 #include "OrthogonalTrackSeedingConfig.h"
 #include "SpacePoint.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 
 
 namespace eicrecon {
+    /// Configurations of the seeders derived from the seeding configuration, as used by TrackSeeding
+    std::pair<Acts::SeedFinderOrthogonalConfig<SpacePoint>, Acts::SeedFinderOptions>
+    orthogonalSeedFinderConfig(const OrthogonalTrackSeedingConfig& cfg);
+    HoughSeedFinder::Config houghSeedFinderConfig(const OrthogonalTrackSeedingConfig& cfg);
+
     class TrackSeeding:
             public eicrecon::WithPodConfig<eicrecon::OrthogonalTrackSeedingConfig> {
     public:
@@ -40,16 +46,32 @@ namespace eicrecon {
         std::shared_ptr<const eicrecon::BField::DD4hepBField> m_BField = nullptr;
         Acts::MagneticFieldContext m_fieldctx;
 
-        Acts::SeedFilterConfig m_seedFilterConfig;
         Acts::SeedFinderOptions m_seedFinderOptions;
         Acts::SeedFinderOrthogonalConfig<SpacePoint> m_seedFinderConfig;
 
-        int determineCharge(std::vector<std::pair<float,float>>& positions, const std::pair<float,float>& PCA, std::tuple<float,float,float>& RX0Y0) const;
+        /// Circle fits (R, X0, Y0) in xy and line fits (slope, intercept) in rz, one entry per seed
+        struct SeedFits {
+            std::vector<float> R, X0, Y0;
+            std::vector<float> slope, intercept;
+        };
+
+        int determineCharge(const std::pair<float,float>& firstpos, const std::pair<float,float>& PCA, std::tuple<float,float,float>& RX0Y0) const;
         std::pair<float,float> findPCA(std::tuple<float,float,float>& circleParams) const;
-        std::vector<const eicrecon::SpacePoint*> getSpacePoints(const edm4eic::TrackerHitCollection& trk_hits);
+        void fillSpacePoints(const edm4eic::TrackerHitCollection& trk_hits);
         std::unique_ptr<edm4eic::TrackParametersCollection> makeTrackParams(SeedContainer& seeds);
+        SeedContainer findOrthogonalSeeds();
+        SeedContainer findHoughSeeds();
+
+        /// Fits all seeds at once, each pass loops over the seeds so that it can be vectorised
+        void fitSeeds(const SeedContainer& seeds, SeedFits& fits) const;
+
+        /// Space points of the current event, kept to reuse their storage
+        SpacePointContainer m_spacePoints;
+        std::vector<SpacePoint> m_spacePointHandles;
+        std::vector<const SpacePoint*> m_spacePointPtrs;
 
-        std::tuple<float,float,float> circleFit(std::vector<std::pair<float,float>>& positions) const;
-        std::tuple<float,float> lineFit(std::vector<std::pair<float,float>>& positions) const;
+        /// Only set if the Hough seeder is selected
+        std::optional<HoughSeedFinder> m_houghSeedFinder;
+        std::vector<HoughSeedFinder::Seed> m_houghSeeds;
     };
 }
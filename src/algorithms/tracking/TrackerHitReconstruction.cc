@@ -6,15 +6,24 @@
 #include <Evaluator/DD4hepUnits.h>
 #include <Math/GenVector/Cartesian3D.h>
 #include <Math/GenVector/DisplacementVector3D.h>
+#include <algorithms/service.h>
 #include <edm4eic/CovDiag3f.h>
 #include <edm4hep/Vector3f.h>
 #include <fmt/core.h>
 #include <spdlog/common.h>
 #include <stddef.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <iterator>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "services/geometry/cellgeo/CellGeoSvc.h"
+#include "services/geometry/cellgeo/ReadoutCells.h"
+
 namespace eicrecon {
 
 namespace {
@@ -28,16 +37,32 @@ namespace {
     }
 } // namespace
 
-void TrackerHitReconstruction::init(const dd4hep::rec::CellIDPositionConverter* converter, std::shared_ptr<spdlog::logger>& logger) {
+void TrackerHitReconstruction::init(const dd4hep::Detector* detector, const dd4hep::rec::CellIDPositionConverter* converter, std::shared_ptr<spdlog::logger>& logger) {
 
     m_log = logger;
 
     m_converter = converter;
+
+    // cell geometry only depends on the cellID, share it between all instances for the same readout
+    auto& serviceSvc = algorithms::ServiceSvc::instance();
+    m_cell_geometry = &serviceSvc.service<CellGeoSvc>("CellGeoSvc")->cache<CellGeometry>(
+        m_cfg.readout.empty() ? std::string("TrackerHitReconstruction") : "TrackerHitReconstruction/" + m_cfg.readout,
+        m_cfg.readout);
+
+    if (m_cfg.prefillCellGeometry) {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            const std::size_t n_cells = prefill_readout_cells(*m_cell_geometry, *detector, m_cfg.readout,
+                                                              [this](uint64_t cellID) { return cell_geometry(cellID); });
+            m_log->debug("Prefilled cell geometry of {} cells of {} in {:.3f} s", n_cells, m_cfg.readout,
+                         std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        } catch (std::exception& e) {
+            m_log->warn("Failed to prefill cell geometry of {}: {}", m_cfg.readout, e.what());
+        }
+    }
 }
 
 std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process(const edm4eic::RawTrackerHitCollection& raw_hits) {
-    using dd4hep::mm;
-
     auto rec_hits { std::make_unique<edm4eic::TrackerHitCollection>() };
 
     for (const auto& raw_hit : raw_hits) {
@@ -45,17 +70,7 @@ std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process
         auto id = raw_hit.getCellID();
 
         // Get position and dimension
-        auto pos = m_converter->position(id);
-        auto dim = m_converter->cellDimensions(id);
-
-        // >oO trace
-        if(m_log->level() == spdlog::level::trace) {
-            m_log->trace("position x={:.2f} y={:.2f} z={:.2f} [mm]: ", pos.x()/ mm, pos.y()/ mm, pos.z()/ mm);
-            m_log->trace("dimension size: {}", dim.size());
-            for (size_t j = 0; j < std::size(dim); ++j) {
-                m_log->trace(" - dimension {:<5} size: {:.2}",  j, dim[j]);
-            }
-        }
+        const auto cell = m_cell_geometry->get(id, [this](uint64_t cellID) { return cell_geometry(cellID); });
 
         // Note about variance:
         //    The variance is used to obtain a diagonal covariance matrix.
@@ -68,9 +83,8 @@ std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process
         //    in the TrackerSourceLinker.
         rec_hits->create(
             raw_hit.getCellID(), // Raw DD4hep cell ID
-            edm4hep::Vector3f{static_cast<float>(pos.x() / mm), static_cast<float>(pos.y() / mm), static_cast<float>(pos.z() / mm)}, // mm
-            edm4eic::CovDiag3f{get_variance(dim[0] / mm), get_variance(dim[1] / mm), // variance (see note above)
-            std::size(dim) > 2 ? get_variance(dim[2] / mm) : 0.},
+            cell.position, // mm
+            cell.covariance, // variance (see note above)
                 static_cast<float>((double)(raw_hit.getTimeStamp()) / 1000.0), // ns
             m_cfg.timeResolution,                            // in ns
             static_cast<float>(raw_hit.getCharge() / 1.0e6),   // Collected energy (GeV)
@@ -81,4 +95,26 @@ std::unique_ptr<edm4eic::TrackerHitCollection> TrackerHitReconstruction::process
     return std::move(rec_hits);
 }
 
+TrackerHitReconstruction::CellGeometry TrackerHitReconstruction::cell_geometry(uint64_t id) const {
+    using dd4hep::mm;
+
+    auto pos = m_converter->position(id);
+    auto dim = m_converter->cellDimensions(id);
+
+    // >oO trace
+    if(m_log->level() == spdlog::level::trace) {
+        m_log->trace("position x={:.2f} y={:.2f} z={:.2f} [mm]: ", pos.x()/ mm, pos.y()/ mm, pos.z()/ mm);
+        m_log->trace("dimension size: {}", dim.size());
+        for (size_t j = 0; j < std::size(dim); ++j) {
+            m_log->trace(" - dimension {:<5} size: {:.2}",  j, dim[j]);
+        }
+    }
+
+    return {
+        edm4hep::Vector3f{static_cast<float>(pos.x() / mm), static_cast<float>(pos.y() / mm), static_cast<float>(pos.z() / mm)}, // mm
+        edm4eic::CovDiag3f{get_variance(dim[0] / mm), get_variance(dim[1] / mm), // variance
+        std::size(dim) > 2 ? get_variance(dim[2] / mm) : 0.}
+    };
+}
+
 } // namespace eicrecon
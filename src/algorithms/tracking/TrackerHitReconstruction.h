@@ -3,14 +3,19 @@
 
 #pragma once
 
+#include <DD4hep/Detector.h>
 #include <DDRec/CellIDPositionConverter.h>
 #include <edm4eic/RawTrackerHitCollection.h>
 #include <edm4eic/TrackerHitCollection.h>
+#include <edm4eic/CovDiag3f.h>
+#include <edm4hep/Vector3f.h>
 #include <spdlog/logger.h>
+#include <cstdint>
 #include <memory>
 
 #include "TrackerHitReconstructionConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "services/geometry/cellgeo/CellGeoSvc.h"
 
 namespace eicrecon {
 
@@ -21,7 +26,7 @@ namespace eicrecon {
 
     public:
         /// Once in a lifetime initialization
-        void init(const dd4hep::rec::CellIDPositionConverter* converter, std::shared_ptr<spdlog::logger>& logger);
+        void init(const dd4hep::Detector* detector, const dd4hep::rec::CellIDPositionConverter* converter, std::shared_ptr<spdlog::logger>& logger);
 
         /// Processes RawTrackerHit and produces a TrackerHit
         std::unique_ptr<edm4eic::TrackerHitCollection> process(const edm4eic::RawTrackerHitCollection& raw_hits);
@@ -35,5 +40,13 @@ namespace eicrecon {
 
         /// Cell ID position converter
         const dd4hep::rec::CellIDPositionConverter* m_converter;
+
+        /// Geometry of a cell as stored in the reconstructed hit
+        struct CellGeometry {
+            edm4hep::Vector3f position;
+            edm4eic::CovDiag3f covariance;
+        };
+        CellGeometry cell_geometry(uint64_t id) const;
+        CellGeoCache<CellGeometry>* m_cell_geometry{nullptr};
     };
 }
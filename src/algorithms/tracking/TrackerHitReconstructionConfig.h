@@ -3,8 +3,13 @@
 
 #pragma once
 
+#include <string>
+
 namespace eicrecon {
     struct TrackerHitReconstructionConfig {
         float timeResolution = 10;
+
+        std::string readout = ""; // the cell geometry is cached per readout
+        bool prefillCellGeometry = false; // cache the geometry of all cells of the readout at initialisation
     };
 }
@@ -15,7 +15,6 @@
 #include <DD4hep/Alignments.h>
 #include <DD4hep/DetElement.h>
 #include <DD4hep/VolumeManager.h>
-#include <DDRec/CellIDPositionConverter.h>
 #include <Evaluator/DD4hepUnits.h>
 #include <Math/GenVector/DisplacementVector3D.h>
 #include <edm4eic/CovDiag3f.h>
@@ -24,7 +23,6 @@
 #include <spdlog/common.h>
 #include <Eigen/Core>
 #include <exception>
-#include <unordered_map>
 #include <utility>
 
 
@@ -32,11 +30,9 @@ namespace eicrecon {
 
 
     void TrackerMeasurementFromHits::init(const dd4hep::Detector* detector,
-                                         const dd4hep::rec::CellIDPositionConverter* converter,
                                          std::shared_ptr<const ActsGeometryProvider> acts_context,
                                          std::shared_ptr<spdlog::logger> logger) {
         m_dd4hepGeo = detector;
-        m_converter = converter;
         m_log = logger;
         m_acts_context = std::move(acts_context);
         m_detid_b0tracker = m_dd4hepGeo->constant<int>("B0Tracker_Station_1_ID");
@@ -50,6 +46,8 @@ namespace eicrecon {
         // output collections
         auto meas2Ds = std::make_unique<edm4eic::Measurement2DCollection>();
 
+        const auto& surfaces = m_acts_context->surfaceTable();
+
         // To do: add clustering to allow forming one measurement from several hits.
         // For now, one hit = one measurement.
         for (const auto hit: trk_hits) {
@@ -59,23 +57,19 @@ namespace eicrecon {
             cov(1, 1) = hit.getPositionError().yy * mm_acts * mm_acts;
             cov(0, 1) = cov(1, 0) = 0.0;
 
-            const auto* vol_ctx = m_converter->findContext(hit.getCellID());
-            auto vol_id = vol_ctx->identifier;
-
-            auto surfaceMap = m_acts_context->surfaceMap();
+            const auto vol_id = surfaces.volumeID(hit.getCellID());
 
             // m_log->trace("Hit preparation information: {}", hit_index);
             m_log->trace("   System id: {}, Cell id: {}", hit.getCellID() &0xFF, hit.getCellID());
             m_log->trace("   cov matrix:      {:>12.2e} {:>12.2e}", cov(0,0), cov(0,1));
             m_log->trace("                    {:>12.2e} {:>12.2e}", cov(1,0), cov(1,1));
-            m_log->trace("   surfaceMap size: {}", surfaceMap.size());
+            m_log->trace("   surface table size: {}", surfaces.size());
 
-            const auto is = surfaceMap.find(vol_id);
-            if (is == m_acts_context->surfaceMap().end()) {
+            const Acts::Surface* surface = surfaces.find(hit.getCellID());
+            if (surface == nullptr) {
                 m_log->warn(" WARNING: vol_id ({})  not found in m_surfaces.", vol_id );
                 continue;
             }
-            const Acts::Surface* surface = is->second;
             // variable surf_center not used anywhere;
 
             const auto& hit_pos = hit.getPosition(); // 3d position
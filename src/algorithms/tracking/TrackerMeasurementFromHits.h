@@ -8,7 +8,6 @@
 #pragma once
 
 #include <DD4hep/Detector.h>
-#include <DDRec/CellIDPositionConverter.h>
 #include <edm4eic/Measurement2DCollection.h>
 #include <edm4eic/TrackerHitCollection.h>
 #include <spdlog/logger.h>
@@ -21,7 +20,6 @@ namespace eicrecon {
     class TrackerMeasurementFromHits {
     public:
         void init(const dd4hep::Detector* detector,
-                  const dd4hep::rec::CellIDPositionConverter* converter,
                   std::shared_ptr<const ActsGeometryProvider> acts_context,
                   std::shared_ptr<spdlog::logger> logger);
 
@@ -30,9 +28,8 @@ namespace eicrecon {
     private:
         std::shared_ptr<spdlog::logger> m_log;
 
-        /// Geometry and Cell ID position converter
+        /// Geometry
         const dd4hep::Detector* m_dd4hepGeo;
-        const dd4hep::rec::CellIDPositionConverter* m_converter;
 
         std::shared_ptr<const ActsGeometryProvider> m_acts_context;
 
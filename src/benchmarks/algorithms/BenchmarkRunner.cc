@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#include "BenchmarkRunner.h"
+
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace eicrecon::benchmarks {
+
+std::string BenchmarkCase::id() const {
+  std::string id = algorithm;
+  for (const auto& [name, value] : parameters) {
+    id += fmt::format("/{}={}", name, value);
+  }
+  return id;
+}
+
+BenchmarkResult BenchmarkRunner::measure(const BenchmarkCase& benchmark) const {
+  PreparedBenchmark prepared = benchmark.prepare();
+
+  // Warm up caches and lazily initialised state
+  prepared.run();
+
+  std::vector<double> times_ns;
+  double total_s = 0.;
+  while ((total_s < m_options.min_time_s || times_ns.size() < m_options.min_iterations)
+         && times_ns.size() < m_options.max_iterations) {
+    auto start = std::chrono::steady_clock::now();
+    prepared.run();
+    auto end = std::chrono::steady_clock::now();
+    double time_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    times_ns.push_back(time_ns);
+    total_s += time_ns * 1e-9;
+  }
+
+  std::sort(times_ns.begin(), times_ns.end());
+  const std::size_t n = times_ns.size();
+  double mean = std::accumulate(times_ns.begin(), times_ns.end(), 0.) / n;
+  double variance = 0.;
+  for (double time_ns : times_ns) {
+    variance += (time_ns - mean) * (time_ns - mean);
+  }
+  variance /= std::max<std::size_t>(n - 1, 1);
+  double median = (n % 2 == 1) ? times_ns[n / 2] : (times_ns[n / 2 - 1] + times_ns[n / 2]) / 2.;
+
+  return {
+    .id = benchmark.id(),
+    .algorithm = benchmark.algorithm,
+    .parameters = benchmark.parameters,
+    .items = prepared.items,
+    .iterations = n,
+    .min_ns = times_ns.front(),
+    .median_ns = median,
+    .mean_ns = mean,
+    .stddev_ns = std::sqrt(variance),
+    .metrics = prepared.metrics ? prepared.metrics() : std::map<std::string, double>{},
+  };
+}
+
+bool BenchmarkRunner::selected(const BenchmarkCase& benchmark) const {
+  return m_options.filter.empty() || benchmark.id().find(m_options.filter) != std::string::npos;
+}
+
+std::vector<std::string> BenchmarkRunner::ids() const {
+  std::vector<std::string> ids;
+  for (const auto& benchmark : m_cases) {
+    if (selected(benchmark)) {
+      ids.push_back(benchmark.id());
+    }
+  }
+  return ids;
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run() const {
+  std::vector<BenchmarkResult> results;
+  for (const auto& benchmark : m_cases) {
+    if (!selected(benchmark)) {
+      continue;
+    }
+    const auto& result = results.emplace_back(measure(benchmark));
+    fmt::print("{:<72} {:>8} items {:>12.1f} us {:>10.1f} ns/item ({} iterations)",
+               result.id, result.items, result.median_ns / 1e3,
+               result.median_ns / std::max<std::size_t>(result.items, 1), result.iterations);
+    for (const auto& [name, value] : result.metrics) {
+      fmt::print(" {}={:.4g}", name, value);
+    }
+    fmt::print("\n");
+  }
+  return results;
+}
+
+void BenchmarkRunner::write_json(const std::string& filename, const std::vector<BenchmarkResult>& results,
+                                 const std::map<std::string, std::string>& context) {
+  nlohmann::json json;
+  json["context"] = context;
+  json["benchmarks"] = nlohmann::json::array();
+  for (const auto& result : results) {
+    json["benchmarks"].push_back({
+      {"id", result.id},
+      {"algorithm", result.algorithm},
+      {"parameters", result.parameters},
+      {"items", result.items},
+      {"iterations", result.iterations},
+      {"min_ns", result.min_ns},
+      {"median_ns", result.median_ns},
+      {"mean_ns", result.mean_ns},
+      {"stddev_ns", result.stddev_ns},
+      {"metrics", result.metrics},
+    });
+  }
+  std::ofstream out(filename);
+  if (!out) {
+    throw std::runtime_error(fmt::format("Unable to open \"{}\" for writing", filename));
+  }
+  out << json.dump(2) << std::endl;
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::read_json(const std::string& filename) {
+  std::ifstream in(filename);
+  if (!in) {
+    throw std::runtime_error(fmt::format("Unable to open \"{}\"", filename));
+  }
+  nlohmann::json json = nlohmann::json::parse(in);
+  std::vector<BenchmarkResult> results;
+  for (const auto& entry : json.at("benchmarks")) {
+    results.push_back({
+      .id = entry.at("id").get<std::string>(),
+      .algorithm = entry.at("algorithm").get<std::string>(),
+      .parameters = entry.at("parameters").get<std::map<std::string, double>>(),
+      .items = entry.at("items").get<std::size_t>(),
+      .iterations = entry.at("iterations").get<std::size_t>(),
+      .min_ns = entry.at("min_ns").get<double>(),
+      .median_ns = entry.at("median_ns").get<double>(),
+      .mean_ns = entry.at("mean_ns").get<double>(),
+      .stddev_ns = entry.at("stddev_ns").get<double>(),
+      .metrics = entry.at("metrics").get<std::map<std::string, double>>(),
+    });
+  }
+  return results;
+}
+
+std::size_t BenchmarkRunner::compare(const std::vector<BenchmarkResult>& results,
+                                     const std::vector<BenchmarkResult>& baseline, double tolerance) {
+  std::map<std::string, const BenchmarkResult*> baseline_by_id;
+  for (const auto& result : baseline) {
+    baseline_by_id[result.id] = &result;
+  }
+
+  std::size_t regressions = 0;
+  fmt::print("\n{:<72} {:>12} {:>12} {:>8}\n", "benchmark", "baseline us", "current us", "change");
+  for (const auto& result : results) {
+    auto it = baseline_by_id.find(result.id);
+    if (it == baseline_by_id.end()) {
+      fmt::print("{:<72} {:>12} {:>12.1f} {:>8}\n", result.id, "-", result.median_ns / 1e3, "new");
+      continue;
+    }
+    double change = result.median_ns / it->second->median_ns - 1.;
+    bool regression = change > tolerance;
+    regressions += regression;
+    fmt::print("{:<72} {:>12.1f} {:>12.1f} {:>+7.1f}%{}\n", result.id, it->second->median_ns / 1e3,
+               result.median_ns / 1e3, 100. * change, regression ? " REGRESSION" : "");
+  }
+  fmt::print("{} of {} benchmarks slower than the baseline by more than {:.0f}%\n", regressions,
+             results.size(), 100. * tolerance);
+  return regressions;
+}
+
+} // namespace eicrecon::benchmarks
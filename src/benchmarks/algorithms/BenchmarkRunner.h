@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eicrecon::benchmarks {
+
+/// The timed part of a benchmark, prepared outside of the timing
+struct PreparedBenchmark {
+  std::function<void()> run;
+  std::size_t items; // number of input objects, e.g. hits, per call
+  std::function<std::map<std::string, double>()> metrics; // optional, quality of the output of the last call
+};
+
+struct BenchmarkCase {
+  std::string algorithm;
+  std::map<std::string, double> parameters; // sweep point
+  std::function<PreparedBenchmark()> prepare;
+
+  std::string id() const;
+};
+
+struct BenchmarkResult {
+  std::string id;
+  std::string algorithm;
+  std::map<std::string, double> parameters;
+  std::size_t items;
+  std::size_t iterations;
+  double min_ns;
+  double median_ns;
+  double mean_ns;
+  double stddev_ns;
+  std::map<std::string, double> metrics;
+};
+
+class BenchmarkRunner {
+public:
+  struct Options {
+    double min_time_s = 0.2;
+    std::size_t min_iterations = 5;
+    std::size_t max_iterations = 100000;
+    std::string filter;
+  };
+
+  explicit BenchmarkRunner(Options options) : m_options(std::move(options)) {};
+
+  void add(BenchmarkCase benchmark) { m_cases.push_back(std::move(benchmark)); };
+
+  /// Ids of all cases matching the filter
+  std::vector<std::string> ids() const;
+
+  /// Runs all cases matching the filter, printing one line per case with its metrics
+  std::vector<BenchmarkResult> run() const;
+
+  static void write_json(const std::string& filename, const std::vector<BenchmarkResult>& results,
+                         const std::map<std::string, std::string>& context);
+  static std::vector<BenchmarkResult> read_json(const std::string& filename);
+
+  /// Prints the change of median time per case with respect to the baseline.
+  /// Returns the number of cases slower than the baseline by more than the tolerance.
+  static std::size_t compare(const std::vector<BenchmarkResult>& results,
+                             const std::vector<BenchmarkResult>& baseline, double tolerance);
+
+private:
+  Options m_options;
+  std::vector<BenchmarkCase> m_cases;
+
+  bool selected(const BenchmarkCase& benchmark) const;
+  BenchmarkResult measure(const BenchmarkCase& benchmark) const;
+};
+
+} // namespace eicrecon::benchmarks
@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#include "SyntheticEvents.h"
+
+#include <edm4eic/CherenkovParticleIDHypothesis.h>
+#include <edm4hep/Vector3f.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <numbers>
+#include <numeric>
+#include <tuple>
+
+namespace eicrecon::benchmarks {
+
+std::vector<CellDeposit> generate_calorimeter_event(const CalorimeterEventConfig& config, std::mt19937_64& rng) {
+  std::map<std::tuple<int, int, int>, CellDeposit> cells;
+  auto deposit = [&](int layer, int x, int y, double energy, int cluster) {
+    if (x < 0 || x >= config.cells || y < 0 || y >= config.cells) {
+      return;
+    }
+    auto it = cells.try_emplace({layer, x, y}, CellDeposit{layer, x, y, 0., cluster}).first;
+    it->second.energy += energy;
+    // A cell shared between showers belongs to the first one
+    if (it->second.cluster < 0) {
+      it->second.cluster = cluster;
+    }
+  };
+
+  std::uniform_real_distribution<double> uniform_position(0., config.cells);
+  std::exponential_distribution<double> shower_energy(1. / config.cluster_energy);
+  const int radius = static_cast<int>(std::ceil(4 * config.moliere_radius));
+  const double shower_max = std::max(1., config.layers / 3.);
+  for (int cluster = 0; cluster < config.clusters; cluster++) {
+    double energy = shower_energy(rng);
+    double cx = uniform_position(rng);
+    double cy = uniform_position(rng);
+    // Normalisation of the longitudinal and transverse profiles
+    double longitudinal_norm = 0.;
+    for (int layer = 0; layer < config.layers; layer++) {
+      double t = (layer + 0.5) / shower_max;
+      longitudinal_norm += t * std::exp(1. - t);
+    }
+    const double transverse_norm = 2 * std::numbers::pi * config.moliere_radius * config.moliere_radius;
+    for (int layer = 0; layer < config.layers; layer++) {
+      double t = (layer + 0.5) / shower_max;
+      double layer_energy = energy * t * std::exp(1. - t) / longitudinal_norm;
+      for (int x = static_cast<int>(cx) - radius; x <= static_cast<int>(cx) + radius; x++) {
+        for (int y = static_cast<int>(cy) - radius; y <= static_cast<int>(cy) + radius; y++) {
+          double r = std::hypot(x + 0.5 - cx, y + 0.5 - cy);
+          double cell_energy = layer_energy * std::exp(-r / config.moliere_radius) / transverse_norm;
+          if (cell_energy >= config.threshold) {
+            deposit(layer, x, y, cell_energy, cluster);
+          }
+        }
+      }
+    }
+  }
+
+  std::bernoulli_distribution is_noisy(config.occupancy);
+  std::exponential_distribution<double> noise_energy(1. / config.noise_energy);
+  for (int layer = 0; layer < config.layers; layer++) {
+    for (int x = 0; x < config.cells; x++) {
+      for (int y = 0; y < config.cells; y++) {
+        if (is_noisy(rng)) {
+          deposit(layer, x, y, noise_energy(rng), -1);
+        }
+      }
+    }
+  }
+
+  std::vector<CellDeposit> deposits;
+  deposits.reserve(cells.size());
+  for (const auto& [key, cell] : cells) {
+    deposits.push_back(cell);
+  }
+  // Hits usually arrive in an order unrelated to the geometry
+  std::shuffle(deposits.begin(), deposits.end(), rng);
+  return deposits;
+}
+
+namespace {
+
+  std::uint64_t encode_cell(const dd4hep::IDDescriptor& id_desc, const CellDeposit& cell) {
+    return id_desc.encode({{"system", 255}, {"layer", cell.layer}, {"x", cell.x}, {"y", cell.y}});
+  }
+
+} // namespace
+
+std::unique_ptr<edm4eic::CalorimeterHitCollection>
+make_calorimeter_hits(const std::vector<CellDeposit>& deposits, const CalorimeterEventConfig& config,
+                      const dd4hep::IDDescriptor& id_desc) {
+  auto hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+  const float half_size = config.cells * config.pitch / 2;
+  for (const auto& cell : deposits) {
+    edm4hep::Vector3f position(
+      (cell.x + 0.5) * config.pitch - half_size,
+      (cell.y + 0.5) * config.pitch - half_size,
+      cell.layer * config.layer_pitch
+    );
+    hits->create(
+      encode_cell(id_desc, cell), // std::uint64_t cellID,
+      cell.energy, // float energy,
+      0.0, // float energyError,
+      0.0, // float time,
+      0.0, // float timeError,
+      position, // edm4hep::Vector3f position,
+      edm4hep::Vector3f(config.pitch, config.pitch, config.layer_pitch), // edm4hep::Vector3f dimension,
+      0, // std::int32_t sector,
+      cell.layer, // std::int32_t layer,
+      position // edm4hep::Vector3f local
+    );
+  }
+  return hits;
+}
+
+std::unique_ptr<edm4eic::CalorimeterHitCollection>
+make_hexagonal_calorimeter_hits(const std::vector<CellDeposit>& deposits, const CalorimeterEventConfig& config,
+                                const dd4hep::IDDescriptor& id_desc) {
+  auto hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+  const double side = config.pitch;
+  const double sqrt3 = std::sqrt(3.);
+  const std::array<std::array<double, 2>, 4> stagger{{
+    {0., sqrt3 / 2 * side},
+    {0.75 * side, -sqrt3 / 4 * side},
+    {0., 0.},
+    {0.75 * side, sqrt3 / 4 * side},
+  }};
+  const double thickness = 3.;
+  for (const auto& cell : deposits) {
+    const auto& offset = stagger[cell.layer % stagger.size()];
+    edm4hep::Vector3f position(
+      1.5 * side * cell.x + offset[0],
+      sqrt3 * side * (cell.y + 0.5 * (cell.x % 2)) + offset[1],
+      cell.layer * config.layer_pitch
+    );
+    hits->create(
+      encode_cell(id_desc, cell), // std::uint64_t cellID,
+      cell.energy, // float energy,
+      0.0, // float energyError,
+      0.0, // float time,
+      0.0, // float timeError,
+      position, // edm4hep::Vector3f position,
+      edm4hep::Vector3f(2 * side, sqrt3 * side, thickness), // edm4hep::Vector3f dimension,
+      0, // std::int32_t sector,
+      cell.layer, // std::int32_t layer,
+      position // edm4hep::Vector3f local
+    );
+  }
+  return hits;
+}
+
+void make_sim_calorimeter_hits(const std::vector<CellDeposit>& deposits, const CalorimeterEventConfig& config,
+                               const dd4hep::IDDescriptor& id_desc, std::size_t contributions_per_hit,
+                               edm4hep::SimCalorimeterHitCollection& hits,
+                               edm4hep::CaloHitContributionCollection& contributions) {
+  const float half_size = config.cells * config.pitch / 2;
+  for (const auto& cell : deposits) {
+    edm4hep::Vector3f position(
+      (cell.x + 0.5) * config.pitch - half_size,
+      (cell.y + 0.5) * config.pitch - half_size,
+      cell.layer * config.layer_pitch
+    );
+    auto hit = hits.create(
+      encode_cell(id_desc, cell), // std::uint64_t cellID,
+      cell.energy, // float energy
+      position // edm4hep::Vector3f position
+    );
+    for (std::size_t i = 0; i < contributions_per_hit; i++) {
+      hit.addToContributions(contributions.create(
+        11, // std::int32_t PDG
+        cell.energy / contributions_per_hit, // float energy
+        5.0 + i, // float time
+        position // edm4hep::Vector3f stepPosition
+      ));
+    }
+  }
+}
+
+std::unique_ptr<edm4eic::ProtoClusterCollection>
+make_protoclusters(const std::vector<CellDeposit>& deposits, const edm4eic::CalorimeterHitCollection& hits) {
+  auto protoclusters = std::make_unique<edm4eic::ProtoClusterCollection>();
+  std::map<int, edm4eic::MutableProtoCluster> by_cluster;
+  for (std::size_t i = 0; i < deposits.size(); i++) {
+    if (deposits[i].cluster < 0) {
+      continue;
+    }
+    auto it = by_cluster.find(deposits[i].cluster);
+    if (it == by_cluster.end()) {
+      it = by_cluster.emplace(deposits[i].cluster, protoclusters->create()).first;
+    }
+    it->second.addToHits(hits[i]);
+    it->second.addToWeights(1);
+  }
+  return protoclusters;
+}
+
+CherenkovPIDEvent make_cherenkov_pid_event(std::size_t n_tracks, std::size_t n_detectors, std::mt19937_64& rng) {
+  CherenkovPIDEvent event;
+  event.tracks = std::make_unique<edm4eic::TrackSegmentCollection>();
+  for (std::size_t i = 0; i < n_tracks; i++) {
+    event.tracks->create();
+  }
+
+  std::poisson_distribution<int> npe(10);
+  std::uniform_real_distribution<double> weight(0., 100.);
+  for (std::size_t detector = 0; detector < n_detectors; detector++) {
+    auto& pids = event.pids.emplace_back(std::make_unique<edm4eic::CherenkovParticleIDCollection>());
+    // Each detector reports the tracks in its own order
+    std::vector<std::size_t> order(n_tracks);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    for (std::size_t i : order) {
+      auto pid = pids->create();
+      pid.setChargedParticle(event.tracks->at(i));
+      pid.setNpe(npe(rng));
+      pid.setRefractiveIndex(1.0 + 0.01 * (detector + 1));
+      pid.setPhotonEnergy(3e-9);
+      for (int pdg : {11, 211, 321, 2212}) {
+        edm4eic::CherenkovParticleIDHypothesis hypothesis;
+        hypothesis.PDG = pdg;
+        hypothesis.npe = npe(rng);
+        hypothesis.weight = weight(rng);
+        pid.addToHypotheses(hypothesis);
+      }
+    }
+  }
+  return event;
+}
+
+ParticleEvent make_particle_event(std::size_t n_particles, const std::vector<int>& pdg_values,
+                                  double max_momentum, std::mt19937_64& rng) {
+  ParticleEvent event;
+  event.mcparticles = std::make_unique<edm4hep::MCParticleCollection>();
+  event.particles = std::make_unique<edm4eic::ReconstructedParticleCollection>();
+  event.associations = std::make_unique<edm4eic::MCRecoParticleAssociationCollection>();
+
+  std::uniform_int_distribution<std::size_t> species(0, pdg_values.size() - 1);
+  std::uniform_real_distribution<double> momentum(0., max_momentum);
+  std::uniform_real_distribution<double> cos_theta(-1., 1.);
+  std::uniform_real_distribution<double> phi(-std::numbers::pi, std::numbers::pi);
+  std::bernoulli_distribution positive(0.5);
+  for (std::size_t i = 0; i < n_particles; i++) {
+    int pdg = pdg_values[species(rng)];
+    float charge = positive(rng) ? 1. : -1.;
+    double p = momentum(rng);
+    double ct = cos_theta(rng);
+    double st = std::sqrt(1. - ct * ct);
+    double ph = phi(rng);
+    edm4hep::Vector3f p3(p * st * std::cos(ph), p * st * std::sin(ph), p * ct);
+
+    auto mcparticle = event.mcparticles->create();
+    mcparticle.setPDG(charge > 0 ? pdg : -pdg);
+    mcparticle.setCharge(charge);
+    mcparticle.setMomentum({p3.x, p3.y, p3.z});
+
+    auto particle = event.particles->create();
+    particle.setMomentum(p3);
+    particle.setCharge(charge);
+    particle.setEnergy(p);
+
+    auto association = event.associations->create();
+    association.setRec(particle);
+    association.setSim(mcparticle);
+  }
+  return event;
+}
+
+SpacePointEvent generate_tracker_event(const TrackerEventConfig& config, std::mt19937_64& rng) {
+  SpacePointEvent event;
+  auto add = [&](double r, double phi, double z, int track) {
+    if (std::abs(z) > config.half_length) {
+      return;
+    }
+    event.r.push_back(r);
+    event.phi.push_back(phi);
+    event.z.push_back(z);
+    event.track.push_back(track);
+  };
+
+  std::uniform_real_distribution<double> curvature(-config.max_curvature, config.max_curvature);
+  std::uniform_real_distribution<double> phi(-std::numbers::pi, std::numbers::pi);
+  std::uniform_real_distribution<double> cot_theta(-config.max_cot_theta, config.max_cot_theta);
+  std::uniform_real_distribution<double> z0(-config.z0_width, config.z0_width);
+  for (int track = 0; track < config.tracks; track++) {
+    double k = curvature(rng);
+    double phi0 = phi(rng);
+    double ct = cot_theta(rng);
+    double vz = z0(rng);
+    for (double r : config.layer_radii) {
+      // Helix through (0, 0, vz), phi = phi0 - asin(r * k / 2)
+      double s = r * k / 2;
+      if (std::abs(s) > 1.) {
+        break;
+      }
+      double arc_length = (std::abs(s) > 1e-9) ? r * std::asin(s) / s : r;
+      add(r, std::remainder(phi0 - std::asin(s), 2 * std::numbers::pi), vz + arc_length * ct, track);
+    }
+  }
+
+  std::uniform_int_distribution<std::size_t> layer(0, config.layer_radii.size() - 1);
+  std::uniform_real_distribution<double> z(-config.half_length, config.half_length);
+  for (int i = 0; i < config.noise; i++) {
+    double r = config.layer_radii[layer(rng)];
+    double ph = phi(rng);
+    add(r, ph, z(rng), -1);
+  }
+  return event;
+}
+
+} // namespace eicrecon::benchmarks
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#pragma once
+
+#include <DD4hep/IDDescriptor.h>
+#include <edm4eic/CalorimeterHitCollection.h>
+#include <edm4eic/CherenkovParticleIDCollection.h>
+#include <edm4eic/MCRecoParticleAssociationCollection.h>
+#include <edm4eic/ProtoClusterCollection.h>
+#include <edm4eic/ReconstructedParticleCollection.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace eicrecon::benchmarks {
+
+/// Parameters of a synthetic calorimeter event on a square grid of cells
+struct CalorimeterEventConfig {
+  int cells = 128;               // cells per side of each layer, at most 256
+  int layers = 1;                // at most 256
+  double pitch = 10.;            // cell size in mm
+  double layer_pitch = 20.;      // layer spacing in mm
+  double occupancy = 0.01;       // fraction of cells with a noise hit
+  int clusters = 10;             // number of showers
+  double cluster_energy = 5.;    // mean shower energy in GeV
+  double moliere_radius = 1.;    // shower width in cells
+  double noise_energy = 1e-3;    // noise hit energy scale in GeV
+  double threshold = 1e-4;       // minimum energy of shower deposits in GeV
+};
+
+/// Energy deposited in one cell
+struct CellDeposit {
+  int layer;
+  int x;
+  int y;
+  double energy;
+  int cluster; // index of the shower, -1 for noise
+};
+
+/// Generates showers with an exponential transverse profile and a
+/// longitudinal profile peaking in the first third of the layers, plus
+/// uniformly distributed noise hits. Deposits in the same cell are merged.
+std::vector<CellDeposit> generate_calorimeter_event(const CalorimeterEventConfig& config, std::mt19937_64& rng);
+
+/// Hits on a rectangular grid, with cell IDs of the mock calorimeter readout
+std::unique_ptr<edm4eic::CalorimeterHitCollection>
+make_calorimeter_hits(const std::vector<CellDeposit>& deposits, const CalorimeterEventConfig& config,
+                      const dd4hep::IDDescriptor& id_desc);
+
+/// Hits on a hexagonal grid with side length config.pitch, with the layers
+/// staggered in the four-fold pattern expected by HEXPLIT
+std::unique_ptr<edm4eic::CalorimeterHitCollection>
+make_hexagonal_calorimeter_hits(const std::vector<CellDeposit>& deposits, const CalorimeterEventConfig& config,
+                                const dd4hep::IDDescriptor& id_desc);
+
+/// Simulated hits, each with the given number of contributions sharing its energy
+void make_sim_calorimeter_hits(const std::vector<CellDeposit>& deposits, const CalorimeterEventConfig& config,
+                               const dd4hep::IDDescriptor& id_desc, std::size_t contributions_per_hit,
+                               edm4hep::SimCalorimeterHitCollection& hits,
+                               edm4hep::CaloHitContributionCollection& contributions);
+
+/// One protocluster per shower, made of the hits in the same order as deposits
+std::unique_ptr<edm4eic::ProtoClusterCollection>
+make_protoclusters(const std::vector<CellDeposit>& deposits, const edm4eic::CalorimeterHitCollection& hits);
+
+/// Cherenkov PID results of several detectors for the same tracks
+struct CherenkovPIDEvent {
+  std::unique_ptr<edm4eic::TrackSegmentCollection> tracks;
+  std::vector<std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> pids;
+};
+CherenkovPIDEvent make_cherenkov_pid_event(std::size_t n_tracks, std::size_t n_detectors, std::mt19937_64& rng);
+
+/// Reconstructed particles associated one to one with charged MC particles
+struct ParticleEvent {
+  std::unique_ptr<edm4hep::MCParticleCollection> mcparticles;
+  std::unique_ptr<edm4eic::ReconstructedParticleCollection> particles;
+  std::unique_ptr<edm4eic::MCRecoParticleAssociationCollection> associations;
+};
+ParticleEvent make_particle_event(std::size_t n_particles, const std::vector<int>& pdg_values,
+                                  double max_momentum, std::mt19937_64& rng);
+
+/// Parameters of a synthetic tracker event on cylindrical barrel layers
+struct TrackerEventConfig {
+  std::vector<double> layer_radii{36., 48., 120., 270., 420.}; // mm
+  double half_length = 1000.;  // of the layers in mm
+  int tracks = 10;
+  double max_curvature = 2e-3; // 1/mm, pT of about 0.25 GeV at 1.7 T
+  double max_cot_theta = 2.;
+  double z0_width = 100.;      // half width of the vertex distribution in mm
+  int noise = 0;               // space points uniformly distributed over the layers
+};
+
+/// Space points in cylindrical coordinates, as used by the seeders
+struct SpacePointEvent {
+  std::vector<float> r;
+  std::vector<float> phi;
+  std::vector<float> z;
+  std::vector<int> track; // index of the track, -1 for noise
+};
+
+/// Generates helices from the beam line with uniformly distributed parameters
+/// crossing the layers, plus uniformly distributed noise
+SpacePointEvent generate_tracker_event(const TrackerEventConfig& config, std::mt19937_64& rng);
+
+} // namespace eicrecon::benchmarks
@@ -0,0 +1,628 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+// Micro-benchmarks of algorithms on the mock geometry of the algorithms tests
+//
+// Usage: benchmark_algorithms [--filter STR] [--min-time SECONDS] [--seed N]
+//                             [--output FILE.json] [--baseline FILE.json] [--tolerance FRACTION] [--list]
+
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Seeding/SeedFinderOrthogonal.hpp>
+#include <Acts/Utilities/KDTree.hpp> // IWYU pragma: keep FIXME KDTree missing in SeedFinderOrthogonal.hpp until Acts v23.0.0
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/Segmentations.h>
+#include <Evaluator/DD4hepUnits.h>
+#include <algorithms/geo.h>
+#include <algorithms/logger.h>
+#include <algorithms/random.h>
+#include <algorithms/service.h>
+#include <edm4eic/ClusterCollection.h>
+#include <edm4eic/MCRecoClusterParticleAssociationCollection.h>
+#include <edm4hep/ParticleIDCollection.h>
+#include <edm4hep/RawCalorimeterHitCollection.h>
+#include <fmt/core.h>
+#include <spdlog/common.h>
+#include <spdlog/logger.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <gsl/pointers>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkRunner.h"
+#include "SyntheticEvents.h"
+#include "algorithms/calorimetry/CalorimeterClusterRecoCoG.h"
+#include "algorithms/calorimetry/CalorimeterClusterRecoCoGConfig.h"
+#include "algorithms/calorimetry/CalorimeterHitDigi.h"
+#include "algorithms/calorimetry/CalorimeterHitDigiConfig.h"
+#include "algorithms/calorimetry/CalorimeterIslandCluster.h"
+#include "algorithms/calorimetry/CalorimeterIslandClusterConfig.h"
+#include "algorithms/calorimetry/HEXPLIT.h"
+#include "algorithms/calorimetry/HEXPLITConfig.h"
+#include "algorithms/calorimetry/ImagingTopoCluster.h"
+#include "algorithms/calorimetry/ImagingTopoClusterConfig.h"
+#include "algorithms/pid/MergeParticleID.h"
+#include "algorithms/pid/MergeParticleIDConfig.h"
+#include "algorithms/pid_lut/PIDLookup.h"
+#include "algorithms/pid_lut/PIDLookupConfig.h"
+#include "algorithms/tracking/HoughSeedFinder.h"
+#include "algorithms/tracking/OrthogonalTrackSeedingConfig.h"
+#include "algorithms/tracking/SpacePoint.h"
+#include "algorithms/tracking/TrackSeeding.h"
+#include "algorithms/interfaces/RandomStreamSvc.h"
+#include "services/evaluator/EvaluatorSvc.h"
+#include "services/geometry/cellgeo/CellGeoSvc.h"
+#include "services/pid_lut/PIDLookupTableSvc.h"
+
+using namespace eicrecon;
+using namespace eicrecon::benchmarks;
+
+namespace {
+
+/// Same mock detector as in the algorithms tests
+std::unique_ptr<const dd4hep::Detector> make_mock_detector() {
+  auto detector = dd4hep::Detector::make_unique("");
+  dd4hep::Readout readout(std::string("MockCalorimeterHits"));
+  dd4hep::IDDescriptor id_desc("MockCalorimeterHits", "system:8,layer:8,x:8,y:8");
+  readout.setIDDescriptor(id_desc);
+  detector->add(id_desc);
+  detector->add(readout);
+
+  dd4hep::Readout readoutTracker(std::string("MockTrackerHits"));
+  dd4hep::IDDescriptor id_desc_tracker("MockTrackerHits", "system:8,layer:8,x:8,y:8");
+  dd4hep::Segmentation segmentation("CartesianGridXY","TrackerHitsSeg", id_desc_tracker.decoder());
+  readoutTracker.setIDDescriptor(id_desc_tracker);
+  readoutTracker.setSegmentation(segmentation);
+  detector->add(id_desc_tracker);
+  detector->add(readoutTracker);
+
+  return detector;
+}
+
+void init_services(const dd4hep::Detector* detector, std::uint64_t seed) {
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  [[maybe_unused]] auto& geoSvc = algorithms::GeoSvc::instance();
+  serviceSvc.setInit<algorithms::GeoSvc>([detector](auto&& g) {
+    g.init(detector);
+  });
+
+  [[maybe_unused]] auto& randomSvc = algorithms::RandomSvc::instance();
+  serviceSvc.setInit<algorithms::RandomSvc>([seed](auto&& r) {
+    r.setProperty("seed", static_cast<size_t>(seed));
+    r.init();
+  });
+
+  [[maybe_unused]] auto& randomStreamSvc = algorithms::RandomStreamSvc::instance();
+  serviceSvc.setInit<algorithms::RandomStreamSvc>([seed](auto&& r) {
+    r.init(seed);
+  });
+
+  auto& evaluatorSvc = EvaluatorSvc::instance();
+  serviceSvc.add<EvaluatorSvc>(&evaluatorSvc);
+
+  auto& cellGeoSvc = CellGeoSvc::instance();
+  serviceSvc.add<CellGeoSvc>(&cellGeoSvc);
+
+  auto& lutSvc = PIDLookupTableSvc::instance();
+  serviceSvc.add<PIDLookupTableSvc>(&lutSvc);
+
+  serviceSvc.init();
+}
+
+/// Inputs of each case only depend on the seed and the case, not on which cases run
+std::mt19937_64 make_rng(std::uint64_t seed, const std::string& id) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (char c : id) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+  return std::mt19937_64(seed ^ hash);
+}
+
+template <typename AlgoT> void quiet(AlgoT& algo) {
+  algo.level(algorithms::LogLevel(spdlog::level::warn));
+}
+
+const dd4hep::IDDescriptor& calorimeter_id_desc() {
+  static const dd4hep::IDDescriptor id_desc =
+    algorithms::GeoSvc::instance().detector()->readout("MockCalorimeterHits").idSpec();
+  return id_desc;
+}
+
+void add_island_cluster(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double split : {0., 1.}) {
+    for (double occupancy : {0.001, 0.01, 0.05}) {
+      for (double clusters : {1., 10., 100.}) {
+        BenchmarkCase benchmark{"CalorimeterIslandCluster", {{"split", split}, {"occupancy", occupancy}, {"clusters", clusters}}, {}};
+        benchmark.prepare = [=, id = benchmark.id()]() {
+          CalorimeterEventConfig event_cfg{.occupancy = occupancy, .clusters = static_cast<int>(clusters)};
+          auto rng = make_rng(seed, id);
+          auto deposits = generate_calorimeter_event(event_cfg, rng);
+          std::shared_ptr<const edm4eic::CalorimeterHitCollection> hits = make_calorimeter_hits(deposits, event_cfg, calorimeter_id_desc());
+
+          CalorimeterIslandClusterConfig cfg{};
+          cfg.minClusterHitEdep = 0. * dd4hep::GeV;
+          cfg.minClusterCenterEdep = 30. * dd4hep::MeV;
+          if (split != 0.) {
+            cfg.localDistXY = {1.5 * event_cfg.pitch * dd4hep::mm, 1.5 * event_cfg.pitch * dd4hep::mm};
+            cfg.splitCluster = true;
+            cfg.transverseEnergyProfileMetric = "localDistXY";
+            cfg.transverseEnergyProfileScale = event_cfg.pitch * dd4hep::mm;
+          } else {
+            cfg.adjacencyMatrix = "abs(x_1 - x_2) + abs(y_1 - y_2) == 1";
+            cfg.readout = "MockCalorimeterHits";
+          }
+          auto algo = std::make_shared<CalorimeterIslandCluster>("CalorimeterIslandCluster");
+          quiet(*algo);
+          algo->applyConfig(cfg);
+          algo->init();
+          return PreparedBenchmark{[algo, hits]() {
+            auto protoclusters = std::make_unique<edm4eic::ProtoClusterCollection>();
+            algo->process({hits.get()}, {protoclusters.get()});
+          }, hits->size()};
+        };
+        runner.add(std::move(benchmark));
+      }
+    }
+  }
+}
+
+void add_imaging_topo_cluster(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double occupancy : {0.001, 0.01}) {
+    for (double clusters : {1., 10., 50.}) {
+      BenchmarkCase benchmark{"ImagingTopoCluster", {{"occupancy", occupancy}, {"clusters", clusters}}, {}};
+      benchmark.prepare = [=, id = benchmark.id()]() {
+        CalorimeterEventConfig event_cfg{.cells = 64, .layers = 20, .occupancy = occupancy, .clusters = static_cast<int>(clusters)};
+        auto rng = make_rng(seed, id);
+        auto deposits = generate_calorimeter_event(event_cfg, rng);
+        std::shared_ptr<const edm4eic::CalorimeterHitCollection> hits = make_calorimeter_hits(deposits, event_cfg, calorimeter_id_desc());
+
+        ImagingTopoClusterConfig cfg;
+        cfg.layerMode = ImagingTopoClusterConfig::ELayerMode::xy;
+        cfg.localDistXY = {1.5 * event_cfg.pitch * dd4hep::mm, 1.5 * event_cfg.pitch * dd4hep::mm};
+        cfg.layerDistXY = {1.5 * event_cfg.pitch * dd4hep::mm, 1.5 * event_cfg.pitch * dd4hep::mm};
+        cfg.minClusterHitEdep = 0. * dd4hep::GeV;
+        cfg.minClusterCenterEdep = 10. * dd4hep::MeV;
+        cfg.minClusterEdep = 10. * dd4hep::MeV;
+        cfg.minClusterNhits = 3;
+        auto algo = std::make_shared<ImagingTopoCluster>("ImagingTopoCluster");
+        quiet(*algo);
+        algo->applyConfig(cfg);
+        algo->init();
+        return PreparedBenchmark{[algo, hits]() {
+          auto protoclusters = std::make_unique<edm4eic::ProtoClusterCollection>();
+          algo->process({hits.get()}, {protoclusters.get()});
+        }, hits->size()};
+      };
+      runner.add(std::move(benchmark));
+    }
+  }
+}
+
+void add_hexplit(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double occupancy : {0.001, 0.01, 0.05}) {
+    for (double clusters : {1., 10.}) {
+      BenchmarkCase benchmark{"HEXPLIT", {{"occupancy", occupancy}, {"clusters", clusters}}, {}};
+      benchmark.prepare = [=, id = benchmark.id()]() {
+        CalorimeterEventConfig event_cfg{.cells = 32, .layers = 20, .pitch = 31.3, .layer_pitch = 25.1, .occupancy = occupancy, .clusters = static_cast<int>(clusters)};
+        auto rng = make_rng(seed, id);
+        auto deposits = generate_calorimeter_event(event_cfg, rng);
+        std::shared_ptr<const edm4eic::CalorimeterHitCollection> hits = make_hexagonal_calorimeter_hits(deposits, event_cfg, calorimeter_id_desc());
+
+        HEXPLITConfig cfg;
+        cfg.MIP = 472. * dd4hep::keV;
+        cfg.tmax = 1000. * dd4hep::ns;
+        auto algo = std::make_shared<HEXPLIT>("HEXPLIT");
+        quiet(*algo);
+        algo->applyConfig(cfg);
+        algo->init();
+        return PreparedBenchmark{[algo, hits]() {
+          auto subcell_hits = std::make_unique<edm4eic::CalorimeterHitCollection>();
+          algo->process({hits.get()}, {subcell_hits.get()});
+        }, hits->size()};
+      };
+      runner.add(std::move(benchmark));
+    }
+  }
+}
+
+void add_calorimeter_hit_digi(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double occupancy : {0.01, 0.1}) {
+    for (double contributions : {1., 10.}) {
+      BenchmarkCase benchmark{"CalorimeterHitDigi", {{"occupancy", occupancy}, {"contributions", contributions}}, {}};
+      benchmark.prepare = [=, id = benchmark.id()]() {
+        CalorimeterEventConfig event_cfg{.occupancy = occupancy, .clusters = 10};
+        auto rng = make_rng(seed, id);
+        auto deposits = generate_calorimeter_event(event_cfg, rng);
+        auto simhits = std::make_shared<edm4hep::SimCalorimeterHitCollection>();
+        auto contribution_coll = std::make_shared<edm4hep::CaloHitContributionCollection>();
+        make_sim_calorimeter_hits(deposits, event_cfg, calorimeter_id_desc(), static_cast<std::size_t>(contributions), *simhits, *contribution_coll);
+
+        CalorimeterHitDigiConfig cfg;
+        cfg.threshold = 0. /* GeV */;
+        cfg.corrMeanScale = "1.";
+        cfg.pedSigmaADC = 1;
+        cfg.tRes = 0.1 * dd4hep::ns;
+        cfg.eRes = {0.1 * sqrt(dd4hep::GeV), 0.01, 0. * dd4hep::GeV};
+        cfg.readout = "MockCalorimeterHits";
+        cfg.capADC = 16384;
+        cfg.dyRangeADC = 100.0 /* GeV */;
+        cfg.pedMeanADC = 100;
+        cfg.resolutionTDC = 0.01 * dd4hep::ns;
+        auto algo = std::make_shared<CalorimeterHitDigi>("CalorimeterHitDigi");
+        quiet(*algo);
+        algo->applyConfig(cfg);
+        algo->init();
+        return PreparedBenchmark{[algo, simhits, contribution_coll]() {
+          auto rawhits = std::make_unique<edm4hep::RawCalorimeterHitCollection>();
+          algo->process({simhits.get()}, {rawhits.get()});
+        }, simhits->size()};
+      };
+      runner.add(std::move(benchmark));
+    }
+  }
+}
+
+void add_cluster_reco_cog(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double clusters : {1., 10., 100.}) {
+    for (double moliere_radius : {1., 3.}) {
+      BenchmarkCase benchmark{"CalorimeterClusterRecoCoG", {{"clusters", clusters}, {"moliere_radius", moliere_radius}}, {}};
+      benchmark.prepare = [=, id = benchmark.id()]() {
+        CalorimeterEventConfig event_cfg{.occupancy = 0., .clusters = static_cast<int>(clusters), .moliere_radius = moliere_radius};
+        auto rng = make_rng(seed, id);
+        auto deposits = generate_calorimeter_event(event_cfg, rng);
+        std::shared_ptr<const edm4eic::CalorimeterHitCollection> hits = make_calorimeter_hits(deposits, event_cfg, calorimeter_id_desc());
+        std::shared_ptr<const edm4eic::ProtoClusterCollection> protoclusters = make_protoclusters(deposits, *hits);
+
+        CalorimeterClusterRecoCoGConfig cfg;
+        cfg.energyWeight = "log";
+        cfg.sampFrac = 0.0203;
+        cfg.logWeightBaseCoeffs = {5.0, 0.65, 0.31};
+        cfg.logWeightBase_Eref = 50 * dd4hep::GeV;
+        auto algo = std::make_shared<CalorimeterClusterRecoCoG>("CalorimeterClusterRecoCoG");
+        quiet(*algo);
+        algo->applyConfig(cfg);
+        algo->init();
+        return PreparedBenchmark{[algo, hits, protoclusters]() {
+          auto clusters = std::make_unique<edm4eic::ClusterCollection>();
+          algo->process({protoclusters.get(), nullptr}, {clusters.get(), nullptr});
+        }, hits->size()};
+      };
+      runner.add(std::move(benchmark));
+    }
+  }
+}
+
+void add_merge_particle_id(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double tracks : {10., 100., 1000.}) {
+    BenchmarkCase benchmark{"MergeParticleID", {{"tracks", tracks}}, {}};
+    benchmark.prepare = [=, id = benchmark.id()]() {
+      auto rng = make_rng(seed, id);
+      auto event = std::make_shared<CherenkovPIDEvent>(make_cherenkov_pid_event(static_cast<std::size_t>(tracks), 2, rng));
+
+      auto logger = spdlog::default_logger()->clone("MergeParticleID");
+      logger->set_level(spdlog::level::warn);
+      MergeParticleIDConfig cfg;
+      cfg.mergeMode = MergeParticleIDConfig::kAddWeights;
+      auto algo = std::make_shared<MergeParticleID>("MergeParticleID");
+      algo->applyConfig(cfg);
+      algo->init(logger);
+      std::vector<gsl::not_null<const edm4eic::CherenkovParticleIDCollection*>> inputs;
+      for (const auto& pids : event->pids) {
+        inputs.push_back(pids.get());
+      }
+      return PreparedBenchmark{[algo, event, inputs]() {
+        auto merged = std::make_unique<edm4eic::CherenkovParticleIDCollection>();
+        algo->process({inputs}, {merged.get()});
+      }, static_cast<std::size_t>(tracks)};
+    };
+    runner.add(std::move(benchmark));
+  }
+}
+
+const std::vector<int> lut_pdg_values{11, 211, 321, 2212};
+
+PIDLookupConfig make_pid_lookup_config(const std::string& filename) {
+  PIDLookupConfig cfg {
+    .filename=filename,
+    .system=0,
+    .pdg_values=lut_pdg_values,
+    .charge_values={1},
+    .momentum_edges={},
+    .polar_edges={},
+    .azimuthal_binning={-180., 180., 30.}, // lower, upper, step
+    .azimuthal_bin_centers_in_lut=true,
+    .momentum_bin_centers_in_lut=true,
+    .polar_bin_centers_in_lut=true,
+    .use_radians=false,
+  };
+  for (int i = 0; i <= 20; i++) {
+    cfg.momentum_edges.push_back(0.5 * i);
+  }
+  for (int i = 0; i <= 18; i++) {
+    cfg.polar_edges.push_back(10. * i);
+  }
+  return cfg;
+}
+
+/// Writes a text LUT with random probabilities for the binning of make_pid_lookup_config()
+void write_pid_lookup_table(const std::string& filename, std::uint64_t seed) {
+  auto cfg = make_pid_lookup_config(filename);
+  auto rng = make_rng(seed, filename);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::ofstream out(filename);
+  for (int pdg : cfg.pdg_values) {
+    for (std::size_t i = 0; i + 1 < cfg.momentum_edges.size(); i++) {
+      for (std::size_t j = 0; j + 1 < cfg.polar_edges.size(); j++) {
+        for (double phi = cfg.azimuthal_binning[0] + cfg.azimuthal_binning[2] / 2; phi < cfg.azimuthal_binning[1]; phi += cfg.azimuthal_binning[2]) {
+          std::array<double, 4> probabilities{uniform(rng), uniform(rng), uniform(rng), uniform(rng)};
+          double sum = probabilities[0] + probabilities[1] + probabilities[2] + probabilities[3];
+          out << fmt::format("{} 1 {} {} {} {} {} {} {}\n", pdg,
+                             (cfg.momentum_edges[i] + cfg.momentum_edges[i + 1]) / 2,
+                             (cfg.polar_edges[j] + cfg.polar_edges[j + 1]) / 2, phi,
+                             probabilities[0] / sum, probabilities[1] / sum,
+                             probabilities[2] / sum, probabilities[3] / sum);
+        }
+      }
+    }
+  }
+}
+
+void add_pid_lookup(BenchmarkRunner& runner, std::uint64_t seed, const std::string& lut_filename) {
+  for (double particles : {10., 100., 1000.}) {
+    BenchmarkCase benchmark{"PIDLookup", {{"particles", particles}}, {}};
+    benchmark.prepare = [=, id = benchmark.id()]() {
+      auto rng = make_rng(seed, id);
+      auto event = std::make_shared<ParticleEvent>(make_particle_event(static_cast<std::size_t>(particles), lut_pdg_values, 10., rng));
+
+      auto algo = std::make_shared<PIDLookup>("PIDLookup");
+      quiet(*algo);
+      algo->applyConfig(make_pid_lookup_config(lut_filename));
+      algo->init();
+      return PreparedBenchmark{[algo, event]() {
+        auto particles_out = std::make_unique<edm4eic::ReconstructedParticleCollection>();
+        auto associations_out = std::make_unique<edm4eic::MCRecoParticleAssociationCollection>();
+        auto particle_ids_out = std::make_unique<edm4hep::ParticleIDCollection>();
+        algo->process({event->particles.get(), event->associations.get()},
+                      {particles_out.get(), associations_out.get(), particle_ids_out.get()});
+      }, static_cast<std::size_t>(particles)};
+    };
+    runner.add(std::move(benchmark));
+  }
+}
+
+/// Tracker event shared by the seeder benchmarks of the same sweep point
+std::shared_ptr<const SpacePointEvent> make_tracker_event(std::uint64_t seed, double tracks, double noise) {
+  TrackerEventConfig event_cfg{.tracks = static_cast<int>(tracks), .noise = static_cast<int>(noise)};
+  auto rng = make_rng(seed, fmt::format("TrackerEvent/noise={}/tracks={}", noise, tracks));
+  return std::make_shared<const SpacePointEvent>(generate_tracker_event(event_cfg, rng));
+}
+
+/// Seed efficiency, the fraction of tracks with at least three space points
+/// that have a seed made of their own space points only, and fake rate, the
+/// fraction of seeds with space points of different tracks or noise
+std::map<std::string, double> seed_metrics(const SpacePointEvent& event,
+                                           const std::vector<std::array<std::size_t, 3>>& seeds) {
+  std::map<int, std::size_t> track_space_points;
+  for (int track : event.track) {
+    if (track >= 0) {
+      track_space_points[track]++;
+    }
+  }
+  std::size_t n_tracks = 0;
+  for (const auto& [track, n] : track_space_points) {
+    n_tracks += (n >= 3);
+  }
+
+  std::set<int> found;
+  std::size_t n_fakes = 0;
+  for (const auto& space_points : seeds) {
+    const int track = event.track[space_points[0]];
+    if (track >= 0 && event.track[space_points[1]] == track && event.track[space_points[2]] == track) {
+      found.insert(track);
+    } else {
+      n_fakes++;
+    }
+  }
+  return {
+    {"efficiency", n_tracks > 0 ? static_cast<double>(found.size()) / n_tracks : 0.},
+    {"fake_rate", !seeds.empty() ? static_cast<double>(n_fakes) / seeds.size() : 0.},
+  };
+}
+
+void add_hough_seed_finder(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double tracks : {10., 100.}) {
+    for (double noise : {0., 100., 1000.}) {
+      BenchmarkCase benchmark{"HoughSeedFinder", {{"tracks", tracks}, {"noise", noise}}, {}};
+      benchmark.prepare = [=]() {
+        auto event = make_tracker_event(seed, tracks, noise);
+        auto algo = std::make_shared<HoughSeedFinder>(houghSeedFinderConfig(OrthogonalTrackSeedingConfig{}));
+        auto seeds = std::make_shared<std::vector<HoughSeedFinder::Seed>>();
+        return PreparedBenchmark{[algo, event, seeds]() {
+          seeds->clear();
+          algo->find(event->r, event->phi, event->z, *seeds);
+        }, event->r.size(), [event, seeds]() {
+          std::vector<std::array<std::size_t, 3>> space_points;
+          for (const auto& s : *seeds) {
+            space_points.push_back(s.spacePoints);
+          }
+          return seed_metrics(*event, space_points);
+        }};
+      };
+      runner.add(std::move(benchmark));
+    }
+  }
+}
+
+/// Space points of a tracker event as given to the Acts seeder by TrackSeeding
+struct ActsSpacePoints {
+  SpacePointContainer container;
+  std::vector<SpacePoint> handles;
+  std::vector<const SpacePoint*> pointers;
+};
+
+void add_orthogonal_seed_finder(BenchmarkRunner& runner, std::uint64_t seed) {
+  for (double tracks : {10., 100.}) {
+    for (double noise : {0., 100., 1000.}) {
+      BenchmarkCase benchmark{"SeedFinderOrthogonal", {{"tracks", tracks}, {"noise", noise}}, {}};
+      benchmark.prepare = [=]() {
+        auto event = make_tracker_event(seed, tracks, noise);
+
+        // Without surfaces, the seeder only uses the positions and variances.
+        // The synthetic positions are exact, the variances are those of 0.1 mm resolution.
+        constexpr float variance = 0.01; // mm^2
+        auto space_points = std::make_shared<ActsSpacePoints>();
+        space_points->container.reserve(event->r.size());
+        for (std::size_t i = 0; i < event->r.size(); i++) {
+          space_points->container.push_back(event->r[i] * std::cos(event->phi[i]),
+                                            event->r[i] * std::sin(event->phi[i]), event->z[i],
+                                            variance, variance, nullptr);
+        }
+        space_points->handles.reserve(event->r.size());
+        for (std::size_t i = 0; i < event->r.size(); i++) {
+          space_points->pointers.push_back(&space_points->handles.emplace_back(space_points->container, i));
+        }
+
+        const auto [finder_cfg, options] = orthogonalSeedFinderConfig(OrthogonalTrackSeedingConfig{});
+        auto algo = std::make_shared<Acts::SeedFinderOrthogonal<SpacePoint>>(finder_cfg);
+        auto seeds = std::make_shared<SeedContainer>();
+        std::function<std::pair<Acts::Vector3, Acts::Vector2>(const SpacePoint* sp)>
+          create_coordinates = [](const SpacePoint* sp) {
+            return std::make_pair(Acts::Vector3(sp->x(), sp->y(), sp->z()),
+                                  Acts::Vector2(sp->varianceR(), sp->varianceZ()));
+          };
+        return PreparedBenchmark{[algo, options = options, space_points, seeds, create_coordinates]() {
+          *seeds = algo->createSeeds(options, space_points->pointers, create_coordinates);
+        }, event->r.size(), [event, seeds]() {
+          std::vector<std::array<std::size_t, 3>> space_points;
+          for (const auto& s : *seeds) {
+            space_points.push_back({s.sp()[0]->index(), s.sp()[1]->index(), s.sp()[2]->index()});
+          }
+          return seed_metrics(*event, space_points);
+        }};
+      };
+      runner.add(std::move(benchmark));
+    }
+  }
+}
+
+void print_usage(const char* program) {
+  fmt::print("Usage: {} [options]\n"
+             "  --filter STR          only run benchmarks whose id contains STR\n"
+             "  --min-time SECONDS    minimum time spent measuring each benchmark (default 0.2)\n"
+             "  --seed N              seed for the synthetic inputs (default 1)\n"
+             "  --output FILE         write results as JSON (default benchmark_algorithms.json)\n"
+             "  --baseline FILE       compare with results written earlier by --output\n"
+             "  --tolerance FRACTION  slowdown counted as a regression (default 0.1)\n"
+             "  --list                list benchmark ids and exit\n",
+             program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  BenchmarkRunner::Options options;
+  std::uint64_t seed = 1;
+  std::string output = "benchmark_algorithms.json";
+  std::string baseline;
+  double tolerance = 0.1;
+  bool list = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        fmt::print(stderr, "Missing value for {}\n", arg);
+        std::exit(EXIT_FAILURE);
+      }
+      return argv[++i];
+    };
+    if (arg == "--filter") {
+      options.filter = value();
+    } else if (arg == "--min-time") {
+      options.min_time_s = std::stod(value());
+    } else if (arg == "--seed") {
+      seed = std::stoull(value());
+    } else if (arg == "--output") {
+      output = value();
+    } else if (arg == "--baseline") {
+      baseline = value();
+    } else if (arg == "--tolerance") {
+      tolerance = std::stod(value());
+    } else if (arg == "--list") {
+      list = true;
+    } else {
+      print_usage(argv[0]);
+      return (arg == "--help" || arg == "-h") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  auto detector = make_mock_detector();
+  init_services(detector.get(), seed);
+
+  const std::string lut_filename =
+    (std::filesystem::temp_directory_path() / fmt::format("benchmark_algorithms_pid_lut_{}.txt", getpid())).string();
+
+  BenchmarkRunner runner(options);
+  add_island_cluster(runner, seed);
+  add_imaging_topo_cluster(runner, seed);
+  add_hexplit(runner, seed);
+  add_calorimeter_hit_digi(runner, seed);
+  add_cluster_reco_cog(runner, seed);
+  add_merge_particle_id(runner, seed);
+  add_pid_lookup(runner, seed, lut_filename);
+  add_hough_seed_finder(runner, seed);
+  add_orthogonal_seed_finder(runner, seed);
+
+  if (list) {
+    for (const auto& id : runner.ids()) {
+      fmt::print("{}\n", id);
+    }
+    return EXIT_SUCCESS;
+  }
+
+  int exit_code = EXIT_SUCCESS;
+  try {
+    write_pid_lookup_table(lut_filename, seed);
+    auto results = runner.run();
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    BenchmarkRunner::write_json(output, results, {
+      {"date", date},
+      {"seed", std::to_string(seed)},
+      {"min_time_s", std::to_string(options.min_time_s)},
+    });
+    fmt::print("Results written to {}\n", output);
+
+    if (!baseline.empty()) {
+      if (BenchmarkRunner::compare(results, BenchmarkRunner::read_json(baseline), tolerance) > 0) {
+        exit_code = EXIT_FAILURE;
+      }
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    exit_code = EXIT_FAILURE;
+  }
+
+  std::filesystem::remove(lut_filename);
+  return exit_code;
+}
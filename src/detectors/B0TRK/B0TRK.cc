@@ -42,6 +42,7 @@ void InitPlugin(JApplication *app) {
         {"B0TrackerRecHits"},
         {
             .timeResolution = 8,
+            .readout = "B0TrackerHits",
         },
         app
     ));
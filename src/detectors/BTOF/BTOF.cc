@@ -53,6 +53,7 @@ void InitPlugin(JApplication *app) {
         {"TOFBarrelRecHit"},     // Output data tag
         {
             .timeResolution = 10,
+            .readout = "TOFBarrelHits",
         },
         app
     ));         // Hit reco default config for factories
@@ -40,7 +40,9 @@ void InitPlugin(JApplication *app) {
         "SiBarrelTrackerRecHits",
         {"SiBarrelRawHits"},
         {"SiBarrelTrackerRecHits"},
-        {}, // default config
+        {
+            .readout = "SiBarrelHits",
+        },
         app
     ));
 
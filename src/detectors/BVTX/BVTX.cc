@@ -39,7 +39,9 @@ void InitPlugin(JApplication *app) {
         "SiBarrelVertexRecHits",
         {"SiBarrelVertexRawHits"},
         {"SiBarrelVertexRecHits"},
-        {}, // default config
+        {
+            .readout = "VertexBarrelHits",
+        },
         app
     ));
 
@@ -41,6 +41,7 @@ void InitPlugin(JApplication *app) {
       {"TOFEndcapRecHits"},     // Output data tag
       {
         .timeResolution = 0.025,
+        .readout = "TOFEndcapHits",
       },
       app
     ));
@@ -39,7 +39,9 @@ void InitPlugin(JApplication *app) {
         "SiEndcapTrackerRecHits",
         {"SiEndcapTrackerRawHits"},
         {"SiEndcapTrackerRecHits"},
-        {}, // default config
+        {
+            .readout = "TrackerEndcapHits",
+        },
         app
     ));
 
@@ -44,6 +44,7 @@ void InitPlugin(JApplication *app) {
         {"ForwardOffMTrackerRecHits"},
         {
             .timeResolution = 8,
+            .readout = "ForwardOffMTrackerHits",
         },
         app
     ));
@@ -109,9 +109,10 @@ extern "C" {
           inputClusterTags,
           {outputTrackTag},
           {
-            .layer_hits_max = 100,
+            .layer_hits_max = 1000,
             .chi2_max = 0.001,
             .n_layer = 4,
+            .road_window = 1.0,
             .restrict_direction = true,
             .optimum_theta = -M_PI+0.026,
             .optimum_phi = 0,
@@ -42,6 +42,7 @@ void InitPlugin(JApplication *app) {
         {"MPGDBarrelRecHits"},     // Output data tag
         {
             .timeResolution = 10,
+            .readout = "MPGDBarrelHits",
         },
         app
     ));
@@ -70,6 +71,7 @@ void InitPlugin(JApplication *app) {
         {"OuterMPGDBarrelRecHits"},     // Output data tag
         {
             .timeResolution = 10,
+            .readout = "OuterMPGDBarrelHits",
         },
         app
     ));
@@ -98,6 +100,7 @@ void InitPlugin(JApplication *app) {
         {"BackwardMPGDEndcapRecHits"},     // Output data tag
         {
             .timeResolution = 10,
+            .readout = "BackwardMPGDEndcapHits",
         },
         app
     ));
@@ -126,6 +129,7 @@ void InitPlugin(JApplication *app) {
         {"ForwardMPGDEndcapRecHits"},     // Output data tag
         {
             .timeResolution = 10,
+            .readout = "ForwardMPGDEndcapHits",
         },
         app
     ));
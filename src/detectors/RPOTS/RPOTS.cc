@@ -44,6 +44,7 @@ void InitPlugin(JApplication *app) {
         {"ForwardRomanPotRecHits"},
         {
             .timeResolution = 8,
+            .readout = "ForwardRomanPotHits",
         },
         app
     ));
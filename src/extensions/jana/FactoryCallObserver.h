@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+/**
+ * Hook for profilers that want to measure resources used by individual factory calls.
+ *
+ * JOmniFactory notifies the installed observer, if any, immediately before and after
+ * running its algorithm, on the thread running the factory. Calls may nest if an
+ * algorithm triggers other factories.
+ */
+class FactoryCallObserver {
+public:
+    virtual ~FactoryCallObserver() = default;
+
+    virtual void BeginCall(const std::string& prefix) = 0;
+    virtual void EndCall(const std::string& prefix) = 0;
+
+    /// Currently installed observer, or nullptr
+    static std::atomic<FactoryCallObserver*>& Instance() {
+        static std::atomic<FactoryCallObserver*> observer{nullptr};
+        return observer;
+    }
+
+    /// Notifies the installed observer for the lifetime of the scope
+    class Scope {
+    public:
+        explicit Scope(const std::string& prefix)
+            : m_observer(Instance().load(std::memory_order_acquire)), m_prefix(prefix) {
+            if (m_observer != nullptr) {
+                m_observer->BeginCall(m_prefix);
+            }
+        }
+        ~Scope() {
+            if (m_observer != nullptr) {
+                m_observer->EndCall(m_prefix);
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FactoryCallObserver* m_observer;
+        const std::string& m_prefix;
+    };
+};
@@ -15,6 +15,8 @@
 #include <JANA/JEvent.h>
 #include <spdlog/spdlog.h>
 
+#include "algorithms/interfaces/RandomStreamSvc.h"
+#include "extensions/jana/FactoryCallObserver.h"
 #include "services/io/podio/datamodel_glue.h"
 #include "services/log/Log_service.h"
 
@@ -556,7 +558,11 @@ public:
             for (auto* output : m_outputs) {
                 output->Reset();
             }
-            static_cast<AlgoT*>(this)->Process(event->GetRunNumber(), event->GetEventNumber());
+            {
+                FactoryCallObserver::Scope observed_call(m_prefix);
+                algorithms::RandomStreamSvc::EventScope random_event(event->GetRunNumber(), event->GetEventNumber());
+                static_cast<AlgoT*>(this)->Process(event->GetRunNumber(), event->GetEventNumber());
+            }
             for (auto* output : m_outputs) {
                 output->SetCollection(*this);
             }
@@ -34,6 +34,7 @@ private:
     ParameterRef<std::string> m_sectorField {this, "sectorField", config().sectorField};
     ParameterRef<std::string> m_localDetElement {this, "localDetElement", config().localDetElement};
     ParameterRef<std::vector<std::string>> m_localDetFields {this, "localDetFields", config().localDetFields};
+    ParameterRef<bool> m_prefillCellGeometry {this, "prefillCellGeometry", config().prefillCellGeometry};
 
     Service<AlgorithmsInit_service> m_algorithmsInit {this};
 
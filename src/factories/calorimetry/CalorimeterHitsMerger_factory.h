@@ -22,6 +22,7 @@ private:
     ParameterRef<std::string> m_readout {this, "readout", config().readout};
     ParameterRef<std::vector<std::string>> m_fields {this, "fields", config().fields};
     ParameterRef<std::vector<int>> m_refs {this, "refs", config().refs};
+    ParameterRef<bool> m_prefillCellGeometry {this, "prefillCellGeometry", config().prefillCellGeometry};
 
     Service<AlgorithmsInit_service> m_algorithmsInit {this};
 
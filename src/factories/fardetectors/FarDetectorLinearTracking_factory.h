@@ -27,6 +27,7 @@ private:
     ParameterRef<int>   n_layer        {this, "numLayers",       config().n_layer         };
     ParameterRef<int>   layer_hits_max {this, "layerHitsMax",    config().layer_hits_max  };
     ParameterRef<float> chi2_max       {this, "chi2Max",         config().chi2_max        };
+    ParameterRef<float> road_window    {this, "roadWindow",      config().road_window     };
 
   public:
     void Configure() {
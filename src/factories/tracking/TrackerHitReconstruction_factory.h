@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "algorithms/tracking/TrackerHitReconstruction.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 #include "extensions/jana/JOmniFactory.h"
@@ -19,13 +21,15 @@ public JOmniFactory<TrackerHitReconstruction_factory, TrackerHitReconstructionCo
     PodioOutput<edm4eic::TrackerHit> m_rec_hits_output {this};
 
     ParameterRef<float> m_timeResolution {this, "timeResolution", config().timeResolution};
+    ParameterRef<std::string> m_readout {this, "readout", config().readout};
+    ParameterRef<bool> m_prefillCellGeometry {this, "prefillCellGeometry", config().prefillCellGeometry};
 
     Service<DD4hep_service> m_geoSvc {this};
 
 public:
     void Configure() {
         m_algo.applyConfig(config());
-        m_algo.init(m_geoSvc().converter(), logger());
+        m_algo.init(m_geoSvc().detector(), m_geoSvc().converter(), logger());
     }
 
     void ChangeRun(int64_t run_number) {
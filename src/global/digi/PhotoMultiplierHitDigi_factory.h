@@ -60,12 +60,12 @@ public:
 
         // Initialize richgeo ReadoutGeo and set random CellID visitor lambda (if a RICH)
         if (GetPluginName() == "DRICH" || GetPluginName() == "PFRICH") {
-            m_RichGeoSvc().GetReadoutGeo(GetPluginName())->SetSeed(config().seed);
+            auto readout_geo = m_RichGeoSvc().GetReadoutGeo(GetPluginName());
             m_algo->SetVisitRngCellIDs(
-                [this] (std::function<void(PhotoMultiplierHitDigi::CellIDType)> lambda, float p) { m_RichGeoSvc().GetReadoutGeo(GetPluginName())->VisitAllRngPixels(lambda, p); }
+                [readout_geo] (std::function<void(PhotoMultiplierHitDigi::CellIDType)> lambda, float p, algorithms::RandomStream& rng) { readout_geo->VisitAllRngPixels(lambda, p, rng); }
                 );
             m_algo->SetPixelGapMask(
-                [this] (PhotoMultiplierHitDigi::CellIDType cellID, dd4hep::Position pos) { return m_RichGeoSvc().GetReadoutGeo(GetPluginName())->PixelGapMask(cellID, pos); }
+                [readout_geo] (PhotoMultiplierHitDigi::CellIDType cellID, dd4hep::Position pos) { return readout_geo->PixelGapMask(cellID, pos); }
                 );
         }
 
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "ActsExamples/EventData/Trajectories.hpp"
+#include "algorithms/tracking/ActsMeasurements.h"
 #include "algorithms/tracking/CKFTracking.h"
 #include "algorithms/tracking/CKFTrackingConfig.h"
 #include "extensions/jana/JOmniFactory.h"
@@ -29,13 +30,15 @@ private:
     std::unique_ptr<AlgoT> m_algo;
 
     PodioInput<edm4eic::TrackParameters> m_parameters_input {this};
-    PodioInput<edm4eic::Measurement2D> m_measurements_input {this};
+    Input<ActsMeasurements> m_acts_measurements_input {this};
     Output<ActsExamples::Trajectories> m_acts_trajectories_output {this};
     Output<ActsExamples::ConstTrackContainer> m_acts_tracks_output {this};
 
     ParameterRef<std::vector<double>> m_etaBins {this, "EtaBins", config().etaBins, "Eta Bins for ACTS CKF tracking reco"};
     ParameterRef<std::vector<double>> m_chi2CutOff {this, "Chi2CutOff", config().chi2CutOff, "Chi2 Cut Off for ACTS CKF tracking"};
     ParameterRef<std::vector<size_t>> m_numMeasurementsCutOff {this, "NumMeasurementsCutOff", config().numMeasurementsCutOff, "Number of measurements Cut Off for ACTS CKF tracking"};
+    ParameterRef<size_t> m_seedChunkSize {this, "SeedChunkSize", config().seedChunkSize, "Number of seeds per chunk processed in parallel within an event (0: no chunking)"};
+    ParameterRef<size_t> m_maxChunkThreads {this, "MaxChunkThreads", config().maxChunkThreads, "Maximum number of threads working on the seed chunks of an event, including the event's thread (0: all threads of the task pool)"};
 
     Service<ACTSGeo_service> m_ACTSGeoSvc {this};
 
@@ -54,7 +57,7 @@ public:
             m_acts_trajectories_output(),
             m_acts_tracks_output()
         ) = m_algo->process(
-            *m_measurements_input(),
+            *m_acts_measurements_input().at(0),
             *m_parameters_input()
         );
     }
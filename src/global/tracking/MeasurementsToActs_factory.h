@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright 2024, Dmitry Kalinkin
+
+#pragma once
+
+#include <memory>
+
+#include "algorithms/tracking/ActsMeasurements.h"
+#include "algorithms/tracking/MeasurementsToActs.h"
+#include "extensions/jana/JOmniFactory.h"
+
+namespace eicrecon {
+
+class MeasurementsToActs_factory
+    : public JOmniFactory<MeasurementsToActs_factory> {
+public:
+  using AlgoT = eicrecon::MeasurementsToActs;
+
+private:
+  std::unique_ptr<AlgoT> m_algo;
+
+  PodioInput<edm4eic::Measurement2D> m_measurements_input {this};
+  Output<ActsMeasurements> m_acts_measurements_output {this};
+
+public:
+  void Configure() {
+    m_algo = std::make_unique<AlgoT>(this->GetPrefix());
+    m_algo->level((algorithms::LogLevel)logger()->level());
+    m_algo->init();
+  };
+
+  void ChangeRun(int64_t run_number) {};
+
+  void Process(int64_t run_number, uint64_t event_number) {
+    auto acts_measurements = std::make_unique<ActsMeasurements>();
+    m_algo->process({m_measurements_input()}, {acts_measurements.get()});
+    m_acts_measurements_output() = {acts_measurements.release()};
+  }
+};
+
+} // namespace eicrecon
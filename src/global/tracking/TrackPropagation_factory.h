@@ -32,6 +32,8 @@ private:
     Input<ActsExamples::ConstTrackContainer> m_acts_tracks_input {this};
     PodioOutput<edm4eic::TrackSegment> m_track_segments_output {this};
 
+    ParameterRef<size_t> m_maxThreads {this, "MaxThreads", config().maxThreads, "Maximum number of threads propagating the trajectories of an event, including the event's thread (0: all threads of the task pool)"};
+
     Service<DD4hep_service> m_GeoSvc {this};
     Service<ACTSGeo_service> m_ACTSGeoSvc {this};
 
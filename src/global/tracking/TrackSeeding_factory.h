@@ -6,6 +6,7 @@
 
 #include <JANA/JEvent.h>
 #include <edm4eic/TrackParametersCollection.h>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
@@ -29,6 +30,7 @@ private:
     PodioOutput<edm4eic::TrackParameters> m_parameters_output {this};
 
 
+    ParameterRef<std::string> m_seeder {this, "seeder", config().seeder, "Seed finder: orthogonal (Acts::OrthogonalSeedFinder) or hough (HoughSeedFinder)"};
     ParameterRef<float> m_rMax {this, "rMax", config().rMax, "max measurement radius for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_rMin {this, "rMin", config().rMin, "min measurement radius for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_deltaRMinTopSP {this, "deltaRMinTopSP", config().deltaRMinTopSP, "min distance in r between middle and top space point in one seed for Acts::OrthogonalSeedFinder"};
@@ -50,6 +52,12 @@ private:
     ParameterRef<float> m_impactMax {this, "impactMax", config().impactMax, "maximum impact parameter allowed for seeds for Acts::OrthogonalSeedFinder. rMin should be larger than impactMax."};
     ParameterRef<float> m_rMinMiddle {this, "rMinMiddle", config().rMinMiddle, "min radius for middle space point for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_rMaxMiddle {this, "rMaxMiddle", config().rMaxMiddle, "max radius for middle space point for Acts::OrthogonalSeedFinder"};
+    ParameterRef<size_t> m_houghPhiBins {this, "houghPhiBins", config().houghPhiBins, "Number of phi0 bins for HoughSeedFinder"};
+    ParameterRef<size_t> m_houghCurvatureBins {this, "houghCurvatureBins", config().houghCurvatureBins, "Number of signed curvature bins for HoughSeedFinder"};
+    ParameterRef<float> m_houghMinPt {this, "houghMinPt", config().houghMinPt, "Minimum pT of seeds for HoughSeedFinder"};
+    ParameterRef<size_t> m_houghCotThetaBins {this, "houghCotThetaBins", config().houghCotThetaBins, "Number of cot theta bins for HoughSeedFinder, within -cotThetaMax and cotThetaMax"};
+    ParameterRef<size_t> m_houghZ0Bins {this, "houghZ0Bins", config().houghZ0Bins, "Number of z0 bins for HoughSeedFinder, within the collision region"};
+    ParameterRef<size_t> m_houghMinHits {this, "houghMinHits", config().houghMinHits, "Minimum number of layers with measurements on a seed for HoughSeedFinder"};
     ParameterRef<float> m_locaError {this, "loc_a_Error", config().locaError, "Error on Loc a for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_locbError {this, "loc_b_Error", config().locbError, "Error on Loc b for Acts::OrthogonalSeedFinder"};
     ParameterRef<float> m_phiError {this, "phi_Error", config().phiError, "Error on phi for Acts::OrthogonalSeedFinder"};
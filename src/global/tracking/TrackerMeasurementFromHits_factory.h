@@ -35,7 +35,7 @@ private:
 public:
     void Configure() {
         m_algo = std::make_unique<AlgoT>();
-        m_algo->init(m_DD4hepSvc().detector(), m_DD4hepSvc().converter(), m_ACTSGeoSvc().actsGeoProvider(), logger());
+        m_algo->init(m_DD4hepSvc().detector(), m_ACTSGeoSvc().actsGeoProvider(), logger());
     }
 
     void ChangeRun(int64_t run_number) {
@@ -18,6 +18,7 @@
 #include "AmbiguitySolver_factory.h"
 #include "CKFTracking_factory.h"
 #include "IterativeVertexFinder_factory.h"
+#include "MeasurementsToActs_factory.h"
 #include "TrackParamTruthInit_factory.h"
 #include "TrackProjector_factory.h"
 #include "TrackPropagationConfig.h"
@@ -84,11 +85,19 @@ void InitPlugin(JApplication *app) {
             app
             ));
 
+    // Acts measurements are converted once and shared by both CKF chains
+    app->Add(new JOmniFactoryGeneratorT<MeasurementsToActs_factory>(
+        "CentralTrackerActsMeasurements",
+        {"CentralTrackerMeasurements"},
+        {"CentralTrackerActsMeasurements"},
+        app
+    ));
+
     app->Add(new JOmniFactoryGeneratorT<CKFTracking_factory>(
         "CentralCKFTrajectories",
         {
             "InitTrackParams",
-            "CentralTrackerMeasurements"
+            "CentralTrackerActsMeasurements"
         },
         {
             "CentralCKFActsTrajectoriesUnfiltered",
@@ -150,7 +159,7 @@ void InitPlugin(JApplication *app) {
         "CentralCKFSeededTrajectories",
         {
             "CentralTrackSeedingResults",
-            "CentralTrackerMeasurements"
+            "CentralTrackerActsMeasurements"
         },
         {
             "CentralCKFSeededActsTrajectoriesUnfiltered",
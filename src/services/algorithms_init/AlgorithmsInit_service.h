@@ -12,8 +12,12 @@
 #include <algorithms/service.h>
 #include <spdlog/common.h>
 #include <spdlog/logger.h>
+#include <cstddef>
+#include <cstdint>
 
 #include "algorithms/interfaces/ParticleSvc.h"
+#include "algorithms/interfaces/RandomStreamSvc.h"
+#include "algorithms/interfaces/TaskPoolSvc.h"
 #include "services/log/Log_service.h"
 #include "services/geometry/dd4hep/DD4hep_service.h"
 
@@ -23,8 +27,11 @@
 class AlgorithmsInit_service : public JService
 {
   public:
-    AlgorithmsInit_service(JApplication *app) { };
-    virtual ~AlgorithmsInit_service() { };
+    AlgorithmsInit_service(JApplication *app) : m_app(app) { };
+    virtual ~AlgorithmsInit_service() {
+        // Join the task pool threads while the application is still around
+        algorithms::TaskPoolSvc::instance().stop();
+    };
 
     void acquire_services(JServiceLocator *srv_locator) override {
         auto& serviceSvc = algorithms::ServiceSvc::instance();
@@ -70,6 +77,24 @@ class AlgorithmsInit_service : public JService
             r.init();
         });
 
+        // Register counter-based random streams, reproducible regardless of threading
+        m_app->SetDefaultParameter("random:seed", m_random_seed,
+            "Seed of the random streams of digitization algorithms");
+        [[maybe_unused]] auto& randomStreamSvc = algorithms::RandomStreamSvc::instance();
+        serviceSvc.setInit<algorithms::RandomStreamSvc>([this](auto&& r) {
+            this->m_log->debug("Initializing algorithms::RandomStreamSvc with seed {}", this->m_random_seed);
+            r.init(this->m_random_seed);
+        });
+
+        // Register a task pool for algorithms that split events into tasks
+        m_app->SetDefaultParameter("taskpool:nthreads", m_task_pool_threads,
+            "Number of threads shared by algorithms that split an event into parallel tasks, in addition to jana:nthreads (0: tasks run on the event's thread)");
+        [[maybe_unused]] auto& taskPoolSvc = algorithms::TaskPoolSvc::instance();
+        serviceSvc.setInit<algorithms::TaskPoolSvc>([this](auto&& p) {
+            this->m_log->debug("Initializing algorithms::TaskPoolSvc with {} threads", this->m_task_pool_threads);
+            p.init(this->m_task_pool_threads);
+        });
+
         // Register a particle service
         [[maybe_unused]] auto& particleSvc = algorithms::ParticleSvc::instance();
 
@@ -79,6 +104,9 @@ class AlgorithmsInit_service : public JService
 
   private:
     AlgorithmsInit_service() = default;
+    JApplication* m_app{nullptr};
+    std::uint64_t m_random_seed{1};
+    std::size_t m_task_pool_threads{0};
     std::shared_ptr<Log_service> m_log_service;
     std::shared_ptr<DD4hep_service> m_dd4hep_service;
     std::shared_ptr<spdlog::logger> m_log;
@@ -4,9 +4,12 @@
 #include <TInterpreter.h>
 #include <TInterpreterValue.h>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <fmt/core.h>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 
 #include "EvaluatorSvc.h"
 
@@ -20,9 +23,11 @@ void EvaluatorSvc::init() {
 
 std::function<double(const std::unordered_map<std::string, double>&)>
 EvaluatorSvc::_compile(const std::string& expr, std::vector<std::string> params) {
-  std::lock_guard<std::mutex> guard(m_interpreter_mutex);
-
-  std::string func_name = fmt::format("_eicrecon_{}", m_function_id++);
+  std::string func_name;
+  {
+    std::lock_guard<std::mutex> guard(m_interpreter_mutex);
+    func_name = fmt::format("_eicrecon_{}", m_function_id++);
+  }
   std::ostringstream sstr;
   sstr << "double " << func_name << "(double params[]){";
   for (unsigned int param_ix = 0; const auto& p : params) {
@@ -31,13 +36,8 @@ EvaluatorSvc::_compile(const std::string& expr, std::vector<std::string> params)
   sstr << "return " << expr << ";";
   sstr << "}";
 
-  TInterpreter* interp = TInterpreter::Instance();
-  debug("Compiling {}", sstr.str());
-  interp->ProcessLine(sstr.str().c_str());
-  std::unique_ptr<TInterpreterValue> func_val{gInterpreter->MakeInterpreterValue()};
-  interp->Evaluate(func_name.c_str(), *func_val);
   typedef double (*func_t)(double params[]);
-  func_t func = ((func_t)(func_val->GetAsPointer()));
+  func_t func = ((func_t)(_declare(func_name, sstr.str())));
 
   return [params, func](const std::unordered_map<std::string, double>& param_values) {
     std::vector<double> value_list;
@@ -49,4 +49,105 @@ EvaluatorSvc::_compile(const std::string& expr, std::vector<std::string> params)
   };
 }
 
+std::function<double(std::uint64_t)>
+EvaluatorSvc::compile(const std::string& expr, const dd4hep::IDDescriptor& id_spec) {
+  // Constant expressions are the most common, they need no interpreter
+  double constant;
+  if (_constant(expr, constant)) {
+    debug("Expression \"{}\" is a constant", expr);
+    return [constant](std::uint64_t) { return constant; };
+  }
+
+  std::string func_name;
+  {
+    std::lock_guard<std::mutex> guard(m_interpreter_mutex);
+    func_name = fmt::format("_eicrecon_{}", m_function_id++);
+  }
+  std::ostringstream sstr;
+  sstr << "double " << func_name << "(unsigned long long cellID){";
+  sstr << _decode_fields(id_spec, "cellID");
+  sstr << "return " << expr << ";";
+  sstr << "}";
+
+  typedef double (*func_t)(unsigned long long cellID);
+  func_t func = ((func_t)(_declare(func_name, sstr.str())));
+
+  return [func](std::uint64_t cellID) { return func(cellID); };
+}
+
+std::function<void(std::span<const std::uint64_t>, std::span<float>)>
+EvaluatorSvc::compile_batch(const std::string& expr, const dd4hep::IDDescriptor& id_spec) {
+  double constant;
+  if (_constant(expr, constant)) {
+    debug("Expression \"{}\" is a constant", expr);
+    return [constant](std::span<const std::uint64_t> cellIDs, std::span<float> values) {
+      if (values.size() < cellIDs.size()) {
+        throw std::length_error("EvaluatorSvc: output span is shorter than the input");
+      }
+      std::fill_n(values.begin(), cellIDs.size(), constant);
+    };
+  }
+
+  std::string func_name;
+  {
+    std::lock_guard<std::mutex> guard(m_interpreter_mutex);
+    func_name = fmt::format("_eicrecon_{}", m_function_id++);
+  }
+  std::ostringstream sstr;
+  sstr << "void " << func_name << "(const unsigned long long* cellIDs, float* values, unsigned long n){";
+  sstr << "for (unsigned long ix = 0; ix < n; ++ix) {";
+  sstr << "unsigned long long cellID = cellIDs[ix];";
+  sstr << _decode_fields(id_spec, "cellID");
+  sstr << "values[ix] = " << expr << ";";
+  sstr << "}";
+  sstr << "}";
+
+  typedef void (*func_t)(const unsigned long long* cellIDs, float* values, unsigned long n);
+  func_t func = ((func_t)(_declare(func_name, sstr.str())));
+
+  return [func](std::span<const std::uint64_t> cellIDs, std::span<float> values) {
+    if (values.size() < cellIDs.size()) {
+      throw std::length_error("EvaluatorSvc: output span is shorter than the input");
+    }
+    static_assert(sizeof(std::uint64_t) == sizeof(unsigned long long));
+    func(reinterpret_cast<const unsigned long long*>(cellIDs.data()), values.data(), cellIDs.size());
+  };
+}
+
+bool EvaluatorSvc::_constant(const std::string& expr, double& value) {
+  const char* begin = expr.c_str();
+  char* end = nullptr;
+  value = std::strtod(begin, &end);
+  const char* rest = end;
+  return (rest != begin) && std::all_of(rest, begin + expr.size(), [](unsigned char c) { return std::isspace(c); });
+}
+
+void* EvaluatorSvc::_declare(const std::string& func_name, const std::string& code) {
+  std::lock_guard<std::mutex> guard(m_interpreter_mutex);
+
+  TInterpreter* interp = TInterpreter::Instance();
+  debug("Compiling {}", code);
+  interp->ProcessLine(code.c_str());
+  std::unique_ptr<TInterpreterValue> func_val{gInterpreter->MakeInterpreterValue()};
+  interp->Evaluate(func_name.c_str(), *func_val);
+  return func_val->GetAsPointer();
+}
+
+std::string EvaluatorSvc::_decode_fields(const dd4hep::IDDescriptor& id_spec, const std::string& cellID) {
+  // Same decoding as dd4hep::BitFieldElement::value, with constant offsets
+  std::ostringstream sstr;
+  for (const auto& [name, field] : id_spec.fields()) {
+    const unsigned int offset = field->offset();
+    const unsigned int width  = field->width();
+    if (field->isSigned()) {
+      sstr << "double " << name << " = (double)(((long long)(" << cellID << " << " << (64 - offset - width)
+           << ")) >> " << (64 - width) << ");";
+    } else {
+      sstr << "double " << name << " = (double)((" << cellID << " & " << field->mask() << "ULL) >> "
+           << offset << ");";
+    }
+  }
+  return sstr.str();
+}
+
 } // namespace eicrecon
@@ -1,9 +1,12 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 // Copyright (C) 2024 Dmitry Kalinkin
 
+#include <DD4hep/IDDescriptor.h>
 #include <algorithms/logger.h>
+#include <cstdint>
 #include <functional>
 #include <mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -62,7 +65,42 @@ public:
   std::function<double(const std::unordered_map<std::string, double>&)>
   _compile(const std::string& expr, std::vector<std::string> params);
 
+  /**
+   * @brief Compile expression `expr` over the fields of a readout
+   * @param expr String expression to compile (e.g. `"(layer == 0) ? 0.019 : 0.037"`)
+   * @param id_spec Readout ID descriptor, its fields are the parameters
+   *
+   * The field offsets and widths are bound into the generated code, so the
+   * resulting function decodes the cellID directly and does not allocate.
+   * Expressions that are plain numbers are not passed to the interpreter.
+   */
+  std::function<double(std::uint64_t)>
+  compile(const std::string& expr, const dd4hep::IDDescriptor& id_spec);
+
+  /**
+   * @brief Compile expression `expr` over the fields of a readout for batches
+   * @param expr String expression to compile
+   * @param id_spec Readout ID descriptor, its fields are the parameters
+   *
+   * The resulting function evaluates the expression for every cellID of the
+   * first span into the corresponding element of the second one, which must
+   * have at least the same size. Expressions that are plain numbers are not
+   * passed to the interpreter.
+   */
+  std::function<void(std::span<const std::uint64_t>, std::span<float>)>
+  compile_batch(const std::string& expr, const dd4hep::IDDescriptor& id_spec);
+
 private:
+  /// Whether `expr` is a plain number, which is then stored in `value`
+  static bool _constant(const std::string& expr, double& value);
+
+  /// Declare `code` to the interpreter and return the address of `func_name`
+  void* _declare(const std::string& func_name, const std::string& code);
+
+  /// C++ statements defining a double variable for each readout field
+  static std::string _decode_fields(const dd4hep::IDDescriptor& id_spec, const std::string& cellID);
+
+
   unsigned int m_function_id = 0;
   std::mutex m_interpreter_mutex;
 
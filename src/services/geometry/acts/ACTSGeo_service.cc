@@ -8,7 +8,9 @@
 #include <Acts/Visualization/ViewConfig.hpp>
 #include <JANA/JException.h>
 #include <array>
+#include <cstddef>
 #include <exception>
+#include <filesystem>
 #include <gsl/pointers>
 #include <stdexcept>
 #include <string>
@@ -86,6 +88,21 @@ std::shared_ptr<const ActsGeometryProvider> ACTSGeo_service::actsGeoProvider() {
             m_acts_provider->setPassiveView(passiveView);
             m_acts_provider->setGridView(gridView);
 
+            auto fieldGrid = m_acts_provider->getFieldGridConfig();
+            std::size_t fieldValidationPoints = m_acts_provider->getFieldValidationPoints();
+            m_app->SetDefaultParameter("acts:BFieldGrid", fieldGrid.type, "Interpolate the magnetic field on a grid: none, rz (axially symmetric) or xyz");
+            m_app->SetDefaultParameter("acts:BFieldGridMin", fieldGrid.min, "Lower grid corner (x,y,z) [mm], for rz only z is used");
+            m_app->SetDefaultParameter("acts:BFieldGridMax", fieldGrid.max, "Upper grid corner (x,y,z) [mm], for rz x is the maximum radius");
+            m_app->SetDefaultParameter("acts:BFieldGridStep", fieldGrid.step, "Grid spacing (x,y,z) [mm], for rz x is the radial spacing");
+            m_app->SetDefaultParameter("acts:BFieldGridFile", fieldGrid.file, "File to read the field grid from, or to write it to if missing or not matching");
+            m_app->SetDefaultParameter("acts:BFieldValidationPoints", fieldValidationPoints, "Number of random points at which to report the grid deviation from the exact field (0: no validation)");
+            // Keep the sampled grid next to the geometry snapshot, if there is one
+            if (fieldGrid.type != "none" && fieldGrid.file.empty() && !m_snapshot_file.empty()) {
+                fieldGrid.file = std::filesystem::path(m_snapshot_file).replace_extension(".bfield").string();
+            }
+            m_acts_provider->setFieldGridConfig(fieldGrid);
+            m_acts_provider->setFieldValidationPoints(fieldValidationPoints);
+
             // Initialize m_acts_provider
             m_acts_provider->initialize(m_dd4hepGeo, material_map_file, m_log, m_log);
 
@@ -110,4 +127,5 @@ void ACTSGeo_service::acquire_services(JServiceLocator * srv_locator) {
     // DD4Hep geometry
     auto dd4hep_service = srv_locator->get<DD4hep_service>();
     m_dd4hepGeo = dd4hep_service->detector();
+    m_snapshot_file = dd4hep_service->snapshotFile();
 }
@@ -9,6 +9,7 @@
 #include <spdlog/logger.h>
 #include <memory>
 #include <mutex>
+#include <string>
 
 #include "algorithms/tracking/ActsGeometryProvider.h"
 
@@ -31,6 +32,7 @@ private:
     std::once_flag m_init_flag;
     JApplication *m_app = nullptr;
     const dd4hep::Detector* m_dd4hepGeo = nullptr;
+    std::string m_snapshot_file;
     std::shared_ptr<ActsGeometryProvider> m_acts_provider;
 
     // General acts log
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include "CellGeoSnapshot_processor.h"
+
+#include <JANA/Services/JParameterManager.h>
+#include <chrono>
+#include <exception>
+#include <string_view>
+#include <utility>
+
+#include "CellGeoSvc.h"
+#include "services/geometry/dd4hep/DD4hep_service.h"
+#include "services/log/Log_service.h"
+
+void CellGeoSnapshot_processor::Init() {
+    auto* app = GetApplication();
+    m_log = app->GetService<Log_service>()->logger("cellgeo");
+
+    // Nothing to do unless snapshots are enabled, finding the snapshot does not load the geometry
+    if (!app->GetJParameterManager()->Exists("dd4hep:snapshot_dir")) {
+        return;
+    }
+    auto dd4hep_service = app->GetService<DD4hep_service>();
+    m_snapshot_file = dd4hep_service->snapshotFile();
+    m_snapshot_key = dd4hep_service->snapshotKey();
+    if (m_snapshot_file.empty()) {
+        return;
+    }
+
+    try {
+        m_snapshot = eicrecon::GeometrySnapshot::open(m_snapshot_file, m_snapshot_key);
+    } catch (std::exception& e) {
+        m_log->warn("Ignoring geometry snapshot: {}", e.what());
+    }
+    if (m_snapshot != nullptr) {
+        const auto start = std::chrono::steady_clock::now();
+        eicrecon::CellGeoSvc::instance().restore(m_snapshot->sections(), m_snapshot);
+        m_log->info("Restored cellID geometry caches from {} in {:.3f} s", m_snapshot_file,
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+void CellGeoSnapshot_processor::Finish() {
+    if (m_snapshot_file.empty()) {
+        return;
+    }
+    auto sections = eicrecon::CellGeoSvc::instance().save();
+    if (sections.empty()) {
+        return;
+    }
+    // Keep the sections of caches that were not used in this job
+    if (m_snapshot != nullptr) {
+        for (const auto& [name, contents] : m_snapshot->sections()) {
+            sections.try_emplace(name, contents.begin(), contents.end());
+        }
+    }
+    try {
+        eicrecon::GeometrySnapshot::write(m_snapshot_file, m_snapshot_key, sections);
+        m_log->info("Saved cellID geometry caches to {}", m_snapshot_file);
+    } catch (std::exception& e) {
+        m_log->warn("{}", e.what());
+    }
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <spdlog/logger.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "services/geometry/dd4hep/GeometrySnapshot.h"
+
+/**
+ * Restores the CellGeoSvc caches from the geometry snapshot before any
+ * algorithm runs, and saves them back at the end of the job if they gained
+ * records. Does nothing unless dd4hep:snapshot_dir is set.
+ */
+class CellGeoSnapshot_processor : public JEventProcessor {
+public:
+    explicit CellGeoSnapshot_processor(JApplication* app) : JEventProcessor(app) {}
+
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override {};
+    void Finish() override;
+
+private:
+    std::shared_ptr<spdlog::logger> m_log;
+    std::string m_snapshot_file;
+    std::uint64_t m_snapshot_key{0};
+    std::shared_ptr<const eicrecon::GeometrySnapshot> m_snapshot;
+};
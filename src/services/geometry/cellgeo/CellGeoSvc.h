@@ -0,0 +1,427 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <algorithms/logger.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Lock-free, insert-only map from cellID to a geometry record
+ *
+ * Lookups never block: a reader that finds a slot still being written, or a
+ * writer that cannot insert, computes the value itself. Storage is allocated
+ * on demand as a chain of open addressing tables, each twice the size of the
+ * previous one, up to `max_capacity` slots in total. Cells that do not fit
+ * are simply not cached. Values must be default-constructible and copyable.
+ */
+template <typename T>
+class CellGeoCache {
+public:
+  static constexpr std::size_t kInitialCapacity = 1 << 10;
+
+  explicit CellGeoCache(std::size_t max_capacity, std::size_t initial_capacity = kInitialCapacity)
+    : m_max_capacity(max_capacity) {
+    std::size_t n_slots = 16;
+    while (n_slots < std::min(initial_capacity, max_capacity)) {
+      n_slots <<= 1;
+    }
+    m_tables[0].store(new Table(n_slots), std::memory_order_release);
+    m_capacity = n_slots;
+    m_n_tables.store(1, std::memory_order_release);
+  }
+
+  CellGeoCache(const CellGeoCache&) = delete;
+  CellGeoCache& operator=(const CellGeoCache&) = delete;
+
+  ~CellGeoCache() {
+    for (auto& table : m_tables) {
+      delete table.load(std::memory_order_acquire);
+    }
+  }
+
+  /// Value for cellID, calls compute(cellID) and caches the result on a miss.
+  /// Exceptions from compute propagate and nothing is cached.
+  template <typename F>
+  T get(std::uint64_t cellID, F&& compute) {
+    if (cellID == kEmpty) {
+      return compute(cellID);
+    }
+    const std::size_t n_tables = m_n_tables.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < n_tables; ++i) {
+      if (const Slot* slot = m_tables[i].load(std::memory_order_acquire)->find(cellID)) {
+        if (slot->ready.load(std::memory_order_acquire)) {
+          return slot->value;
+        }
+        // being written by another thread
+        return compute(cellID);
+      }
+    }
+
+    T value = compute(cellID);
+    insert(cellID, value);
+    return value;
+  }
+
+  /// Eagerly cache the values for a range of cellIDs, cells for which compute
+  /// throws are skipped. Returns the number of such cells.
+  template <typename Range, typename F>
+  std::size_t prefill(const Range& cellIDs, F&& compute) {
+    std::size_t n_failed = 0;
+    for (std::uint64_t cellID : cellIDs) {
+      try {
+        get(cellID, compute);
+      } catch (...) {
+        ++n_failed;
+      }
+    }
+    return n_failed;
+  }
+
+  /// True for the first caller only, so that one of the instances sharing the cache prefills it.
+  /// False for caches restored from a snapshot.
+  bool claim_prefill() { return !m_prefill_claimed.exchange(true, std::memory_order_acq_rel); }
+
+  /// Cache a known value, e.g. one read back from a snapshot
+  void put(std::uint64_t cellID, const T& value) {
+    if (cellID != kEmpty) {
+      insert(cellID, value);
+    }
+  }
+
+  /// Calls f(cellID, value) for every cached value
+  template <typename F>
+  void for_each(F&& f) const {
+    const std::size_t n_tables = m_n_tables.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < n_tables; ++i) {
+      const Table& table = *m_tables[i].load(std::memory_order_acquire);
+      for (std::size_t j = 0; j <= table.mask; ++j) {
+        const Slot& slot = table.slots[j];
+        if (slot.ready.load(std::memory_order_acquire)) {
+          f(slot.key.load(std::memory_order_relaxed), slot.value);
+        }
+      }
+    }
+  }
+
+  /// Number of cached values
+  std::size_t size() const { return m_size.load(std::memory_order_relaxed); }
+  /// Number of slots allocated so far
+  std::size_t capacity() const {
+    std::lock_guard<std::mutex> lock(m_grow_mutex);
+    return m_capacity;
+  }
+  /// Number of values that can be cached at most
+  std::size_t max_size() const { return m_max_capacity - m_max_capacity / 4; }
+
+private:
+  static constexpr std::uint64_t kEmpty = ~static_cast<std::uint64_t>(0);
+  static constexpr std::size_t kMaxProbes = 32;
+  static constexpr std::size_t kMaxTables = 48;
+
+  struct Slot {
+    std::atomic<std::uint64_t> key{kEmpty};
+    std::atomic<bool> ready{false};
+    T value{};
+  };
+
+  enum class InsertResult { inserted, present, full };
+
+  struct Table {
+    explicit Table(std::size_t n_slots)
+      : slots(std::make_unique<Slot[]>(n_slots)), mask(n_slots - 1), max_size(n_slots - n_slots / 4) {}
+
+    const Slot* find(std::uint64_t cellID) const {
+      const std::size_t start = hash(cellID) & mask;
+      for (std::size_t probe = 0; probe < kMaxProbes; ++probe) {
+        const Slot& slot = slots[(start + probe) & mask];
+        const std::uint64_t key = slot.key.load(std::memory_order_acquire);
+        if (key == cellID) {
+          return &slot;
+        }
+        if (key == kEmpty) {
+          break;
+        }
+      }
+      return nullptr;
+    }
+
+    InsertResult insert(std::uint64_t cellID, const T& value) {
+      if (size.load(std::memory_order_relaxed) >= max_size) {
+        return InsertResult::full;
+      }
+      const std::size_t start = hash(cellID) & mask;
+      for (std::size_t probe = 0; probe < kMaxProbes; ++probe) {
+        Slot& slot = slots[(start + probe) & mask];
+        std::uint64_t key = kEmpty;
+        if (slot.key.compare_exchange_strong(key, cellID, std::memory_order_acq_rel)) {
+          slot.value = value;
+          slot.ready.store(true, std::memory_order_release);
+          size.fetch_add(1, std::memory_order_relaxed);
+          return InsertResult::inserted;
+        }
+        if (key == cellID) {
+          // inserted concurrently
+          return InsertResult::present;
+        }
+      }
+      return InsertResult::full;
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    std::size_t max_size;
+    std::atomic<std::size_t> size{0};
+  };
+
+  // cellIDs are bit fields, mix them before using the low bits
+  static std::uint64_t hash(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  void insert(std::uint64_t cellID, const T& value) {
+    // values only go to the newest table, older ones are full
+    for (;;) {
+      const std::size_t n_tables = m_n_tables.load(std::memory_order_acquire);
+      switch (m_tables[n_tables - 1].load(std::memory_order_acquire)->insert(cellID, value)) {
+      case InsertResult::inserted:
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        return;
+      case InsertResult::present:
+        return;
+      case InsertResult::full:
+        if (!grow(n_tables)) {
+          return;
+        }
+      }
+    }
+  }
+
+  /// Adds a table after the first n_tables, unless another thread did. False if at the maximum capacity.
+  bool grow(std::size_t n_tables) {
+    std::lock_guard<std::mutex> lock(m_grow_mutex);
+    if (m_n_tables.load(std::memory_order_relaxed) != n_tables) {
+      return true;
+    }
+    const std::size_t n_slots = (m_tables[n_tables - 1].load(std::memory_order_relaxed)->mask + 1) * 2;
+    if (n_tables == kMaxTables || m_capacity + n_slots > m_max_capacity) {
+      return false;
+    }
+    m_tables[n_tables].store(new Table(n_slots), std::memory_order_release);
+    m_capacity += n_slots;
+    m_n_tables.store(n_tables + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::array<std::atomic<Table*>, kMaxTables> m_tables{};
+  std::atomic<std::size_t> m_n_tables{0};
+  std::size_t m_max_capacity;
+  std::size_t m_capacity{0};
+  mutable std::mutex m_grow_mutex;
+  std::atomic<std::size_t> m_size{0};
+  std::atomic<bool> m_prefill_claimed{false};
+};
+
+/**
+ * @brief Shares memoised cellID geometry between algorithm instances
+ *
+ * Hit reconstruction looks up positions, dimensions and detector elements for
+ * every hit, each of which walks the TGeo hierarchy. Algorithms request a
+ * cache by a name, typically the algorithm and its readout, and by a
+ * `configuration` that describes everything besides the geometry that the
+ * records depend on. All instances of a factory running on different threads
+ * share the same table, requests with another configuration get their own.
+ *
+ * Caches of trivially copyable records can be saved to and restored from a
+ * geometry snapshot. Records saved with another configuration or record type
+ * are not restored. Restored caches are not prefilled again.
+ */
+class CellGeoSvc : public algorithms::LoggedService<CellGeoSvc> {
+public:
+  /// Upper bound on the slots of a cache, storage is allocated as it fills
+  static constexpr std::size_t kDefaultMaxCapacity = 1 << 22;
+
+  /// Serialised caches, by section name
+  using Sections = std::map<std::string, std::vector<char>>;
+
+  void init() {};
+
+  template <typename T>
+  CellGeoCache<T>& cache(const std::string& name, const std::string& configuration = "", std::size_t max_capacity = kDefaultMaxCapacity) {
+    const std::string key = section_name(name, configuration);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_caches.find(key);
+    if (it == m_caches.end()) {
+      debug("Creating cellID geometry cache \"{}\" for up to {} cells", name, max_capacity - max_capacity / 4);
+      auto cache = std::make_shared<CellGeoCache<T>>(max_capacity);
+      Entry entry{name, std::type_index(typeid(T)), cache};
+      if constexpr (std::is_trivially_copyable_v<T>) {
+        const std::uint64_t tag = record_tag(typeid(T).name(), configuration);
+        entry.save = [cache, tag]() { return serialise(*cache, tag); };
+        entry.restore = [cache, tag](std::string_view data) { return deserialise(*cache, tag, data); };
+      }
+      it = m_caches.emplace(key, std::move(entry)).first;
+      restore_entry(key, it->second);
+    } else if (it->second.type != std::type_index(typeid(T))) {
+      throw std::runtime_error(fmt::format("CellGeoSvc: cache \"{}\" requested with a different record type", name));
+    }
+    return *std::static_pointer_cast<CellGeoCache<T>>(it->second.cache);
+  }
+
+  /// Use the records in a snapshot, for caches already created and to be created.
+  /// The sections must stay valid as long as `storage` is held.
+  void restore(std::map<std::string, std::string_view> sections, std::shared_ptr<const void> storage) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot_sections = std::move(sections);
+    m_snapshot_storage = std::move(storage);
+    for (auto& [key, entry] : m_caches) {
+      restore_entry(key, entry);
+    }
+  }
+
+  /// Serialised caches that gained records since they were restored
+  Sections save() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Sections sections;
+    for (const auto& [key, entry] : m_caches) {
+      if (entry.save) {
+        std::vector<char> data = entry.save();
+        if (record_count(data) > entry.n_restored) {
+          sections.emplace(key, std::move(data));
+        }
+      }
+    }
+    return sections;
+  }
+
+  /// Snapshot section of a cache, distinct for each configuration
+  static std::string section_name(const std::string& name, std::string_view configuration = "") {
+    if (configuration.empty()) {
+      return "cellgeo/" + name;
+    }
+    return fmt::format("cellgeo/{}/{:016x}", name, record_tag("", configuration));
+  }
+
+private:
+  struct Entry {
+    std::string name;
+    std::type_index type;
+    std::shared_ptr<void> cache;
+    std::function<std::vector<char>()> save{};
+    std::function<std::size_t(std::string_view)> restore{};
+    std::size_t n_restored{0};
+  };
+
+  // Section layout: SectionHeader, then per record the cellID followed by the record
+  struct SectionHeader {
+    std::uint64_t record_size;
+    std::uint64_t tag;
+    std::uint64_t n_records;
+  };
+
+  static std::uint64_t record_tag(std::string_view type_name, std::string_view configuration) {
+    std::uint64_t hash = 0xcbf29ce484222325; // FNV-1a
+    for (std::string_view part : {type_name, std::string_view("\0", 1), configuration}) {
+      for (char c : part) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+      }
+    }
+    return hash;
+  }
+
+  static std::size_t record_count(const std::vector<char>& data) {
+    SectionHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    return header.n_records;
+  }
+
+  template <typename T>
+  static std::vector<char> serialise(const CellGeoCache<T>& cache, std::uint64_t tag) {
+    std::vector<char> data(sizeof(SectionHeader));
+    std::uint64_t n_records = 0;
+    cache.for_each([&](std::uint64_t cellID, const T& value) {
+      const char* id = reinterpret_cast<const char*>(&cellID);
+      const char* record = reinterpret_cast<const char*>(&value);
+      data.insert(data.end(), id, id + sizeof(cellID));
+      data.insert(data.end(), record, record + sizeof(T));
+      ++n_records;
+    });
+    const SectionHeader header{sizeof(T), tag, n_records};
+    std::memcpy(data.data(), &header, sizeof(header));
+    return data;
+  }
+
+  template <typename T>
+  static std::size_t deserialise(CellGeoCache<T>& cache, std::uint64_t tag, std::string_view data) {
+    SectionHeader header;
+    if (data.size() < sizeof(header)) {
+      return 0;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    constexpr std::size_t stride = sizeof(std::uint64_t) + sizeof(T);
+    if (header.record_size != sizeof(T) || header.tag != tag
+        || (data.size() - sizeof(header)) / stride < header.n_records) {
+      return 0;
+    }
+    const char* pos = data.data() + sizeof(header);
+    for (std::uint64_t i = 0; i < header.n_records; ++i, pos += stride) {
+      std::uint64_t cellID;
+      T value;
+      std::memcpy(&cellID, pos, sizeof(cellID));
+      std::memcpy(&value, pos + sizeof(cellID), sizeof(T));
+      cache.put(cellID, value);
+    }
+    // the snapshot was saved after the cache was prefilled or used, do not walk the readout again
+    if (header.n_records > 0) {
+      cache.claim_prefill();
+    }
+    return header.n_records;
+  }
+
+  void restore_entry(const std::string& key, Entry& entry) {
+    auto it = m_snapshot_sections.find(key);
+    if (it == m_snapshot_sections.end() || !entry.restore) {
+      return;
+    }
+    entry.n_restored = entry.restore(it->second);
+    if (entry.n_restored > 0) {
+      debug("Restored {} records of cellID geometry cache \"{}\" from snapshot", entry.n_restored, entry.name);
+    } else {
+      warning("Records of cellID geometry cache \"{}\" in snapshot do not match its configuration, ignored", entry.name);
+    }
+  }
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, Entry> m_caches; // by section name
+  std::map<std::string, std::string_view> m_snapshot_sections;
+  std::shared_ptr<const void> m_snapshot_storage;
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(CellGeoSvc);
+};
+
+} // namespace eicrecon
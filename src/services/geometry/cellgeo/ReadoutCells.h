@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Objects.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/Segmentations.h>
+#include <DD4hep/Shapes.h>
+#include <DD4hep/VolumeManager.h>
+#include <DD4hep/detail/VolumeManagerInterna.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CellGeoSvc.h"
+
+namespace eicrecon {
+
+/**
+ * @brief cellIDs of all cells of a readout, used to prefill cellID geometry caches
+ *
+ * The sensitive volumes of the readout are taken from the volume manager. An
+ * unsegmented readout has one cell per volume. For segmentations along
+ * Cartesian axes (their type ends in the axes, e.g. CartesianGridXY or
+ * HexGridXY), the bounding box of each volume is sampled at half the smallest
+ * cell dimension. Other segmentations throw std::invalid_argument. At most
+ * `max_cells` cellIDs are returned, enumeration stops early at a volume with
+ * too many cells left to fit.
+ */
+inline std::vector<std::uint64_t> readout_cell_ids(const dd4hep::Detector& detector, const std::string& readout_name,
+                                                   std::size_t max_cells) {
+  dd4hep::Readout readout = detector.readout(readout_name);
+
+  dd4hep::DetElement det;
+  for (const auto& [name, handle] : detector.sensitiveDetectors()) {
+    dd4hep::SensitiveDetector sd = handle;
+    if (sd.readout().isValid() && sd.readout().name() == readout_name) {
+      det = detector.detector(name);
+      break;
+    }
+  }
+  if (!det.isValid()) {
+    throw std::invalid_argument(fmt::format("No detector with readout {}", readout_name));
+  }
+
+  dd4hep::VolumeID system_id = 0;
+  readout.idSpec().decoder()->set(system_id, "system", det.id());
+  const auto& volumes = detector.volumeManager().subdetector(system_id).ptr()->volumes;
+
+  // Segmented axes, from the end of the segmentation type
+  dd4hep::Segmentation segmentation = readout.segmentation();
+  std::array<bool, 3> segmented{false, false, false};
+  if (segmentation.isValid() && segmentation.type() != "NoSegmentation") {
+    const std::string type = segmentation.type();
+    for (auto c = type.rbegin(); c != type.rend() && *c >= 'X' && *c <= 'Z'; ++c) {
+      segmented[*c - 'X'] = true;
+    }
+    if (!segmented[0] && !segmented[1] && !segmented[2]) {
+      throw std::invalid_argument(fmt::format("Cells of {} segmentation of {} can not be enumerated", type, readout_name));
+    }
+  }
+
+  std::vector<std::uint64_t> cellIDs;
+  std::vector<std::uint64_t> volume_cellIDs;
+  for (const auto& [vol_id, context] : volumes) {
+    if (!segmented[0] && !segmented[1] && !segmented[2]) {
+      cellIDs.push_back(vol_id);
+    } else {
+      const dd4hep::Box box = context->volumePlacement().volume().boundingBox();
+      const std::array<double, 3> half_lengths{box.x(), box.y(), box.z()};
+      const auto dimensions = segmentation.cellDimensions(vol_id);
+      const double step = *std::min_element(dimensions.begin(), dimensions.end()) / 2;
+      if (!(step > 0)) {
+        continue;
+      }
+      std::array<std::size_t, 3> n_steps{1, 1, 1};
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        if (segmented[axis]) {
+          n_steps[axis] = static_cast<std::size_t>(std::ceil(2 * half_lengths[axis] / step));
+        }
+      }
+      // each cell is sampled up to twice per axis, stop before sampling far more than the cells left
+      if (n_steps[0] * n_steps[1] * n_steps[2] > 8 * (max_cells - cellIDs.size())) {
+        break;
+      }
+      auto coordinate = [&](std::size_t axis, std::size_t i) {
+        return segmented[axis] ? -half_lengths[axis] + (i + 0.5) * step : 0.;
+      };
+      volume_cellIDs.clear();
+      for (std::size_t ix = 0; ix < n_steps[0]; ++ix) {
+        for (std::size_t iy = 0; iy < n_steps[1]; ++iy) {
+          for (std::size_t iz = 0; iz < n_steps[2]; ++iz) {
+            const dd4hep::Position local(coordinate(0, ix), coordinate(1, iy), coordinate(2, iz));
+            // segmentations along Cartesian axes only use the local position
+            volume_cellIDs.push_back(segmentation.cellID(local, local, vol_id));
+          }
+        }
+      }
+      std::sort(volume_cellIDs.begin(), volume_cellIDs.end());
+      volume_cellIDs.erase(std::unique(volume_cellIDs.begin(), volume_cellIDs.end()), volume_cellIDs.end());
+      cellIDs.insert(cellIDs.end(), volume_cellIDs.begin(), volume_cellIDs.end());
+    }
+    if (cellIDs.size() >= max_cells) {
+      cellIDs.resize(max_cells);
+      break;
+    }
+  }
+  return cellIDs;
+}
+
+/**
+ * @brief Caches the geometry of all cells of a readout
+ *
+ * Only the first of the instances sharing `cache` prefills it, the others
+ * return 0 right away. Returns the number of cells cached, cells for which
+ * `compute` throws are skipped. Exceptions from readout_cell_ids propagate.
+ */
+template <typename T, typename F>
+std::size_t prefill_readout_cells(CellGeoCache<T>& cache, const dd4hep::Detector& detector, const std::string& readout_name,
+                                  F&& compute) {
+  if (!cache.claim_prefill()) {
+    return 0;
+  }
+  const std::vector<std::uint64_t> cellIDs = readout_cell_ids(detector, readout_name, cache.max_size());
+  return cellIDs.size() - cache.prefill(cellIDs, std::forward<F>(compute));
+}
+
+} // namespace eicrecon
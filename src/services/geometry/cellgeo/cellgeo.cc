@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include <JANA/JApplication.h>
+#include <algorithms/service.h>
+
+#include "CellGeoSnapshot_processor.h"
+#include "CellGeoSvc.h"
+
+extern "C" {
+
+void InitPlugin(JApplication* app) {
+  InitJANAPlugin(app);
+
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  auto& cellGeoSvc = eicrecon::CellGeoSvc::instance();
+  serviceSvc.add<eicrecon::CellGeoSvc>(&cellGeoSvc);
+
+  app->Add(new CellGeoSnapshot_processor(app));
+}
+}
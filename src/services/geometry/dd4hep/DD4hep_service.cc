@@ -9,6 +9,7 @@
 #include <fmt/core.h>
 #include <fmt/format.h>
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
@@ -18,6 +19,7 @@
 #include <vector>
 
 #include "DD4hep_service.h"
+#include "GeometrySnapshot.h"
 #include "services/log/Log_service.h"
 
 //----------------------------------------------------------------
@@ -72,18 +74,36 @@ DD4hep_service::converter() {
 }
 
 //----------------------------------------------------------------
-// Initialize
+// snapshotFile
 //
-/// Initialize the dd4hep geometry by reading in from the XML.
-/// Note that this is called automatically the first time detector()
-/// is called. Which XML file(s) are read is determined by the
-/// dd4hep:xml_files configuration parameter.
+/// Return the geometry snapshot file name, empty if snapshots are disabled.
+/// Does not load the geometry.
 //----------------------------------------------------------------
-void DD4hep_service::Initialize() {
+std::string DD4hep_service::snapshotFile() {
+    std::call_once(files_flag, &DD4hep_service::InitializeFiles, this);
+    return m_snapshot_file;
+}
 
-    if (m_dd4hepGeo) {
-        m_log->warn("DD4hep_service already initialized!");
-    }
+//----------------------------------------------------------------
+// snapshotKey
+//
+/// Return the key identifying the geometry files.
+/// Does not load the geometry.
+//----------------------------------------------------------------
+std::uint64_t DD4hep_service::snapshotKey() {
+    std::call_once(files_flag, &DD4hep_service::InitializeFiles, this);
+    return m_snapshot_key;
+}
+
+//----------------------------------------------------------------
+// InitializeFiles
+//
+/// Determine the geometry files and, if snapshots are enabled, the
+/// snapshot key, before and without loading the geometry. Which XML
+/// file(s) are read is determined by the dd4hep:xml_files configuration
+/// parameter.
+//----------------------------------------------------------------
+void DD4hep_service::InitializeFiles() {
 
     // The current recommended way of getting the XML file is to use the environment variables
     // DETECTOR_PATH and DETECTOR_CONFIG.
@@ -115,6 +135,43 @@ void DD4hep_service::Initialize() {
         throw std::runtime_error("No dd4hep XML file specified.");
     }
 
+    for (auto &filename : m_xml_files) {
+        m_resolved_xml_files.push_back(resolveFileName(filename, detector_path_env));
+    }
+
+    m_app->SetDefaultParameter("dd4hep:snapshot_dir", m_snapshot_dir, "Directory for geometry snapshots that speed up later starts with the same geometry (empty: disabled)");
+
+    // Snapshots are named by the key, so that different geometries can share the directory
+    if (!m_snapshot_dir.empty()) {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            m_snapshot_key = eicrecon::GeometrySnapshot::key(m_resolved_xml_files);
+            std::filesystem::create_directories(m_snapshot_dir);
+            m_snapshot_file = fmt::format("{}/geometry-{:016x}.snapshot", m_snapshot_dir, m_snapshot_key);
+            m_log->info("Using geometry snapshot {} (key computed in {:.3f} s)", m_snapshot_file,
+                        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        } catch(std::exception &e) {
+            m_log->warn("Geometry snapshots disabled: {}", e.what());
+            m_snapshot_file.clear();
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// Initialize
+//
+/// Initialize the dd4hep geometry by reading in from the XML.
+/// Note that this is called automatically the first time detector()
+/// is called.
+//----------------------------------------------------------------
+void DD4hep_service::Initialize() {
+
+    if (m_dd4hepGeo) {
+        m_log->warn("DD4hep_service already initialized!");
+    }
+
+    std::call_once(files_flag, &DD4hep_service::InitializeFiles, this);
+
     // Reading the geometry may take a long time and if the JANA ticker is enabled, it will keep printing
     // while no other output is coming which makes it look like something is wrong. Disable the ticker
     // while parsing and loading the geometry
@@ -124,11 +181,9 @@ void DD4hep_service::Initialize() {
     // load geometry
     auto detector = dd4hep::Detector::make_unique("");
     try {
-        m_log->info("Loading DD4hep geometry from {} files", m_xml_files.size());
-        for (auto &filename : m_xml_files) {
-
-            auto resolved_filename = resolveFileName(filename, detector_path_env);
-
+        const auto start = std::chrono::steady_clock::now();
+        m_log->info("Loading DD4hep geometry from {} files", m_resolved_xml_files.size());
+        for (auto &resolved_filename : m_resolved_xml_files) {
             m_log->info("  - loading geometry file:  '{}' (patience ....)", resolved_filename);
             try {
                 detector->fromCompact(resolved_filename);
@@ -141,7 +196,8 @@ void DD4hep_service::Initialize() {
         m_cellid_converter = std::make_unique<const dd4hep::rec::CellIDPositionConverter>(*detector);
         m_dd4hepGeo = std::move(detector); // const
 
-        m_log->info("Geometry successfully loaded.");
+        m_log->info("Geometry successfully loaded in {:.1f} s.",
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
     } catch(std::exception &e) {
         m_log->error("Problem loading geometry: {}", e.what());
         throw std::runtime_error(fmt::format("Problem loading geometry: {}", e.what()));
@@ -10,6 +10,7 @@
 #include <JANA/Services/JServiceLocator.h>
 #include <gsl/pointers>
 #include <spdlog/logger.h>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -24,18 +25,30 @@ public:
     virtual gsl::not_null<const dd4hep::Detector*> detector();
     virtual gsl::not_null<const dd4hep::rec::CellIDPositionConverter*> converter();
 
+    /// Geometry snapshot file for the geometry, empty unless dd4hep:snapshot_dir is set.
+    /// Available before the geometry is loaded, and does not load it.
+    virtual std::string snapshotFile();
+    /// Key of the geometry files, see GeometrySnapshot::key()
+    virtual std::uint64_t snapshotKey();
+
 protected:
+    void InitializeFiles();
     void Initialize();
 
 private:
     DD4hep_service() = default;
     void acquire_services(JServiceLocator *) override;
 
+    std::once_flag files_flag;
     std::once_flag init_flag;
     JApplication *m_app = nullptr;
     std::unique_ptr<const dd4hep::Detector> m_dd4hepGeo = nullptr;
     std::unique_ptr<const dd4hep::rec::CellIDPositionConverter> m_cellid_converter = nullptr;
     std::vector<std::string> m_xml_files;
+    std::vector<std::string> m_resolved_xml_files;
+    std::string m_snapshot_dir;
+    std::string m_snapshot_file;
+    std::uint64_t m_snapshot_key{0};
 
     /// Ensures there is a geometry file that should be opened
     std::string resolveFileName(const std::string &filename, char *detector_path_env);
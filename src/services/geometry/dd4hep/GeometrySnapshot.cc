@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include "GeometrySnapshot.h"
+
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream> // IWYU pragma: keep
+#include <functional>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace eicrecon {
+
+namespace {
+
+  constexpr char snapshot_magic[8] = {'E', 'I', 'C', 'G', 'E', 'O', 'S', 'N'};
+
+  // Sections start at multiples of this, so that records can be read in place
+  constexpr std::size_t section_alignment = 16;
+
+  struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t n_sections;
+    std::uint64_t key;
+  };
+
+  struct SectionHeader {
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t name_size;
+  };
+
+  template <typename T> void append(std::vector<char>& buf, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const char* p = reinterpret_cast<const char*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+  }
+
+  class FNV1a {
+  public:
+    void update(const char* data, std::size_t size) {
+      for (std::size_t i = 0; i < size; ++i) {
+        m_hash = (m_hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3;
+      }
+    }
+    void update(const std::string& value) {
+      update(static_cast<std::uint64_t>(value.size()));
+      update(value.data(), value.size());
+    }
+    template <typename T> void update(const T& value) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      update(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    std::uint64_t value() const { return m_hash; }
+
+  private:
+    std::uint64_t m_hash{0xcbf29ce484222325};
+  };
+
+  /// Values of the attributes that name files in compact XML: included files, GDML and
+  /// other inputs of detector constructors, and field maps. Comments are skipped.
+  std::vector<std::string> file_references(const std::string& content) {
+    static const std::regex comment(R"(<!--[\s\S]*?-->)");
+    static const std::regex attribute(R"re(\b(?:ref|url|file|filename)\s*=\s*(?:"([^"]*)"|'([^']*)'))re");
+    const std::string text = std::regex_replace(content, comment, "");
+    std::vector<std::string> references;
+    for (std::sregex_iterator it(text.begin(), text.end(), attribute), end; it != end; ++it) {
+      references.push_back((*it)[1].matched ? (*it)[1].str() : (*it)[2].str());
+    }
+    return references;
+  }
+
+  /// Path of a referenced file with environment variables expanded, looked up next to
+  /// the referencing file, in DETECTOR_PATH and in the working directory. Empty if not found.
+  std::filesystem::path resolve_reference(const std::string& reference, const std::filesystem::path& directory) {
+    namespace fs = std::filesystem;
+    if (reference.find("://") != std::string::npos) {
+      return {};
+    }
+    static const std::regex variable(R"(\$\{(\w+)\})");
+    std::string expanded;
+    auto last = reference.cbegin();
+    for (std::sregex_iterator it(reference.begin(), reference.end(), variable), end; it != end; ++it) {
+      expanded.append(last, (*it)[0].first);
+      const char* value = std::getenv((*it)[1].str().c_str());
+      expanded.append(value != nullptr ? value : "");
+      last = (*it)[0].second;
+    }
+    expanded.append(last, reference.cend());
+    if (expanded.empty()) {
+      return {};
+    }
+
+    std::vector<fs::path> candidates;
+    if (fs::path(expanded).is_absolute()) {
+      candidates.emplace_back(expanded);
+    } else {
+      candidates.push_back(directory / expanded);
+      if (const char* detector_path = std::getenv("DETECTOR_PATH")) {
+        candidates.push_back(fs::path(detector_path) / expanded);
+      }
+      candidates.emplace_back(expanded);
+    }
+    for (const auto& candidate : candidates) {
+      std::error_code ec;
+      if (fs::is_regular_file(candidate, ec)) {
+        return candidate;
+      }
+    }
+    return {};
+  }
+
+} // namespace
+
+std::uint64_t GeometrySnapshot::key(const std::vector<std::string>& compact_files) {
+  namespace fs = std::filesystem;
+
+  // Files are hashed in the order they are referenced, each once. References
+  // are hashed as written, so the same geometry installed elsewhere has the
+  // same key. Unresolved references (e.g. remote field maps) only enter by name.
+  FNV1a hash;
+  hash.update(kFormatVersion);
+  std::set<fs::path> visited;
+  std::function<void(const std::string&, const fs::path&)> add = [&](const std::string& name, const fs::path& path) {
+    hash.update(name);
+    std::error_code ec;
+    const fs::path canonical = fs::weakly_canonical(path, ec);
+    if (!visited.insert(ec ? path : canonical).second) {
+      return;
+    }
+    std::ifstream in(path, std::ios::binary);
+    const std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    if (!in.good() && !in.eof()) {
+      throw std::runtime_error(fmt::format("Unable to read geometry file \"{}\"", path.string()));
+    }
+    hash.update(content);
+    if (path.extension() != ".xml") {
+      return;
+    }
+    for (const auto& reference : file_references(content)) {
+      const auto resolved = resolve_reference(reference, path.parent_path());
+      if (resolved.empty()) {
+        hash.update(reference);
+      } else {
+        add(reference, resolved);
+      }
+    }
+  };
+  for (const auto& compact_file : compact_files) {
+    add(fs::path(compact_file).filename().string(), compact_file);
+  }
+  return hash.value();
+}
+
+GeometrySnapshot::~GeometrySnapshot() {
+  if (m_mapping != nullptr) {
+    munmap(m_mapping, m_mapping_size);
+  }
+}
+
+std::string_view GeometrySnapshot::section(const std::string& name) const {
+  auto it = m_sections.find(name);
+  return (it != m_sections.end()) ? it->second : std::string_view{};
+}
+
+std::shared_ptr<const GeometrySnapshot> GeometrySnapshot::open(const std::string& filename, std::uint64_t key) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+    close(fd);
+    throw std::runtime_error(fmt::format("Geometry snapshot \"{}\" is truncated", filename));
+  }
+  // Read-only shared mapping: pages are shared between all processes on the node using this file
+  void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("Unable to map geometry snapshot \"{}\"", filename));
+  }
+  std::shared_ptr<GeometrySnapshot> snapshot(new GeometrySnapshot());
+  snapshot->m_mapping = mapping;
+  snapshot->m_mapping_size = st.st_size;
+
+  const char* data = static_cast<const char*>(mapping);
+  const std::size_t size = st.st_size;
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0) {
+    throw std::runtime_error(fmt::format("\"{}\" is not a geometry snapshot", filename));
+  }
+  if (header.version != kFormatVersion) {
+    throw std::runtime_error(fmt::format("Geometry snapshot \"{}\" has format version {}, expected {}", filename, header.version, kFormatVersion));
+  }
+  if (header.key != key) {
+    throw std::runtime_error(fmt::format("Geometry snapshot \"{}\" is for geometry {:016x}, expected {:016x}", filename, header.key, key));
+  }
+
+  std::size_t pos = sizeof(FileHeader);
+  for (std::uint32_t i = 0; i < header.n_sections; ++i) {
+    SectionHeader section;
+    if (size - pos < sizeof(section)) {
+      throw std::runtime_error(fmt::format("Geometry snapshot \"{}\" is truncated", filename));
+    }
+    std::memcpy(&section, data + pos, sizeof(section));
+    pos += sizeof(section);
+    if (size - pos < section.name_size || section.offset > size || size - section.offset < section.size) {
+      throw std::runtime_error(fmt::format("Geometry snapshot \"{}\" is truncated", filename));
+    }
+    snapshot->m_sections.emplace(std::string(data + pos, section.name_size), std::string_view(data + section.offset, section.size));
+    pos += section.name_size;
+  }
+  return snapshot;
+}
+
+void GeometrySnapshot::write(const std::string& filename, std::uint64_t key, const Sections& sections) {
+  std::vector<char> header;
+  FileHeader file_header{{}, kFormatVersion, static_cast<std::uint32_t>(sections.size()), key};
+  std::copy(std::begin(snapshot_magic), std::end(snapshot_magic), file_header.magic);
+  append(header, file_header);
+
+  std::size_t header_size = header.size();
+  for (const auto& [name, contents] : sections) {
+    header_size += sizeof(SectionHeader) + name.size();
+  }
+  auto align = [](std::size_t offset) { return (offset + section_alignment - 1) / section_alignment * section_alignment; };
+  std::size_t offset = align(header_size);
+  for (const auto& [name, contents] : sections) {
+    append(header, SectionHeader{offset, contents.size(), name.size()});
+    header.insert(header.end(), name.begin(), name.end());
+    offset = align(offset + contents.size());
+  }
+
+  // Write to a temporary file and rename, so that concurrent readers never see a partial file
+  const std::string tmp_filename = filename + ".tmp" + std::to_string(std::random_device{}());
+  {
+    std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+    const char padding[section_alignment] = {};
+    out.write(header.data(), header.size());
+    std::size_t pos = header.size();
+    for (const auto& [name, contents] : sections) {
+      out.write(padding, align(pos) - pos);
+      out.write(contents.data(), contents.size());
+      pos = align(pos) + contents.size();
+    }
+    if (!out.flush()) {
+      std::remove(tmp_filename.c_str());
+      throw std::runtime_error(fmt::format("Unable to write geometry snapshot \"{}\"", tmp_filename));
+    }
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    std::remove(tmp_filename.c_str());
+    throw std::runtime_error(fmt::format("Unable to write geometry snapshot \"{}\"", filename));
+  }
+}
+
+} // namespace eicrecon
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * @brief Versioned on-disk store of products derived from a geometry
+ *
+ * A snapshot is a set of named binary sections that is valid for one
+ * geometry, identified by key(). The file is memory-mapped read-only, so
+ * processes on the same node share its pages, and it is replaced atomically
+ * by write(). Section contents are opaque here, their owners are expected to
+ * check that a record layout matches before using it.
+ */
+class GeometrySnapshot {
+public:
+  /// Incremented whenever the file layout changes
+  static constexpr std::uint32_t kFormatVersion = 1;
+
+  using Sections = std::map<std::string, std::vector<char>>;
+
+  /// Key from the contents of the compact files and of the files they reference,
+  /// followed through included XML files, including field maps. Cheap compared to
+  /// loading the geometry, so that it can be computed first.
+  static std::uint64_t key(const std::vector<std::string>& compact_files);
+
+  /// Maps a snapshot file, nullptr if it does not exist. Throws std::runtime_error
+  /// if it is not a snapshot of this format version or was made for another key.
+  static std::shared_ptr<const GeometrySnapshot> open(const std::string& filename, std::uint64_t key);
+
+  /// Writes a snapshot through a temporary file, so that concurrent readers never see a partial file
+  static void write(const std::string& filename, std::uint64_t key, const Sections& sections);
+
+  ~GeometrySnapshot();
+  GeometrySnapshot(const GeometrySnapshot&) = delete;
+  GeometrySnapshot& operator=(const GeometrySnapshot&) = delete;
+
+  const std::map<std::string, std::string_view>& sections() const { return m_sections; }
+
+  /// Contents of a section, empty if there is none with this name
+  std::string_view section(const std::string& name) const;
+
+private:
+  GeometrySnapshot() = default;
+
+  void* m_mapping{nullptr};
+  std::size_t m_mapping_size{0};
+  std::map<std::string, std::string_view> m_sections;
+};
+
+} // namespace eicrecon
@@ -30,14 +30,11 @@ richgeo::ReadoutGeo::ReadoutGeo(std::string detName_, gsl::not_null<const dd4hep
   // capitalize m_detName
   std::transform(m_detName.begin(), m_detName.end(), m_detName.begin(), ::toupper);
 
-  // random number generators
-  m_random.SetSeed(1); // default seed
-
   // default (empty) cellID looper
   m_loopCellIDs = [] (std::function<void(CellIDType)> lambda) { return; };
 
   // default (empty) cellID rng generator
-  m_rngCellIDs = [] (std::function<void(CellIDType)> lambda, float p) { return; };
+  m_rngCellIDs = [] (std::function<void(CellIDType)> lambda, float p, algorithms::RandomStream& rng) { return; };
 
   // common objects
   m_readoutCoder = m_det->readout(m_detName+"Hits").idSpec().decoder();
@@ -84,17 +81,17 @@ richgeo::ReadoutGeo::ReadoutGeo(std::string detName_, gsl::not_null<const dd4hep
     }; // end definition of m_loopCellIDs
 
     // define k random cell IDs generator
-    m_rngCellIDs = [this] (std::function<void(CellIDType)> lambda, float p) {
+    m_rngCellIDs = [this] (std::function<void(CellIDType)> lambda, float p, algorithms::RandomStream& rng) {
       m_log->trace("call RngReadoutPixels for systemID = {} = {}", m_systemID, m_detName);
 
       int k = p * m_num_sec * m_num_pdus * m_num_sipms_per_pdu * m_num_px * m_num_px;
 
       for (int i = 0; i < k; i++) {
-        int isec = m_random.Uniform(0., m_num_sec);
-        int ipdu = m_random.Uniform(0., m_num_pdus);
-        int isipm = m_random.Uniform(0., m_num_sipms_per_pdu);
-        int x = m_random.Uniform(0., m_num_px);
-        int y = m_random.Uniform(0., m_num_px);
+        int isec = rng.uniform(0., m_num_sec);
+        int ipdu = rng.uniform(0., m_num_pdus);
+        int isipm = rng.uniform(0., m_num_sipms_per_pdu);
+        int x = rng.uniform(0., m_num_px);
+        int y = rng.uniform(0., m_num_px);
 
         auto cellID = cellIDEncoding(isec, ipdu, isipm, x, y);
 
@@ -13,7 +13,6 @@
 #include <DDRec/CellIDPositionConverter.h>
 #include <DDSegmentation/BitFieldCoder.h>
 #include <Parsers/Primitives.h>
-#include <TRandomGen.h>
 #include <spdlog/logger.h>
 #include <functional>
 #include <gsl/pointers>
@@ -22,6 +21,7 @@
 
 // local
 #include "RichGeo.h"
+#include "algorithms/interfaces/RandomStreamSvc.h"
 
 namespace richgeo {
   class ReadoutGeo {
@@ -50,8 +50,8 @@ namespace richgeo {
       // loop over readout pixels, executing `lambda(cellID)` on each
       void VisitAllReadoutPixels(std::function<void(CellIDType)> lambda) { m_loopCellIDs(lambda); }
 
-      // generated k rng cell IDs, executing `lambda(cellID)` on each
-      void VisitAllRngPixels(std::function<void(CellIDType)> lambda, float p) { m_rngCellIDs(lambda, p); }
+      // generated k rng cell IDs from `rng`, executing `lambda(cellID)` on each
+      void VisitAllRngPixels(std::function<void(CellIDType)> lambda, float p, algorithms::RandomStream& rng) { m_rngCellIDs(lambda, p, rng); }
 
       // pixel gap mask
       bool PixelGapMask(CellIDType cellID, dd4hep::Position pos_hit_global);
@@ -60,9 +60,6 @@ namespace richgeo {
       // IMPORTANT NOTE: this has only been tested for the dRICH; if you use it, test it carefully...
       dd4hep::Position GetSensorLocalPosition(CellIDType id, dd4hep::Position pos);
 
-      // set RNG seed
-      void SetSeed(unsigned long seed) { m_random.SetSeed(seed); }
-
     protected:
 
       // common objects
@@ -82,12 +79,7 @@ namespace richgeo {
       // local function to loop over cellIDs; defined in initialization and called by `VisitAllReadoutPixels`
       std::function< void(std::function<void(CellIDType)>) > m_loopCellIDs;
       // local function to generate rng cellIDs; defined in initialization and called by `VisitAllRngPixels`
-      std::function< void(std::function<void(CellIDType)>, float) > m_rngCellIDs;
-
-    private:
-
-      // random number generators
-      TRandomMixMax m_random;
+      std::function< void(std::function<void(CellIDType)>, float, algorithms::RandomStream&) > m_rngCellIDs;
 
   };
 }
@@ -16,13 +16,76 @@
 #include <podio/ROOTFrameWriter.h>
 #endif
 #include <spdlog/common.h>
+#include <algorithm>
 #include <chrono>
 #include <exception>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
+#include "services/io/podio/datamodel_glue.h"
+#include "services/io/podio/datamodel_includes.h" // IWYU pragma: keep
 #include "services/log/Log_service.h"
 
 
+//------------------------------------------------------------------------------
+// CopyingVisitor
+//
+/// Copies a collection into the frame that is handed to the writer thread, so
+/// that the event can be released before it is written. Objects are cloned in
+/// order and keep their index, and the frame assigns the collection the same ID
+/// as the original because IDs are hashed from the collection name. Relations
+/// of the clones still point to the original objects, which therefore resolve
+/// to the copies in the output file. Subset collections refer to the original
+/// objects in the same way.
+///
+/// \param frame             frame to put the copy into
+/// \param collection_name   name of the collection in the frame
+//------------------------------------------------------------------------------
+struct CopyingVisitor {
+    podio::Frame& m_frame;
+    const std::string& m_collection_name;
+
+    CopyingVisitor(podio::Frame& frame, const std::string& collection_name) : m_frame(frame), m_collection_name(collection_name){};
+
+    template <typename T>
+    void operator() (const T& collection) {
+
+        T copy;
+        if (collection.isSubsetCollection()) {
+            copy.setSubsetCollection();
+            for (const auto& object : collection) {
+                copy.push_back(object);
+            }
+        }
+        else {
+            for (const auto& object : collection) {
+                copy.push_back(object.clone());
+            }
+        }
+        m_frame.put(std::move(copy), m_collection_name);
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// CopyParameters
+//
+/// Copies the event parameters of type T, e.g. those read from the input file.
+//------------------------------------------------------------------------------
+template <typename T>
+void CopyParameters(const podio::Frame& from, podio::Frame& to) {
+    for (const std::string& key : from.getParameterKeys<T>()) {
+#if podio_VERSION >= PODIO_VERSION(0, 99, 0)
+        to.putParameter(key, from.getParameter<std::vector<T>>(key).value());
+#else
+        to.putParameter(key, from.getParameter<std::vector<T>>(key));
+#endif
+    }
+}
+
+
 JEventProcessorPODIO::JEventProcessorPODIO() {
     SetTypeName(NAME_OF_THIS); // Provide JANA with this class's name
 
@@ -338,12 +401,21 @@ JEventProcessorPODIO::JEventProcessorPODIO() {
             output_exclude_collections,
             "Comma separated list of collection names to not write out."
     );
+    japp->SetDefaultParameter(
+            "podio:output_queue_size",
+            m_queue_size,
+            "Maximum number of finished events waiting to be written. Processing threads block when the queue is full."
+    );
+    japp->SetDefaultParameter(
+            "podio:output_ordered",
+            m_ordered_output,
+            "Write events in order of event number, as far as events in the output queue allow."
+    );
     japp->SetDefaultParameter(
             "podio:print_collections",
             m_collections_to_print,
             "Comma separated list of collection names to print to screen, e.g. for debugging."
     );
-
     m_output_collections = std::set<std::string>(output_collections.begin(),
                                                  output_collections.end());
     m_output_exclude_collections = std::set<std::string>(output_exclude_collections.begin(),
@@ -362,6 +434,10 @@ void JEventProcessorPODIO::Init() {
 #else
     m_writer = std::make_unique<podio::ROOTFrameWriter>(m_output_file);
 #endif
+    m_queue = std::make_unique<eicrecon::WriteQueue<QueuedFrame>>(
+            [this](QueuedFrame& queued) { m_writer->writeFrame(queued.frame, "events", queued.collections); },
+            eicrecon::WriteQueue<QueuedFrame>::Options{.max_size = m_queue_size, .ordered = m_ordered_output}
+    );
     // TODO: NWB: Verify that output file is writable NOW, rather than after event processing completes.
     //       I definitely don't trust PODIO to do this for me.
 
@@ -416,9 +492,13 @@ void JEventProcessorPODIO::FindCollectionsToWrite(const std::shared_ptr<const JE
 
 void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_is_first_event) {
-        FindCollectionsToWrite(event);
+    // The first event decides which collections are written, all others wait for it
+    std::call_once(m_first_event_once, [&]() { FindCollectionsToWrite(event); });
+
+    std::vector<std::string> collections_to_write;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collections_to_write = m_collections_to_write;
     }
 
     // Trigger all collections once to fix the collection IDs
@@ -426,7 +506,8 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
     //            that are determined by hash, we have to ensure they are reproducible
     //            even if the collections are filled in unpredictable order (or not at
     //            all). See also below, at "TODO: NWB:".
-    for (const auto& coll_name : m_collections_to_write) {
+    // Factories run here in parallel on all threads, no lock is held.
+    for (const auto& coll_name : collections_to_write) {
         try {
             [[maybe_unused]]
             const auto* coll_ptr = event->GetCollectionBase(coll_name);
@@ -439,23 +520,24 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
     // Print the contents of some collections, just for debugging purposes
     // Do this before writing just in case writing crashes
     if (!m_collections_to_print.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         LOG << "========================================" << LOG_END;
         LOG << "JEventProcessorPODIO: Event " << event->GetEventNumber() << LOG_END;
-    }
-    for (const auto& coll_name : m_collections_to_print) {
-        LOG << "------------------------------" << LOG_END;
-        LOG << coll_name << LOG_END;
-        try {
-            const auto* coll_ptr = event->GetCollectionBase(coll_name);
-            if (coll_ptr == nullptr) {
+        for (const auto& coll_name : m_collections_to_print) {
+            LOG << "------------------------------" << LOG_END;
+            LOG << coll_name << LOG_END;
+            try {
+                const auto* coll_ptr = event->GetCollectionBase(coll_name);
+                if (coll_ptr == nullptr) {
+                    LOG << "missing" << LOG_END;
+                } else {
+                    coll_ptr->print();
+                }
+            }
+            catch(std::exception &e) {
                 LOG << "missing" << LOG_END;
-            } else {
-                coll_ptr->print();
             }
         }
-        catch(std::exception &e) {
-            LOG << "missing" << LOG_END;
-        }
     }
 
     m_log->trace("==================================");
@@ -481,8 +563,7 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
     //            This means that the collection IDs are stable so the writer doesn't segfault.
     //            The better fix is to maintain a map of collection IDs, or just wait for PODIO to fix the bug.
     std::vector<std::string> successful_collections;
-    static std::set<std::string> failed_collections;
-    for (const std::string& coll : m_collections_to_write) {
+    for (const std::string& coll : collections_to_write) {
         try {
             m_log->trace("Ensuring factory for collection '{}' has been called.", coll);
             const auto* coll_ptr = event->GetCollectionBase(coll);
@@ -491,9 +572,9 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
                 // To avoid this, we treat this as a failing collection and omit from this point onwards.
                 // However, this code path is expected to be unreachable because any missing collection will be
                 // replaced with an empty collection in JFactoryPodioTFixed::Create.
-                if (failed_collections.count(coll) == 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_failed_collections.insert(coll).second) {
                     m_log->error("Omitting PODIO collection '{}' because it is null", coll);
-                    failed_collections.insert(coll);
                 }
             }
             else {
@@ -503,30 +584,45 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
         }
         catch(std::exception &e) {
             // Limit printing warning to just once per factory
-            if (failed_collections.count(coll) == 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_failed_collections.insert(coll).second) {
                 m_log->error("Omitting PODIO collection '{}' due to exception: {}.", coll, e.what());
-                failed_collections.insert(coll);
             }
         }
     }
-    m_collections_to_write = successful_collections;
 
-    // Frame will contain data from all Podio factories that have been triggered,
-    // including by the `event->GetCollectionBase(coll);` above.
-    // Note that collections MUST be present in frame. If a collection is null, the writer will segfault.
-    const auto* frame = event->GetSingle<podio::Frame>();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::erase_if(m_collections_to_write, [this](const std::string& coll) { return m_failed_collections.count(coll) != 0; });
+    }
+
+    // The writer thread gets its own copy of the collections, so that this event can be recycled
+    // before it is written and processors running after this one see it unchanged. Copies are
+    // prepared for writing here, which resolves their relations while the originals still exist.
+    podio::Frame frame;
+    const auto* event_frame = event->GetSingle<podio::Frame>();
+    CopyParameters<int>(*event_frame, frame);
+    CopyParameters<float>(*event_frame, frame);
+    CopyParameters<double>(*event_frame, frame);
+    CopyParameters<std::string>(*event_frame, frame);
+    VisitPodioCollection<CopyingVisitor> visit;
+    for (const std::string& coll : successful_collections) {
+        CopyingVisitor visitor(frame, coll);
+        visit(visitor, *event->GetCollectionBase(coll));
+        frame.getCollectionForWrite(coll);
+    }
 
     // TODO: NWB: We need to actively stabilize podio collections. Until then, keep this around in case
     //            the writer starts segfaulting, so we can quickly see whether the problem is unstable collection IDs.
     /*
     m_log->info("Event {}: Writing {} collections", event->GetEventNumber(), m_collections_to_write.size());
     for (const std::string& collname : m_collections_to_write) {
-        m_log->info("Writing collection '{}' with id {}", collname, frame->get(collname)->getID());
+        m_log->info("Writing collection '{}' with id {}", collname, frame.get(collname)->getID());
     }
     */
-    m_writer->writeFrame(*frame, "events", m_collections_to_write);
-    m_is_first_event = false;
 
+    // Blocks while the output queue is full
+    m_queue->push(event->GetEventNumber(), {std::move(frame), std::move(successful_collections)});
 }
 
 void JEventProcessorPODIO::Finish() {
@@ -537,5 +633,12 @@ void JEventProcessorPODIO::Finish() {
       std::this_thread::sleep_for(10s);
     }
 
+    // Write the events still in the queue before closing the file
+    m_queue->finish();
+    const auto stats = m_queue->stats();
+    m_log->info("Wrote {} events in {:.3f} s. Output queue: max depth {} of {}, mean depth {:.1f}, processing threads waited {:.3f} s in {} pushes on a full queue",
+                stats.written, stats.write_seconds, stats.max_depth, m_queue_size, stats.mean_depth,
+                stats.blocked_seconds, stats.blocked_pushes);
+
     m_writer->finish();
 }
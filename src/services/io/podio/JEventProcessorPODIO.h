@@ -9,13 +9,17 @@
 #else
 #include <podio/ROOTFrameWriter.h>
 #endif
+#include <podio/Frame.h>
 #include <spdlog/logger.h>
+#include <cstddef>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "services/io/podio/WriteQueue.h"
+
 
 class JEventProcessorPODIO : public JEventProcessor {
 
@@ -35,8 +39,18 @@ public:
 #else
     std::unique_ptr<podio::ROOTFrameWriter> m_writer;
 #endif
-    std::mutex m_mutex;
-    bool m_is_first_event = true;
+
+    // Events are written from a copy of their output collections by a single writer thread
+    struct QueuedFrame {
+        podio::Frame frame;
+        std::vector<std::string> collections;
+    };
+    std::unique_ptr<eicrecon::WriteQueue<QueuedFrame>> m_queue;  // declared after m_writer, which it writes to
+    std::size_t m_queue_size = 16;  // config. parameter
+    bool m_ordered_output = false;  // config. parameter
+
+    std::mutex m_mutex;  // serializes printing, protects the collection lists
+    std::once_flag m_first_event_once;
     bool m_user_included_collections = false;
     std::shared_ptr<spdlog::logger> m_log;
     bool m_output_include_collections_set = false;
@@ -48,4 +62,6 @@ public:
     std::vector<std::string> m_collections_to_write;  // derived from above config. parameters
     std::vector<std::string> m_collections_to_print;
 
+    std::set<std::string> m_failed_collections;  // omitted after an error, reported once
+
 };
@@ -11,9 +11,14 @@
 #include <JANA/JEvent.h>
 #include <JANA/JException.h>
 #include <JANA/JLogger.h>
+#include <JANA/Podio/JFactoryPodioT.h>
+#include <JANA/Services/JParameterManager.h>
 #include <JANA/Utils/JTypeInfo.h>
+#include <TBranch.h>
 #include <TFile.h>
+#include <TObjArray.h>
 #include <TObject.h>
+#include <TTree.h>
 #include <fmt/color.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
@@ -21,7 +26,10 @@
 #include <podio/Frame.h>
 #include <podio/podioVersion.h>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstdlib>
+#include <deque>
 #include <exception>
 #include <filesystem>
 #include <iostream>
@@ -60,6 +68,60 @@ struct InsertingVisitor {
 };
 
 
+//------------------------------------------------------------------------------
+// DeferredFactoryVisitor
+//
+/// Creates an empty JFactoryPodioT for a collection whose reading is deferred,
+/// so that JEvent::GetCollection can find it and JANA will ask this source
+/// for the data via GetObjects(). Called for deferred collections in GetEvent()
+/// with the collection type name recorded from the first entry.
+//------------------------------------------------------------------------------
+struct DeferredFactoryVisitor {
+    JEvent& m_event;
+    const std::string& m_collection_name;
+
+    DeferredFactoryVisitor(JEvent& event, const std::string& collection_name) : m_event(event), m_collection_name(collection_name){};
+
+    template <typename CollectionT>
+    void operator() () {
+
+        using ContentsT = decltype(std::declval<const CollectionT&>()[0]);
+        if (m_event.GetFactory<ContentsT>(m_collection_name) != nullptr) {
+            return; // factory sets are recycled, so this is only done once per pooled event
+        }
+        auto* factory = new JFactoryPodioT<ContentsT>();
+        factory->SetTag(m_collection_name);
+        m_event.GetFactorySet()->Add(factory);
+    }
+};
+
+
+//------------------------------------------------------------------------------
+// DeferredInsertingVisitor
+//
+/// Hands a lazily read collection to the factory that requested it.
+/// DeferredInsertingVisitor is called in GetObjects()
+//------------------------------------------------------------------------------
+struct DeferredInsertingVisitor {
+    JFactory* m_factory;
+
+    DeferredInsertingVisitor(JFactory* factory) : m_factory(factory){};
+
+    template <typename T>
+    void operator() (const T& collection) {
+
+        using ContentsT = decltype(collection[0]);
+        auto* factory = dynamic_cast<JFactoryPodioT<ContentsT>*>(m_factory);
+        if (factory == nullptr) {
+            throw JException("Factory for deferred PODIO collection '%s' has type %s, expected %s",
+                             m_factory->GetTag().c_str(), m_factory->GetObjectName().c_str(),
+                             JTypeInfo::demangle<ContentsT>().c_str());
+        }
+        factory->SetCollectionAlreadyInFrame(&collection);
+    }
+};
+
+
 //------------------------------------------------------------------------------
 // Constructor
 //
@@ -87,6 +149,23 @@ JEventSourcePODIO::JEventSourcePODIO(std::string resource_name, JApplication* ap
             "Print list of collection names and their types"
             );
 
+    // Allow user to read only the collections needed by the configured outputs
+    GetApplication()->SetDefaultParameter(
+            "podio:lazy_input",
+            m_lazy_input,
+            "set to true to read only collections needed for podio:output_collections with each event and load the rest on first use"
+            );
+#if podio_VERSION < PODIO_VERSION(1, 1, 0)
+    if (m_lazy_input) {
+        LOG_WARN(default_cerr_logger) << "podio:lazy_input requires podio >= 1.1, reading all collections" << LOG_END;
+        m_lazy_input = false;
+    }
+#endif
+    if (m_lazy_input) {
+        // Let JANA ask us for deferred collections when they are first requested
+        EnableGetObjects();
+    }
+
     // Hopefully we won't need to reimplement background event merging. Using podio frames, it looks like we would
     // have to do a deep copy of all data in order to insert it into the same frame, which would probably be
     // quite inefficient.
@@ -112,6 +191,7 @@ JEventSourcePODIO::JEventSourcePODIO(std::string resource_name, JApplication* ap
 //------------------------------------------------------------------------------
 JEventSourcePODIO::~JEventSourcePODIO() {
     LOG << "Closing Event Source for " << GetResourceName() << LOG_END;
+    if (m_lazy_configured) PrintInputStatistics();
 }
 
 //------------------------------------------------------------------------------
@@ -158,6 +238,18 @@ void JEventSourcePODIO::Open() {
 
         if( print_type_table ) PrintCollectionTypeTable();
 
+        if( m_lazy_input ) {
+            // Record on-disk sizes of all branches, to be attributed to collections once they are known
+            std::unique_ptr<TFile> file(TFile::Open(GetResourceName().c_str()));
+            auto* tree = (file && !file->IsZombie()) ? file->Get<TTree>("events") : nullptr;
+            if (tree != nullptr) {
+                for (TObject* obj : *tree->GetListOfBranches()) {
+                    auto* branch = static_cast<TBranch*>(obj);
+                    m_branch_bytes[branch->GetName()] = {branch->GetZipBytes("*"), branch->GetTotBytes("*")};
+                }
+            }
+        }
+
     }catch (std::exception &e ){
         LOG_ERROR(default_cerr_logger) << e.what() << LOG_END;
         throw JException( fmt::format( "Problem opening file \"{}\"", GetResourceName() ) );
@@ -201,8 +293,17 @@ void JEventSourcePODIO::GetEvent(std::shared_ptr<JEvent> event) {
         }
     }
 
-    auto frame_data = m_reader.readEntry("events", Nevents_read);
-    auto frame = std::make_unique<podio::Frame>(std::move(frame_data));
+    std::unique_ptr<podio::Frame> frame;
+    {
+        std::lock_guard<std::mutex> lock(m_reader_mutex);
+        auto start = std::chrono::steady_clock::now();
+        frame = ReadFrame(Nevents_read, m_lazy_configured ? m_eager_collections : std::vector<std::string>{});
+        m_eager_read_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (m_lazy_input && !m_lazy_configured) {
+        // First entry is read in full, which tells us what is in the file
+        ConfigureLazyInput(*frame);
+    }
 
     const auto& event_headers = frame->get<edm4hep::EventHeaderCollection>("EventHeader"); // TODO: What is the collection name?
     if (event_headers.size() != 1) {
@@ -219,10 +320,248 @@ void JEventSourcePODIO::GetEvent(std::shared_ptr<JEvent> event) {
         visit(visitor, *collection);
     }
 
+    // Register everything that was not read so JANA will come back to us via GetObjects()
+    if (m_lazy_configured) {
+        auto* entry = new DeferredEntry;
+        entry->entry = Nevents_read;
+        event->Insert(entry);
+
+        VisitPodioCollectionType<DeferredFactoryVisitor> visit_type;
+        for (const auto& [coll_name, group] : m_deferred_collections) {
+            DeferredFactoryVisitor visitor(*event, coll_name);
+            visit_type(visitor, m_collection_types.at(coll_name));
+        }
+    }
+
     event->Insert(frame.release()); // Transfer ownership from unique_ptr to JFactoryT<podio::Frame>
     Nevents_read += 1;
 }
 
+//------------------------------------------------------------------------------
+// GetObjects
+//
+/// Read a deferred collection for the event on its first request. Only called
+/// when podio:lazy_input is set.
+///
+/// \param event
+/// \param factory  factory for the requested collection
+/// \return         true if the collection was read from file
+//------------------------------------------------------------------------------
+bool JEventSourcePODIO::GetObjects(const std::shared_ptr<const JEvent>& event, JFactory* factory) {
+
+    if (!m_lazy_configured) return false;
+
+    auto it = m_deferred_collections.find(factory->GetTag());
+    if (it == m_deferred_collections.end()) return false;
+    const auto& [coll_name, group] = *it;
+
+    const auto* entry = event->GetSingle<DeferredEntry>();
+    if (entry == nullptr) return false;
+
+    // GetObjects may be called concurrently for different events, but the reader is not thread safe
+    std::lock_guard<std::mutex> lock(m_reader_mutex);
+    auto& frame = entry->frames[group];
+    if (frame == nullptr) {
+        // Collections related to each other are read into one frame, so that relations resolve within it
+        auto start = std::chrono::steady_clock::now();
+        frame = ReadFrame(entry->entry, m_deferred_groups[group]);
+        auto& stats = m_collection_stats[coll_name];
+        stats.lazy_loads += 1;
+        stats.lazy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const podio::CollectionBase* collection = frame->get(coll_name);
+    if (collection == nullptr) return false;
+    DeferredInsertingVisitor visitor(factory);
+    VisitPodioCollection<DeferredInsertingVisitor> visit;
+    visit(visitor, *collection);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// ReadFrame
+//
+/// Read an entry from the "events" category.
+///
+/// \param entry        entry number in file
+/// \param collections  collections to read, or all collections if empty
+//------------------------------------------------------------------------------
+std::unique_ptr<podio::Frame> JEventSourcePODIO::ReadFrame(size_t entry, const std::vector<std::string>& collections) {
+#if podio_VERSION >= PODIO_VERSION(1, 1, 0)
+    if (!collections.empty()) {
+        return std::make_unique<podio::Frame>(m_reader.readEntry("events", entry, collections));
+    }
+#endif
+    auto frame_data = m_reader.readEntry("events", entry);
+    return std::make_unique<podio::Frame>(std::move(frame_data));
+}
+
+//------------------------------------------------------------------------------
+// ConfigureLazyInput
+//
+/// Split the collections found in the first entry into those read with every
+/// entry and those read on demand. A collection is read with every entry if it
+/// is requested for output, is an input of a factory whose outputs are needed
+/// (following *:InputTags and *:OutputTags), or is connected to such a
+/// collection through podio relations in either direction. The remaining
+/// collections are grouped by the relations between them, and a group is read
+/// into a single frame the first time one of its collections is requested, so
+/// that every object is read at most once per event. Lazy input is turned off
+/// if all collections are written out.
+///
+/// \param frame  first entry of the file, read in full
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::ConfigureLazyInput(const podio::Frame& frame) {
+
+    auto to_lower = [](std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+        return str;
+    };
+
+    auto* pm = GetApplication()->GetJParameterManager();
+    std::vector<std::string> needed;
+    if (pm->Exists("podio:output_collections")) {
+        needed = pm->GetParameterValue<std::vector<std::string>>("podio:output_collections");
+    }
+    if (needed.empty()) {
+        LOG << "podio:lazy_input has no effect when podio:output_collections is empty, reading all collections" << LOG_END;
+        m_lazy_input = false;
+        return;
+    }
+    needed.push_back("EventHeader");
+
+    // Map every factory output collection to the inputs that produce it
+    std::map<std::string, std::string> input_tags_by_prefix;
+    std::map<std::string, std::string> output_tags_by_prefix;
+    for (const auto& [key, param] : pm->GetAllParameters()) {
+        const std::string lkey = to_lower(key);
+        for (const auto& [suffix, tags] : {std::pair{std::string(":inputtags"), &input_tags_by_prefix},
+                                           std::pair{std::string(":outputtags"), &output_tags_by_prefix}}) {
+            if (lkey.size() > suffix.size() && lkey.compare(lkey.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                (*tags)[lkey.substr(0, lkey.size() - suffix.size())] = param->GetValue();
+            }
+        }
+    }
+    std::map<std::string, std::vector<std::string>> inputs_by_output;
+    for (const auto& [prefix, output_tags] : output_tags_by_prefix) {
+        std::vector<std::string> outputs, inputs;
+        JParameterManager::Parse(output_tags, outputs);
+        if (auto it = input_tags_by_prefix.find(prefix); it != input_tags_by_prefix.end()) {
+            JParameterManager::Parse(it->second, inputs);
+        }
+        for (const auto& output : outputs) {
+            auto& deps = inputs_by_output[output];
+            deps.insert(deps.end(), inputs.begin(), inputs.end());
+        }
+    }
+
+    // Map every collection in the file to the collections its relations point to
+    std::map<uint32_t, std::string> name_by_id;
+    for (const std::string& name : frame.getAvailableCollections()) {
+        const podio::CollectionBase* coll = frame.get(name);
+        name_by_id[coll->getID()] = name;
+        m_collection_types[name] = std::string(coll->getTypeName());
+    }
+    std::map<std::string, std::set<std::string>> refs_by_name;
+    for (const auto& [id, name] : name_by_id) {
+        // getCollectionForWrite() fills the reference buffers with the ObjectIDs of related objects
+        auto* coll = const_cast<podio::CollectionBase*>(frame.getCollectionForWrite(name));
+        auto buffers = coll->getBuffers();
+        if (buffers.references == nullptr) continue;
+        for (const auto& refs : *buffers.references) {
+            for (const auto& ref : *refs) {
+                if (auto it = name_by_id.find(ref.collectionID); it != name_by_id.end() && it->second != name) {
+                    // Relations are followed both ways: reading either end alone would duplicate the other
+                    refs_by_name[name].insert(it->second);
+                    refs_by_name[it->second].insert(name);
+                }
+            }
+        }
+    }
+
+    // Closure of a set of collections over factory inputs and relations
+    auto closure = [&](std::vector<std::string> seeds, bool follow_factories) {
+        std::set<std::string> visited;
+        std::deque<std::string> queue(seeds.begin(), seeds.end());
+        while (!queue.empty()) {
+            std::string name = std::move(queue.front());
+            queue.pop_front();
+            if (!visited.insert(name).second) continue;
+            if (follow_factories) {
+                if (auto it = inputs_by_output.find(name); it != inputs_by_output.end()) {
+                    queue.insert(queue.end(), it->second.begin(), it->second.end());
+                }
+            }
+            if (auto it = refs_by_name.find(name); it != refs_by_name.end()) {
+                queue.insert(queue.end(), it->second.begin(), it->second.end());
+            }
+        }
+        return visited;
+    };
+
+    const std::set<std::string> eager = closure(needed, true);
+    for (const auto& [name, type] : m_collection_types) {
+        if (eager.count(name) != 0) {
+            m_eager_collections.push_back(name);
+        } else if (m_deferred_collections.count(name) == 0) {
+            // Collections connected through relations form a group that is read together
+            auto group = closure({name}, false);
+            for (const auto& member : group) {
+                m_deferred_collections[member] = m_deferred_groups.size();
+            }
+            m_deferred_groups.emplace_back(group.begin(), group.end());
+        }
+    }
+
+    // Attribute on-disk branch sizes to collections. Relation and vector member
+    // branches of collection "X" are named "_X_<member>".
+    for (const auto& [branch_name, bytes] : m_branch_bytes) {
+        const std::string* owner = nullptr;
+        for (const auto& [name, type] : m_collection_types) {
+            bool match = (branch_name == name)
+                      || (branch_name.size() > name.size() + 2 && branch_name[0] == '_'
+                          && branch_name.compare(1, name.size(), name) == 0 && branch_name[name.size() + 1] == '_');
+            if (match && (owner == nullptr || name.size() > owner->size())) owner = &name;
+        }
+        if (owner != nullptr) {
+            m_collection_stats[*owner].zip_bytes += bytes.first;
+            m_collection_stats[*owner].tot_bytes += bytes.second;
+        }
+    }
+
+    LOG << "podio:lazy_input reading " << m_eager_collections.size() << " of " << m_collection_types.size()
+        << " collections with each event, the rest on demand in " << m_deferred_groups.size() << " groups" << LOG_END;
+    m_lazy_configured = true;
+}
+
+//------------------------------------------------------------------------------
+// PrintInputStatistics
+//
+/// Print on-disk size of the collections read with every event versus all
+/// collections, and how often and how long each deferred collection was loaded.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::PrintInputStatistics() const {
+
+    std::uint64_t eager_zip_bytes = 0;
+    std::uint64_t all_zip_bytes = 0;
+    for (const auto& [name, stats] : m_collection_stats) {
+        all_zip_bytes += stats.zip_bytes;
+    }
+    for (const auto& name : m_eager_collections) {
+        if (auto it = m_collection_stats.find(name); it != m_collection_stats.end()) {
+            eager_zip_bytes += it->second.zip_bytes;
+        }
+    }
+
+    LOG << fmt::format("Lazy input: {} events, {:.3f} s reading entries, {:.1f} of {:.1f} MB compressed input in eagerly read collections",
+                       Nevents_read, m_eager_read_seconds, eager_zip_bytes / 1e6, all_zip_bytes / 1e6) << LOG_END;
+    for (const auto& [name, stats] : m_collection_stats) {
+        if (stats.lazy_loads == 0) continue;
+        LOG << fmt::format("  {:40s} {:8d} loads {:10.3f} s {:10.1f} MB compressed {:10.1f} MB uncompressed in file",
+                           name, stats.lazy_loads, stats.lazy_seconds, stats.zip_bytes / 1e6, stats.tot_bytes / 1e6) << LOG_END;
+    }
+}
+
 //------------------------------------------------------------------------------
 // GetDescription
 //------------------------------------------------------------------------------
@@ -8,11 +8,18 @@
 #include <JANA/JEvent.h>
 #include <JANA/JEventSource.h>
 #include <JANA/JEventSourceGeneratorT.h>
+#include <JANA/JFactory.h>
+#include <podio/Frame.h>
 #include <podio/ROOTFrameReader.h>
 #include <stddef.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 class JEventSourcePODIO : public JEventSource {
 
@@ -27,11 +34,25 @@ public:
 
     void GetEvent(std::shared_ptr<JEvent>) override;
 
+    bool GetObjects(const std::shared_ptr<const JEvent>& event, JFactory* factory) override;
+
     static std::string GetDescription();
 
     void PrintCollectionTypeTable(void);
 
+    /// Per-event handle used to load deferred collections on demand.
+    /// Frames holding lazily read groups of collections are owned here, by
+    /// group index, so that they live exactly as long as the event.
+    struct DeferredEntry {
+        size_t entry = 0;
+        mutable std::map<size_t, std::unique_ptr<podio::Frame>> frames;
+    };
+
 protected:
+    std::unique_ptr<podio::Frame> ReadFrame(size_t entry, const std::vector<std::string>& collections = {});
+    void ConfigureLazyInput(const podio::Frame& frame);
+    void PrintInputStatistics() const;
+
     podio::ROOTFrameReader m_reader;
     size_t Nevents_in_file = 0;
     size_t Nevents_read = 0;
@@ -42,6 +63,25 @@ protected:
     std::set<std::string> m_INPUT_EXCLUDE_COLLECTIONS;
     bool m_run_forever=false;
 
+    // Lazy input: only collections reachable from the configured outputs are
+    // read with each entry, everything else is read on the first request.
+    struct CollectionStats {
+        std::uint64_t zip_bytes = 0;
+        std::uint64_t tot_bytes = 0;
+        size_t lazy_loads = 0;
+        double lazy_seconds = 0.;
+    };
+    bool m_lazy_input = false;
+    std::atomic<bool> m_lazy_configured{false};
+    std::mutex m_reader_mutex;
+    std::vector<std::string> m_eager_collections;
+    std::map<std::string, size_t> m_deferred_collections; // name -> index in m_deferred_groups
+    std::vector<std::vector<std::string>> m_deferred_groups; // collections connected by relations, read together
+    std::map<std::string, std::string> m_collection_types;
+    std::map<std::string, std::pair<std::uint64_t, std::uint64_t>> m_branch_bytes;
+    std::map<std::string, CollectionStats> m_collection_stats;
+    double m_eager_read_seconds = 0.;
+
 };
 
 template <>
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * Bounded queue of finished events that a single thread drains into an output.
+ *
+ * Items are pushed from the processing threads together with their event
+ * number and are owned by the queue until they are written. When the queue is
+ * full, push() blocks until the writer has taken an item (back-pressure). In
+ * ordered mode the writer holds items back until the queue is full, or until
+ * finish() is called, and always writes the lowest event number first. The
+ * output is then exactly ordered as long as the queue is longer than the number
+ * of events in flight.
+ *
+ * An exception thrown while writing stops the writer and is rethrown from the
+ * following push() and from finish().
+ */
+template <typename T> class WriteQueue {
+public:
+  struct Options {
+    std::size_t max_size;
+    bool ordered;
+  };
+
+  struct Stats {
+    std::size_t written{0};
+    std::size_t max_depth{0};
+    double mean_depth{0.};
+    std::size_t blocked_pushes{0};
+    double blocked_seconds{0.};
+    double write_seconds{0.};
+  };
+
+  /// Writes one item, called on the writer thread only
+  using WriteFunction = std::function<void(T& item)>;
+
+  WriteQueue(WriteFunction write, Options options) : m_write(std::move(write)), m_options(options) {
+    m_options.max_size = std::max<std::size_t>(m_options.max_size, 1);
+    m_queue.reserve(m_options.max_size);
+    m_writer = std::thread(&WriteQueue::writer, this);
+  }
+
+  ~WriteQueue() { stop(); }
+
+  WriteQueue(const WriteQueue&)            = delete;
+  WriteQueue& operator=(const WriteQueue&) = delete;
+
+  /// Hands an item to the writer, blocks while the queue is full
+  void push(std::uint64_t number, T item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_queue.size() >= m_options.max_size && !m_exception) {
+      auto start = std::chrono::steady_clock::now();
+      m_not_full.wait(lock, [this] { return m_queue.size() < m_options.max_size || m_exception; });
+      m_blocked_pushes += 1;
+      m_blocked_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (m_exception) {
+      std::rethrow_exception(m_exception);
+    }
+
+    m_queue.push_back({number, std::move(item)});
+    if (m_options.ordered) {
+      std::push_heap(m_queue.begin(), m_queue.end(), later);
+    }
+    m_pushes += 1;
+    m_max_depth = std::max(m_max_depth, m_queue.size());
+    m_sum_depth += m_queue.size();
+    m_not_empty.notify_one();
+  }
+
+  /// Writes everything still queued and stops the writer thread
+  void finish() {
+    stop();
+    if (m_exception) {
+      std::rethrow_exception(m_exception);
+    }
+  }
+
+  Stats stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return {m_written,
+            m_max_depth,
+            m_pushes > 0 ? static_cast<double>(m_sum_depth) / m_pushes : 0.,
+            m_blocked_pushes,
+            m_blocked_seconds,
+            m_write_seconds};
+  }
+
+private:
+  struct Entry {
+    std::uint64_t number;
+    T item;
+  };
+
+  static bool later(const Entry& a, const Entry& b) { return a.number > b.number; }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_not_empty.notify_all();
+    if (m_writer.joinable()) {
+      m_writer.join();
+    }
+  }
+
+  void writer() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_not_empty.wait(lock, [this] {
+        return m_stop || (m_options.ordered ? m_queue.size() >= m_options.max_size : !m_queue.empty());
+      });
+      if (m_queue.empty()) {
+        return;
+      }
+
+      auto next = m_queue.begin();
+      if (m_options.ordered) {
+        std::pop_heap(m_queue.begin(), m_queue.end(), later);
+        next = m_queue.end() - 1;
+      }
+      Entry entry = std::move(*next);
+      m_queue.erase(next);
+      m_not_full.notify_one();
+
+      lock.unlock();
+      auto start = std::chrono::steady_clock::now();
+      try {
+        m_write(entry.item);
+      } catch (...) {
+        lock.lock();
+        m_exception = std::current_exception();
+        m_queue.clear();
+        m_not_full.notify_all();
+        return;
+      }
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      lock.lock();
+      m_written += 1;
+      m_write_seconds += seconds;
+    }
+  }
+
+  WriteFunction m_write;
+  Options m_options;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+  std::vector<Entry> m_queue; // heap on event number in ordered mode, otherwise oldest first
+  bool m_stop{false};
+  std::exception_ptr m_exception;
+  std::thread m_writer;
+
+  std::size_t m_written{0};
+  std::size_t m_pushes{0};
+  std::size_t m_max_depth{0};
+  std::size_t m_sum_depth{0};
+  std::size_t m_blocked_pushes{0};
+  double m_blocked_seconds{0.};
+  double m_write_seconds{0.};
+};
+
+} // namespace eicrecon
@@ -89,12 +89,17 @@ def AddCollections(datamodelName, collectionfiles):
         visitor.append('            return visitor(*reinterpret_cast<const ' + datamodelName + '::' + basename + 'Collection*>(&collection));')
         visitor.append('        }')
 
+        type_visitor.append('        if (podio_typename == "' + datamodelName + '::' + basename + 'Collection") {')
+        type_visitor.append('            return visitor.template operator()<' + datamodelName + '::' + basename + 'Collection>();')
+        type_visitor.append('        }')
+
 
 collectionfiles_edm4hep = glob.glob(EDM4HEP_INCLUDE_DIR+'/edm4hep/*Collection.h')
 collectionfiles_edm4eic    = glob.glob(EDM4EIC_INCLUDE_DIR+'/edm4eic/*Collection.h')
 header_lines      = []
 type_map = []
 visitor = []
+type_visitor = []
 AddCollections('edm4hep', collectionfiles_edm4hep)
 AddCollections('edm4eic'   , collectionfiles_edm4eic   )
 
@@ -114,6 +119,7 @@ with open('datamodel_glue.h', 'w') as f:
     f.write('#pragma once\n')
     f.write('\n')
     f.write('#include <stdexcept>\n')
+    f.write('#include <string_view>\n')
     f.write('#include <podio/podioVersion.h>\n')
     f.write('#include <podio/CollectionBase.h>\n')
     f.write('\n')
@@ -134,4 +140,10 @@ with open('datamodel_glue.h', 'w') as f:
     f.write('\n        throw std::runtime_error("Unrecognized podio typename!");')
     f.write('\n    }')
     f.write('\n};\n')
+    f.write('\ntemplate <typename Visitor> struct VisitPodioCollectionType {')
+    f.write('\n    void operator()(Visitor& visitor, std::string_view podio_typename) {\n')
+    f.write('\n'.join(type_visitor))
+    f.write('\n        throw std::runtime_error("Unrecognized podio typename!");')
+    f.write('\n    }')
+    f.write('\n};\n')
     f.close()
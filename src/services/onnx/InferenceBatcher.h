@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eicrecon {
+
+/**
+ * Collects rows submitted from concurrent events into batches for one model.
+ *
+ * A batch is started as soon as the previous one finished, with the rows that
+ * arrived in the meantime, so rows are only batched when their callers overlap.
+ * A non-zero latency cap additionally lets the first row of a batch wait for
+ * more rows, up to max_batch_size. With max_batch_size of 1 every row is run on
+ * the calling thread.
+ */
+class InferenceBatcher {
+public:
+  struct Options {
+    std::size_t max_batch_size;
+    std::chrono::microseconds max_latency;
+  };
+
+  /// Evaluates `n_rows` rows stacked in `rows`, returns the outputs stacked likewise
+  using RunFunction = std::function<std::vector<float>(std::vector<float>& rows, std::size_t n_rows)>;
+
+  InferenceBatcher(RunFunction run, std::size_t input_size, Options options)
+      : m_run(std::move(run)), m_input_size(input_size), m_options(options) {
+    if (m_options.max_batch_size > 1) {
+      m_worker = std::thread(&InferenceBatcher::worker, this);
+    }
+  }
+
+  ~InferenceBatcher() {
+    if (m_worker.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_cv.notify_all();
+      m_worker.join();
+    }
+  }
+
+  InferenceBatcher(const InferenceBatcher&) = delete;
+  InferenceBatcher& operator=(const InferenceBatcher&) = delete;
+
+  /// Whether rows from different submissions are evaluated together
+  bool batched() const { return m_worker.joinable(); };
+
+  /// Evaluates a row of input_size features, resolving to the model output for it
+  std::future<std::vector<float>> submit(std::vector<float> row) {
+    if (row.size() != m_input_size) {
+      throw std::invalid_argument(fmt::format("ONNX model input row has {} features, expected {}", row.size(),
+                                              m_input_size));
+    }
+
+    Request request{std::move(row), {}, std::chrono::steady_clock::now()};
+    auto result = request.result.get_future();
+    if (!batched()) {
+      std::vector<Request> batch;
+      batch.push_back(std::move(request));
+      run_batch(batch);
+      return result;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push_back(std::move(request));
+    }
+    m_cv.notify_one();
+    return result;
+  }
+
+private:
+  struct Request {
+    std::vector<float> row;
+    std::promise<std::vector<float>> result;
+    std::chrono::steady_clock::time_point submitted;
+  };
+
+  void run_batch(std::vector<Request>& batch) {
+    try {
+      std::vector<float> rows;
+      rows.reserve(batch.size() * m_input_size);
+      for (const auto& request : batch) {
+        rows.insert(rows.end(), request.row.begin(), request.row.end());
+      }
+      std::vector<float> outputs = m_run(rows, batch.size());
+      if (outputs.size() % batch.size() != 0) {
+        throw std::runtime_error(fmt::format("ONNX model output of {} values does not split into {} rows",
+                                             outputs.size(), batch.size()));
+      }
+      const std::size_t output_size = outputs.size() / batch.size();
+      for (std::size_t i = 0; i < batch.size(); i++) {
+        batch[i].result.set_value({outputs.begin() + i * output_size, outputs.begin() + (i + 1) * output_size});
+      }
+    } catch (...) {
+      for (auto& request : batch) {
+        request.result.set_exception(std::current_exception());
+      }
+    }
+  }
+
+  void worker() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+      if (m_queue.empty()) {
+        return;
+      }
+
+      // Wait for more rows until the batch is full or the oldest row reaches the latency cap
+      if (m_options.max_latency.count() > 0) {
+        m_cv.wait_until(lock, m_queue.front().submitted + m_options.max_latency,
+                        [this] { return m_stop || m_queue.size() >= m_options.max_batch_size; });
+      }
+
+      const std::size_t n_rows = std::min(m_queue.size(), m_options.max_batch_size);
+      std::vector<Request> batch(std::make_move_iterator(m_queue.begin()),
+                                 std::make_move_iterator(m_queue.begin() + n_rows));
+      m_queue.erase(m_queue.begin(), m_queue.begin() + n_rows);
+
+      lock.unlock();
+      run_batch(batch);
+      lock.lock();
+    }
+  }
+
+  RunFunction m_run;
+  std::size_t m_input_size;
+  Options m_options;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<Request> m_queue;
+  bool m_stop{false};
+  std::thread m_worker;
+};
+
+} // namespace eicrecon
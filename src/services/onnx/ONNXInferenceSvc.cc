@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck, Dmitry Kalinkin
+
+#include "ONNXInferenceSvc.h"
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <onnxruntime_c_api.h>
+#include <stdexcept>
+
+namespace eicrecon {
+
+ONNXModel::ONNXModel(const Ort::Env& env, const std::string& path, const Ort::SessionOptions& session_options,
+                     Options options)
+    : m_session(env, path.c_str(), session_options) {
+  if (m_session.GetInputCount() != 1 || m_session.GetOutputCount() != 1) {
+    throw std::runtime_error(fmt::format("ONNX model \"{}\" has {} inputs and {} outputs, expected one of each",
+                                         path, m_session.GetInputCount(), m_session.GetOutputCount()));
+  }
+  Ort::AllocatorWithDefaultOptions allocator;
+  m_input_name = m_session.GetInputNameAllocated(0, allocator).get();
+  m_output_name = m_session.GetOutputNameAllocated(0, allocator).get();
+  m_input_shape = m_session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+
+  // A dynamic first dimension is the batch dimension, any other one is a model error
+  const bool has_batch_dimension = !m_input_shape.empty() && m_input_shape.front() < 0;
+  for (std::size_t i = has_batch_dimension ? 1 : 0; i < m_input_shape.size(); i++) {
+    if (m_input_shape[i] < 0) {
+      throw std::runtime_error(fmt::format("ONNX model \"{}\" input has dynamic dimension {}", path, i));
+    }
+    m_input_size *= m_input_shape[i];
+  }
+
+  // rows of a model without a batch dimension are run one at a time
+  if (!has_batch_dimension) {
+    options.max_batch_size = 1;
+  }
+  m_batcher = std::make_unique<InferenceBatcher>(
+      [this](std::vector<float>& rows, std::size_t n_rows) { return run(rows, n_rows); }, m_input_size, options);
+}
+
+std::vector<float> ONNXModel::run(std::vector<float>& rows, std::size_t n_rows) {
+  std::vector<std::int64_t> shape = m_input_shape;
+  if (!shape.empty() && shape.front() < 0) {
+    shape.front() = n_rows;
+  }
+  Ort::MemoryInfo mem_info =
+      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+  auto input_tensor = Ort::Value::CreateTensor<float>(mem_info, rows.data(), rows.size(), shape.data(), shape.size());
+
+  const char* input_name = m_input_name.c_str();
+  const char* output_name = m_output_name.c_str();
+  auto output_tensors = m_session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, 1);
+  if (output_tensors.size() != 1 || !output_tensors[0].IsTensor()) {
+    throw std::runtime_error("ONNX model output is not a tensor");
+  }
+  const float* data = output_tensors[0].GetTensorData<float>();
+  return {data, data + output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount()};
+}
+
+ONNXModel* ONNXInferenceSvc::load(const std::string& path) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_models.find(path);
+  if (it != m_models.end()) {
+    return it->second.get();
+  }
+
+  if (m_env == nullptr) {
+    m_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "eicrecon");
+  }
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(m_options.intra_op_threads);
+  session_options.SetInterOpNumThreads(1);
+  session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+  info("Loading ONNX model \"{}\"", path);
+  auto model = std::make_unique<ONNXModel>(*m_env, path, session_options,
+                                           ONNXModel::Options{m_options.max_batch_size, m_options.max_latency});
+  debug("Input {} : {}, output {}", model->input_name(), fmt::join(model->input_shape(), "x"),
+        model->output_name());
+  if (model->batched()) {
+    debug("Batching up to {} rows, waiting at most {} us", m_options.max_batch_size, m_options.max_latency.count());
+  }
+  return m_models.emplace(path, std::move(model)).first->second.get();
+}
+
+} // namespace eicrecon
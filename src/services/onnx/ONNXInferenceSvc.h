@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck, Dmitry Kalinkin
+
+#pragma once
+
+#include <algorithms/logger.h>
+#include <onnxruntime_cxx_api.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "InferenceBatcher.h"
+
+namespace eicrecon {
+
+/**
+ * A single-input, single-output model, shared by all algorithms using its file.
+ *
+ * Rows submitted from concurrent events are evaluated together in one session
+ * run, which spreads the fixed cost of a run over the batch (see InferenceBatcher).
+ * Models with a fixed first dimension cannot be batched and are run on submission.
+ */
+class ONNXModel {
+public:
+  using Options = InferenceBatcher::Options;
+
+  ONNXModel(const Ort::Env& env, const std::string& path, const Ort::SessionOptions& session_options,
+            Options options);
+  ONNXModel(const ONNXModel&) = delete;
+  ONNXModel& operator=(const ONNXModel&) = delete;
+
+  const std::string& input_name() const { return m_input_name; };
+  const std::string& output_name() const { return m_output_name; };
+  const std::vector<std::int64_t>& input_shape() const { return m_input_shape; };
+
+  /// Number of features in a row
+  std::size_t input_size() const { return m_input_size; };
+
+  /// Whether rows from different submissions are evaluated together
+  bool batched() const { return m_batcher->batched(); };
+
+  /// Evaluates a row of input_size() features, resolving to the model output for it
+  std::future<std::vector<float>> submit(std::vector<float> row) { return m_batcher->submit(std::move(row)); };
+
+private:
+  /// Evaluates `n_rows` rows stacked in `rows`, returns the outputs stacked likewise
+  std::vector<float> run(std::vector<float>& rows, std::size_t n_rows);
+
+  Ort::Session m_session{nullptr};
+  std::string m_input_name;
+  std::string m_output_name;
+  std::vector<std::int64_t> m_input_shape;
+  std::size_t m_input_size{1};
+  // declared last, so that its thread is joined before the session is destroyed
+  std::unique_ptr<InferenceBatcher> m_batcher;
+};
+
+/**
+ * Owns the ONNX Runtime environment and one session per model file
+ */
+class ONNXInferenceSvc : public algorithms::LoggedService<ONNXInferenceSvc> {
+public:
+  struct Options {
+    int intra_op_threads{1};
+    std::size_t max_batch_size{64};
+    std::chrono::microseconds max_latency{0};
+  };
+
+  void init() {};
+
+  /// Destroys the models and the environment, to be called before static destruction
+  void release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_models.clear();
+    m_env.reset();
+  };
+
+  /// Applies to models loaded afterwards
+  void configure(const Options& options) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options = options;
+  };
+
+  /// The model in `path`, loaded on first use. Throws if it can not be loaded.
+  ONNXModel* load(const std::string& path);
+
+private:
+  std::mutex m_mutex;
+  Options m_options;
+  // the environment has to outlive the sessions
+  std::unique_ptr<Ort::Env> m_env;
+  std::map<std::string, std::unique_ptr<ONNXModel>> m_models;
+
+  ALGORITHMS_DEFINE_LOGGED_SERVICE(ONNXInferenceSvc);
+};
+
+} // namespace eicrecon
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck, Dmitry Kalinkin
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JServiceLocator.h>
+#include <algorithms/service.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "ONNXInferenceSvc.h"
+
+namespace {
+
+/// Destroys the ONNX Runtime sessions and environment with the application,
+/// rather than during static destruction after ONNX Runtime may be unloaded
+class ONNXInferenceRelease_service : public JService {
+public:
+  ~ONNXInferenceRelease_service() override { eicrecon::ONNXInferenceSvc::instance().release(); }
+};
+
+} // namespace
+
+extern "C" {
+
+void InitPlugin(JApplication* app) {
+  InitJANAPlugin(app);
+
+  int intra_op_threads = 1;
+  int max_batch_size = 64;
+  int max_latency_us = 0;
+  app->SetDefaultParameter("onnx:intra_op_threads", intra_op_threads,
+                           "Threads used by ONNX Runtime within a single inference");
+  app->SetDefaultParameter("onnx:max_batch_size", max_batch_size,
+                           "Maximum number of events evaluated together (1 disables batching)");
+  app->SetDefaultParameter("onnx:max_latency_us", max_latency_us,
+                           "Maximum time an event waits for other events to join its batch [us] (0: only events submitted while a batch runs are batched)");
+
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  auto& onnxInferenceSvc = eicrecon::ONNXInferenceSvc::instance();
+  onnxInferenceSvc.configure({
+    .intra_op_threads = intra_op_threads,
+    .max_batch_size = static_cast<std::size_t>(std::max(max_batch_size, 1)),
+    .max_latency = std::chrono::microseconds(max_latency_us),
+  });
+  serviceSvc.add<eicrecon::ONNXInferenceSvc>(&onnxInferenceSvc);
+  app->ProvideService(std::make_shared<ONNXInferenceRelease_service>());
+}
+}
@@ -3,26 +3,93 @@
 
 #include "services/pid_lut/PIDLookupTable.h"
 
-#include <boost/histogram.hpp>
+#include <boost/histogram/axis.hpp>
 #include <boost/iostreams/categories.hpp>
 #include <boost/iostreams/close.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
+#include <fcntl.h>
 #include <fmt/core.h>
 #include <math.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream> // IWYU pragma: keep
 #include <iterator>
-#include <sstream> // IWYU pragma: keep
+#include <optional>
+#include <random>
 #include <stdexcept>
+#include <type_traits>
 // IWYU pragma: no_include <boost/mp11/detail/mp_defer.hpp>
 
 namespace bh = boost::histogram;
 
 namespace eicrecon {
 
+namespace {
+
+  constexpr char binary_magic[8] = {'E', 'I', 'C', 'P', 'I', 'D', 'L', '1'};
+
+  constexpr PIDLookupTable::Entry zero_entry{0.f, 0.f, 0.f, 0.f};
+
+  template <typename T> void append(std::vector<char>& buf, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const char* p = reinterpret_cast<const char*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+  }
+
+  template <typename T> void append(std::vector<char>& buf, const std::vector<T>& values) {
+    append(buf, static_cast<std::uint64_t>(values.size()));
+    for (const T& value : values) {
+      append(buf, value);
+    }
+  }
+
+  /// Index of value on an axis, or nothing if it falls into an under- or overflow bin
+  template <typename Axis, typename Value> std::optional<std::size_t> inner_index(const Axis& axis, Value value) {
+    const auto index = axis.index(value);
+    if (index < 0 || index >= axis.size()) {
+      return std::nullopt;
+    }
+    return static_cast<std::size_t>(index);
+  }
+
+} // namespace
+
+PIDLookupTable::~PIDLookupTable() {
+    if (m_mapping != nullptr) {
+      munmap(m_mapping, m_mapping_size);
+    }
+}
+
+void PIDLookupTable::make_axes(const PIDLookupTable::Binning &binning) {
+    const double angle_fudge = binning.use_radians ? 180. / M_PI : 1.;
+
+    m_pdg_axis = bh::axis::category<int>(binning.pdg_values);
+    m_charge_axis = bh::axis::category<int>(binning.charge_values);
+    m_momentum_axis = bh::axis::variable<>(binning.momentum_edges);
+    std::vector<double> polar_edges = binning.polar_edges;
+    for (double &edge : polar_edges) {
+      edge *= angle_fudge;
+    }
+    m_polar_axis = bh::axis::variable<>(polar_edges);
+    m_azimuthal_axis = bh::axis::circular<>(bh::axis::step(binning.azimuthal_binning.at(2) * angle_fudge), binning.azimuthal_binning.at(0) * angle_fudge, binning.azimuthal_binning.at(1) * angle_fudge);
+
+    m_symmetrizing_charges = binning.charge_values.size() == 1;
+}
+
+std::size_t PIDLookupTable::size() const {
+    return static_cast<std::size_t>(m_pdg_axis.size()) * m_charge_axis.size() * m_momentum_axis.size()
+         * m_polar_axis.size() * m_azimuthal_axis.size();
+}
+
 const PIDLookupTable::Entry* PIDLookupTable::Lookup(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const {
     // Our lookup table expects _unsigned_ PDGs. The charge information is passed separately.
     pdg = std::abs(pdg);
@@ -31,14 +98,18 @@ const PIDLookupTable::Entry* PIDLookupTable::Lookup(int pdg, int charge, double
       charge = std::abs(charge);
     }
 
-    return &m_hist[
-      decltype(m_hist)::multi_index_type {
-        m_hist.axis(0).index(pdg),
-        m_hist.axis(1).index(charge),
-        m_hist.axis(2).index(momentum),
-        m_hist.axis(3).index(theta_deg),
-        m_hist.axis(4).index(phi_deg)
-      }
+    const auto i_pdg = inner_index(m_pdg_axis, pdg);
+    const auto i_charge = inner_index(m_charge_axis, charge);
+    const auto i_momentum = inner_index(m_momentum_axis, momentum);
+    const auto i_polar = inner_index(m_polar_axis, theta_deg);
+    const auto i_azimuthal = inner_index(m_azimuthal_axis, phi_deg);
+    if (m_entries == nullptr || !i_pdg || !i_charge || !i_momentum || !i_polar || !i_azimuthal) {
+      return &zero_entry;
+    }
+
+    return &m_entries[
+      (((*i_pdg * m_charge_axis.size() + *i_charge) * m_momentum_axis.size() + *i_momentum)
+        * m_polar_axis.size() + *i_polar) * m_azimuthal_axis.size() + *i_azimuthal
     ];
 }
 
@@ -61,85 +132,177 @@ void PIDLookupTable::load_file(const std::string& filename, const PIDLookupTable
     in.push(file);
 
     std::string line;
-    std::istringstream iss;
-    double step;
 
     const double angle_fudge = binning.use_radians ? 180. / M_PI : 1.;
 
-    bh::axis::category<int> pdg_bins(binning.pdg_values);
-    bh::axis::category<int> charge_bins(binning.charge_values);
-    bh::axis::variable<> momentum_bins(binning.momentum_edges);
-    std::vector<double> polar_edges = binning.polar_edges;
-    for (double &edge : polar_edges) {
-      edge *= angle_fudge;
-    }
-    bh::axis::variable<> polar_bins(polar_edges);
-    bh::axis::circular<> azimuthal_bins(bh::axis::step(binning.azimuthal_binning.at(2) * angle_fudge), binning.azimuthal_binning.at(0) * angle_fudge, binning.azimuthal_binning.at(1) * angle_fudge);
-
-    m_hist = bh::make_histogram_with(bh::dense_storage<PIDLookupTable::Entry>(), pdg_bins, charge_bins, momentum_bins, polar_bins, azimuthal_bins);
+    make_axes(binning);
+    m_storage.assign(size(), zero_entry);
+    std::vector<unsigned char> counts(m_storage.size(), 0);
 
-    m_symmetrizing_charges = binning.charge_values.size() == 1;
+    const std::size_t n_values = binning.missing_electron_prob ? 8 : 9;
 
     while (std::getline(in, line)) {
-        Entry entry;
         if (line.empty() || line[0] == '#' || std::all_of(std::begin(line), std::end(line), [](unsigned char c) { return std::isspace(c); })) continue;
 
-        iss.str(line);
-        iss.clear();
-        double pdg, charge, momentum, eta, phi, prob_electron, prob_pion, prob_kaon, prob_proton;
-        // Read each field from the line and assign to Entry struct members
-        if ((bool)(iss >> pdg
-                >> charge
-                >> momentum
-                >> eta
-                >> phi) && (binning.missing_electron_prob || (bool)(iss
-                >> prob_electron)) && (bool)(iss
-                >> prob_pion
-                >> prob_kaon
-                >> prob_proton)) {
-
-            if (m_symmetrizing_charges) {
-              charge = std::abs(charge);
-            }
-
-            // operator() here allows to lookup mutable entry and increases the access counter
-            auto &entry = *m_hist(
-              pdg,
-              charge,
-              momentum + (binning.momentum_bin_centers_in_lut ? 0. : (momentum_bins.bin(0).width() / 2)),
-              eta * angle_fudge + (binning.polar_bin_centers_in_lut ? 0. : (polar_bins.bin(0).width() / 2)),
-              phi * angle_fudge + (binning.azimuthal_bin_centers_in_lut ? 0. : (azimuthal_bins.bin(0).width() / 2))
-            ); // N.B. bin(0) may not be of a correct width
-            entry.prob_electron = prob_electron;
-            entry.prob_pion = prob_pion;
-            entry.prob_kaon = prob_kaon;
-            entry.prob_proton = prob_proton;
+        // pdg, charge, momentum, eta, phi, [prob_electron,] prob_pion, prob_kaon, prob_proton
+        std::array<double, 9> values{};
+        const char* begin = line.c_str();
+        std::size_t n_parsed = 0;
+        for (; n_parsed < n_values; ++n_parsed) {
+            char* end = nullptr;
+            values[n_parsed] = std::strtod(begin, &end);
+            if (end == begin) break;
+            begin = end;
         }
-        else {
+        if (n_parsed != n_values) {
             error("Unable to parse LUT file!");
             throw std::runtime_error("Unable to parse LUT file!");
         }
+        if (binning.missing_electron_prob) {
+            std::rotate(values.begin() + 5, values.begin() + 8, values.end());
+            values[5] = 0.;
+        }
+        auto [pdg, charge, momentum, eta, phi, prob_electron, prob_pion, prob_kaon, prob_proton] = values;
+
+        if (m_symmetrizing_charges) {
+          charge = std::abs(charge);
+        }
+
+        const auto i_pdg = inner_index(m_pdg_axis, static_cast<int>(pdg));
+        const auto i_charge = inner_index(m_charge_axis, static_cast<int>(charge));
+        const auto i_momentum = inner_index(m_momentum_axis, momentum + (binning.momentum_bin_centers_in_lut ? 0. : (m_momentum_axis.bin(0).width() / 2)));
+        const auto i_polar = inner_index(m_polar_axis, eta * angle_fudge + (binning.polar_bin_centers_in_lut ? 0. : (m_polar_axis.bin(0).width() / 2)));
+        const auto i_azimuthal = inner_index(m_azimuthal_axis, phi * angle_fudge + (binning.azimuthal_bin_centers_in_lut ? 0. : (m_azimuthal_axis.bin(0).width() / 2)));
+        // N.B. bin(0) may not be of a correct width
+        if (!i_pdg || !i_charge || !i_momentum || !i_polar || !i_azimuthal) {
+            // Outside of the configured binning, such entries could never be looked up
+            continue;
+        }
+
+        const std::size_t index =
+          (((*i_pdg * m_charge_axis.size() + *i_charge) * m_momentum_axis.size() + *i_momentum)
+            * m_polar_axis.size() + *i_polar) * m_azimuthal_axis.size() + *i_azimuthal;
+        m_storage[index] = Entry{
+          static_cast<float>(prob_electron),
+          static_cast<float>(prob_pion),
+          static_cast<float>(prob_kaon),
+          static_cast<float>(prob_proton),
+        };
+        counts[index] += 1;
     }
 
-    for (auto&& b : bh::indexed(m_hist)) {
-      if (b->value() != 1) {
+    for (std::size_t index = 0; index < counts.size(); ++index) {
+      if (counts[index] != 1) {
+        std::size_t rest = index;
+        const auto i_azimuthal = rest % m_azimuthal_axis.size(); rest /= m_azimuthal_axis.size();
+        const auto i_polar = rest % m_polar_axis.size(); rest /= m_polar_axis.size();
+        const auto i_momentum = rest % m_momentum_axis.size(); rest /= m_momentum_axis.size();
+        const auto i_charge = rest % m_charge_axis.size(); rest /= m_charge_axis.size();
+        const auto i_pdg = rest;
         error(
           "Bin {} {} {}:{} {}:{} {}:{} is defined {} times in the PID table",
-          b.bin(0).lower(),
-          b.bin(1).lower(),
-          b.bin(2).lower(),
-          b.bin(2).upper(),
-          b.bin(3).lower() / angle_fudge,
-          b.bin(3).upper() / angle_fudge,
-          b.bin(4).lower() / angle_fudge,
-          b.bin(4).upper() / angle_fudge,
-          b->value()
+          m_pdg_axis.value(i_pdg),
+          m_charge_axis.value(i_charge),
+          m_momentum_axis.bin(i_momentum).lower(),
+          m_momentum_axis.bin(i_momentum).upper(),
+          m_polar_axis.bin(i_polar).lower() / angle_fudge,
+          m_polar_axis.bin(i_polar).upper() / angle_fudge,
+          m_azimuthal_axis.bin(i_azimuthal).lower() / angle_fudge,
+          m_azimuthal_axis.bin(i_azimuthal).upper() / angle_fudge,
+          counts[index]
         );
       }
     }
 
+    m_entries = m_storage.data();
+
     boost::iostreams::close(in);
     file.close();
 }
 
+std::vector<char> PIDLookupTable::binary_header(const PIDLookupTable::Binning &binning) const {
+    // The header holds the complete binning configuration, so that a binary LUT
+    // is only ever used with the configuration it was made with
+    std::vector<char> body;
+    const std::uint8_t flags =
+        (binning.azimuthal_bin_centers_in_lut << 0)
+      | (binning.momentum_bin_centers_in_lut << 1)
+      | (binning.polar_bin_centers_in_lut << 2)
+      | (binning.use_radians << 3)
+      | (binning.missing_electron_prob << 4);
+    append(body, flags);
+    append(body, binning.pdg_values);
+    append(body, binning.charge_values);
+    append(body, binning.momentum_edges);
+    append(body, binning.polar_edges);
+    append(body, binning.azimuthal_binning);
+
+    std::vector<char> header(binary_magic, binary_magic + sizeof(binary_magic));
+    const std::size_t fixed_size = header.size() + 2 * sizeof(std::uint64_t);
+    // Pad so that entries are aligned
+    const std::size_t header_size = (fixed_size + body.size() + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    append(header, static_cast<std::uint64_t>(header_size));
+    append(header, static_cast<std::uint64_t>(size()));
+    header.insert(header.end(), body.begin(), body.end());
+    header.resize(header_size, 0);
+    return header;
+}
+
+bool PIDLookupTable::load_binary(const std::string& filename, const PIDLookupTable::Binning &binning) {
+    make_axes(binning);
+    const std::vector<char> header = binary_header(binning);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != header.size() + size() * sizeof(Entry)) {
+      close(fd);
+      return false;
+    }
+    // Read-only shared mapping: pages are shared between all processes on the node using this file
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      return false;
+    }
+    if (std::memcmp(mapping, header.data(), header.size()) != 0) {
+      munmap(mapping, st.st_size);
+      return false;
+    }
+
+    if (m_mapping != nullptr) {
+      munmap(m_mapping, m_mapping_size);
+    }
+    m_mapping = mapping;
+    m_mapping_size = st.st_size;
+    m_storage.clear();
+    m_entries = reinterpret_cast<const Entry*>(static_cast<const char*>(mapping) + header.size());
+    return true;
+}
+
+void PIDLookupTable::write_binary(const std::string& filename, const PIDLookupTable::Binning &binning) const {
+    if (m_entries == nullptr) {
+      throw std::runtime_error("No PID lookup table loaded");
+    }
+    const std::vector<char> header = binary_header(binning);
+
+    // Write to a temporary file and rename, so that concurrent readers never see a partial file
+    const std::string tmp_filename = filename + ".tmp" + std::to_string(std::random_device{}());
+    {
+      std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+      out.write(header.data(), header.size());
+      out.write(reinterpret_cast<const char*>(m_entries), size() * sizeof(Entry));
+      if (!out.flush()) {
+        std::remove(tmp_filename.c_str());
+        throw std::runtime_error(fmt::format("Unable to write binary LUT file \"{}\"", tmp_filename));
+      }
+    }
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+      std::remove(tmp_filename.c_str());
+      throw std::runtime_error(fmt::format("Unable to write binary LUT file \"{}\"", filename));
+    }
+}
+
 }
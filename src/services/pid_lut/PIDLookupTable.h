@@ -4,9 +4,9 @@
 #pragma once
 
 #include <algorithms/logger.h>
-#include <boost/histogram.hpp>
+#include <boost/histogram/axis.hpp>
+#include <cstddef>
 #include <string>
-#include <tuple>
 #include <vector>
 // IWYU pragma: no_include <boost/mp11/detail/mp_defer.hpp>
 
@@ -15,10 +15,11 @@ namespace eicrecon {
 class PIDLookupTable : public algorithms::LoggerMixin {
 
 public:
-    /// The histogram entry with access counter, where the probabilities are stored in metadata
-    struct Entry : public boost::histogram::accumulators::count<unsigned char, false> {
-        double prob_electron, prob_pion, prob_kaon, prob_proton;
+    /// The table entry, stored as is in binary LUT files
+    struct Entry {
+        float prob_electron, prob_pion, prob_kaon, prob_proton;
     };
+    static_assert(sizeof(Entry) == 4 * sizeof(float));
 
     struct Binning {
       std::vector<int> pdg_values;
@@ -34,25 +35,42 @@ public:
     };
 
 private:
-    boost::histogram::histogram<
-      std::tuple<
-        boost::histogram::axis::category<int>,
-        boost::histogram::axis::category<int>,
-        boost::histogram::axis::variable<>,
-        boost::histogram::axis::variable<>,
-        boost::histogram::axis::circular<>
-      >
-      , boost::histogram::dense_storage<Entry>
-    > m_hist;
+    boost::histogram::axis::category<int> m_pdg_axis;
+    boost::histogram::axis::category<int> m_charge_axis;
+    boost::histogram::axis::variable<> m_momentum_axis;
+    boost::histogram::axis::variable<> m_polar_axis;
+    boost::histogram::axis::circular<> m_azimuthal_axis;
     bool m_symmetrizing_charges;
 
+    /// Entries for all bins, either in m_storage or in a read-only mapping of a binary LUT file
+    const Entry* m_entries = nullptr;
+    std::vector<Entry> m_storage;
+    void* m_mapping = nullptr;
+    std::size_t m_mapping_size = 0;
+
+    void make_axes(const Binning& binning);
+    std::size_t size() const;
+    std::vector<char> binary_header(const Binning& binning) const;
+
 public:
 
     PIDLookupTable() : algorithms::LoggerMixin("PIDLookupTable") {};
+    ~PIDLookupTable();
+    PIDLookupTable(const PIDLookupTable&) = delete;
+    PIDLookupTable& operator=(const PIDLookupTable&) = delete;
 
+    /// Returns the entry for the bin, or an entry with all probabilities zero outside of the table
     const Entry* Lookup(int pdg, int charge, double momentum, double theta_deg, double phi_deg) const;
 
+    /// Parse a (possibly gzip-compressed) text LUT
     void load_file(const std::string& filename, const Binning &binning);
+
+    /// Map a binary LUT written by write_binary(). Returns false if the file can not be used
+    /// with this binning, e.g. because it was made from a different configuration.
+    bool load_binary(const std::string& filename, const Binning &binning);
+
+    /// Write the table in binary form, to be used with load_binary()
+    void write_binary(const std::string& filename, const Binning &binning) const;
 };
 
 }
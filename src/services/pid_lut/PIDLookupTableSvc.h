@@ -7,14 +7,43 @@
 #include "PIDLookupTable.h"
 #include <JANA/Services/JServiceLocator.h>
 #include <JANA/JLogger.h>
-#include <mutex>
+#include <exception>
+#include <fmt/core.h>
+#include <functional>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
 
 namespace eicrecon {
 
 class PIDLookupTableSvc : public algorithms::LoggedService<PIDLookupTableSvc> {
 public:
-    void init() {};
+    /// Binary copies of text tables are read from and written to binary_cache_dir.
+    /// When it is empty (the default), text tables are always parsed and nothing is written.
+    void init(std::string binary_cache_dir = "") {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_binary_cache_dir = std::move(binary_cache_dir);
+    };
+
+    /// Binary copy of a text table in the cache directory, empty if there is none
+    std::string binary_cache_filename(const std::string& filename) const {
+        if (m_binary_cache_dir.empty()) {
+            return "";
+        }
+        // the same name in different directories gives different copies
+        std::error_code ec;
+        auto path = std::filesystem::absolute(filename, ec);
+        if (ec) {
+            path = filename;
+        }
+        const auto hash = std::hash<std::string>{}(path.lexically_normal().string());
+        return (std::filesystem::path(m_binary_cache_dir)
+                / fmt::format("{}.{:016x}.bin", path.filename().string(), hash)).string();
+    }
 
     const PIDLookupTable* load(std::string filename, const PIDLookupTable::Binning &binning) {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -28,7 +57,36 @@ public:
                 return nullptr;
             }
 
-            lut->load_file(filename, binning); // load_file can except
+            const bool is_binary = filename.size() >= 4 && filename.substr(filename.size() - 4) == ".bin";
+            if (is_binary) {
+                if (!lut->load_binary(filename, binning)) {
+                    error("Binary PID lookup table \"{}\" does not match the configured binning", filename);
+                    return nullptr;
+                }
+            } else {
+                // A binary copy in the cache directory is mapped instead of parsing the text,
+                // unless it is stale or was made for a different binning
+                const std::string binary_filename = binary_cache_filename(filename);
+                std::error_code ec;
+                const bool binary_is_current = !binary_filename.empty()
+                    && std::filesystem::exists(binary_filename, ec)
+                    && std::filesystem::last_write_time(binary_filename, ec) >= std::filesystem::last_write_time(filename, ec)
+                    && !ec;
+                if (binary_is_current && lut->load_binary(binary_filename, binning)) {
+                    debug("Using binary PID lookup table \"{}\"", binary_filename);
+                } else {
+                    lut->load_file(filename, binning); // load_file can except
+                    if (!binary_filename.empty() && std::filesystem::is_regular_file(filename, ec)) {
+                        try {
+                            std::filesystem::create_directories(m_binary_cache_dir);
+                            lut->write_binary(binary_filename, binning);
+                            debug("Wrote binary PID lookup table \"{}\"", binary_filename);
+                        } catch (const std::exception& e) {
+                            warning("Not caching PID lookup table \"{}\": {}", filename, e.what());
+                        }
+                    }
+                }
+            }
             auto result_ptr = lut.get();
             m_cache.insert({filename, std::move(lut)});
             return result_ptr;
@@ -40,6 +98,7 @@ public:
 
 private:
     std::mutex m_mutex;
+    std::string m_binary_cache_dir;
     std::map<std::string, std::unique_ptr<PIDLookupTable>> m_cache;
 
     ALGORITHMS_DEFINE_LOGGED_SERVICE(PIDLookupTableSvc);
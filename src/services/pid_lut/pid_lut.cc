@@ -3,6 +3,7 @@
 
 #include <JANA/JApplication.h>
 #include <algorithms/service.h>
+#include <string>
 
 #include "PIDLookupTableSvc.h"
 
@@ -14,5 +15,12 @@ void InitPlugin(JApplication* app) {
   auto& serviceSvc = algorithms::ServiceSvc::instance();
   auto& pidLookupTableSvc = eicrecon::PIDLookupTableSvc::instance();
   serviceSvc.add<eicrecon::PIDLookupTableSvc>(&pidLookupTableSvc);
+
+  std::string binary_cache_dir;
+  app->SetDefaultParameter("pid_lut:binary_cache_dir", binary_cache_dir,
+      "Directory for binary copies of text PID lookup tables, mapped on later runs (empty: always parse the text)");
+  serviceSvc.setInit<eicrecon::PIDLookupTableSvc>([binary_cache_dir](auto&& svc) {
+    svc.init(binary_cache_dir);
+  });
 }
 }
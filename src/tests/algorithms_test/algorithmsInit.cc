@@ -7,12 +7,15 @@
 #include <DD4hep/Segmentations.h>
 #include <algorithms/geo.h>
 #include <algorithms/random.h>
+#include <algorithms/interfaces/RandomStreamSvc.h>
+#include <algorithms/interfaces/TaskPoolSvc.h>
 #include <algorithms/service.h>
 #include <catch2/generators/catch_generators_random.hpp>
 #include <catch2/interfaces/catch_interfaces_reporter.hpp>
 #include <catch2/reporters/catch_reporter_event_listener.hpp>
 #include <catch2/reporters/catch_reporter_registrars.hpp>
 #include <services/evaluator/EvaluatorSvc.h>
+#include <services/geometry/cellgeo/CellGeoSvc.h>
 #include <services/pid_lut/PIDLookupTableSvc.h>
 #include <stddef.h>
 #include <cstdint>
@@ -58,9 +61,23 @@ public:
       r.init();
     });
 
+    [[maybe_unused]] auto& randomStreamSvc = algorithms::RandomStreamSvc::instance();
+    serviceSvc.setInit<algorithms::RandomStreamSvc>([seed](auto&& r) {
+      r.init(seed);
+    });
+
+    // a few threads, so that tests of algorithms splitting events into tasks run them concurrently
+    [[maybe_unused]] auto& taskPoolSvc = algorithms::TaskPoolSvc::instance();
+    serviceSvc.setInit<algorithms::TaskPoolSvc>([](auto&& p) {
+      p.init(3);
+    });
+
     auto& evaluatorSvc = eicrecon::EvaluatorSvc::instance();
     serviceSvc.add<eicrecon::EvaluatorSvc>(&evaluatorSvc);
 
+    auto& cellGeoSvc = eicrecon::CellGeoSvc::instance();
+    serviceSvc.add<eicrecon::CellGeoSvc>(&cellGeoSvc);
+
     auto& lutSvc = eicrecon::PIDLookupTableSvc::instance();
     serviceSvc.add<eicrecon::PIDLookupTableSvc>(&lutSvc);
 
@@ -225,4 +225,57 @@ TEST_CASE( "the clustering algorithm runs", "[CalorimeterIslandCluster]" ) {
       REQUIRE( (*protoclust_coll)[0].weights_size() == 3 );
     }
   }
+
+  SECTION( "on cells across the phi boundary" ) {
+    cfg.splitCluster = false;
+    cfg.globalDistEtaPhi = {0.1, 0.01 * dd4hep::rad};
+    algo.applyConfig(cfg);
+    algo.init();
+
+    edm4eic::CalorimeterHitCollection hits_coll;
+    hits_coll.create(
+      0, // std::uint64_t cellID,
+      5.0, // float energy,
+      0.0, // float energyError,
+      0.0, // float time,
+      0.0, // float timeError,
+      edm4hep::Vector3f(-100.0 /* mm */, 0.05 /* mm */, 0.0), // edm4hep::Vector3f position,
+      edm4hep::Vector3f(1.0, 1.0, 0.0), // edm4hep::Vector3f dimension,
+      0, // std::int32_t sector,
+      0, // std::int32_t layer,
+      edm4hep::Vector3f(0.0, 0.0, 0.0) // edm4hep::Vector3f local
+    );
+    hits_coll.create(
+      1, // std::uint64_t cellID,
+      6.0, // float energy,
+      0.0, // float energyError,
+      0.0, // float time,
+      0.0, // float timeError,
+      edm4hep::Vector3f(100.0 /* mm */, 0.0, 0.0), // edm4hep::Vector3f position,
+      edm4hep::Vector3f(1.0, 1.0, 0.0), // edm4hep::Vector3f dimension,
+      0, // std::int32_t sector,
+      0, // std::int32_t layer,
+      edm4hep::Vector3f(0.0, 0.0, 0.0) // edm4hep::Vector3f local
+    );
+    hits_coll.create(
+      2, // std::uint64_t cellID,
+      4.0, // float energy,
+      0.0, // float energyError,
+      0.0, // float time,
+      0.0, // float timeError,
+      edm4hep::Vector3f(-100.0 /* mm */, -0.05 /* mm */, 0.0), // edm4hep::Vector3f position,
+      edm4hep::Vector3f(1.0, 1.0, 0.0), // edm4hep::Vector3f dimension,
+      0, // std::int32_t sector,
+      0, // std::int32_t layer,
+      edm4hep::Vector3f(0.0, 0.0, 0.0) // edm4hep::Vector3f local
+    );
+    auto protoclust_coll = std::make_unique<edm4eic::ProtoClusterCollection>();
+    algo.process({&hits_coll}, {protoclust_coll.get()});
+
+    REQUIRE( (*protoclust_coll).size() == 2 );
+    REQUIRE( (*protoclust_coll)[0].hits_size() == 2 );
+    REQUIRE( (*protoclust_coll)[0].getHits()[0].getCellID() == 0 );
+    REQUIRE( (*protoclust_coll)[0].getHits()[1].getCellID() == 2 );
+    REQUIRE( (*protoclust_coll)[1].hits_size() == 1 );
+  }
 }
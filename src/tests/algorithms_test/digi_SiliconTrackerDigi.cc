@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#include <DD4hep/DD4hepUnits.h>
+#include <algorithms/logger.h>
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/EDM4eicVersion.h>
+#include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
+#include <edm4eic/RawTrackerHitCollection.h>
+#include <edm4hep/MCParticleCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+#include <spdlog/common.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "algorithms/digi/SiliconTrackerDigi.h"
+#include "algorithms/digi/SiliconTrackerDigiConfig.h"
+
+TEST_CASE("the SiliconTrackerDigi algorithm merges hits per cell", "[SiliconTrackerDigi]") {
+  eicrecon::SiliconTrackerDigi algo("SiliconTrackerDigi");
+
+  eicrecon::SiliconTrackerDigiConfig cfg;
+  cfg.threshold      = 1 * dd4hep::keV;
+  cfg.timeResolution = 0;
+
+  algo.level(algorithms::LogLevel(spdlog::level::trace));
+  algo.applyConfig(cfg);
+  algo.init();
+
+  edm4hep::MCParticleCollection mcparticles;
+  auto mcparticle = mcparticles.create();
+
+  struct SimHit {
+    std::uint64_t cellID;
+    double edep;
+    double time;
+  };
+  const std::vector<SimHit> inputs{
+      {1, 2 * dd4hep::keV, 3.},
+      {2, 0.5 * dd4hep::keV, 1.},
+      {1, 0.5 * dd4hep::keV, 1.},
+      {3, 3 * dd4hep::keV, 2.},
+      {1, 2 * dd4hep::keV, 2.},
+  };
+  auto sim_hits = std::make_unique<edm4hep::SimTrackerHitCollection>();
+  for (const auto& input : inputs) {
+    auto sim_hit = sim_hits->create();
+    sim_hit.setCellID(input.cellID);
+    sim_hit.setEDep(input.edep);
+    sim_hit.setTime(input.time);
+    sim_hit.setMCParticle(mcparticle);
+  }
+
+  auto raw_hits     = std::make_unique<edm4eic::RawTrackerHitCollection>();
+  auto associations = std::make_unique<edm4eic::MCRecoTrackerHitAssociationCollection>();
+  algo.process({sim_hits.get()}, {raw_hits.get(), associations.get()});
+
+  // Raw hits are ordered by the first sim hit above threshold in each cell
+  REQUIRE(raw_hits->size() == 2);
+  REQUIRE((*raw_hits)[0].getCellID() == 1);
+  REQUIRE((*raw_hits)[0].getCharge() == 4);
+  REQUIRE((*raw_hits)[0].getTimeStamp() == 2000);
+  REQUIRE((*raw_hits)[1].getCellID() == 3);
+  REQUIRE((*raw_hits)[1].getCharge() == 3);
+
+  // All sim hits in the cells with a raw hit are associated, in input order
+  const std::vector<std::size_t> expected_sim_hits{0, 2, 4, 3};
+  REQUIRE(associations->size() == expected_sim_hits.size());
+  for (std::size_t i = 0; i < expected_sim_hits.size(); i++) {
+    const auto& assoc = (*associations)[i];
+    CHECK(assoc.getRawHit().getCellID() == inputs[expected_sim_hits[i]].cellID);
+#if EDM4EIC_VERSION_MAJOR >= 6
+    CHECK(assoc.getSimHit() == (*sim_hits)[expected_sim_hits[i]]);
+#else
+    CHECK(assoc.getSimHits(0) == (*sim_hits)[expected_sim_hits[i]]);
+#endif
+  }
+
+  SECTION("scratch space is reset between events") {
+    auto raw_hits2     = std::make_unique<edm4eic::RawTrackerHitCollection>();
+    auto associations2 = std::make_unique<edm4eic::MCRecoTrackerHitAssociationCollection>();
+    algo.process({sim_hits.get()}, {raw_hits2.get(), associations2.get()});
+    REQUIRE(raw_hits2->size() == raw_hits->size());
+    REQUIRE(associations2->size() == associations->size());
+    REQUIRE((*raw_hits2)[0].getCharge() == 4);
+  }
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Simon Gardner
+
+#include <algorithms/logger.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/TrackerHitCollection.h>
+#include <edm4hep/Vector3d.h>
+#include <gsl/pointers>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "algorithms/fardetectors/FarDetectorLinearTracking.h"
+#include "algorithms/fardetectors/FarDetectorLinearTrackingConfig.h"
+
+TEST_CASE("the linear tracking algorithm finds straight tracks", "[FarDetectorLinearTracking]") {
+  eicrecon::FarDetectorLinearTracking algo("FarDetectorLinearTracking");
+
+  eicrecon::FarDetectorLinearTrackingConfig cfg;
+  cfg.n_layer            = 4;
+  cfg.chi2_max           = 0.001;
+  cfg.restrict_direction = true;
+  cfg.optimum_theta      = M_PI - 0.026;
+  cfg.optimum_phi        = 0;
+
+  algo.applyConfig(cfg);
+  algo.level(algorithms::LogLevel::kTrace);
+  algo.init();
+
+  // Layers are planes of constant z, ordered along the track direction
+  const std::vector<double> layer_z{0., -10., -20., -30.};
+  std::vector<edm4hep::TrackerHitCollection> layers(layer_z.size());
+
+  // Straight tracks at the optimum angle, starting from different points
+  const double slope = std::tan(0.026);
+  const std::vector<std::pair<double, double>> track_origins{{0., 0.}, {5., -3.}};
+  for (const auto& [x0, y0] : track_origins) {
+    for (std::size_t layer = 0; layer < layer_z.size(); layer++) {
+      auto hit = layers[layer].create();
+      hit.setPosition(edm4hep::Vector3d(x0 - slope * layer_z[layer], y0, layer_z[layer]));
+    }
+  }
+
+  SECTION("isolated tracks") {
+    std::vector<gsl::not_null<const edm4hep::TrackerHitCollection*>> inputs;
+    for (const auto& layer : layers) {
+      inputs.emplace_back(&layer);
+    }
+    edm4eic::TrackSegmentCollection tracks;
+    algo.process({inputs}, {&tracks});
+
+    REQUIRE(tracks.size() == track_origins.size());
+    for (const auto& track : tracks) {
+      REQUIRE(track.points_size() == 1);
+      CHECK_THAT(track.getPoints(0).theta, Catch::Matchers::WithinAbs(M_PI - 0.026, 1e-4));
+    }
+  }
+
+  SECTION("with hits away from the tracks") {
+    for (std::size_t layer = 0; layer < layer_z.size(); layer++) {
+      auto hit = layers[layer].create();
+      hit.setPosition(edm4hep::Vector3d(-5. + layer, 5., layer_z[layer]));
+    }
+    std::vector<gsl::not_null<const edm4hep::TrackerHitCollection*>> inputs;
+    for (const auto& layer : layers) {
+      inputs.emplace_back(&layer);
+    }
+    edm4eic::TrackSegmentCollection tracks;
+    algo.process({inputs}, {&tracks});
+
+    REQUIRE(tracks.size() == track_origins.size());
+  }
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Simon Gardner
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <string>
+
+#include "algorithms/fardetectors/TMVADenseNetwork.h"
+
+using eicrecon::TMVADenseNetwork;
+
+TEST_CASE( "dense networks from TMVA weight files are evaluated", "[TMVADenseNetwork]" ) {
+  char filename[] = "/tmp/tmva_weights_XXXXXX";
+  int fd = mkstemp(filename);
+  REQUIRE(fd >= 0);
+  close(fd);
+  {
+    // Layout of a weight file written by the TMVA DL method
+    std::ofstream xml(filename);
+    xml << R"(<?xml version="1.0"?>
+<MethodSetup Method="DL::DNN_CPU">
+  <Variables NVar="2">
+    <Variable VarIndex="0" Expression="a" Label="a" Type="F" Min="0" Max="4"/>
+    <Variable VarIndex="1" Expression="b" Label="b" Type="F" Min="-1" Max="1"/>
+  </Variables>
+  <Targets NTrgt="1">
+    <Target TargetIndex="0" Expression="t" Label="t" Type="F" Min="10" Max="20"/>
+  </Targets>
+  <Transformations NTransformations="1">
+    <Transform Name="Normalize">
+      <Selection>
+        <Input NInputs="3">
+          <Input Type="Variable" Label="a" Expression="a"/>
+          <Input Type="Variable" Label="b" Expression="b"/>
+          <Input Type="Target" Label="t" Expression="t"/>
+        </Input>
+      </Selection>
+      <Class ClassIndex="0">
+        <Ranges>
+          <Range Index="0" Min="0" Max="4"/>
+          <Range Index="1" Min="-1" Max="1"/>
+          <Range Index="2" Min="10" Max="20"/>
+        </Ranges>
+      </Class>
+    </Transform>
+  </Transformations>
+  <Weights NetDepth="2" InputWidth="2" OutputFunction="I">
+    <DenseLayer Width="3" ActivationFunction="3">
+      <Weights Rows="3" Columns="2">1.0e+00  2.0e+00  -1.0e+00  5.0e-01  2.5e-01  0.0e+00  </Weights>
+      <Biases Rows="3" Columns="1">1.0e-01  -2.0e-01  3.0e-01  </Biases>
+    </DenseLayer>
+    <DenseLayer Width="1" ActivationFunction="0">
+      <Weights Rows="1" Columns="3">5.0e-01  -1.0e+00  2.0e+00  </Weights>
+      <Biases Rows="1" Columns="1">5.0e-02  </Biases>
+    </DenseLayer>
+  </Weights>
+</MethodSetup>
+)";
+  }
+
+  auto network = TMVADenseNetwork::load(filename);
+  REQUIRE( network->variables() == std::vector<std::string>{"a", "b"} );
+  REQUIRE( network->targets() == std::vector<std::string>{"t"} );
+
+  SECTION( "networks are shared" ) {
+    REQUIRE( TMVADenseNetwork::load(filename) == network );
+  }
+
+  SECTION( "rows are evaluated independently" ) {
+    TMVADenseNetwork::Matrix inputs(2, 2);
+    inputs << 1., 0.5,
+              3., -0.2;
+    auto outputs = network->evaluate(inputs);
+    REQUIRE( outputs.rows() == 2 );
+    REQUIRE( outputs.cols() == 1 );
+    for (int row = 0; row < inputs.rows(); row++) {
+      // normalized to [-1, 1] by the variable ranges
+      double a = inputs(row, 0) / 2. - 1.;
+      double b = inputs(row, 1);
+      double output = 0.5 * std::tanh(a + 2. * b + 0.1) - std::tanh(-a + 0.5 * b - 0.2)
+                      + 2. * std::tanh(0.25 * a + 0.3) + 0.05;
+      REQUIRE( outputs(row, 0) == Catch::Approx((output + 1.) * 5. + 10.) );
+
+      auto single = network->evaluate(inputs.row(row));
+      REQUIRE( single(0, 0) == Catch::Approx(outputs(row, 0)) );
+    }
+  }
+
+  SECTION( "inputs must match the variables" ) {
+    REQUIRE_THROWS_AS( network->evaluate(TMVADenseNetwork::Matrix(1, 3)), std::invalid_argument );
+  }
+
+  std::remove(filename);
+}
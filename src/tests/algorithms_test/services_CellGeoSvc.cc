@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "services/geometry/cellgeo/CellGeoSvc.h"
+
+using eicrecon::CellGeoCache;
+using eicrecon::CellGeoSvc;
+
+namespace {
+
+  std::uint64_t value_of(std::uint64_t cellID) { return cellID * 3 + 1; }
+
+} // namespace
+
+TEST_CASE( "cellID geometry cache computes each cell once", "[CellGeoSvc]" ) {
+  CellGeoCache<std::uint64_t> cache(1 << 20);
+  const std::size_t initial_capacity = cache.capacity();
+  CHECK(initial_capacity == CellGeoCache<std::uint64_t>::kInitialCapacity);
+
+  std::size_t n_computed = 0;
+  auto compute = [&](std::uint64_t cellID) {
+    ++n_computed;
+    return value_of(cellID);
+  };
+  // cellIDs differing only in the high bits, as for different systems
+  std::vector<std::uint64_t> cellIDs;
+  for (std::uint64_t i = 0; i < 10000; ++i) {
+    cellIDs.push_back((i << 32) | 0x2a);
+  }
+
+  for (auto cellID : cellIDs) {
+    REQUIRE(cache.get(cellID, compute) == value_of(cellID));
+  }
+  CHECK(n_computed == cellIDs.size());
+  CHECK(cache.size() == cellIDs.size());
+  // storage grew with the number of cells
+  CHECK(cache.capacity() > initial_capacity);
+  CHECK(cache.capacity() < 4 * cellIDs.size());
+
+  for (auto cellID : cellIDs) {
+    REQUIRE(cache.get(cellID, compute) == value_of(cellID));
+  }
+  CHECK(n_computed == cellIDs.size());
+
+  // the key reserved for empty slots is computed every time
+  cache.get(~static_cast<std::uint64_t>(0), compute);
+  cache.get(~static_cast<std::uint64_t>(0), compute);
+  CHECK(n_computed == cellIDs.size() + 2);
+}
+
+TEST_CASE( "cellID geometry cache stops caching at its maximum capacity", "[CellGeoSvc]" ) {
+  CellGeoCache<std::uint64_t> cache(1 << 12, 1 << 10);
+
+  std::size_t n_computed = 0;
+  auto compute = [&](std::uint64_t cellID) {
+    ++n_computed;
+    return value_of(cellID);
+  };
+  for (std::uint64_t cellID = 0; cellID < 20000; ++cellID) {
+    REQUIRE(cache.get(cellID, compute) == value_of(cellID));
+  }
+  CHECK(cache.capacity() <= (1 << 12));
+  CHECK(cache.size() <= cache.max_size());
+  CHECK(cache.size() > 0);
+
+  // cells that did not fit are still computed correctly
+  n_computed = 0;
+  for (std::uint64_t cellID = 0; cellID < 20000; ++cellID) {
+    REQUIRE(cache.get(cellID, compute) == value_of(cellID));
+  }
+  CHECK(n_computed == 20000 - cache.size());
+}
+
+TEST_CASE( "cellID geometry cache is shared between threads", "[CellGeoSvc]" ) {
+  CellGeoCache<std::uint64_t> cache(1 << 20);
+  constexpr std::uint64_t n_cells = 50000;
+
+  std::atomic<std::size_t> n_wrong{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t]() {
+      for (std::uint64_t i = 0; i < n_cells; ++i) {
+        // threads walk through the cells in different orders
+        const std::uint64_t cellID = (i * (2 * t + 1)) % n_cells;
+        if (cache.get(cellID, value_of) != value_of(cellID)) {
+          ++n_wrong;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  CHECK(n_wrong == 0);
+  CHECK(cache.size() >= n_cells);
+
+  std::size_t n_visited = 0;
+  cache.for_each([&](std::uint64_t cellID, std::uint64_t value) {
+    ++n_visited;
+    CHECK(value == value_of(cellID));
+  });
+  CHECK(n_visited == cache.size());
+}
+
+TEST_CASE( "cellID geometry cache prefill", "[CellGeoSvc]" ) {
+  CellGeoCache<std::uint64_t> cache(1 << 16);
+  CHECK(cache.claim_prefill());
+  CHECK_FALSE(cache.claim_prefill());
+
+  const std::vector<std::uint64_t> cellIDs{1, 2, 3, 4, 5};
+  const std::size_t n_failed = cache.prefill(cellIDs, [](std::uint64_t cellID) {
+    if (cellID == 3) {
+      throw std::runtime_error("unknown cell");
+    }
+    return value_of(cellID);
+  });
+  CHECK(n_failed == 1);
+  CHECK(cache.size() == 4);
+  for (auto cellID : {1, 2, 4, 5}) {
+    CHECK(cache.get(cellID, [](std::uint64_t) -> std::uint64_t { throw std::logic_error("not prefilled"); }) == value_of(cellID));
+  }
+}
+
+TEST_CASE( "cellID geometry caches are distinct per name and configuration", "[CellGeoSvc]" ) {
+  auto& svc = CellGeoSvc::instance();
+
+  auto& a = svc.cache<std::uint64_t>("CellGeoSvcTest/ReadoutA", "configuration");
+  auto& b = svc.cache<std::uint64_t>("CellGeoSvcTest/ReadoutB", "configuration");
+  auto& a_other = svc.cache<std::uint64_t>("CellGeoSvcTest/ReadoutA", "other configuration");
+  CHECK(&a == &svc.cache<std::uint64_t>("CellGeoSvcTest/ReadoutA", "configuration"));
+  CHECK(&a != &b);
+  CHECK(&a != &a_other);
+  CHECK_THROWS_AS(svc.cache<float>("CellGeoSvcTest/ReadoutA", "configuration"), std::runtime_error);
+
+  a.get(1, value_of);
+  CHECK(a.size() == 1);
+  CHECK(b.size() == 0);
+  CHECK(a_other.size() == 0);
+}
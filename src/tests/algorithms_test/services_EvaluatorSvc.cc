@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/IDDescriptor.h>
+#include <DD4hep/Readout.h>
+#include <algorithms/geo.h>
+#include <algorithms/service.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "services/evaluator/EvaluatorSvc.h"
+
+TEST_CASE( "expressions over readout fields are evaluated", "[EvaluatorSvc]" ) {
+  auto& serviceSvc = algorithms::ServiceSvc::instance();
+  auto evaluator = serviceSvc.service<eicrecon::EvaluatorSvc>("EvaluatorSvc");
+
+  auto detector = algorithms::GeoSvc::instance().detector();
+  auto id_desc = detector->readout("MockCalorimeterHits").idSpec();
+
+  std::vector<std::uint64_t> cellIDs{
+    id_desc.encode({{"system", 255}, {"layer", 0}, {"x", 1}, {"y", 2}}),
+    id_desc.encode({{"system", 255}, {"layer", 3}, {"x", 4}, {"y", 5}}),
+  };
+
+  SECTION( "constant" ) {
+    auto func = evaluator->compile("0.0203", id_desc);
+    for (auto cellID : cellIDs) {
+      REQUIRE( func(cellID) == 0.0203 );
+    }
+  }
+
+  SECTION( "fields" ) {
+    auto func = evaluator->compile("(layer == 0) ? x + 10 * y : -x", id_desc);
+    REQUIRE( func(cellIDs[0]) == 21. );
+    REQUIRE( func(cellIDs[1]) == -4. );
+  }
+
+  SECTION( "batch" ) {
+    auto func = evaluator->compile_batch("system + layer", id_desc);
+    std::vector<float> values(cellIDs.size());
+    func(cellIDs, values);
+    REQUIRE( values[0] == 255.f );
+    REQUIRE( values[1] == 258.f );
+
+    std::vector<float> short_values(cellIDs.size() - 1);
+    REQUIRE_THROWS_AS( func(cellIDs, short_values), std::length_error );
+  }
+
+  SECTION( "constant batch" ) {
+    auto func = evaluator->compile_batch("0.0203", id_desc);
+    std::vector<float> values(cellIDs.size() + 1, -1.f);
+    func(cellIDs, values);
+    REQUIRE( values[0] == 0.0203f );
+    REQUIRE( values[1] == 0.0203f );
+    // elements beyond the input are left alone
+    REQUIRE( values[2] == -1.f );
+  }
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "services/geometry/cellgeo/CellGeoSvc.h"
+#include "services/geometry/dd4hep/GeometrySnapshot.h"
+
+using eicrecon::CellGeoSvc;
+using eicrecon::GeometrySnapshot;
+
+namespace {
+
+  struct Record {
+    float position[3];
+    std::uint32_t layer;
+  };
+
+  std::string temporary_directory() {
+    char dirname[] = "/tmp/geometry_snapshot_XXXXXX";
+    REQUIRE(mkdtemp(dirname) != nullptr);
+    return dirname;
+  }
+
+} // namespace
+
+TEST_CASE( "geometry snapshot sections survive a round trip", "[GeometrySnapshot]" ) {
+  const std::string dirname = temporary_directory();
+  const std::string filename = dirname + "/geometry.snapshot";
+
+  REQUIRE(GeometrySnapshot::open(filename, 42) == nullptr);
+
+  GeometrySnapshot::Sections sections;
+  sections["empty"] = {};
+  sections["odd"] = {'a', 'b', 'c'};
+  sections["large"] = std::vector<char>(10000, 'x');
+  GeometrySnapshot::write(filename, 42, sections);
+
+  auto snapshot = GeometrySnapshot::open(filename, 42);
+  REQUIRE(snapshot != nullptr);
+  REQUIRE(snapshot->sections().size() == sections.size());
+  for (const auto& [name, contents] : sections) {
+    const std::string_view section = snapshot->section(name);
+    CHECK(std::string(section) == std::string(contents.begin(), contents.end()));
+    CHECK(reinterpret_cast<std::uintptr_t>(section.data()) % 8 == 0);
+  }
+  CHECK(snapshot->section("missing").empty());
+
+  CHECK_THROWS_AS(GeometrySnapshot::open(filename, 43), std::runtime_error);
+
+  std::filesystem::remove_all(dirname);
+}
+
+TEST_CASE( "geometry snapshot key follows the files referenced by the compact files", "[GeometrySnapshot]" ) {
+  const std::string dirname = temporary_directory();
+  std::filesystem::create_directories(dirname + "/compact");
+  std::filesystem::create_directories(dirname + "/fieldmaps");
+  auto write = [](const std::string& filename, const std::string& contents) {
+    std::ofstream(filename) << contents;
+  };
+  write(dirname + "/epic.xml",
+        "<lccdd><include ref=\"compact/tracking.xml\"/><!-- <include ref=\"compact/old.xml\"/> --></lccdd>");
+  write(dirname + "/compact/tracking.xml",
+        "<lccdd><include ref='../epic.xml'/><fields><field url=\"fieldmaps/solenoid.txt\"/></fields>"
+        "<include ref=\"missing.xml\"/></lccdd>");
+  write(dirname + "/compact/old.xml", "<lccdd/>");
+  write(dirname + "/compact/calorimetry.xml", "<lccdd/>");
+  write(dirname + "/fieldmaps/solenoid.txt", "0 0 1.7");
+
+  // field maps are looked up in DETECTOR_PATH
+  const char* detector_path = std::getenv("DETECTOR_PATH");
+  const std::string saved_detector_path = detector_path != nullptr ? detector_path : "";
+  setenv("DETECTOR_PATH", dirname.c_str(), 1);
+
+  const std::uint64_t key = GeometrySnapshot::key({dirname + "/epic.xml"});
+  CHECK(GeometrySnapshot::key({dirname + "/epic.xml"}) == key);
+
+  SECTION( "files that are not referenced do not change the key" ) {
+    write(dirname + "/compact/calorimetry.xml", "<lccdd><!-- changed --></lccdd>");
+    write(dirname + "/compact/old.xml", "<lccdd><!-- changed --></lccdd>");
+    CHECK(GeometrySnapshot::key({dirname + "/epic.xml"}) == key);
+  }
+
+  SECTION( "included files change the key" ) {
+    write(dirname + "/compact/tracking.xml", "<lccdd><!-- changed --></lccdd>");
+    CHECK(GeometrySnapshot::key({dirname + "/epic.xml"}) != key);
+  }
+
+  SECTION( "field maps change the key" ) {
+    write(dirname + "/fieldmaps/solenoid.txt", "0 0 3.0");
+    CHECK(GeometrySnapshot::key({dirname + "/epic.xml"}) != key);
+  }
+
+  SECTION( "the key does not depend on the installation directory" ) {
+    const std::string other_dirname = temporary_directory();
+    std::filesystem::copy(dirname, other_dirname, std::filesystem::copy_options::recursive);
+    CHECK(GeometrySnapshot::key({other_dirname + "/epic.xml"}) == key);
+    std::filesystem::remove_all(other_dirname);
+  }
+
+  if (detector_path != nullptr) {
+    setenv("DETECTOR_PATH", saved_detector_path.c_str(), 1);
+  } else {
+    unsetenv("DETECTOR_PATH");
+  }
+  std::filesystem::remove_all(dirname);
+}
+
+TEST_CASE( "cellID geometry caches are restored from saved sections", "[CellGeoSvc]" ) {
+  auto& svc = CellGeoSvc::instance();
+
+  auto& cache = svc.cache<Record>("GeometrySnapshotTest", "configuration");
+  for (std::uint64_t cellID = 0; cellID < 100; ++cellID) {
+    cache.get(cellID, [](std::uint64_t id) { return Record{{1.f * id, 2.f * id, 3.f * id}, static_cast<std::uint32_t>(id % 7)}; });
+  }
+
+  auto saved = svc.save();
+  const std::string section = CellGeoSvc::section_name("GeometrySnapshotTest", "configuration");
+  REQUIRE(saved.contains(section));
+  const std::vector<char> data = saved.at(section);
+
+  SECTION( "same configuration" ) {
+    svc.restore({{CellGeoSvc::section_name("GeometrySnapshotTestRestored", "configuration"), std::string_view(data.data(), data.size())}}, nullptr);
+    auto& restored = svc.cache<Record>("GeometrySnapshotTestRestored", "configuration");
+    CHECK(restored.size() == 100);
+    for (std::uint64_t cellID = 0; cellID < 100; ++cellID) {
+      const Record record = restored.get(cellID, [](std::uint64_t) -> Record { throw std::logic_error("not restored"); });
+      CHECK(record.position[2] == 3.f * cellID);
+      CHECK(record.layer == cellID % 7);
+    }
+    // nothing new to save
+    CHECK_FALSE(svc.save().contains(CellGeoSvc::section_name("GeometrySnapshotTestRestored", "configuration")));
+    // restored caches are not prefilled again
+    CHECK_FALSE(restored.claim_prefill());
+  }
+
+  SECTION( "other configuration" ) {
+    // same section name, but records tagged with another configuration
+    svc.restore({{CellGeoSvc::section_name("GeometrySnapshotTestOther", "other configuration"), std::string_view(data.data(), data.size())}}, nullptr);
+    auto& restored = svc.cache<Record>("GeometrySnapshotTestOther", "other configuration");
+    CHECK(restored.size() == 0);
+    CHECK(restored.claim_prefill());
+  }
+
+  svc.restore({}, nullptr);
+}
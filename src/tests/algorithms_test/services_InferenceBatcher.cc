@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "services/onnx/InferenceBatcher.h"
+
+using eicrecon::InferenceBatcher;
+using namespace std::chrono_literals;
+
+namespace {
+
+  /// Stands in for a model with two features in and two out, recording the batch sizes
+  struct MockModel {
+    std::vector<float> operator()(std::vector<float>& rows, std::size_t n_rows) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch_sizes.push_back(n_rows);
+      }
+      std::vector<float> outputs;
+      for (std::size_t i = 0; i < n_rows; i++) {
+        outputs.push_back(rows[2 * i] + rows[2 * i + 1]);
+        outputs.push_back(rows[2 * i] * 2);
+      }
+      return outputs;
+    }
+
+    std::vector<std::size_t> sizes() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return batch_sizes;
+    }
+
+    std::mutex mutex;
+    std::vector<std::size_t> batch_sizes;
+  };
+
+} // namespace
+
+TEST_CASE( "batched inference returns each row's output to its caller", "[InferenceBatcher]" ) {
+  MockModel model;
+  InferenceBatcher batcher(std::ref(model), 2, {.max_batch_size = 8, .max_latency = 0us});
+  REQUIRE(batcher.batched());
+
+  constexpr int n_threads = 6;
+  constexpr int n_rows = 200;
+  std::vector<int> n_wrong(n_threads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < n_rows; ++i) {
+        const float x = t * 1000 + i;
+        const auto output = batcher.submit({x, 1.f}).get();
+        if (output != std::vector<float>{x + 1.f, 2 * x}) {
+          ++n_wrong[t];
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < n_threads; ++t) {
+    CHECK(n_wrong[t] == 0);
+  }
+
+  std::size_t n_evaluated = 0;
+  for (std::size_t size : model.sizes()) {
+    CHECK(size <= 8);
+    n_evaluated += size;
+  }
+  CHECK(n_evaluated == n_threads * n_rows);
+}
+
+TEST_CASE( "rows submitted while a batch runs form the next batch", "[InferenceBatcher]" ) {
+  MockModel model;
+  std::promise<void> started;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  bool first = true;
+  // the first batch runs until released
+  auto run = [&](std::vector<float>& rows, std::size_t n_rows) {
+    if (first) {
+      first = false;
+      started.set_value();
+      released.wait();
+    }
+    return model(rows, n_rows);
+  };
+  InferenceBatcher batcher(run, 2, {.max_batch_size = 3, .max_latency = 0us});
+
+  auto a = batcher.submit({1.f, 0.f});
+  started.get_future().wait();
+  std::vector<std::future<std::vector<float>>> queued;
+  for (int i = 2; i <= 6; ++i) {
+    queued.push_back(batcher.submit({static_cast<float>(i), 0.f}));
+  }
+  release.set_value();
+
+  CHECK(a.get() == std::vector<float>{1.f, 2.f});
+  for (std::size_t i = 0; i < queued.size(); ++i) {
+    const float x = i + 2;
+    CHECK(queued[i].get() == std::vector<float>{x, 2 * x});
+  }
+  // the queued rows in submission order, split at the maximum batch size
+  CHECK(model.sizes() == std::vector<std::size_t>{1, 3, 2});
+}
+
+TEST_CASE( "batches wait for more rows up to the latency cap", "[InferenceBatcher]" ) {
+  MockModel model;
+
+  SECTION( "a lone row runs after the latency cap" ) {
+    InferenceBatcher batcher(std::ref(model), 2, {.max_batch_size = 4, .max_latency = 50ms});
+    const auto start = std::chrono::steady_clock::now();
+    CHECK(batcher.submit({1.f, 2.f}).get() == std::vector<float>{3.f, 2.f});
+    CHECK(std::chrono::steady_clock::now() - start >= 50ms);
+    CHECK(model.sizes() == std::vector<std::size_t>{1});
+  }
+
+  SECTION( "a full batch runs without waiting for the latency cap" ) {
+    InferenceBatcher batcher(std::ref(model), 2, {.max_batch_size = 4, .max_latency = 100s});
+    std::vector<std::future<std::vector<float>>> results;
+    for (int i = 0; i < 4; ++i) {
+      results.push_back(batcher.submit({static_cast<float>(i), 0.f}));
+    }
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(results[i].wait_for(10s) == std::future_status::ready);
+      CHECK(results[i].get() == std::vector<float>{static_cast<float>(i), 2.f * i});
+    }
+    CHECK(model.sizes() == std::vector<std::size_t>{4});
+  }
+}
+
+TEST_CASE( "unbatched inference runs on submission", "[InferenceBatcher]" ) {
+  MockModel model;
+  InferenceBatcher batcher(std::ref(model), 2, {.max_batch_size = 1, .max_latency = 100s});
+  CHECK_FALSE(batcher.batched());
+
+  auto result = batcher.submit({1.f, 2.f});
+  REQUIRE(result.wait_for(0s) == std::future_status::ready);
+  CHECK(result.get() == std::vector<float>{3.f, 2.f});
+  CHECK_THROWS_AS(batcher.submit({1.f}), std::invalid_argument);
+}
+
+TEST_CASE( "model errors are passed to every row of the batch", "[InferenceBatcher]" ) {
+  InferenceBatcher batcher([](std::vector<float>&, std::size_t) -> std::vector<float> {
+    throw std::runtime_error("inference failed");
+  }, 1, {.max_batch_size = 4, .max_latency = 0us});
+  auto a = batcher.submit({1.f});
+  auto b = batcher.submit({2.f});
+  CHECK_THROWS_AS(a.get(), std::runtime_error);
+  CHECK_THROWS_AS(b.get(), std::runtime_error);
+}
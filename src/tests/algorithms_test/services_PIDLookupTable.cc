@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "services/pid_lut/PIDLookupTable.h"
+#include "services/pid_lut/PIDLookupTableSvc.h"
+
+using eicrecon::PIDLookupTable;
+using eicrecon::PIDLookupTableSvc;
+
+TEST_CASE( "binary lookup tables reproduce text lookup tables", "[PIDLookupTable]" ) {
+  PIDLookupTable::Binning binning {
+    .pdg_values={11, 211},
+    .charge_values={1},
+    .momentum_edges={0., 1., 2.},
+    .polar_edges={0., 90., 180.},
+    .azimuthal_binning={0., 360., 180.}, // lower, upper, step
+    .azimuthal_bin_centers_in_lut=false,
+    .momentum_bin_centers_in_lut=false,
+    .polar_bin_centers_in_lut=false,
+    .use_radians=false,
+    .missing_electron_prob=false,
+  };
+
+  char text_filename[] = "/tmp/pid_lut_XXXXXX";
+  int fd = mkstemp(text_filename);
+  REQUIRE(fd >= 0);
+  close(fd);
+  const std::string binary_filename = std::string(text_filename) + ".bin";
+  {
+    std::ofstream text(text_filename);
+    text << "# pdg charge momentum theta phi prob_electron prob_pion prob_kaon prob_proton\n";
+    for (int pdg : binning.pdg_values) {
+      for (double momentum : {0., 1.}) {
+        for (double theta : {0., 90.}) {
+          for (double phi : {0., 180.}) {
+            text << pdg << " 1 " << momentum << " " << theta << " " << phi << " "
+                 << 0.1 * momentum << " " << theta / 1000. << " " << phi / 1000. << " " << pdg / 1000. << "\n";
+          }
+        }
+      }
+    }
+  }
+
+  PIDLookupTable text_lut;
+  text_lut.load_file(text_filename, binning);
+  text_lut.write_binary(binary_filename, binning);
+
+  PIDLookupTable binary_lut;
+  REQUIRE(binary_lut.load_binary(binary_filename, binning));
+
+  SECTION( "entries agree" ) {
+    for (int pdg : {-211, -11, 11, 211}) {
+      for (double momentum : {0.5, 1.5}) {
+        for (double theta : {45., 135.}) {
+          for (double phi : {90., 270.}) {
+            const auto* text_entry = text_lut.Lookup(pdg, 1, momentum, theta, phi);
+            const auto* binary_entry = binary_lut.Lookup(pdg, 1, momentum, theta, phi);
+            CHECK(text_entry->prob_electron == binary_entry->prob_electron);
+            CHECK(text_entry->prob_pion == binary_entry->prob_pion);
+            CHECK(text_entry->prob_kaon == binary_entry->prob_kaon);
+            CHECK(text_entry->prob_proton == binary_entry->prob_proton);
+            CHECK(binary_entry->prob_proton == Catch::Approx(std::abs(pdg) / 1000.));
+            CHECK(binary_entry->prob_kaon == Catch::Approx(phi > 180. ? 0.18 : 0.));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION( "out of range lookups give zero probabilities" ) {
+    for (const auto* entry : {
+      binary_lut.Lookup(2212, 1, 0.5, 45., 90.),
+      binary_lut.Lookup(11, 1, 2.5, 45., 90.),
+      text_lut.Lookup(11, 1, -1., 45., 90.),
+    }) {
+      CHECK(entry->prob_electron == 0.f);
+      CHECK(entry->prob_pion == 0.f);
+      CHECK(entry->prob_kaon == 0.f);
+      CHECK(entry->prob_proton == 0.f);
+    }
+  }
+
+  SECTION( "binary tables are rejected for a different binning" ) {
+    auto other_binning = binning;
+    other_binning.momentum_edges = {0., 1., 3.};
+    PIDLookupTable other_lut;
+    CHECK_FALSE(other_lut.load_binary(binary_filename, other_binning));
+    CHECK_FALSE(other_lut.load_binary(text_filename, binning));
+  }
+
+  std::remove(text_filename);
+  std::remove(binary_filename.c_str());
+}
+
+TEST_CASE( "binary copies of text lookup tables are only written to the cache directory", "[PIDLookupTable]" ) {
+  PIDLookupTable::Binning binning {
+    .pdg_values={11},
+    .charge_values={1},
+    .momentum_edges={0., 1.},
+    .polar_edges={0., 180.},
+    .azimuthal_binning={0., 360., 360.}, // lower, upper, step
+    .azimuthal_bin_centers_in_lut=false,
+    .momentum_bin_centers_in_lut=false,
+    .polar_bin_centers_in_lut=false,
+    .use_radians=false,
+    .missing_electron_prob=false,
+  };
+
+  char dirname[] = "/tmp/pid_lut_dir_XXXXXX";
+  REQUIRE(mkdtemp(dirname) != nullptr);
+  const std::filesystem::path dir(dirname);
+  const std::filesystem::path cache_dir = dir / "cache";
+  for (const char* name : {"lut_a.txt", "lut_b.txt"}) {
+    std::ofstream text(dir / name);
+    text << "11 1 0 0 0 0.1 0.2 0.3 0.4\n";
+  }
+
+  auto& svc = PIDLookupTableSvc::instance();
+
+  // no cache directory: the text is parsed and nothing is written
+  svc.init();
+  CHECK(svc.binary_cache_filename((dir / "lut_a.txt").string()).empty());
+  REQUIRE(svc.load((dir / "lut_a.txt").string(), binning) != nullptr);
+  CHECK(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator{}) == 2);
+
+  svc.init(cache_dir.string());
+  const std::string binary_filename = svc.binary_cache_filename((dir / "lut_b.txt").string());
+  CHECK(std::filesystem::path(binary_filename).parent_path() == cache_dir);
+  const auto* lut = svc.load((dir / "lut_b.txt").string(), binning);
+  REQUIRE(lut != nullptr);
+  CHECK_FALSE(std::filesystem::exists(dir / "lut_b.txt.bin"));
+  REQUIRE(std::filesystem::exists(binary_filename));
+
+  PIDLookupTable binary_lut;
+  REQUIRE(binary_lut.load_binary(binary_filename, binning));
+  CHECK(binary_lut.Lookup(11, 1, 0.5, 90., 180.)->prob_proton == lut->Lookup(11, 1, 0.5, 90., 180.)->prob_proton);
+
+  svc.init();
+  std::filesystem::remove_all(dir);
+}
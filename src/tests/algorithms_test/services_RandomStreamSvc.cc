@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "algorithms/interfaces/RandomStreamSvc.h"
+
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE( "Philox4x32-10 reproduces the known answers", "[RandomStreamSvc]" ) {
+  // Known-answer tests of the Random123 reference implementation
+  REQUIRE( algorithms::philox4x32({0, 0, 0, 0}, {0, 0})
+           == std::array<std::uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8} );
+  REQUIRE( algorithms::philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff})
+           == std::array<std::uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd} );
+}
+
+TEST_CASE( "random streams depend only on their keys", "[RandomStreamSvc]" ) {
+  const auto& svc = algorithms::RandomStreamSvc::instance();
+  const std::uint64_t key = algorithms::RandomStreamSvc::key("test");
+
+  auto draw = [&](std::uint64_t run, std::uint64_t event, std::uint64_t id) {
+    algorithms::RandomStreamSvc::EventScope scope(run, event);
+    auto rng = svc.stream(key, id);
+    return std::array<double, 3>{rng.uniform(), rng.gaussian(), rng.gaussian()};
+  };
+
+  SECTION( "same keys give the same numbers, on any thread" ) {
+    auto reference = draw(1, 2, 3);
+    std::vector<std::array<double, 3>> results(4);
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+      threads.emplace_back([&result, &draw] { result = draw(1, 2, 3); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& result : results) {
+      REQUIRE( result == reference );
+    }
+  }
+
+  SECTION( "different keys give different numbers" ) {
+    auto reference = draw(1, 2, 3);
+    REQUIRE( draw(1, 2, 4) != reference );
+    REQUIRE( draw(1, 3, 3) != reference );
+    REQUIRE( draw(2, 2, 3) != reference );
+    REQUIRE( algorithms::RandomStreamSvc::key("test", 1) != key );
+  }
+
+  SECTION( "event scopes nest" ) {
+    algorithms::RandomStreamSvc::EventScope outer(1, 2);
+    auto before = svc.stream(key, 3).uniform();
+    {
+      algorithms::RandomStreamSvc::EventScope inner(5, 6);
+      REQUIRE( svc.stream(key, 3).uniform() != before );
+    }
+    REQUIRE( svc.stream(key, 3).uniform() == before );
+  }
+}
+
+TEST_CASE( "random stream distributions", "[RandomStreamSvc]" ) {
+  algorithms::RandomStream rng(algorithms::RandomStreamSvc::key("test"), 0);
+  const int n = 100000;
+  double sum_uniform = 0., sum = 0., sum2 = 0.;
+  for (int i = 0; i < n; i++) {
+    double u = rng.uniform();
+    REQUIRE( u >= 0. );
+    REQUIRE( u < 1. );
+    sum_uniform += u;
+    double g = rng.gaussian(1., 2.);
+    sum += g;
+    sum2 += g * g;
+  }
+  REQUIRE_THAT( sum_uniform / n, WithinAbs(0.5, 0.01) );
+  REQUIRE_THAT( sum / n, WithinAbs(1., 0.03) );
+  REQUIRE_THAT( sum2 / n - (sum / n) * (sum / n), WithinAbs(4., 0.1) );
+}
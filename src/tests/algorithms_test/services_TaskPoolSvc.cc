@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "algorithms/interfaces/TaskPoolSvc.h"
+
+TEST_CASE( "task pool runs every task once on a bounded set of threads", "[TaskPoolSvc]" ) {
+  auto& pool = algorithms::TaskPoolSvc::instance();
+  pool.init(3);
+  REQUIRE(pool.size() == 3);
+
+  constexpr std::size_t n_events = 4;
+  constexpr std::size_t n_tasks = 250;
+
+  for (std::size_t max_threads : {0, 1, 2}) {
+    std::vector<std::atomic<int>> calls(n_events * n_tasks);
+    std::atomic<std::size_t> max_active{0};
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+
+    // several events submitting at once, as from JANA threads
+    std::vector<std::thread> events;
+    for (std::size_t ievent = 0; ievent < n_events; ++ievent) {
+      events.emplace_back([&, ievent]() {
+        std::atomic<std::size_t> active{0};
+        pool.parallel_for(n_tasks, max_threads, [&](std::size_t i) {
+          const std::size_t n = ++active;
+          std::size_t expected = max_active.load();
+          while (n > expected && !max_active.compare_exchange_weak(expected, n)) {}
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            thread_ids.insert(std::this_thread::get_id());
+          }
+          calls[ievent * n_tasks + i] += 1;
+          std::this_thread::yield();
+          --active;
+        });
+      });
+    }
+    for (auto& event : events) {
+      event.join();
+    }
+
+    CHECK(std::all_of(calls.begin(), calls.end(), [](const auto& c) { return c.load() == 1; }));
+    // the submitting threads and the threads of the pool
+    CHECK(thread_ids.size() <= n_events + pool.size());
+    if (max_threads > 0) {
+      CHECK(max_active <= max_threads);
+    }
+  }
+}
+
+TEST_CASE( "task pool rethrows exceptions of tasks", "[TaskPoolSvc]" ) {
+  auto& pool = algorithms::TaskPoolSvc::instance();
+  pool.init(3);
+
+  std::atomic<std::size_t> n_calls{0};
+  CHECK_THROWS_AS(pool.parallel_for(100, 0, [&](std::size_t i) {
+    ++n_calls;
+    if (i == 42) {
+      throw std::runtime_error("task failed");
+    }
+  }), std::runtime_error);
+  // the other tasks still ran
+  CHECK(n_calls == 100);
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Wouter Deconinck, Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "services/io/podio/WriteQueue.h"
+
+using eicrecon::WriteQueue;
+using namespace std::chrono_literals;
+
+namespace {
+
+  /// Stands in for the output file, recording the event numbers in the order they are written
+  struct MockOutput {
+    void operator()(std::unique_ptr<std::uint64_t>& item) {
+      std::lock_guard<std::mutex> lock(mutex);
+      written.push_back(*item);
+    }
+
+    std::vector<std::uint64_t> numbers() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return written;
+    }
+
+    std::mutex mutex;
+    std::vector<std::uint64_t> written;
+  };
+
+  void push(WriteQueue<std::unique_ptr<std::uint64_t>>& queue, std::uint64_t number) {
+    queue.push(number, std::make_unique<std::uint64_t>(number));
+  }
+
+} // namespace
+
+TEST_CASE( "ordered output is written by event number", "[WriteQueue]" ) {
+  MockOutput output;
+  WriteQueue<std::unique_ptr<std::uint64_t>> queue(std::ref(output), {.max_size = 4, .ordered = true});
+
+  // Events are held back until the queue is full, then the lowest number goes first
+  for (std::uint64_t number : {3, 1, 4, 2}) {
+    push(queue, number);
+  }
+  for (std::uint64_t number : {6, 5, 8, 7}) {
+    push(queue, number);
+  }
+  queue.finish();
+
+  REQUIRE(output.numbers() == std::vector<std::uint64_t>{1, 2, 3, 4, 5, 6, 7, 8});
+  const auto stats = queue.stats();
+  REQUIRE(stats.written == 8);
+  REQUIRE(stats.max_depth == 4);
+}
+
+TEST_CASE( "unordered output is written in the order events finish", "[WriteQueue]" ) {
+  MockOutput output;
+  WriteQueue<std::unique_ptr<std::uint64_t>> queue(std::ref(output), {.max_size = 2, .ordered = false});
+
+  for (std::uint64_t number : {3, 1, 4, 2, 5}) {
+    push(queue, number);
+  }
+  queue.finish();
+
+  REQUIRE(output.numbers() == std::vector<std::uint64_t>{3, 1, 4, 2, 5});
+}
+
+TEST_CASE( "finish writes all queued events before stopping", "[WriteQueue]" ) {
+
+  SECTION( "ordered events below the queue size" ) {
+    MockOutput output;
+    WriteQueue<std::unique_ptr<std::uint64_t>> queue(std::ref(output), {.max_size = 16, .ordered = true});
+    for (std::uint64_t number : {3, 1, 2}) {
+      push(queue, number);
+    }
+    std::this_thread::sleep_for(10ms);
+    REQUIRE(output.numbers().empty());
+
+    queue.finish();
+    REQUIRE(output.numbers() == std::vector<std::uint64_t>{1, 2, 3});
+  }
+
+  SECTION( "slow writer with producers blocked on a full queue" ) {
+    MockOutput output;
+    auto slow = [&output](std::unique_ptr<std::uint64_t>& item) {
+      std::this_thread::sleep_for(1ms);
+      output(item);
+    };
+    WriteQueue<std::unique_ptr<std::uint64_t>> queue(slow, {.max_size = 2, .ordered = false});
+
+    constexpr int n_threads = 3;
+    constexpr int n_events = 20;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < n_events; ++i) {
+          push(queue, t * n_events + i);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    queue.finish();
+
+    auto numbers = output.numbers();
+    std::sort(numbers.begin(), numbers.end());
+    REQUIRE(numbers.size() == n_threads * n_events);
+    for (std::size_t i = 0; i < numbers.size(); ++i) {
+      REQUIRE(numbers[i] == i);
+    }
+    const auto stats = queue.stats();
+    REQUIRE(stats.written == n_threads * n_events);
+    REQUIRE(stats.max_depth <= 2);
+    REQUIRE(stats.blocked_pushes > 0);
+  }
+}
+
+TEST_CASE( "write errors are passed to the processing threads", "[WriteQueue]" ) {
+  WriteQueue<std::unique_ptr<std::uint64_t>> queue(
+      [](std::unique_ptr<std::uint64_t>&) { throw std::runtime_error("disk full"); },
+      {.max_size = 1, .ordered = false});
+
+  push(queue, 1);
+  REQUIRE_THROWS_AS(queue.finish(), std::runtime_error);
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Surfaces/PerigeeSurface.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "algorithms/tracking/ActsGeometryProvider.h"
+
+using eicrecon::ActsGeometryProvider;
+
+TEST_CASE( "surface table finds the sensor surface of a cell ID", "[ActsGeometryProvider]" ) {
+  // two systems with different volume ID bits, the system ID is in the lowest byte
+  constexpr std::uint64_t system_a = 0x21;
+  constexpr std::uint64_t system_b = 0x42;
+  std::array<std::uint64_t, 256> masks{};
+  masks[system_a] = 0xFFFFFFFF;
+  masks[system_b] = 0xFFFF;
+
+  std::vector<std::shared_ptr<const Acts::Surface>> surfaces;
+  for (int i = 0; i < 3; ++i) {
+    surfaces.push_back(Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3{0., 0., 1. * i}));
+  }
+  const ActsGeometryProvider::VolumeSurfaceMap surface_map{
+    {0x0A00 | system_a, surfaces[0].get()},
+    {0x0B00 | system_a, surfaces[1].get()},
+    {0x0A00 | system_b, surfaces[2].get()},
+  };
+  const ActsGeometryProvider::SurfaceTable table(masks, surface_map);
+  REQUIRE(table.size() == 3);
+
+  SECTION( "cells of known sensors" ) {
+    // segmentation bits above the volume ID bits of each system
+    CHECK(table.volumeID(0x1234'0000'0A00 | system_a) == (0x0A00 | system_a));
+    CHECK(table.find(0x1234'0000'0A00 | system_a) == surfaces[0].get());
+    CHECK(table.find(0x0000'0000'0B00 | system_a) == surfaces[1].get());
+    CHECK(table.volumeID(0x1234'0000'0A00 | system_b) == (0x0A00 | system_b));
+    CHECK(table.find(0x1234'0000'0A00 | system_b) == surfaces[2].get());
+  }
+
+  SECTION( "cells of unknown systems" ) {
+    constexpr std::uint64_t cellID = 0x1234'0000'0A00 | 0x33;
+    CHECK(table.volumeID(cellID) == 0);
+    CHECK(table.find(cellID) == nullptr);
+    CHECK(table.volumeID(0) == 0);
+    CHECK(table.find(0) == nullptr);
+  }
+
+  SECTION( "cells of a known system that are not in the table" ) {
+    // the volume ID of another sensor of system_a
+    CHECK(table.volumeID(0x0C00 | system_a) == (0x0C00 | system_a));
+    CHECK(table.find(0x0C00 | system_a) == nullptr);
+    // beyond the last volume ID
+    CHECK(table.find(0xFFFF'FF00 | system_a) == nullptr);
+    // volume ID bits of system_a, which system_b does not use
+    CHECK(table.find(0x0001'0A00 | system_b) == surfaces[2].get());
+    CHECK(table.find(0x0001'0A00 | system_a) == nullptr);
+  }
+
+  SECTION( "empty table" ) {
+    const ActsGeometryProvider::SurfaceTable empty;
+    CHECK(empty.size() == 0);
+    CHECK(empty.volumeID(0x0A00 | system_a) == 0);
+    CHECK(empty.find(0x0A00 | system_a) == nullptr);
+  }
+}
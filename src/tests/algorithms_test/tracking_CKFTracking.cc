@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Definitions/TrackParametrization.hpp>
+#include <Acts/EventData/MultiTrajectory.hpp>
+#include <Acts/EventData/TrackProxy.hpp>
+#include <Acts/EventData/TrackStatePropMask.hpp>
+#include <Acts/Surfaces/PerigeeSurface.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <ActsExamples/EventData/Track.hpp>
+#include <ActsExamples/EventData/Trajectories.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <edm4eic/TrackParametersCollection.h>
+#include <spdlog/logger.h>
+#include <spdlog/spdlog.h>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "algorithms/tracking/ActsMeasurements.h"
+#include "algorithms/tracking/CKFTracking.h"
+
+using eicrecon::CKFTracking;
+
+namespace {
+
+/// Stands in for the Acts CKF: a branching trajectory per seed, determined by the seed,
+/// including a state on a branch that no track ends on
+class MockTrackFinder : public CKFTracking::CKFTrackingFunction {
+public:
+  CKFTracking::TrackFinderResult operator()(const ActsExamples::TrackParameters& seed,
+                                            const CKFTracking::TrackFinderOptions&,
+                                            ActsExamples::TrackContainer& tracks) const override {
+    using IndexType = Acts::MultiTrajectoryTraits::IndexType;
+    const double x = seed.parameters()[Acts::eBoundLoc0];
+    const int n_states = 2 + static_cast<int>(x) % 4;
+    const auto mask = Acts::TrackStatePropMask::Predicted | Acts::TrackStatePropMask::Filtered;
+
+    auto& states = tracks.trackStateContainer();
+    auto add_state = [&](IndexType previous, double value) {
+      auto state = states.getTrackState(states.addTrackState(mask, previous));
+      state.predicted() = Acts::BoundVector::Constant(value);
+      state.predictedCovariance() = Acts::BoundSquareMatrix::Identity() * value;
+      state.filtered() = Acts::BoundVector::Constant(-value);
+      state.filteredCovariance() = Acts::BoundSquareMatrix::Identity() * (value + 1);
+      return state.index();
+    };
+    IndexType trunk = Acts::MultiTrajectoryTraits::kInvalid;
+    for (int i = 0; i < n_states; ++i) {
+      trunk = add_state(trunk, x + 0.1 * i);
+    }
+    add_state(trunk, x + 0.5); // dropped branch
+    const IndexType branch = add_state(trunk, x + 0.7);
+
+    std::vector<ActsExamples::TrackContainer::TrackProxy> found;
+    // no tracks for some seeds, as when track finding fails
+    if (static_cast<int>(x) % 5 == 3) {
+      return found;
+    }
+    for (IndexType tip : {trunk, branch}) {
+      auto track = tracks.getTrack(tracks.addTrack());
+      track.tipIndex() = tip;
+      track.setReferenceSurface(m_surface);
+      track.parameters() = Acts::BoundVector::Constant(x + tip);
+      track.covariance() = Acts::BoundSquareMatrix::Identity() * x;
+      found.push_back(track);
+    }
+    return found;
+  }
+
+private:
+  std::shared_ptr<const Acts::Surface> m_surface =
+      Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3{0., 0., 0.});
+};
+
+} // namespace
+
+TEST_CASE( "CKF over seed chunks gives the same tracks as a single pass", "[CKFTracking]" ) {
+  std::shared_ptr<spdlog::logger> logger = spdlog::default_logger()->clone("CKFTracking");
+  auto track_finder = std::make_shared<MockTrackFinder>();
+
+  edm4eic::TrackParametersCollection seeds;
+  for (int i = 0; i < 47; ++i) {
+    auto seed = seeds.create();
+    seed.setLoc({static_cast<float>(i), 0.f});
+    seed.setTheta(1.f);
+    seed.setQOverP(1.f);
+  }
+  const eicrecon::ActsMeasurements measurements;
+
+  auto run = [&](std::size_t seed_chunk_size, std::size_t max_chunk_threads) {
+    CKFTracking ckf;
+    ckf.applyConfig({.seedChunkSize = seed_chunk_size, .maxChunkThreads = max_chunk_threads});
+    ckf.init(track_finder, logger);
+    return ckf.process(measurements, seeds);
+  };
+
+  auto [ref_trajectories, ref_tracks_v] = run(0, 0);
+  const auto& ref_tracks = *ref_tracks_v.front();
+  REQUIRE(ref_tracks.size() > 0);
+
+  // (seed chunk size, maximum threads per event)
+  const std::vector<std::pair<std::size_t, std::size_t>> chunkings{{1, 0}, {5, 0}, {5, 2}, {46, 0}};
+  for (const auto& [seed_chunk_size, max_chunk_threads] : chunkings) {
+    auto [trajectories, tracks_v] = run(seed_chunk_size, max_chunk_threads);
+    const auto& tracks = *tracks_v.front();
+
+    // track states, including those on dropped branches
+    const auto& ref_states = ref_tracks.trackStateContainer();
+    const auto& states = tracks.trackStateContainer();
+    REQUIRE(states.size() == ref_states.size());
+    for (std::size_t i = 0; i < ref_states.size(); ++i) {
+      const auto ref_state = ref_states.getTrackState(i);
+      const auto state = states.getTrackState(i);
+      REQUIRE(state.hasPrevious() == ref_state.hasPrevious());
+      if (ref_state.hasPrevious()) {
+        CHECK(state.previous() == ref_state.previous());
+      }
+      CHECK(state.predicted() == ref_state.predicted());
+      CHECK(state.predictedCovariance() == ref_state.predictedCovariance());
+      CHECK(state.filtered() == ref_state.filtered());
+      CHECK(state.filteredCovariance() == ref_state.filteredCovariance());
+    }
+
+    // tracks, with their seed numbers
+    const Acts::ConstTrackAccessor<unsigned int> seed_number("seed");
+    REQUIRE(tracks.size() == ref_tracks.size());
+    for (std::size_t i = 0; i < ref_tracks.size(); ++i) {
+      const auto ref_track = ref_tracks.getTrack(i);
+      const auto track = tracks.getTrack(i);
+      CHECK(track.tipIndex() == ref_track.tipIndex());
+      CHECK(seed_number(track) == seed_number(ref_track));
+      CHECK(track.parameters() == ref_track.parameters());
+      CHECK(track.covariance() == ref_track.covariance());
+    }
+
+    // trajectories per seed
+    REQUIRE(trajectories.size() == ref_trajectories.size());
+    for (std::size_t i = 0; i < ref_trajectories.size(); ++i) {
+      CHECK(trajectories[i]->tips() == ref_trajectories[i]->tips());
+    }
+
+    for (auto* t : trajectories) delete t;
+    for (auto* t : tracks_v) delete t;
+  }
+
+  for (auto* t : ref_trajectories) delete t;
+  for (auto* t : ref_tracks_v) delete t;
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "algorithms/tracking/HoughSeedFinder.h"
+
+using eicrecon::HoughSeedFinder;
+
+namespace {
+
+HoughSeedFinder::Config make_config() {
+  return {
+    .rMin = 30.,
+    .rMax = 450.,
+    .zMin = -1500.,
+    .zMax = 1700.,
+    .phiBins = 256,
+    .curvatureBins = 64,
+    .curvatureMax = 5e-3, // 1 / mm, pT of about 100 MeV at 1.7 T
+    .cotThetaBins = 500,
+    .cotThetaMax = 27.,
+    .z0Bins = 10,
+    .z0Min = -250.,
+    .z0Max = 250.,
+    .minHits = 4,
+    .deltaRMin = 5.,
+  };
+}
+
+struct SpacePoints {
+  std::vector<float> r;
+  std::vector<float> phi;
+  std::vector<float> z;
+  std::vector<int> track; // -1 for noise
+
+  void add(float x, float y, float z_, int track_) {
+    r.push_back(std::hypot(x, y));
+    phi.push_back(std::atan2(y, x));
+    z.push_back(z_);
+    track.push_back(track_);
+  }
+};
+
+const std::vector<float> layer_radii{36., 48., 120., 270., 420.};
+
+/// Space points of a helix from (0, 0, z0) on each layer it reaches
+void add_track(SpacePoints& sps, int track, float curvature, float phi0, float cotTheta, float z0) {
+  for (float r : layer_radii) {
+    const float s = r * curvature / 2;
+    if (std::abs(s) > 1) {
+      break;
+    }
+    const float phi = phi0 - std::asin(s);
+    const float arc_length = std::abs(s) > 1e-6f ? r * std::asin(s) / s : r;
+    sps.add(r * std::cos(phi), r * std::sin(phi), z0 + arc_length * cotTheta, track);
+  }
+}
+
+} // namespace
+
+TEST_CASE("seeds are found on isolated tracks", "[HoughSeedFinder]") {
+  HoughSeedFinder finder(make_config());
+
+  SpacePoints sps;
+  const std::vector<float> curvatures{-3e-3, -1e-3, 0., 2e-4, 2.5e-3};
+  const std::vector<float> cotThetas{-3., -0.5, 0.1, 1., 3.};
+  for (std::size_t track = 0; track < curvatures.size(); ++track) {
+    add_track(sps, track, curvatures[track], -3. + 1.3 * track, cotThetas[track], -100. + 40. * track);
+  }
+
+  std::vector<HoughSeedFinder::Seed> seeds;
+  finder.find(sps.r, sps.phi, sps.z, seeds);
+
+  std::vector<bool> found(curvatures.size(), false);
+  for (const auto& seed : seeds) {
+    const int track = sps.track[seed.spacePoints[0]];
+    for (std::size_t i : seed.spacePoints) {
+      REQUIRE(sps.track[i] == track);
+    }
+    REQUIRE(sps.r[seed.spacePoints[0]] < sps.r[seed.spacePoints[1]]);
+    REQUIRE(sps.r[seed.spacePoints[1]] < sps.r[seed.spacePoints[2]]);
+    REQUIRE_THAT(seed.z0, Catch::Matchers::WithinAbs(-100. + 40. * track, 5.));
+    REQUIRE_THAT(seed.cotTheta, Catch::Matchers::WithinRel(cotThetas[track], 0.02f));
+    found[track] = true;
+  }
+  for (std::size_t track = 0; track < found.size(); ++track) {
+    INFO("track " << track);
+    CHECK(found[track]);
+  }
+}
+
+TEST_CASE("no seeds are made of too few space points", "[HoughSeedFinder]") {
+  HoughSeedFinder finder(make_config());
+
+  SECTION("tracks not reaching enough layers") {
+    SpacePoints sps;
+    // curls up before the fourth layer
+    add_track(sps, 0, 1e-2, 0., 1., 0.);
+    REQUIRE(sps.r.size() == 3);
+
+    std::vector<HoughSeedFinder::Seed> seeds;
+    finder.find(sps.r, sps.phi, sps.z, seeds);
+    REQUIRE(seeds.empty());
+  }
+
+  SECTION("space points outside of the r and z ranges") {
+    SpacePoints sps;
+    add_track(sps, 0, 1e-3, 0., 10., 0.);
+    for (auto& z : sps.z) {
+      z += 2000.;
+    }
+
+    std::vector<HoughSeedFinder::Seed> seeds;
+    finder.find(sps.r, sps.phi, sps.z, seeds);
+    REQUIRE(seeds.empty());
+  }
+}
+
+TEST_CASE("seeds of tracks curling up at the last layer are finite", "[HoughSeedFinder]") {
+  HoughSeedFinder finder(make_config());
+
+  // reaches r = 420 mm, which is beyond 2 / curvature at the centre of its curvature bin
+  SpacePoints sps;
+  add_track(sps, 0, 0.9995 * 2 / layer_radii.back(), 0.5, 0.5, 10.);
+  REQUIRE(sps.r.size() == layer_radii.size());
+
+  std::vector<HoughSeedFinder::Seed> seeds;
+  finder.find(sps.r, sps.phi, sps.z, seeds);
+  REQUIRE(!seeds.empty());
+  for (const auto& seed : seeds) {
+    CHECK(std::isfinite(seed.z0));
+    CHECK(std::isfinite(seed.cotTheta));
+    CHECK(std::isfinite(seed.curvature));
+    CHECK_THAT(seed.z0, Catch::Matchers::WithinAbs(10., 5.));
+    // including the space point on the last layer
+    CHECK(seed.hits == layer_radii.size());
+  }
+}
+
+TEST_CASE("tracks are found among noise", "[HoughSeedFinder]") {
+  HoughSeedFinder finder(make_config());
+
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<float> uniform(0., 1.);
+  SpacePoints sps;
+  for (int i = 0; i < 200; ++i) {
+    const float r = layer_radii[i % layer_radii.size()];
+    const float phi = 2 * std::numbers::pi_v<float> * uniform(rng);
+    const float z = -1000. + 2000. * uniform(rng);
+    sps.add(r * std::cos(phi), r * std::sin(phi), z, -1);
+  }
+  const int n_tracks = 20;
+  for (int track = 0; track < n_tracks; ++track) {
+    const float curvature = 4e-3 * (uniform(rng) - 0.5);
+    const float phi0 = 2 * std::numbers::pi_v<float> * uniform(rng);
+    const float cotTheta = 4. * (uniform(rng) - 0.5);
+    const float z0 = 200. * (uniform(rng) - 0.5);
+    add_track(sps, track, curvature, phi0, cotTheta, z0);
+  }
+
+  std::vector<HoughSeedFinder::Seed> seeds;
+  finder.find(sps.r, sps.phi, sps.z, seeds);
+
+  std::vector<bool> found(n_tracks, false);
+  for (const auto& seed : seeds) {
+    const int track = sps.track[seed.spacePoints[0]];
+    if (track >= 0 && sps.track[seed.spacePoints[1]] == track && sps.track[seed.spacePoints[2]] == track) {
+      found[track] = true;
+    }
+  }
+  for (int track = 0; track < n_tracks; ++track) {
+    INFO("track " << track);
+    CHECK(found[track]);
+  }
+}
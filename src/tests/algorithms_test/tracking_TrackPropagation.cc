@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024 Dmitry Kalinkin
+
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Definitions/TrackParametrization.hpp>
+#include <Acts/Definitions/Units.hpp>
+#include <Acts/EventData/ParticleHypothesis.hpp>
+#include <Acts/EventData/TrackStatePropMask.hpp>
+#include <Acts/EventData/VectorMultiTrajectory.hpp>
+#include <Acts/MagneticField/ConstantBField.hpp>
+#include <Acts/Surfaces/CylinderSurface.hpp>
+#include <Acts/Surfaces/PerigeeSurface.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <ActsExamples/EventData/Track.hpp>
+#include <ActsExamples/EventData/Trajectories.hpp>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Objects.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <edm4eic/TrackCollection.h>
+#include <edm4eic/TrackSegmentCollection.h>
+#include <edm4hep/utils/vector_utils.h>
+#include <spdlog/logger.h>
+#include <spdlog/spdlog.h>
+#include <cstddef>
+#include <memory>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "algorithms/tracking/TrackPropagation.h"
+#include "algorithms/tracking/TrackPropagationConfig.h"
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+using eicrecon::CylinderSurfaceConfig;
+using eicrecon::TrackPropagation;
+
+TEST_CASE( "chained propagation through the target surfaces matches propagation from the start", "[TrackPropagation]" ) {
+  using namespace Acts::UnitLiterals;
+
+  std::shared_ptr<spdlog::logger> logger = spdlog::default_logger()->clone("TrackPropagation");
+
+  auto detector = dd4hep::Detector::make_unique("");
+  detector->addConstant(dd4hep::Constant("MockTracker_ID", "1"));
+
+  // target surfaces ordered along tracks from the origin
+  const std::vector<double> radii{100., 200., 300., 400.};
+  constexpr double zmin = -1000.;
+  constexpr double zmax = 1000.;
+  eicrecon::TrackPropagationConfig cfg;
+  cfg.filter_surfaces.push_back(CylinderSurfaceConfig{"MockTracker_ID", 50., zmin, zmax});
+  for (double r : radii) {
+    cfg.target_surfaces.push_back(CylinderSurfaceConfig{"MockTracker_ID", r, zmin, zmax});
+  }
+
+  TrackPropagation propagation;
+  propagation.applyConfig(cfg);
+  propagation.init(detector.get(), std::make_shared<Acts::ConstantBField>(Acts::Vector3(0., 0., 1.7_T)), logger);
+
+  // the same surfaces, for propagating to each of them from the start
+  std::vector<std::shared_ptr<const Acts::Surface>> surfaces;
+  for (double r : radii) {
+    surfaces.push_back(Acts::Surface::makeShared<Acts::CylinderSurface>(
+        Acts::Transform3(Acts::Translation3(Acts::Vector3(0, 0, (zmax + zmin) / 2))), r, (zmax - zmin) / 2));
+  }
+
+  // trajectories with a single state and parameters at the origin
+  Acts::VectorMultiTrajectory states;
+  const auto tip = states.addTrackState(Acts::TrackStatePropMask::None);
+  const Acts::ConstVectorMultiTrajectory const_states(std::move(states));
+  auto perigee = Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3(0., 0., 0.));
+
+  std::vector<ActsExamples::Trajectories> trajectories;
+  for (double p : {1., 2.5, 10.}) {
+    for (double charge : {-1., 1.}) {
+      for (double theta : {0.9, std::numbers::pi / 2, 2.2}) {
+        Acts::BoundVector params = Acts::BoundVector::Zero();
+        params(Acts::eBoundPhi) = 0.3 * p;
+        params(Acts::eBoundTheta) = theta;
+        params(Acts::eBoundQOverP) = charge / (p * 1_GeV);
+        const Acts::BoundSquareMatrix cov = Acts::BoundSquareMatrix::Identity() * 1e-4;
+        ActsExamples::Trajectories::IndexedParameters parameters;
+        parameters.emplace(tip, ActsExamples::TrackParameters{perigee, params, cov, Acts::ParticleHypothesis::pion()});
+        trajectories.emplace_back(const_states, std::vector<Acts::MultiTrajectoryTraits::IndexType>{tip}, parameters);
+      }
+    }
+  }
+  std::vector<const ActsExamples::Trajectories*> trajectory_ptrs;
+  for (const auto& trajectory : trajectories) {
+    trajectory_ptrs.push_back(&trajectory);
+  }
+
+  const edm4eic::TrackCollection tracks;
+  edm4eic::TrackSegmentCollection segments;
+  propagation.propagateToSurfaceList({tracks, trajectory_ptrs, {}}, {&segments});
+
+  REQUIRE(segments.size() == trajectories.size());
+  for (std::size_t i = 0; i < trajectories.size(); ++i) {
+    const auto points = segments[i].getPoints();
+    REQUIRE(points.size() == surfaces.size());
+    for (std::size_t j = 0; j < surfaces.size(); ++j) {
+      const auto direct = propagation.propagate(edm4eic::Track{}, &trajectories[i], surfaces[j]);
+      REQUIRE(direct != nullptr);
+      const auto& chained = points[j];
+      CHECK_THAT(chained.position.x, WithinAbs(direct->position.x, 1e-2));
+      CHECK_THAT(chained.position.y, WithinAbs(direct->position.y, 1e-2));
+      CHECK_THAT(chained.position.z, WithinAbs(direct->position.z, 1e-2));
+      CHECK_THAT(edm4hep::utils::magnitude(chained.momentum), WithinRel(edm4hep::utils::magnitude(direct->momentum), 1e-5f));
+      CHECK_THAT(chained.theta, WithinAbs(direct->theta, 1e-4));
+      CHECK_THAT(chained.phi, WithinAbs(direct->phi, 1e-4));
+      // path lengths are summed over the steps from one surface to the next
+      CHECK_THAT(chained.pathlength, WithinAbs(direct->pathlength, 1e-2));
+    }
+  }
+}
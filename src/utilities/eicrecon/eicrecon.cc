@@ -18,7 +18,11 @@ std::vector<std::string> EICRECON_DEFAULT_PLUGINS = {
         "acts",
         "algorithms_init",
         "evaluator",
+        "cellgeo",
         "pid_lut",
+#ifdef USE_ONNX
+        "onnx",
+#endif
         "richgeo",
         "rootfile",
         "beam",
@@ -2,11 +2,23 @@
 // Copyright (C) 2023, Wouter Deconinck
 
 #include <JANA/JEventProcessor.h>
+#include <fmt/core.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
-class JEventProcessorJANATOP : public JEventProcessor
+#include "extensions/jana/FactoryCallObserver.h"
+#include "LatencyHistogram.h"
+#include "MemoryProbe.h"
+
+class JEventProcessorJANATOP : public JEventProcessor, public FactoryCallObserver
 {
   private:
     enum node_type {
@@ -73,6 +85,51 @@ class JEventProcessorJANATOP : public JEventProcessor
         unsigned int Nfrom_factory;
         unsigned int Nfrom_source;
         unsigned int Nfrom_cache;
+        LatencyHistogram latency_us; // wall time of calls that ran the factory, including its callees
+
+        void Merge(const FactoryCallStats &other) {
+            if (type == kDefault) type = other.type;
+            time_waited_on += other.time_waited_on;
+            time_waiting += other.time_waiting;
+            Nfrom_factory += other.Nfrom_factory;
+            Nfrom_source += other.Nfrom_source;
+            Nfrom_cache += other.Nfrom_cache;
+            latency_us.Merge(other.latency_us);
+        }
+    };
+
+    class MemoryStats {
+      public:
+        unsigned int Ncalls = 0;
+        std::int64_t allocated_bytes = 0;
+        std::int64_t max_allocated_bytes = 0;
+        long peak_rss_growth_kb = 0;
+        long max_peak_rss_growth_kb = 0;
+
+        void Fill(std::int64_t call_allocated_bytes, long call_peak_rss_growth_kb) {
+            Ncalls++;
+            allocated_bytes += call_allocated_bytes;
+            max_allocated_bytes = std::max(max_allocated_bytes, call_allocated_bytes);
+            peak_rss_growth_kb += call_peak_rss_growth_kb;
+            max_peak_rss_growth_kb = std::max(max_peak_rss_growth_kb, call_peak_rss_growth_kb);
+        }
+
+        void Merge(const MemoryStats &other) {
+            Ncalls += other.Ncalls;
+            allocated_bytes += other.allocated_bytes;
+            max_allocated_bytes = std::max(max_allocated_bytes, other.max_allocated_bytes);
+            peak_rss_growth_kb += other.peak_rss_growth_kb;
+            max_peak_rss_growth_kb = std::max(max_peak_rss_growth_kb, other.max_peak_rss_growth_kb);
+        }
+    };
+
+    /// Statistics accumulated by one thread, merged in Finish()
+    class ThreadStats {
+      public:
+        std::map<CallLink, CallStats> call_links;
+        std::map<std::string, FactoryCallStats> factory_stats;
+        std::map<std::string, MemoryStats> memory_stats;
+        std::vector<MemoryProbe::Sample> open_calls;
     };
 
   public:
@@ -82,7 +139,17 @@ class JEventProcessorJANATOP : public JEventProcessor
         auto app = japp;
     };
 
-    void Init() override { };
+    void Init() override {
+        auto app = GetApplication();
+        app->SetDefaultParameter("janatop:output", output_basename,
+            "Write per-factory statistics to <basename>.json and <basename>_factories.csv (empty to disable)");
+        app->SetDefaultParameter("janatop:memory", memory_accounting,
+            "Measure bytes allocated and peak RSS growth for each factory call (written to <basename>_memory.csv)");
+        if (memory_accounting) {
+            memory_probe = std::make_unique<MemoryProbe>();
+            FactoryCallObserver::Instance().store(this, std::memory_order_release);
+        }
+    };
 
     void BeginRun(const std::shared_ptr<const JEvent>& event) override { };
 
@@ -90,8 +157,10 @@ class JEventProcessorJANATOP : public JEventProcessor
         // Get the call stack for ths event and add the results to our stats
         auto stack = event->GetJCallGraphRecorder()->GetCallGraph();
 
-        // Lock mutex in case we are running with multiple threads
-        std::lock_guard<std::mutex> lck(mutex);
+        // Accumulate per thread, without locking
+        ThreadStats &thread_stats = GetThreadStats();
+        auto &call_links = thread_stats.call_links;
+        auto &factory_stats = thread_stats.factory_stats;
 
         // Loop over the call stack elements and add in the values
         for (unsigned int i = 0; i < stack.size(); i++) {
@@ -103,7 +172,8 @@ class JEventProcessorJANATOP : public JEventProcessor
             FactoryCallStats &fcallstats1 = factory_stats[nametag1];
             FactoryCallStats &fcallstats2 = factory_stats[nametag2];
 
-            auto delta_t_ms = std::chrono::duration_cast<std::chrono::milliseconds>(stack[i].end_time - stack[i].start_time).count();
+            auto delta_t_us = std::chrono::duration_cast<std::chrono::microseconds>(stack[i].end_time - stack[i].start_time).count();
+            double delta_t_ms = delta_t_us / 1000.0;
             fcallstats1.time_waiting += delta_t_ms;
             fcallstats2.time_waited_on += delta_t_ms;
 
@@ -132,6 +202,7 @@ class JEventProcessorJANATOP : public JEventProcessor
                     break;
                 case JCallGraphRecorder::DATA_FROM_FACTORY:
                     fcallstats2.Nfrom_factory++;
+                    fcallstats2.latency_us.Fill(delta_t_us);
                     stats.Nfrom_factory++;
                     stats.from_factory_ms += delta_t_ms;
                     break;
@@ -141,7 +212,47 @@ class JEventProcessorJANATOP : public JEventProcessor
 
     void EndRun() override { };
 
+    void BeginCall(const std::string& /* prefix */) override {
+        GetThreadStats().open_calls.push_back(memory_probe->Take());
+    }
+
+    void EndCall(const std::string& prefix) override {
+        ThreadStats &thread_stats = GetThreadStats();
+        if (thread_stats.open_calls.empty()) return;
+        MemoryProbe::Sample end = memory_probe->Take();
+        MemoryProbe::Sample begin = thread_stats.open_calls.back();
+        thread_stats.open_calls.pop_back();
+        thread_stats.memory_stats[prefix].Fill(
+            end.allocated_bytes - begin.allocated_bytes,
+            end.peak_rss_kb - begin.peak_rss_kb);
+    }
+
     void Finish() override {
+        if (memory_accounting) {
+            FactoryCallObserver::Instance().store(nullptr, std::memory_order_release);
+        }
+
+        // Merge statistics from all threads
+        for (const auto &thread_stats : all_thread_stats) {
+            for (const auto &[link, stats] : thread_stats->call_links) {
+                CallStats &merged = call_links[link];
+                merged.from_cache_ms += stats.from_cache_ms;
+                merged.from_source_ms += stats.from_source_ms;
+                merged.from_factory_ms += stats.from_factory_ms;
+                merged.data_not_available_ms += stats.data_not_available_ms;
+                merged.Nfrom_cache += stats.Nfrom_cache;
+                merged.Nfrom_source += stats.Nfrom_source;
+                merged.Nfrom_factory += stats.Nfrom_factory;
+                merged.Ndata_not_available += stats.Ndata_not_available;
+            }
+            for (const auto &[nametag, stats] : thread_stats->factory_stats) {
+                factory_stats[nametag].Merge(stats);
+            }
+            for (const auto &[prefix, stats] : thread_stats->memory_stats) {
+                memory_stats[prefix].Merge(stats);
+            }
+        }
+
         // In order to get the total time we have to first get a list of
         // the event processors (i.e. top-level callers). We can tell
         // this just by looking for callers that never show up as callees
@@ -169,6 +280,14 @@ class JEventProcessorJANATOP : public JEventProcessor
         }
         if (total_ms == 0.0) total_ms = 1.0;
 
+        if (!output_basename.empty()) {
+            WriteJSON(output_basename + ".json", total_ms);
+            WriteFactoriesCSV(output_basename + "_factories.csv");
+            if (memory_accounting) {
+                WriteMemoryCSV(output_basename + "_memory.csv");
+            }
+        }
+
         // Loop over call links
         std::cout << "Links:" << std::endl;
         std::vector<std::pair<CallLink, CallStats>> call_links_vector{
@@ -236,10 +355,126 @@ class JEventProcessorJANATOP : public JEventProcessor
 
   private:
 
-    std::mutex mutex;
+    std::mutex mutex; // protects all_thread_stats
 
+    static inline std::atomic<std::uint64_t> next_instance_id{0};
+    const std::uint64_t instance_id = next_instance_id++;
+    std::vector<std::unique_ptr<ThreadStats>> all_thread_stats;
+
+    // Merged in Finish()
     std::map<CallLink, CallStats> call_links;
     std::map<std::string, FactoryCallStats> factory_stats;
+    std::map<std::string, MemoryStats> memory_stats;
+
+    std::string output_basename = ""; // config. parameter
+    bool memory_accounting = false; // config. parameter
+    std::unique_ptr<MemoryProbe> memory_probe;
+
+    ThreadStats& GetThreadStats() {
+        thread_local std::map<std::uint64_t, ThreadStats*> thread_stats;
+        ThreadStats* &stats = thread_stats[instance_id];
+        if (stats == nullptr) {
+            std::lock_guard<std::mutex> lck(mutex);
+            stats = all_thread_stats.emplace_back(std::make_unique<ThreadStats>()).get();
+        }
+        return *stats;
+    }
+
+    static std::string JSONString(const std::string &str) {
+        std::string escaped = "\"";
+        for (char c : str) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    static std::string CSVString(const std::string &str) {
+        std::string escaped = "\"";
+        for (char c : str) {
+            if (c == '"') escaped += '"';
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    void WriteJSON(const std::string &filename, double total_ms) {
+        std::ofstream out(filename);
+        out << "{\n";
+        out << fmt::format("  \"total_ms\": {},\n", total_ms);
+        out << "  \"factories\": [";
+        bool first = true;
+        for (const auto &[nametag, stats] : factory_stats) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << fmt::format(
+                "    {{\"name\": {}, \"calls_from_factory\": {}, \"calls_from_cache\": {}, \"calls_from_source\": {}, "
+                "\"time_waited_on_ms\": {}, \"time_waiting_ms\": {}, \"self_time_ms\": {}, "
+                "\"latency_us\": {{\"count\": {}, \"mean\": {}, \"min\": {}, \"p50\": {}, \"p95\": {}, \"p99\": {}, \"max\": {}}}}}",
+                JSONString(nametag), stats.Nfrom_factory, stats.Nfrom_cache, stats.Nfrom_source,
+                stats.time_waited_on, stats.time_waiting, stats.time_waited_on - stats.time_waiting,
+                stats.latency_us.Count(), stats.latency_us.Mean(), stats.latency_us.Min(),
+                stats.latency_us.Quantile(0.50), stats.latency_us.Quantile(0.95), stats.latency_us.Quantile(0.99),
+                stats.latency_us.Max());
+        }
+        out << "\n  ],\n";
+        out << "  \"links\": [";
+        first = true;
+        for (const auto &[link, stats] : call_links) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << fmt::format(
+                "    {{\"caller\": {}, \"callee\": {}, \"calls_from_factory\": {}, \"calls_from_cache\": {}, "
+                "\"calls_from_source\": {}, \"calls_data_not_available\": {}, \"from_factory_ms\": {}, "
+                "\"from_cache_ms\": {}, \"from_source_ms\": {}, \"data_not_available_ms\": {}}}",
+                JSONString(MakeNametag(link.caller_name, link.caller_tag)),
+                JSONString(MakeNametag(link.callee_name, link.callee_tag)),
+                stats.Nfrom_factory, stats.Nfrom_cache, stats.Nfrom_source, stats.Ndata_not_available,
+                stats.from_factory_ms, stats.from_cache_ms, stats.from_source_ms, stats.data_not_available_ms);
+        }
+        out << "\n  ]";
+        if (memory_accounting) {
+            out << ",\n";
+            out << fmt::format("  \"allocation_source\": {},\n", JSONString(memory_probe->AllocationSource()));
+            out << "  \"memory\": [";
+            first = true;
+            for (const auto &[prefix, stats] : memory_stats) {
+                out << (first ? "\n" : ",\n");
+                first = false;
+                out << fmt::format(
+                    "    {{\"factory\": {}, \"calls\": {}, \"allocated_bytes\": {}, \"max_allocated_bytes_per_call\": {}, "
+                    "\"peak_rss_growth_kb\": {}, \"max_peak_rss_growth_kb_per_call\": {}}}",
+                    JSONString(prefix), stats.Ncalls, stats.allocated_bytes, stats.max_allocated_bytes,
+                    stats.peak_rss_growth_kb, stats.max_peak_rss_growth_kb);
+            }
+            out << "\n  ]";
+        }
+        out << "\n}\n";
+    }
+
+    void WriteFactoriesCSV(const std::string &filename) {
+        std::ofstream out(filename);
+        out << "name,calls_from_factory,calls_from_cache,calls_from_source,self_time_ms,"
+               "latency_mean_us,latency_min_us,latency_p50_us,latency_p95_us,latency_p99_us,latency_max_us\n";
+        for (const auto &[nametag, stats] : factory_stats) {
+            out << fmt::format("{},{},{},{},{},{},{},{},{},{},{}\n",
+                CSVString(nametag), stats.Nfrom_factory, stats.Nfrom_cache, stats.Nfrom_source,
+                stats.time_waited_on - stats.time_waiting,
+                stats.latency_us.Mean(), stats.latency_us.Min(),
+                stats.latency_us.Quantile(0.50), stats.latency_us.Quantile(0.95), stats.latency_us.Quantile(0.99),
+                stats.latency_us.Max());
+        }
+    }
+
+    void WriteMemoryCSV(const std::string &filename) {
+        std::ofstream out(filename);
+        out << "factory,calls,allocated_bytes,max_allocated_bytes_per_call,peak_rss_growth_kb,max_peak_rss_growth_kb_per_call\n";
+        for (const auto &[prefix, stats] : memory_stats) {
+            out << fmt::format("{},{},{},{},{},{}\n",
+                CSVString(prefix), stats.Ncalls, stats.allocated_bytes, stats.max_allocated_bytes,
+                stats.peak_rss_growth_kb, stats.max_peak_rss_growth_kb);
+        }
+    }
 
     std::string MakeTimeString(double time_in_ms) {
         double order = log10(time_in_ms);
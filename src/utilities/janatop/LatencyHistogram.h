@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Histogram of durations in microseconds with log-linear binning: values below
+ * 2 * sub_buckets are binned exactly, larger values with a relative bin width of
+ * at most 1 / sub_buckets. Histograms filled on different threads can be merged.
+ */
+class LatencyHistogram {
+  public:
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr std::uint64_t sub_buckets = 1 << sub_bucket_bits;
+
+    void Fill(std::uint64_t value_us) {
+        std::size_t index = BucketIndex(value_us);
+        if (index >= counts.size()) counts.resize(index + 1, 0);
+        counts[index]++;
+        n++;
+        sum_us += value_us;
+        min_us = std::min(min_us, value_us);
+        max_us = std::max(max_us, value_us);
+    }
+
+    void Merge(const LatencyHistogram &other) {
+        if (other.counts.size() > counts.size()) counts.resize(other.counts.size(), 0);
+        for (std::size_t i = 0; i < other.counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        n += other.n;
+        sum_us += other.sum_us;
+        min_us = std::min(min_us, other.min_us);
+        max_us = std::max(max_us, other.max_us);
+    }
+
+    std::uint64_t Count() const { return n; }
+    double Mean() const { return n > 0 ? static_cast<double>(sum_us) / n : 0.0; }
+    std::uint64_t Min() const { return n > 0 ? min_us : 0; }
+    std::uint64_t Max() const { return max_us; }
+
+    /// Value below which the fraction q of all entries lie, to within the bin width
+    double Quantile(double q) const {
+        if (n == 0) return 0.0;
+        std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * n)));
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < counts.size(); i++) {
+            cumulative += counts[i];
+            if (cumulative >= rank) {
+                double center = (BucketLower(i) + BucketUpper(i) - 1) / 2.0;
+                return std::clamp(center, static_cast<double>(min_us), static_cast<double>(max_us));
+            }
+        }
+        return max_us;
+    }
+
+  private:
+    static std::size_t BucketIndex(std::uint64_t value) {
+        if (value < 2 * sub_buckets) return value;
+        unsigned shift = std::bit_width(value) - sub_bucket_bits - 1;
+        return shift * sub_buckets + (value >> shift);
+    }
+
+    /// Smallest value in the bucket
+    static std::uint64_t BucketLower(std::size_t index) {
+        if (index < 2 * sub_buckets) return index;
+        unsigned shift = index / sub_buckets - 1;
+        return (index % sub_buckets + sub_buckets) << shift;
+    }
+
+    /// One past the largest value in the bucket
+    static std::uint64_t BucketUpper(std::size_t index) {
+        if (index < 2 * sub_buckets) return index + 1;
+        unsigned shift = index / sub_buckets - 1;
+        return (index % sub_buckets + sub_buckets + 1) << shift;
+    }
+
+    std::vector<std::uint64_t> counts;
+    std::uint64_t n = 0;
+    std::uint64_t sum_us = 0;
+    std::uint64_t min_us = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_us = 0;
+};
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck
+
+#pragma once
+
+#include <dlfcn.h>
+#ifdef __linux__
+#include <malloc.h>
+#endif
+#include <sys/resource.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Samples memory counters around factory calls.
+ *
+ * Allocated bytes come from jemalloc's per-thread allocation counter when the
+ * process runs with jemalloc. Otherwise the glibc heap statistics are used, which
+ * are process-wide and only give the net change of the heap in use, so they
+ * are only meaningful with a single processing thread.
+ */
+class MemoryProbe {
+  public:
+    struct Sample {
+        std::int64_t allocated_bytes = 0;
+        long peak_rss_kb = 0;
+    };
+
+    MemoryProbe() {
+        m_mallctl = reinterpret_cast<mallctl_t>(dlsym(RTLD_DEFAULT, "mallctl"));
+    }
+
+    const char* AllocationSource() const {
+        if (m_mallctl != nullptr) return "jemalloc thread.allocated";
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        return "glibc mallinfo2 (process-wide, net)";
+#else
+        return "none";
+#endif
+    }
+
+    Sample Take() const {
+        Sample sample;
+        sample.allocated_bytes = AllocatedBytes();
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+            sample.peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+            sample.peak_rss_kb = usage.ru_maxrss;
+#endif
+        }
+        return sample;
+    }
+
+  private:
+    using mallctl_t = int (*)(const char*, void*, std::size_t*, void*, std::size_t);
+    mallctl_t m_mallctl = nullptr;
+
+    std::int64_t AllocatedBytes() const {
+        if (m_mallctl != nullptr) {
+            // The counter lives in thread-local storage of jemalloc, look it up once per thread
+            thread_local std::uint64_t* allocatedp = nullptr;
+            if (allocatedp == nullptr) {
+                std::size_t size = sizeof(allocatedp);
+                if (m_mallctl("thread.allocatedp", &allocatedp, &size, nullptr, 0) != 0) {
+                    allocatedp = nullptr;
+                    return 0;
+                }
+            }
+            return static_cast<std::int64_t>(*allocatedp);
+        }
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        return static_cast<std::int64_t>(mallinfo2().uordblks);
+#else
+        return 0;
+#endif
+    }
+};
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck
+
+#include <JANA/JEvent.h>
+#include <JANA/JEventProcessor.h>
+#include <JANA/JException.h>
+#include <JANA/JFactory.h>
+#include <JANA/JFactorySet.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+/**
+ * Writes the factory calls of sampled events as a Chrome trace-event timeline
+ * (JSON array format), which can be opened in https://ui.perfetto.dev or
+ * chrome://tracing.
+ *
+ * Each JANA worker thread gets its own track. All calls recorded for an event
+ * are drawn on the track of the thread that processed the event, since JANA runs
+ * the factories of an event on the thread that requests them. Processors only
+ * show up through the calls they make, so each one is drawn as a slice spanning
+ * its first to last request.
+ *
+ * The call graph is recorded for every event, JANA enables RECORD_CALL_STACK for
+ * the whole run before any factory of an event is called. janatrace:sample_every
+ * and janatrace:max_events therefore only limit the size of the trace, not the
+ * recording overhead.
+ */
+class JEventProcessorJANATRACE : public JEventProcessor
+{
+  public:
+
+    JEventProcessorJANATRACE(): JEventProcessor() {
+        SetTypeName("JEventProcessorJANATRACE");
+    };
+
+    void Init() override {
+        auto app = GetApplication();
+        app->SetDefaultParameter("janatrace:output_file", m_output_file,
+            "Chrome trace-event JSON file to write");
+        app->SetDefaultParameter("janatrace:sample_every", m_sample_every,
+            "Trace one out of this many events (limits the trace size, all events are recorded)");
+        app->SetDefaultParameter("janatrace:max_events", m_max_events,
+            "Maximum number of events to trace (0 for no limit, limits the trace size only)");
+        if (m_sample_every == 0) m_sample_every = 1;
+
+        m_out.open(m_output_file);
+        if (!m_out) {
+            throw JException("Unable to open trace file \"%s\"", m_output_file.c_str());
+        }
+        m_out << "[\n" << R"({"name": "process_name", "ph": "M", "pid": 1, "tid": 0, "args": {"name": "eicrecon"}})";
+    };
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        std::uint64_t event_index = m_events_seen++;
+        if (event_index % m_sample_every != 0) return;
+        std::uint64_t sample_index = event_index / m_sample_every;
+        if (m_max_events > 0 && sample_index >= m_max_events) return;
+
+        auto stack = event->GetJCallGraphRecorder()->GetCallGraph();
+        if (stack.empty()) return;
+
+        int tid = GetThreadIndex();
+        auto event_number = event->GetEventNumber();
+
+        std::string buffer;
+        auto event_start = stack.front().start_time;
+        auto event_end = stack.front().end_time;
+        std::map<std::string, std::pair<decltype(event_start), decltype(event_end)>> caller_spans;
+        std::set<std::string> callees;
+        for (const auto &node : stack) {
+            callees.insert(MakeNametag(node.callee_name, node.callee_tag));
+            event_start = std::min(event_start, node.start_time);
+            event_end = std::max(event_end, node.end_time);
+            auto [iter, inserted] = caller_spans.try_emplace(MakeNametag(node.caller_name, node.caller_tag), node.start_time, node.end_time);
+            if (!inserted) {
+                iter->second.first = std::min(iter->second.first, node.start_time);
+                iter->second.second = std::max(iter->second.second, node.end_time);
+            }
+        }
+
+        // Event and processor slices
+        AppendSlice(buffer, fmt::format("Event {}", event_number), "event", tid, event_start, event_end,
+            fmt::format(R"({{"event": {}}})", event_number));
+        for (const auto &[caller, span] : caller_spans) {
+            if (callees.count(caller) == 0) {
+                AppendSlice(buffer, caller, "processor", tid, span.first, span.second,
+                    fmt::format(R"({{"event": {}}})", event_number));
+            }
+        }
+
+        // Factory slices
+        for (const auto &node : stack) {
+            const char *data_source = "not_available";
+            switch (node.data_source) {
+                case JCallGraphRecorder::DATA_NOT_AVAILABLE: data_source = "not_available"; break;
+                case JCallGraphRecorder::DATA_FROM_CACHE: data_source = "cache"; break;
+                case JCallGraphRecorder::DATA_FROM_SOURCE: data_source = "source"; break;
+                case JCallGraphRecorder::DATA_FROM_FACTORY: data_source = "factory"; break;
+            }
+            std::string args = fmt::format(R"({{"event": {}, "caller": {}, "data_source": "{}")",
+                event_number, JSONString(MakeNametag(node.caller_name, node.caller_tag)), data_source);
+            auto *factory = event->GetFactorySet()->GetFactory(node.callee_name, node.callee_tag);
+            if (factory != nullptr && node.data_source != JCallGraphRecorder::DATA_NOT_AVAILABLE) {
+                args += fmt::format(R"(, "objects": {})", factory->GetNumObjects());
+            }
+            args += "}";
+            AppendSlice(buffer, MakeNametag(node.callee_name, node.callee_tag), data_source, tid,
+                node.start_time, node.end_time, args);
+        }
+
+        std::lock_guard<std::mutex> lck(m_mutex);
+        m_out << buffer;
+    };
+
+    void Finish() override {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        // The closing bracket is optional in the JSON array format, so a trace of an
+        // aborted job can still be opened
+        m_out << "\n]\n";
+        m_out.close();
+    };
+
+  private:
+
+    using CallGraphNode = decltype(std::declval<JCallGraphRecorder>().GetCallGraph())::value_type;
+    using clock = decltype(CallGraphNode::start_time)::clock;
+
+    std::string m_output_file = "janatrace.json"; // config. parameter
+    std::uint64_t m_sample_every = 10; // config. parameter
+    std::uint64_t m_max_events = 1000; // config. parameter
+
+    std::mutex m_mutex; // protects m_out and m_thread_count
+    std::ofstream m_out;
+    int m_thread_count = 0;
+    std::atomic<std::uint64_t> m_events_seen{0};
+    const clock::time_point m_start_time = clock::now();
+
+    /// Track number for the calling thread, announcing the track when it is first used
+    int GetThreadIndex() {
+        thread_local std::map<const JEventProcessorJANATRACE*, int> thread_indices;
+        auto iter = thread_indices.find(this);
+        if (iter != thread_indices.end()) return iter->second;
+
+        std::lock_guard<std::mutex> lck(m_mutex);
+        int tid = ++m_thread_count;
+        m_out << fmt::format(",\n" R"({{"name": "thread_name", "ph": "M", "pid": 1, "tid": {0}, "args": {{"name": "worker {0}"}}}})", tid);
+        thread_indices[this] = tid;
+        return tid;
+    }
+
+    void AppendSlice(std::string &buffer, const std::string &name, const char *category, int tid,
+                     clock::time_point start, clock::time_point end, const std::string &args) const {
+        double ts_us = std::chrono::duration<double, std::micro>(start - m_start_time).count();
+        double dur_us = std::chrono::duration<double, std::micro>(end - start).count();
+        buffer += fmt::format(",\n" R"({{"name": {}, "cat": "{}", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f}, "args": {}}})",
+            JSONString(name), category, tid, ts_us, dur_us, args);
+    }
+
+    static std::string JSONString(const std::string &str) {
+        std::string escaped = "\"";
+        for (char c : str) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    static std::string MakeNametag(const std::string &name, const std::string &tag) {
+        std::string nametag = name;
+        if (tag.size() > 0) nametag += ":" + tag;
+        return nametag;
+    }
+};
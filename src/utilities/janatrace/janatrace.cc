@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2024, Wouter Deconinck
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JParameterManager.h>
+#include <memory>
+
+#include "JEventProcessorJANATRACE.h"
+
+extern "C" {
+    void InitPlugin(JApplication *app) {
+        InitJANAPlugin(app);
+        app->Add(new JEventProcessorJANATRACE());
+        app->GetJParameterManager()->SetParameter("RECORD_CALL_STACK", true);
+    }
+}